@@ -70,6 +70,10 @@ EntityServer::~EntityServer() {
         _pruneDeletedEntitiesTimer->stop();
         _pruneDeletedEntitiesTimer->deleteLater();
     }
+    if (_updateSimulationViewersTimer) {
+        _updateSimulationViewersTimer->stop();
+        _updateSimulationViewersTimer->deleteLater();
+    }
 
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->removeNewlyCreatedHook(this);
@@ -121,6 +125,11 @@ void EntityServer::beforeRun() {
     const int PRUNE_DELETED_MODELS_INTERVAL_MSECS = 1 * 1000; // once every second
     _pruneDeletedEntitiesTimer->start(PRUNE_DELETED_MODELS_INTERVAL_MSECS);
 
+    _updateSimulationViewersTimer = new QTimer();
+    connect(_updateSimulationViewersTimer, &QTimer::timeout, this, &EntityServer::updateSimulationViewers);
+    const int UPDATE_SIMULATION_VIEWERS_INTERVAL_MSECS = 250;
+    _updateSimulationViewersTimer->start(UPDATE_SIMULATION_VIEWERS_INTERVAL_MSECS);
+
     DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
     connect(&domainHandler, &DomainHandler::settingsReceiveFail, this, &EntityServer::domainSettingsRequestFailed);
 }
@@ -306,6 +315,23 @@ void EntityServer::pruneDeletedEntities() {
     }
 }
 
+void EntityServer::updateSimulationViewers() {
+    // the simulation steps far away kinematic entities less often, so tell it where the agents are looking from
+    if (!_entitySimulation) {
+        return;
+    }
+    std::vector<glm::vec3> viewerPositions;
+    DependencyManager::get<NodeList>()->eachNode([&viewerPositions](const SharedNodePointer& node) {
+        EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
+        if (nodeData && node->getType() == NodeType::Agent) {
+            for (const auto& view : nodeData->getConicalViews()) {
+                viewerPositions.push_back(view.getPosition());
+            }
+        }
+    });
+    _entitySimulation->setViewerPositions(viewerPositions);
+}
+
 void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectionObject) {
     bool wantEditLogging = false;
     readOptionBool(QString("wantEditLogging"), settingsSectionObject, wantEditLogging);
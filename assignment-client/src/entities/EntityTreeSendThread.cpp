@@ -101,7 +101,16 @@ void EntityTreeSendThread::preDistributionProcessing() {
 
 bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, OctreeQueryNode* nodeData,
             bool viewFrustumChanged, bool isFullScene) {
-    if (viewFrustumChanged || _traversal.finished()) {
+    const auto& queryFilter = getQueryFilter(nodeData->getJSONParameters());
+    if (queryFilter.getIndex() != EntityQueryFilter::Index::None && nodeData->getCurrentViews().empty()) {
+        // without a view every entity passing the filter is sent, and the tree keeps an index of the candidates
+        bool forceFirstPass = isFullScene || !_isSendingFromIndex;
+        if (!_isSendingFromIndex) {
+            _isSendingFromIndex = true;
+            _traversal.reset();
+        }
+        queueIndexedEntities(*static_cast<EntityNodeData*>(nodeData), forceFirstPass);
+    } else if (viewFrustumChanged || _traversal.finished() || _isSendingFromIndex) {
         EntityTreeElementPointer root = std::dynamic_pointer_cast<EntityTreeElement>(_myServer->getOctree()->getRoot());
 
 
@@ -111,7 +120,8 @@ bool EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
         int32_t lodLevelOffset = nodeData->getBoundaryLevelAdjust() + (viewFrustumChanged ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
         newView.lodScaleFactor = powf(2.0f, lodLevelOffset);
         
-        startNewTraversal(newView, root, isFullScene);
+        startNewTraversal(newView, root, isFullScene || _isSendingFromIndex);
+        _isSendingFromIndex = false;
 
         // When the viewFrustum changed the sort order may be incorrect, so we re-sort
         // and also use the opportunity to cull anything no longer in view
@@ -317,6 +327,50 @@ void EntityTreeSendThread::startNewTraversal(const DiffTraversal::View& view, En
     }
 }
 
+void EntityTreeSendThread::queueIndexedEntities(EntityNodeData& nodeData, bool forceFirstPass) {
+    if (forceFirstPass) {
+        _knownState.clear();
+    }
+
+    // like the Repeat traversal: queue what we haven't sent yet, or what changed since we sent it
+    auto queueIfChanged = [&](const EntityItemPointer& entity) {
+        if (!entity || _sendQueue.contains(entity.get())) {
+            return;
+        }
+        auto knownTimestamp = _knownState.find(entity.get());
+        if (knownTimestamp == _knownState.end() || entity->getLastEdited() > knownTimestamp->second ||
+            entity->getLastChangedOnServer() > knownTimestamp->second) {
+            _sendQueue.emplace(entity, PrioritizedEntity::WHEN_IN_DOUBT_PRIORITY);
+        }
+    };
+
+    auto entityTree = std::static_pointer_cast<EntityTree>(_myServer->getOctree());
+    auto candidates = entityTree->getIndexedEntities(_queryFilter);
+    for (const auto& entity : candidates) {
+        queueIfChanged(entity);
+    }
+
+    // the ancestors and descendants flagged by preDistributionProcessing() aren't in the index, nor are the entities
+    // that stopped matching the filter since we sent them, which have to be sent once more
+    foreach(const QUuid& entityID, nodeData.getFlaggedExtraEntities()) {
+        queueIfChanged(entityTree->findEntityByID(entityID));
+    }
+    foreach(const QUuid& entityID, nodeData.getSentFilteredEntities()) {
+        if (!candidates.contains(entityID)) {
+            queueIfChanged(entityTree->findEntityByID(entityID));
+        }
+    }
+}
+
+const EntityQueryFilter& EntityTreeSendThread::getQueryFilter(const QJsonObject& jsonFilters) {
+    // the JSON parameters rarely change, and comparing them is cheap while they share data
+    if (jsonFilters != _queryFilterJSON) {
+        _queryFilterJSON = jsonFilters;
+        _queryFilter = EntityQueryFilter(jsonFilters);
+    }
+    return _queryFilter;
+}
+
 bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) {
     if (_sendQueue.empty()) {
         params.stopReason = EncodeBitstreamParams::FINISHED;
@@ -369,7 +423,7 @@ bool EntityTreeSendThread::traverseTreeAndBuildNextPacketPayload(EncodeBitstream
             const QUuid& entityID = entity->getID();
             // Only send entities that match the jsonFilters, but keep track of everything we've tried to send so we don't try to send it again;
             // also send if we previously matched since this represents change to a matched item.
-            bool entityMatchesFilters = entity->matchesJSONFilters(jsonFilters);
+            bool entityMatchesFilters = entity->matchesQueryFilter(getQueryFilter(jsonFilters));
             bool entityPreviouslyMatchedFilter = entityNodeData->sentFilteredEntity(entityID);
 
             if (entityMatchesFilters || entityNodeData->isEntityFlaggedAsExtra(entityID) || entityPreviouslyMatchedFilter) {
@@ -18,6 +18,7 @@
 
 #include <DiffTraversal.h>
 #include <EntityPriorityQueue.h>
+#include <EntityQueryFilter.h>
 #include <shared/ConicalViewFrustum.h>
 
 
@@ -43,6 +44,9 @@ private:
     bool addDescendantsToExtraFlaggedEntities(const QUuid& filteredEntityID, EntityItem& entityItem, EntityNodeData& nodeData);
 
     void startNewTraversal(const DiffTraversal::View& viewFrustum, EntityTreeElementPointer root, bool forceFirstPass = false);
+    // replaces the tree traversal for queries without a view whose filter has an index in the EntityTree
+    void queueIndexedEntities(EntityNodeData& nodeData, bool forceFirstPass);
+    const EntityQueryFilter& getQueryFilter(const QJsonObject& jsonFilters);
     bool traverseTreeAndBuildNextPacketPayload(EncodeBitstreamParams& params, const QJsonObject& jsonFilters) override;
 
     void preDistributionProcessing() override;
@@ -53,6 +57,10 @@ private:
     EntityPriorityQueue _sendQueue;
     std::unordered_map<EntityItem*, uint64_t> _knownState;
 
+    QJsonObject _queryFilterJSON;
+    EntityQueryFilter _queryFilter; // compiled from _queryFilterJSON
+    bool _isSendingFromIndex { false };
+
     // packet construction stuff
     EntityTreeElementExtraEncodeDataPointer _extraEncodeData { new EntityTreeElementExtraEncodeData() };
     int32_t _numEntitiesOffset { 0 };
@@ -154,52 +154,56 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         }
         
         const unsigned char* editData = nullptr;
-        
-        while (message->getBytesLeftToRead() > 0) {
 
-            editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
+        // apply every edit in the packet under one write lock, rather than taking it once per edit, so a client
+        // streaming many small edits doesn't keep handing the lock back and forth with the send threads
+        quint64 startLock = usecTimestampNow();
+        _myServer->getOctree()->withWriteLock([&] {
+            quint64 startProcess = usecTimestampNow();
+            lockWaitTime += startProcess - startLock;
 
-            int maxSize = message->getBytesLeftToRead();
+            _myServer->getOctree()->beginEditPacket(*message, sendingNode);
 
-            if (debugProcessPacket) {
-                qDebug() << " --- inside while loop ---";
-                qDebug() << "    maxSize=" << maxSize;
-                qDebug("OctreeInboundPacketProcessor::processPacket() %hhu "
-                       "payload=%p payloadLength=%lld editData=%p payloadPosition=%lld maxSize=%d",
-                       (unsigned char)packetType, message->getRawMessage(), message->getSize(), editData,
-                        message->getPosition(), maxSize);
-            }
+            while (message->getBytesLeftToRead() > 0) {
+
+                editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
+
+                int maxSize = message->getBytesLeftToRead();
+
+                if (debugProcessPacket) {
+                    qDebug() << " --- inside while loop ---";
+                    qDebug() << "    maxSize=" << maxSize;
+                    qDebug("OctreeInboundPacketProcessor::processPacket() %hhu "
+                           "payload=%p payloadLength=%lld editData=%p payloadPosition=%lld maxSize=%d",
+                           (unsigned char)packetType, message->getRawMessage(), message->getSize(), editData,
+                            message->getPosition(), maxSize);
+                }
 
-            quint64 startProcess, startLock = usecTimestampNow();
-            int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
+                int editDataBytesRead =
                     _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
-            });
-            quint64 endProcess = usecTimestampNow();
 
-            if (debugProcessPacket) {
-                qDebug() << "OctreeInboundPacketProcessor::processPacket() after processEditPacketData()..."
-                    << "editDataBytesRead=" << editDataBytesRead;
-            }
+                if (debugProcessPacket) {
+                    qDebug() << "OctreeInboundPacketProcessor::processPacket() after processEditPacketData()..."
+                        << "editDataBytesRead=" << editDataBytesRead;
+                }
 
-            editsInPacket++;
-            quint64 thisProcessTime = endProcess - startProcess;
-            quint64 thisLockWaitTime = startProcess - startLock;
-            processTime += thisProcessTime;
-            lockWaitTime += thisLockWaitTime;
+                editsInPacket++;
 
-            // skip to next edit record in the packet
-            message->seek(message->getPosition() + editDataBytesRead);
+                // skip to next edit record in the packet
+                message->seek(message->getPosition() + editDataBytesRead);
+
+                if (debugProcessPacket) {
+                    qDebug() << "    editDataBytesRead=" << editDataBytesRead;
+                    qDebug() << "    AFTER processEditPacketData payload position=" << message->getPosition();
+                    qDebug() << "    AFTER processEditPacketData payload size=" << message->getSize();
+                }
 
-            if (debugProcessPacket) {
-                qDebug() << "    editDataBytesRead=" << editDataBytesRead;
-                qDebug() << "    AFTER processEditPacketData payload position=" << message->getPosition();
-                qDebug() << "    AFTER processEditPacketData payload size=" << message->getSize();
             }
 
-        }
+            _myServer->getOctree()->endEditPacket();
+
+            processTime += usecTimestampNow() - startProcess;
+        });
 
         if (debugProcessPacket) {
             qDebug("OctreeInboundPacketProcessor::processPacket() DONE LOOPING FOR %hhu "
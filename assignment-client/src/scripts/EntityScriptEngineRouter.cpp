@@ -0,0 +1,199 @@
+//
+//  EntityScriptEngineRouter.cpp
+//  assignment-client/src/scripts
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityScriptEngineRouter.h"
+
+#include <limits>
+#include <time.h>
+
+#ifdef Q_OS_WIN
+#include <Windows.h>
+#endif
+
+#include <QtCore/QTimer>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+// an engine above either of these is skipped when placing a script, as long as another one is below them
+static const float BUSY_WORKER_CPU_USAGE = 0.8f;
+static const uint64_t BUSY_WORKER_QUEUE_LATENCY_USECS = 100 * USECS_PER_MSEC;
+
+static uint64_t currentThreadCPUUsecs() {
+#ifdef Q_OS_WIN
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    // FILETIMEs count 100ns intervals
+    auto toUsecs = [](const FILETIME& time) {
+        return (((uint64_t)time.dwHighDateTime << 32) | time.dwLowDateTime) / 10;
+    };
+    return toUsecs(kernelTime) + toUsecs(userTime);
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+        return 0;
+    }
+    return (uint64_t)time.tv_sec * USECS_PER_SECOND + (uint64_t)time.tv_nsec / NSECS_PER_USEC;
+#endif
+}
+
+void EntityScriptEngineRouter::setEngines(const std::vector<ScriptEnginePointer>& engines) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _workers.clear();
+    _entityWorkers.clear();
+    for (const auto& engine : engines) {
+        Worker worker;
+        worker.engine = engine;
+        worker.load = std::make_shared<WorkerLoad>();
+        _workers.push_back(worker);
+    }
+}
+
+std::vector<ScriptEnginePointer> EntityScriptEngineRouter::getEngines() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    std::vector<ScriptEnginePointer> engines;
+    engines.reserve(_workers.size());
+    for (const auto& worker : _workers) {
+        engines.push_back(worker.engine);
+    }
+    return engines;
+}
+
+size_t EntityScriptEngineRouter::getNumEngines() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _workers.size();
+}
+
+ScriptEnginePointer EntityScriptEngineRouter::getEngine(const EntityItemID& entityID) const {
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _entityWorkers.find(entityID);
+    if (it == _entityWorkers.end()) {
+        return ScriptEnginePointer();
+    }
+    return _workers[it->second].engine;
+}
+
+ScriptEnginePointer EntityScriptEngineRouter::assignEngine(const EntityItemID& entityID) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_workers.empty()) {
+        return ScriptEnginePointer();
+    }
+
+    auto it = _entityWorkers.find(entityID);
+    if (it != _entityWorkers.end()) {
+        return _workers[it->second].engine;
+    }
+
+    // prefer engines that are not busy, then the ones with the fewest scripts
+    size_t bestIndex = 0;
+    bool bestIsBusy = true;
+    int bestNumScripts = std::numeric_limits<int>::max();
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const auto& worker = _workers[i];
+        bool isBusy = worker.load->cpuUsage > BUSY_WORKER_CPU_USAGE ||
+            worker.load->queueLatencyUsecs > BUSY_WORKER_QUEUE_LATENCY_USECS;
+        if ((!isBusy && bestIsBusy) ||
+            (isBusy == bestIsBusy && worker.numAssignedScripts < bestNumScripts)) {
+            bestIndex = i;
+            bestIsBusy = isBusy;
+            bestNumScripts = worker.numAssignedScripts;
+        }
+    }
+
+    _entityWorkers[entityID] = bestIndex;
+    _workers[bestIndex].numAssignedScripts++;
+    return _workers[bestIndex].engine;
+}
+
+void EntityScriptEngineRouter::unassignEngine(const EntityItemID& entityID) {
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _entityWorkers.find(entityID);
+    if (it != _entityWorkers.end()) {
+        _workers[it->second].numAssignedScripts--;
+        _entityWorkers.erase(it);
+    }
+}
+
+std::vector<EntityItemID> EntityScriptEngineRouter::getAssignedEntities() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    std::vector<EntityItemID> entities;
+    entities.reserve(_entityWorkers.size());
+    for (const auto& entry : _entityWorkers) {
+        entities.push_back(entry.first);
+    }
+    return entities;
+}
+
+int EntityScriptEngineRouter::getNumRunningEntityScripts() const {
+    int numRunningScripts = 0;
+    for (const auto& engine : getEngines()) {
+        numRunningScripts += engine->getNumRunningEntityScripts();
+    }
+    return numRunningScripts;
+}
+
+void EntityScriptEngineRouter::sampleLoad() {
+    std::lock_guard<std::mutex> lock(_lock);
+    auto postedUsecs = usecTimestampNow();
+    for (const auto& worker : _workers) {
+        auto load = worker.load;
+        // runs on the engine thread, between two iterations of its script loop
+        QTimer::singleShot(0, worker.engine.data(), [load, postedUsecs] {
+            auto nowUsecs = usecTimestampNow();
+            auto cpuUsecs = currentThreadCPUUsecs();
+            load->queueLatencyUsecs = nowUsecs > postedUsecs ? nowUsecs - postedUsecs : 0;
+
+            auto lastSampleUsecs = load->lastSampleUsecs.exchange(nowUsecs);
+            auto lastCPUUsecs = load->lastCPUUsecs.exchange(cpuUsecs);
+            if (lastSampleUsecs != 0 && nowUsecs > lastSampleUsecs && cpuUsecs >= lastCPUUsecs) {
+                load->cpuUsage = (float)(cpuUsecs - lastCPUUsecs) / (float)(nowUsecs - lastSampleUsecs);
+            }
+        });
+    }
+}
+
+QJsonObject EntityScriptEngineRouter::getStats() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    QJsonObject workersStats;
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const auto& worker = _workers[i];
+        QJsonObject workerStats;
+        workerStats["number_running_scripts"] = worker.engine->getNumRunningEntityScripts();
+        workerStats["number_assigned_scripts"] = worker.numAssignedScripts;
+        workerStats["cpu_usage"] = (double)worker.load->cpuUsage;
+        workerStats["queue_latency_msecs"] = (double)worker.load->queueLatencyUsecs / USECS_PER_MSEC;
+        workersStats[QString("engine_%1").arg(i)] = workerStats;
+    }
+    return workersStats;
+}
+
+void EntityScriptEngineRouter::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                      const QStringList& params, const QUuid& remoteCallerID) {
+    // the engine marshals the call to its own thread
+    auto engine = getEngine(entityID);
+    if (engine) {
+        engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+    }
+}
+
+QFuture<QVariant> EntityScriptEngineRouter::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    auto engine = getEngine(entityID);
+    if (!engine) {
+        // no engine runs this script, any of them answers with empty details
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_workers.empty()) {
+            return QFuture<QVariant>();
+        }
+        engine = _workers.front().engine;
+    }
+    return engine->getLocalEntityScriptDetails(entityID);
+}
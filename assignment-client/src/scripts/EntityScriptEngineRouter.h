@@ -0,0 +1,73 @@
+//
+//  EntityScriptEngineRouter.h
+//  assignment-client/src/scripts
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptEngineRouter_h
+#define hifi_EntityScriptEngineRouter_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QJsonObject>
+
+#include <EntitiesScriptEngineProvider.h>
+#include <EntityItemID.h>
+#include <ScriptEngine.h>
+
+// Spreads the server entity scripts over several script engines, each running on its own thread.
+// A script is placed on the least loaded engine when it is loaded and stays there until it is unloaded:
+// moving a running script would lose its state, so the load is rebalanced as scripts are (re)loaded.
+// Calls to entity script methods are routed to the engine running the script of the entity.
+class EntityScriptEngineRouter : public EntitiesScriptEngineProvider {
+public:
+    void setEngines(const std::vector<ScriptEnginePointer>& engines);
+    std::vector<ScriptEnginePointer> getEngines() const;
+    size_t getNumEngines() const;
+
+    // The engine the script of the entity was placed on, null if it has none
+    ScriptEnginePointer getEngine(const EntityItemID& entityID) const;
+    // Places the script of the entity on the least loaded engine
+    ScriptEnginePointer assignEngine(const EntityItemID& entityID);
+    void unassignEngine(const EntityItemID& entityID);
+    std::vector<EntityItemID> getAssignedEntities() const;
+
+    int getNumRunningEntityScripts() const;
+
+    // Posts a probe to every engine thread, measuring the cpu time of the thread and how long the probe waited in its
+    // event queue. The results are used by assignEngine() and show up in getStats() once the probes have run.
+    void sampleLoad();
+    QJsonObject getStats() const;
+
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params = QStringList(), const QUuid& remoteCallerID = QUuid()) override;
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
+private:
+    struct WorkerLoad {
+        std::atomic<uint64_t> lastSampleUsecs { 0 };
+        std::atomic<uint64_t> lastCPUUsecs { 0 };
+        std::atomic<float> cpuUsage { 0.0f }; // fraction of a core
+        std::atomic<uint64_t> queueLatencyUsecs { 0 };
+    };
+
+    struct Worker {
+        ScriptEnginePointer engine;
+        std::shared_ptr<WorkerLoad> load;
+        int numAssignedScripts { 0 };
+    };
+
+    mutable std::mutex _lock;
+    std::vector<Worker> _workers;
+    std::unordered_map<EntityItemID, size_t> _entityWorkers;
+};
+
+#endif // hifi_EntityScriptEngineRouter_h
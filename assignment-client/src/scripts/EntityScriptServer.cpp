@@ -54,7 +54,10 @@ void messageHandler(QtMsgType type, const QMessageLogContext& context, const QSt
 
 int EntityScriptServer::_entitiesScriptEngineCount = 0;
 
-EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssignment(message) {
+EntityScriptServer::EntityScriptServer(ReceivedMessage& message) :
+    ThreadedAssignment(message),
+    _entitiesScriptEngines(new EntityScriptEngineRouter())
+{
     qInstallMessageHandler(messageHandler);
 
     DependencyManager::registerInheritance<EntityDynamicFactoryInterface, AssignmentDynamicFactory>();
@@ -125,7 +128,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto scriptEngine = _entitiesScriptEngines->getEngine(entityID);
+        if (scriptEngine && scriptEngine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -154,6 +158,25 @@ void EntityScriptServer::handleSettings() {
 
     auto entityScriptServerSettings = settingsObject[ENTITY_SCRIPT_SERVER_SETTINGS_KEY].toObject();
 
+    static const QString NUM_SCRIPT_ENGINES_OPTION = "script_engines";
+    if (entityScriptServerSettings.contains(NUM_SCRIPT_ENGINES_OPTION)) {
+        int numScriptEngines = std::min(std::max(1, entityScriptServerSettings[NUM_SCRIPT_ENGINES_OPTION].toInt()),
+                                        MAX_NUM_ENTITIES_SCRIPT_ENGINES);
+        if (numScriptEngines != _numEntitiesScriptEngines) {
+            qCDebug(entity_script_server) << "Entity scripts will run in" << numScriptEngines << "script engines";
+            _numEntitiesScriptEngines = numScriptEngines;
+            if (_entitiesScriptEngines->getNumEngines() > 0 && !_shuttingDown) {
+                // reload the scripts that were already placed on the new engines
+                auto entitiesWithScripts = _entitiesScriptEngines->getAssignedEntities();
+                stopEntitiesScriptEngines();
+                resetEntitiesScriptEngines();
+                for (const auto& entityID : entitiesWithScripts) {
+                    checkAndCallPreload(entityID);
+                }
+            }
+        }
+    }
+
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
 
@@ -170,7 +193,7 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = _entitiesScriptEngines->getNumRunningEntityScripts();
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplication would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -231,7 +254,7 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
+    if (_entitiesScriptEngines->getNumEngines() > 0 && _entityViewer.getTree() && !_shuttingDown) {
         auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
@@ -245,7 +268,8 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        // routed to the engine running the script of the entity
+        _entitiesScriptEngines->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
     }
 }
 
@@ -277,7 +301,7 @@ void EntityScriptServer::run() {
     });
 
     // Setup Script Engine
-    resetEntitiesScriptEngine();
+    resetEntitiesScriptEngines();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     entityScriptingInterface->init();
@@ -439,7 +463,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+ScriptEnginePointer EntityScriptServer::createEntitiesScriptEngine() {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
 
@@ -456,48 +480,62 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+    connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+            this, &EntityScriptServer::updateEntityPPS);
+
+    scriptEngines->runScriptInitializers(newEngine);
+    newEngine->runInThread();
+    return newEngine;
+}
+
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    std::vector<ScriptEnginePointer> newEngines;
+    for (int i = 0; i < _numEntitiesScriptEngines; ++i) {
+        newEngines.push_back(createEntitiesScriptEngine());
+    }
+
+    // the entity tree is updated once per frame of the first engine
+    connect(newEngines.front().data(), &ScriptEngine::update, this, [this] {
         _entityViewer.queryOctree();
         _entityViewer.getTree()->preUpdate();
         _entityViewer.getTree()->update();
     });
 
-    scriptEngines->runScriptInitializers(newEngine);
-    newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
+    _entitiesScriptEngines->setEngines(newEngines);
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(
+        qSharedPointerCast<EntitiesScriptEngineProvider>(_entitiesScriptEngines));
+}
 
-    if (_entitiesScriptEngine) {
-        disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+void EntityScriptServer::stopEntitiesScriptEngines() {
+    // unload and stop the engines
+    auto engines = _entitiesScriptEngines->getEngines();
+    for (auto& engine : engines) {
+        disconnect(engine.data(), &ScriptEngine::entityScriptDetailsUpdated,
                    this, &EntityScriptServer::updateEntityPPS);
+        // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
+        engine->unloadAllEntityScripts();
+        engine->stop();
     }
-
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+    for (auto& engine : engines) {
+        engine->waitTillDoneRunning();
+    }
+    _entitiesScriptEngines->setEngines(std::vector<ScriptEnginePointer>());
 }
 
-
 void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
-        // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
-        _entitiesScriptEngine->waitTillDoneRunning();
-    }
+    stopEntitiesScriptEngines();
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
+        engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
@@ -506,12 +544,13 @@ void EntityScriptServer::shutdownScriptEngine() {
     auto scriptEngines = DependencyManager::get<ScriptEngines>();
     scriptEngines->shutdownScripting();
 
-    _entitiesScriptEngine.clear();
-
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
     entityScriptingInterface->setEntityTree(nullptr);
 
+    // clear() stopped and dropped the engines; the EntityScriptingInterface outlives us, so release the pool from it too
+    entityScriptingInterface->setEntitiesScriptEngine(QSharedPointer<EntitiesScriptEngineProvider>());
+
     // Should always be true as they are singletons.
     if (entityScriptingInterface->getPacketSender() == &_entityEditSender) {
         // The packet sender is about to go away.
@@ -524,8 +563,12 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown) {
+        auto scriptEngine = _entitiesScriptEngines->getEngine(entityID);
+        if (scriptEngine) {
+            scriptEngine->unloadEntityScript(entityID, true);
+            _entitiesScriptEngines->unassignEngine(entityID);
+        }
     }
 }
 
@@ -536,20 +579,31 @@ void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool forceRedownload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngines->getNumEngines() > 0) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
         EntityScriptDetails details;
-        bool isRunning = _entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        auto scriptEngine = _entitiesScriptEngines->getEngine(entityID);
+        bool isRunning = scriptEngine && scriptEngine->getEntityScriptDetails(entityID, details);
         if (entity && (forceRedownload || !isRunning || details.scriptText != entity->getServerScripts())) {
             if (isRunning) {
-                _entitiesScriptEngine->unloadEntityScript(entityID, true);
+                // the script starts over, so it can move to a less loaded engine
+                scriptEngine->unloadEntityScript(entityID, true);
+                _entitiesScriptEngines->unassignEngine(entityID);
+                scriptEngine.reset();
             }
 
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, forceRedownload);
+                if (!scriptEngine) {
+                    scriptEngine = _entitiesScriptEngines->assignEngine(entityID);
+                }
+                scriptEngine->loadEntityScript(entityID, scriptUrl, forceRedownload);
+            } else if (scriptEngine) {
+                // the script was cleared before it started running, so its engine stops counting it
+                scriptEngine->unloadEntityScript(entityID, true);
+                _entitiesScriptEngines->unassignEngine(entityID);
             }
         }
     }
@@ -565,12 +619,10 @@ void EntityScriptServer::sendStatsPacket() {
     statsObject["octree_stats"] = octreeStats;
 
     QJsonObject scriptEngineStats;
-    int numberRunningScripts = 0;
-    const auto scriptEngine = _entitiesScriptEngine;
-    if (scriptEngine) {
-        numberRunningScripts = scriptEngine->getNumRunningEntityScripts();
-    }
-    scriptEngineStats["number_running_scripts"] = numberRunningScripts;
+    scriptEngineStats["number_running_scripts"] = _entitiesScriptEngines->getNumRunningEntityScripts();
+    // per engine load, as sampled by the probes posted on the previous stats packet
+    scriptEngineStats["engines"] = _entitiesScriptEngines->getStats();
+    _entitiesScriptEngines->sampleLoad();
     statsObject["script_engine_stats"] = scriptEngineStats;
     
 
@@ -24,6 +24,10 @@
 #include <SimpleEntitySimulation.h>
 #include <ThreadedAssignment.h>
 #include "../entities/EntityTreeHeadlessViewer.h"
+#include "EntityScriptEngineRouter.h"
+
+static const int DEFAULT_NUM_ENTITIES_SCRIPT_ENGINES = 1;
+static const int MAX_NUM_ENTITIES_SCRIPT_ENGINES = 16;
 
 class EntityScriptServer : public ThreadedAssignment {
     Q_OBJECT
@@ -61,7 +65,9 @@ private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    void resetEntitiesScriptEngines();
+    ScriptEnginePointer createEntitiesScriptEngine();
+    void stopEntitiesScriptEngines();
     void clear();
     void shutdownScriptEngine();
 
@@ -75,7 +81,9 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+    // the engines running the entity scripts, the first one also drives the entity tree updates
+    QSharedPointer<EntityScriptEngineRouter> _entitiesScriptEngines;
+    int _numEntitiesScriptEngines { DEFAULT_NUM_ENTITIES_SCRIPT_ENGINES };
     SimpleEntitySimulationPointer _entitySimulation;
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
@@ -5269,6 +5269,8 @@ void Application::idle() {
     {
         _gameWorkload.updateViews(_viewFrustum, getMyAvatar()->getHeadPosition());
         _gameWorkload._engine->run();
+        _entitySimulation->setViewerPositions({ getMyAvatar()->getHeadPosition() });
+        _entitySimulation->setViewFrustums({ _viewFrustum });
     }
     {
         PerformanceTimer perfTimer("update");
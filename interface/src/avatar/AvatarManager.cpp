@@ -35,6 +35,7 @@
 #include <RegisteredMetaTypes.h>
 #include <Rig.h>
 #include <SettingHandle.h>
+#include <TBBHelpers.h>
 #include <UsersScriptingInterface.h>
 #include <UUID.h>
 #include <shared/ConicalViewFrustum.h>
@@ -55,6 +56,9 @@
 // We add _myAvatar into the hash with all the other AvatarData, and we use the default NULL QUid as the key.
 const QUuid MY_AVATAR_KEY;  // NULL key
 
+// enough avatars to keep the worker pool busy without overshooting the update budget by much
+const int AVATAR_SIMULATION_BATCH_SIZE = 16;
+
 AvatarManager::AvatarManager(QObject* parent) :
     _myAvatar(new MyAvatar(qApp->thread()), [](MyAvatar* ptr) { ptr->deleteLater(); })
 {
@@ -296,6 +300,18 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     render::Transaction renderTransaction;
     workload::Transaction workloadTransaction;
 
+    // Avatars are simulated in batches.  For each batch the main thread does the scene, transit and position work,
+    // then the rig and skeleton work runs across the worker pool, then the main thread gathers the flow, render and
+    // workload updates.  The time budget is checked between batches.
+    struct AvatarSimulation {
+        OtherAvatarPointer avatar;
+        bool inView;
+    };
+    std::vector<AvatarSimulation> batch;
+    std::vector<AvatarSimulation*> parallelBatch;
+    batch.reserve(AVATAR_SIMULATION_BATCH_SIZE);
+    parallelBatch.reserve(AVATAR_SIMULATION_BATCH_SIZE);
+
     for (int p = kHero; p < NumVariants; p++) {
         auto& priorityQueue = avatarPriorityQueues[p];
         // Sorting the current queue HERE as part of the measured timing.
@@ -303,33 +319,63 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
         auto passExpiry = updatePriorityExpiries[p];
 
-        for (auto it = sortedAvatarVector.begin(); it != sortedAvatarVector.end(); ++it) {
-            const SortableAvatar& sortData = *it;
-            const auto avatar = std::static_pointer_cast<OtherAvatar>(sortData.getAvatar());
-            if (!avatar->_isClientAvatar) {
-                avatar->setIsClientAvatar(true);
-            }
-            // TODO: to help us scale to more avatars it would be nice to not have to poll this stuff every update
-            if (avatar->getSkeletonModel()->isLoaded()) {
-                // remove the orb if it is there
-                avatar->removeOrb();
-                if (avatar->needsPhysicsUpdate()) {
-                    _otherAvatarsToChangeInPhysics.insert(avatar);
+        auto it = sortedAvatarVector.begin();
+        while (it != sortedAvatarVector.end()) {
+            if (usecTimestampNow() >= passExpiry) {
+                // we've spent our time budget for this priority bucket
+                // let's deal with the reminding avatars if this pass and BREAK from the loop
+
+                if (p == kHero) {
+                    // Hero,
+                    // --> put them back in the non hero queue
+
+                    auto& crowdQueue = avatarPriorityQueues[kNonHero];
+                    while (it != sortedAvatarVector.end()) {
+                        crowdQueue.push(SortableAvatar((*it).getAvatar()));
+                        ++it;
+                    }
+                } else {
+                    // Non Hero
+                    // --> bail on the rest of the avatar updates
+                    // --> more avatars may freeze until their priority trickles up
+                    // --> some scale animations may glitch
+                    // --> some avatar velocity measurements may be a little off
+
+                    // no time to simulate, but we take the time to count how many were tragically missed
+                    numAvatarsNotUpdated = sortedAvatarVector.end() - it;
                 }
-            } else {
-                avatar->updateOrbPosition();
-            }
 
-            // for ALL avatars...
-            if (_shouldRender) {
-                avatar->ensureInScene(avatar, qApp->getMain3DScene());
+                // We had to cut short this pass, we must break out of the loop here
+                break;
             }
 
-            avatar->animateScaleChanges(deltaTime);
+            batch.clear();
+            parallelBatch.clear();
+            auto batchEnd = it + std::min<ptrdiff_t>(AVATAR_SIMULATION_BATCH_SIZE, sortedAvatarVector.end() - it);
+            for (; it != batchEnd; ++it) {
+                const SortableAvatar& sortData = *it;
+                const auto avatar = std::static_pointer_cast<OtherAvatar>(sortData.getAvatar());
+                if (!avatar->_isClientAvatar) {
+                    avatar->setIsClientAvatar(true);
+                }
+                // TODO: to help us scale to more avatars it would be nice to not have to poll this stuff every update
+                if (avatar->getSkeletonModel()->isLoaded()) {
+                    // remove the orb if it is there
+                    avatar->removeOrb();
+                    if (avatar->needsPhysicsUpdate()) {
+                        _otherAvatarsToChangeInPhysics.insert(avatar);
+                    }
+                } else {
+                    avatar->updateOrbPosition();
+                }
+
+                // for ALL avatars...
+                if (_shouldRender) {
+                    avatar->ensureInScene(avatar, qApp->getMain3DScene());
+                }
+
+                avatar->animateScaleChanges(deltaTime);
 
-            uint64_t now = usecTimestampNow();
-            if (now < passExpiry) {
-                // we're within budget
                 bool inView = sortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
                 if (inView && avatar->hasNewJointData()) {
                     numAvatarsUpdated++;
@@ -340,7 +386,29 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                     avatar->_transit.reset();
                     avatar->setIsNewAvatar(false);
                 }
-                avatar->simulate(deltaTime, inView);
+                avatar->simulatePosition(inView);
+                batch.push_back({ avatar, inView });
+            }
+
+            for (auto& simulation : batch) {
+                if (simulation.avatar->canSimulateJointsInParallel()) {
+                    parallelBatch.push_back(&simulation);
+                } else {
+                    simulation.avatar->simulateJoints(deltaTime, simulation.inView);
+                }
+            }
+            {
+                PROFILE_RANGE(simulation, "simulateJoints");
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, parallelBatch.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+                    for (size_t i = range.begin(); i < range.end(); ++i) {
+                        parallelBatch[i]->avatar->simulateJoints(deltaTime, parallelBatch[i]->inView);
+                    }
+                });
+            }
+
+            for (const auto& simulation : batch) {
+                const auto& avatar = simulation.avatar;
+                avatar->finishSimulate(deltaTime, simulation.inView);
                 if (avatar->getSkeletonModel()->isLoaded() && avatar->getWorkloadRegion() == workload::Region::R1) {
                     _myAvatar->addAvatarHandsToFlow(avatar);
                 }
@@ -351,33 +419,6 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                 avatar->updateRenderItem(renderTransaction);
                 avatar->updateSpaceProxy(workloadTransaction);
                 avatar->setLastRenderUpdateTime(startTime);
-
-            } else {
-                // we've spent our time budget for this priority bucket
-                // let's deal with the reminding avatars if this pass and BREAK from the for loop
-
-                if (p == kHero) {
-                    // Hero,
-                    // --> put them back in the non hero queue
-
-                    auto& crowdQueue = avatarPriorityQueues[kNonHero];
-                    while (it != sortedAvatarVector.end()) {
-                        crowdQueue.push(SortableAvatar((*it).getAvatar()));
-                        ++it;
-                    }
-                } else {
-                    // Non Hero
-                    // --> bail on the rest of the avatar updates
-                    // --> more avatars may freeze until their priority trickles up
-                    // --> some scale animations may glitch
-                    // --> some avatar velocity measurements may be a little off
-
-                    // no time to simulate, but we take the time to count how many were tragically missed
-                    numAvatarsNotUpdated = sortedAvatarVector.end() - it;
-                }
-
-                // We had to cut short this pass, we must break out of the for loop here
-                break;
             }
         }
 
@@ -245,7 +245,12 @@ void OtherAvatar::setCollisionWithOtherAvatarsFlags() {
 
 void OtherAvatar::simulate(float deltaTime, bool inView) {
     PROFILE_RANGE(simulation, "simulate");
+    simulatePosition(inView);
+    simulateJoints(deltaTime, inView);
+    finishSimulate(deltaTime, inView);
+}
 
+void OtherAvatar::simulatePosition(bool inView) {
     _globalPosition = _transit.isActive() ? _transit.getCurrentPosition() : _serverPosition;
     if (!hasParent()) {
         setLocalPosition(_globalPosition);
@@ -255,40 +260,52 @@ void OtherAvatar::simulate(float deltaTime, bool inView) {
     if (inView) {
         _simulationInViewRate.increment();
     }
+}
 
-    PerformanceTimer perfTimer("simulate");
-    {
-        PROFILE_RANGE(simulation, "updateJoints");
-        if (inView) {
-            Head* head = getHead();
-            if (_hasNewJointData || _transit.isActive()) {
-                _skeletonModel->getRig().copyJointsFromJointData(_jointData);
-                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
-                _skeletonModel->getRig().computeExternalPoses(rootTransform);
-                _jointDataSimulationRate.increment();
-
-                head->simulate(deltaTime);
-                _skeletonModel->simulate(deltaTime, true);
-
-                locationChanged(); // joints changed, so if there are any children, update them.
-                _hasNewJointData = false;
-
-                glm::vec3 headPosition = getWorldPosition();
-                if (!_skeletonModel->getHeadPosition(headPosition)) {
-                    headPosition = getWorldPosition();
-                }
-                head->setPosition(headPosition);
-            } else {
-                head->simulate(deltaTime);
-                _skeletonModel->simulate(deltaTime, false);
+void OtherAvatar::simulateJoints(float deltaTime, bool inView) {
+    // NOTE: this only touches this avatar's rig, head and skeleton model, which is what lets the AvatarManager
+    // run it for many avatars at once.  Anything that reaches children, entities or the scene goes in finishSimulate().
+    PROFILE_RANGE(simulation, "updateJoints");
+    PerformanceTimer perfTimer("simulateJoints");
+    _jointsChangedInSimulate = false;
+    if (inView) {
+        Head* head = getHead();
+        if (_hasNewJointData || _transit.isActive()) {
+            _skeletonModel->getRig().copyJointsFromJointData(_jointData);
+            glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
+            _skeletonModel->getRig().computeExternalPoses(rootTransform);
+            _jointDataSimulationRate.increment();
+
+            head->simulate(deltaTime);
+            _skeletonModel->simulate(deltaTime, true);
+
+            _jointsChangedInSimulate = true;
+            _hasNewJointData = false;
+
+            glm::vec3 headPosition = getWorldPosition();
+            if (!_skeletonModel->getHeadPosition(headPosition)) {
+                headPosition = getWorldPosition();
             }
-            head->setScale(getModelScale());
-            relayJointDataToChildren();
+            head->setPosition(headPosition);
         } else {
-            // a non-full update is still required so that the position, rotation, scale and bounds of the skeletonModel are updated.
+            head->simulate(deltaTime);
             _skeletonModel->simulate(deltaTime, false);
         }
-        _skeletonModelSimulationRate.increment();
+        head->setScale(getModelScale());
+    } else {
+        // a non-full update is still required so that the position, rotation, scale and bounds of the skeletonModel are updated.
+        _skeletonModel->simulate(deltaTime, false);
+    }
+    _skeletonModelSimulationRate.increment();
+}
+
+void OtherAvatar::finishSimulate(float deltaTime, bool inView) {
+    PerformanceTimer perfTimer("simulate");
+    if (_jointsChangedInSimulate) {
+        locationChanged(); // joints changed, so if there are any children, update them.
+    }
+    if (inView) {
+        relayJointDataToChildren();
     }
 
     // update animation for display name fade in/out
@@ -326,6 +343,11 @@ void OtherAvatar::simulate(float deltaTime, bool inView) {
     }
 }
 
+bool OtherAvatar::canSimulateJointsInParallel() const {
+    // the first simulate after the skeleton loads builds the joint states and emits rigReady(), keep that on this thread
+    return _skeletonModel->isLoaded() && !_skeletonModel->getRig().jointStatesEmpty();
+}
+
 void OtherAvatar::debugJointData() const {
     // Get a copy of the joint data
     auto jointData = getJointData();
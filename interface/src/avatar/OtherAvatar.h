@@ -64,6 +64,14 @@ public:
     void setCollisionWithOtherAvatarsFlags() override;
 
     void simulate(float deltaTime, bool inView) override;
+
+    // simulate() in three steps, so that the AvatarManager can run simulateJoints() for many avatars in parallel
+    // between the main thread only simulatePosition() and finishSimulate()
+    void simulatePosition(bool inView);
+    void simulateJoints(float deltaTime, bool inView);
+    void finishSimulate(float deltaTime, bool inView);
+    bool canSimulateJointsInParallel() const;
+
     void debugJointData() const;
     friend AvatarManager;
 
@@ -91,6 +99,7 @@ protected:
     uint8_t _workloadRegion { workload::Region::INVALID };
     BodyLOD _bodyLOD { BodyLOD::Sphere };
     bool _needsDetailedRebuild { false };
+    bool _jointsChangedInSimulate { false };
 };
 
 using OtherAvatarPointer = std::shared_ptr<OtherAvatar>;
@@ -11,6 +11,14 @@
 #include "AnimClip.h"
 
 #include <assert.h>
+#include <mutex>
+#include <unordered_map>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+
+#include <Profile.h>
 
 #include "GLMHelpers.h"
 #include "AnimationLogging.h"
@@ -223,6 +231,92 @@ static std::vector<AnimPoseVec> copyAndRetargetFromNetworkAnim(AnimationPointer
     return anim;
 }
 
+// identifies a skeleton by everything copyAndRetargetFromNetworkAnim() and mirroring read from it
+static QByteArray computeSkeletonSignature(const AnimSkeleton& skeleton) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    auto addData = [&](const void* data, size_t size) {
+        hash.addData(reinterpret_cast<const char*>(data), (int)size);
+    };
+    const int jointCount = skeleton.getNumJoints();
+    addData(&jointCount, sizeof(jointCount));
+    for (int i = 0; i < jointCount; i++) {
+        hash.addData(skeleton.getJointName(i).toUtf8());
+        const int parentIndex = skeleton.getParentIndex(i);
+        addData(&parentIndex, sizeof(parentIndex));
+        const AnimPose& pose = skeleton.getRelativeDefaultPose(i);
+        addData(&pose.scale(), sizeof(glm::vec3));
+        addData(&pose.rot(), sizeof(glm::quat));
+        addData(&pose.trans(), sizeof(glm::vec3));
+    }
+    addData(&skeleton.getGeometryOffset(), sizeof(glm::mat4));
+    return hash.result();
+}
+
+class AnimClipFramesBuilder : public QRunnable {
+public:
+    AnimClipFramesBuilder(AnimClipFramesRequestPointer request, std::function<AnimClipFrames()> build) :
+        _request(request), _build(build) {}
+
+    void run() override {
+        PROFILE_RANGE(simulation_animation, "AnimClipFramesBuilder");
+        _request->setFrames(std::make_shared<const AnimClipFrames>(_build()));
+    }
+
+private:
+    AnimClipFramesRequestPointer _request;
+    std::function<AnimClipFrames()> _build;
+};
+
+// Process wide cache of retargeted animations.  An entry lives as long as some AnimClip holds it,
+// so avatars that share an animation graph and skeleton share one copy of every clip.
+class RetargetedAnimCache {
+public:
+    static RetargetedAnimCache& getInstance() {
+        static RetargetedAnimCache instance;
+        return instance;
+    }
+
+    // returns the existing request for key, or runs build, on a worker thread if async is true
+    AnimClipFramesRequestPointer getFrames(const QByteArray& key, std::function<AnimClipFrames()> build, bool async) {
+        AnimClipFramesRequestPointer request;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto& entry = _requests[key];
+            request = entry.lock();
+            if (request) {
+                return request;
+            }
+            request = std::make_shared<AnimClipFramesRequest>(key);
+            entry = request;
+            removeExpiredEntries();
+        }
+        if (async) {
+            QThreadPool::globalInstance()->start(new AnimClipFramesBuilder(request, build));
+        } else {
+            AnimClipFramesBuilder(request, build).run();
+        }
+        return request;
+    }
+
+private:
+    void removeExpiredEntries() {
+        for (auto itr = _requests.begin(); itr != _requests.end();) {
+            if (itr->second.expired()) {
+                itr = _requests.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    }
+
+    struct KeyHash {
+        size_t operator()(const QByteArray& key) const { return qHash(key); }
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<QByteArray, std::weak_ptr<AnimClipFramesRequest>, KeyHash> _requests;
+};
+
 AnimClip::AnimClip(const QString& id, const QString& url, float startFrame, float endFrame, float timeScale, bool loopFlag, bool mirrorFlag,
                    AnimBlendType blendType, const QString& baseURL, float baseFrame) :
     AnimNode(AnimNode::Type::Clip, id),
@@ -261,52 +355,39 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
     _frame = ::accumulateTime(_startFrame, _endFrame, _timeScale, frame, dt, _loopFlag, _id, triggersOut);
 
     // poll network anim to see if it's finished loading yet.
-    if (_blendType == AnimBlendType_Normal) {
-        if (_networkAnim && _networkAnim->isLoaded() && _skeleton) {
-            // loading is complete, copy & retarget animation.
-            _anim = copyAndRetargetFromNetworkAnim(_networkAnim, _skeleton);
-
-            // we no longer need the actual animation resource anymore.
-            _networkAnim.reset();
-
-            // mirrorAnim will be re-built on demand, if needed.
-            _mirrorAnim.clear();
-
-            _poses.resize(_skeleton->getNumJoints());
-        }
-    } else {
-        // an additive blend type
-        if (_networkAnim && _networkAnim->isLoaded() && _baseNetworkAnim && _baseNetworkAnim->isLoaded() && _skeleton) {
-            // loading is complete, copy & retarget animation.
-            _anim = copyAndRetargetFromNetworkAnim(_networkAnim, _skeleton);
+    bool loaded = _networkAnim && _networkAnim->isLoaded() && _skeleton;
+    if (_blendType != AnimBlendType_Normal) {
+        loaded = loaded && _baseNetworkAnim && _baseNetworkAnim->isLoaded();
+    }
+    if (loaded && !_pendingAnim) {
+        // loading is complete, fetch the retargeted animation from the cache, which builds it
+        // on a worker thread if no other clip has asked for it yet.
+        requestAnim();
+    }
 
-            // we no longer need the actual animation resource anymore.
-            _networkAnim.reset();
+    if (_pendingAnim && _pendingAnim->isReady()) {
+        _anim = _pendingAnim;
+        _pendingAnim.reset();
 
-            // mirrorAnim will be re-built on demand, if needed.
-            // TODO: handle mirrored relative animations.
-            _mirrorAnim.clear();
+        // we no longer need the actual animation resource anymore.
+        _networkAnim.reset();
 
-            _poses.resize(_skeleton->getNumJoints());
+        // mirrorAnim will be re-built on demand, if needed.
+        // TODO: handle mirrored relative animations.
+        _mirrorAnim.reset();
 
-            // copy & retarget baseAnim!
-            auto baseAnim = copyAndRetargetFromNetworkAnim(_baseNetworkAnim, _skeleton);
-
-            if (_blendType == AnimBlendType_AddAbsolute) {
-                bakeAbsoluteDeltaAnim(_anim, baseAnim[(int)_baseFrame], _skeleton);
-            } else {
-                // AnimBlendType_AddRelative
-                bakeRelativeDeltaAnim(_anim, baseAnim[(int)_baseFrame]);
-            }
-        }
+        _poses.resize(_skeleton->getNumJoints());
     }
 
-    if (_anim.size()) {
+    if (_anim && _anim->getFrames()->size()) {
 
         // lazy creation of mirrored animation frames.
-        if (_mirrorFlag && _anim.size() != _mirrorAnim.size()) {
-            buildMirrorAnim();
+        if (_mirrorFlag && !_mirrorAnim) {
+            requestMirrorAnim();
         }
+        // another clip may still be building the mirrored frames, play the unmirrored ones until they are ready.
+        bool mirrored = _mirrorFlag && _mirrorAnim->isReady();
+        const AnimClipFrames& frames = mirrored ? *_mirrorAnim->getFrames() : *_anim->getFrames();
 
         int prevIndex = (int)glm::floor(_frame);
         int nextIndex;
@@ -318,12 +399,12 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
 
         // It can be quite possible for the user to set _startFrame and _endFrame to
         // values before or past valid ranges.  We clamp the frames here.
-        int frameCount = (int)_anim.size();
+        int frameCount = (int)frames.size();
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
 
-        const AnimPoseVec& prevFrame = _mirrorFlag ? _mirrorAnim[prevIndex] : _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _mirrorFlag ? _mirrorAnim[nextIndex] : _anim[nextIndex];
+        const AnimPoseVec& prevFrame = frames[prevIndex];
+        const AnimPoseVec& nextFrame = frames[nextIndex];
         float alpha = glm::fract(_frame);
 
         ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
@@ -341,17 +422,59 @@ void AnimClip::setCurrentFrameInternal(float frame) {
     _frame = ::accumulateTime(_startFrame, _endFrame, _timeScale, frame + _startFrame, dt, _loopFlag, _id, triggers);
 }
 
-void AnimClip::buildMirrorAnim() {
+void AnimClip::requestAnim() {
     assert(_skeleton);
 
-    _mirrorAnim.clear();
-    _mirrorAnim.reserve(_anim.size());
-    for (auto& relPoses : _anim) {
-        _mirrorAnim.push_back(relPoses);
-        _skeleton->mirrorRelativePoses(_mirrorAnim.back());
+    QByteArray key = computeSkeletonSignature(*_skeleton);
+    key.append(_url.toUtf8());
+    key.append('\0');
+
+    AnimationPointer networkAnim = _networkAnim;
+    AnimSkeleton::ConstPointer skeleton = _skeleton;
+    if (_blendType == AnimBlendType_Normal) {
+        _pendingAnim = RetargetedAnimCache::getInstance().getFrames(key, [networkAnim, skeleton] {
+            return copyAndRetargetFromNetworkAnim(networkAnim, skeleton);
+        }, true);
+    } else {
+        key.append(QString("%1|%2|%3").arg(_baseURL).arg((int)_baseFrame).arg((int)_blendType).toUtf8());
+
+        AnimationPointer baseNetworkAnim = _baseNetworkAnim;
+        AnimBlendType blendType = _blendType;
+        int baseFrame = (int)_baseFrame;
+        _pendingAnim = RetargetedAnimCache::getInstance().getFrames(key, [networkAnim, baseNetworkAnim, skeleton, blendType, baseFrame] {
+            AnimClipFrames anim = copyAndRetargetFromNetworkAnim(networkAnim, skeleton);
+
+            // copy & retarget baseAnim!
+            auto baseAnim = copyAndRetargetFromNetworkAnim(baseNetworkAnim, skeleton);
+
+            if (blendType == AnimBlendType_AddAbsolute) {
+                bakeAbsoluteDeltaAnim(anim, baseAnim[baseFrame], skeleton);
+            } else {
+                // AnimBlendType_AddRelative
+                bakeRelativeDeltaAnim(anim, baseAnim[baseFrame]);
+            }
+            return anim;
+        }, true);
     }
 }
 
+void AnimClip::requestMirrorAnim() {
+    assert(_skeleton && _anim && _anim->isReady());
+
+    // mirroring is cheap next to retargeting, so it is done here rather than making the clip wait a frame
+    AnimClipFramesPointer anim = _anim->getFrames();
+    AnimSkeleton::ConstPointer skeleton = _skeleton;
+    _mirrorAnim = RetargetedAnimCache::getInstance().getFrames(_anim->getKey() + "|mirror", [anim, skeleton] {
+        AnimClipFrames mirrorAnim;
+        mirrorAnim.reserve(anim->size());
+        for (auto& relPoses : *anim) {
+            mirrorAnim.push_back(relPoses);
+            skeleton->mirrorRelativePoses(mirrorAnim.back());
+        }
+        return mirrorAnim;
+    }, false);
+}
+
 const AnimPoseVec& AnimClip::getPosesInternal() const {
     return _poses;
 }
@@ -359,5 +482,6 @@ const AnimPoseVec& AnimClip::getPosesInternal() const {
 void AnimClip::loadURL(const QString& url) {
     auto animCache = DependencyManager::get<AnimationCache>();
     _networkAnim = animCache->getAnimation(url);
+    _pendingAnim.reset();
     _url = url;
 }
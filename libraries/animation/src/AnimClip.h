@@ -11,10 +11,38 @@
 #ifndef hifi_AnimClip_h
 #define hifi_AnimClip_h
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include "AnimationCache.h"
 #include "AnimNode.h"
 
+// _frames[frame][joint], retargeted onto a particular skeleton.  Immutable once built, so it is shared between
+// every AnimClip that plays the same animation on the same skeleton.
+using AnimClipFrames = std::vector<AnimPoseVec>;
+using AnimClipFramesPointer = std::shared_ptr<const AnimClipFrames>;
+
+// A handle on a set of AnimClipFrames that may still be being built on a worker thread.
+class AnimClipFramesRequest {
+public:
+    AnimClipFramesRequest(const QByteArray& key) : _key(key) {}
+
+    const QByteArray& getKey() const { return _key; }
+    bool isReady() const { return _ready.load(std::memory_order_acquire); }
+    const AnimClipFramesPointer& getFrames() const { return _frames; }
+
+    void setFrames(AnimClipFramesPointer frames) {
+        _frames = frames;
+        _ready.store(true, std::memory_order_release);
+    }
+
+private:
+    QByteArray _key;
+    AnimClipFramesPointer _frames;
+    std::atomic<bool> _ready { false };
+};
+using AnimClipFramesRequestPointer = std::shared_ptr<AnimClipFramesRequest>;
+
 // Playback a single animation timeline.
 // url determines the location of the fbx file to use within this clip.
 // startFrame and endFrame are in frames 1/30th of a second.
@@ -61,7 +89,8 @@ protected:
 
     virtual void setCurrentFrameInternal(float frame) override;
 
-    void buildMirrorAnim();
+    void requestAnim();
+    void requestMirrorAnim();
 
     // for AnimDebugDraw rendering
     virtual const AnimPoseVec& getPosesInternal() const override;
@@ -71,9 +100,10 @@ protected:
 
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
-    std::vector<AnimPoseVec> _mirrorAnim;
+    // _anim[frame][joint], shared with other clips through the retargeted animation cache
+    AnimClipFramesRequestPointer _anim;
+    AnimClipFramesRequestPointer _mirrorAnim;
+    AnimClipFramesRequestPointer _pendingAnim;
 
     QString _url;
     float _startFrame;
@@ -15,6 +15,7 @@
 #include <GLMHelpers.h>
 
 #include "AnimationLogging.h"
+#include "AnimUtil.h"
 
 AnimSkeleton::AnimSkeleton(const HFMModel& hfmModel) {
 
@@ -132,6 +133,15 @@ AnimPose AnimSkeleton::getAbsolutePose(int jointIndex, const AnimPoseVec& relati
 
 void AnimSkeleton::convertRelativePosesToAbsolute(AnimPoseVec& poses) const {
     // poses start off relative and leave in absolute frame
+    if ((int)poses.size() >= _jointsSize && !_levelStarts.empty()) {
+        // joints at the same depth don't depend on each other, so each level can be done in one batch.
+        for (size_t level = 0; level + 1 < _levelStarts.size(); level++) {
+            size_t start = _levelStarts[level];
+            composeParentPoses(_levelStarts[level + 1] - start, &_levelJoints[start], &_levelParents[start], poses.data());
+        }
+        return;
+    }
+
     int lastIndex = std::min((int)poses.size(), _jointsSize);
     for (int i = 0; i < lastIndex; ++i) {
         int parentIndex = _parentIndices[i];
@@ -215,6 +225,40 @@ void AnimSkeleton::buildSkeletonFromJoints(const std::vector<HFMJoint>& joints,
     }
 
     _jointsSize = (int)joints.size();
+
+    // group the non-root joints by depth.
+    _levelJoints.clear();
+    _levelParents.clear();
+    _levelStarts.clear();
+    std::vector<int> depths(_jointsSize, 0);
+    int maxDepth = 0;
+    bool parentsFirst = true;
+    for (int i = 0; i < _jointsSize; i++) {
+        int parentIndex = _parentIndices[i];
+        if (parentIndex >= i) {
+            parentsFirst = false;
+            break;
+        }
+        if (parentIndex >= 0) {
+            depths[i] = depths[parentIndex] + 1;
+            maxDepth = std::max(maxDepth, depths[i]);
+        }
+    }
+    if (parentsFirst) {
+        _levelJoints.reserve(_jointsSize);
+        _levelParents.reserve(_jointsSize);
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            _levelStarts.push_back(_levelJoints.size());
+            for (int i = 0; i < _jointsSize; i++) {
+                if (depths[i] == depth) {
+                    _levelJoints.push_back(i);
+                    _levelParents.push_back(_parentIndices[i]);
+                }
+            }
+        }
+        _levelStarts.push_back(_levelJoints.size());
+    }
+
     // build a cache of bind poses
 
     // build a chache of default poses
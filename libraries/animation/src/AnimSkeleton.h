@@ -76,6 +76,12 @@ protected:
     std::vector<HFMJoint> _joints;
     std::vector<int> _parentIndices;
     int _jointsSize { 0 };
+
+    // non-root joints grouped by depth in the hierarchy, with their parents, for convertRelativePosesToAbsolute().
+    // level i is [_levelStarts[i], _levelStarts[i + 1]), empty if a joint comes before its parent.
+    std::vector<int> _levelJoints;
+    std::vector<int> _levelParents;
+    std::vector<size_t> _levelStarts;
     AnimPoseVec _relativeDefaultPoses;
     AnimPoseVec _absoluteDefaultPoses;
     AnimPoseVec _relativePreRotationPoses;
@@ -13,9 +13,7 @@
 #include <NumericalConstants.h>
 #include <DebugDraw.h>
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+static void blend_ref(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
@@ -26,7 +24,7 @@ void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, A
     }
 }
 
-void blend3(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, float* alphas, AnimPose* result) {
+static void blend3_ref(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, float* alphas, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
@@ -38,7 +36,7 @@ void blend3(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPos
     }
 }
 
-void blend4(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, const AnimPose* d, float* alphas, AnimPose* result) {
+static void blend4_ref(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, const AnimPose* d, float* alphas, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
@@ -51,6 +49,83 @@ void blend4(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPos
     }
 }
 
+static void composeParentPoses_ref(size_t numJoints, const int* joints, const int* parents, AnimPose* poses) {
+    for (size_t i = 0; i < numJoints; i++) {
+        poses[joints[i]] = poses[parents[i]] * poses[joints[i]];
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+//
+// Runtime CPU dispatch
+//
+#include <CPUDetect.h>
+
+size_t blend_AVX2(size_t numPoses, const float* a, const float* b, float alpha, float* result, int quatWIndex);
+size_t blendN_AVX2(size_t numPoses, const float* const* inputs, const float* alphas, int numInputs, float* result, int quatWIndex);
+size_t composeParentPoses_AVX2(size_t numJoints, const int* joints, const int* parents, float* poses, int quatWIndex);
+
+static_assert(sizeof(AnimPose) == 10 * sizeof(float), "class AnimPose size doesn't match.");
+static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+
+static int getQuatWIndex() {
+    glm::quat q;
+    return (int)(&q.w - reinterpret_cast<const float*>(&q));
+}
+static int _quatWIndex = getQuatWIndex();
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    size_t i = 0;
+    if (_cpuSupportsAVX2 && numPoses >= 8) {
+        i = blend_AVX2(numPoses, (const float*)a, (const float*)b, alpha, (float*)result, _quatWIndex);
+    }
+    blend_ref(numPoses - i, a + i, b + i, alpha, result + i);
+}
+
+void blend3(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, float* alphas, AnimPose* result) {
+    size_t i = 0;
+    if (_cpuSupportsAVX2 && numPoses >= 8) {
+        const float* inputs[] = { (const float*)a, (const float*)b, (const float*)c };
+        i = blendN_AVX2(numPoses, inputs, alphas, 3, (float*)result, _quatWIndex);
+    }
+    blend3_ref(numPoses - i, a + i, b + i, c + i, alphas, result + i);
+}
+
+void blend4(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, const AnimPose* d, float* alphas, AnimPose* result) {
+    size_t i = 0;
+    if (_cpuSupportsAVX2 && numPoses >= 8) {
+        const float* inputs[] = { (const float*)a, (const float*)b, (const float*)c, (const float*)d };
+        i = blendN_AVX2(numPoses, inputs, alphas, 4, (float*)result, _quatWIndex);
+    }
+    blend4_ref(numPoses - i, a + i, b + i, c + i, d + i, alphas, result + i);
+}
+
+void composeParentPoses(size_t numJoints, const int* joints, const int* parents, AnimPose* poses) {
+    size_t i = 0;
+    if (_cpuSupportsAVX2 && numJoints >= 8) {
+        i = composeParentPoses_AVX2(numJoints, joints, parents, (float*)poses, _quatWIndex);
+    }
+    composeParentPoses_ref(numJoints - i, joints + i, parents + i, poses);
+}
+
+#else   // portable reference code
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blend_ref(numPoses, a, b, alpha, result);
+}
+
+void blend3(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, float* alphas, AnimPose* result) {
+    blend3_ref(numPoses, a, b, c, alphas, result);
+}
+
+void blend4(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, const AnimPose* d, float* alphas, AnimPose* result) {
+    blend4_ref(numPoses, a, b, c, d, alphas, result);
+}
+
+void composeParentPoses(size_t numJoints, const int* joints, const int* parents, AnimPose* poses) {
+    composeParentPoses_ref(numJoints, joints, parents, poses);
+}
+#endif
+
 // additive blend
 void blendAdd(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
 
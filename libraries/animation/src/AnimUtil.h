@@ -22,6 +22,10 @@ void blend3(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPos
 // blend between four sets of poses
 void blend4(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, const AnimPose* d, float* alphas, AnimPose* result);
 
+// poses[joints[i]] = poses[parents[i]] * poses[joints[i]] for each i, where no joint is the parent of another.
+// AnimSkeleton::convertRelativePosesToAbsolute() calls this once per level of the joint hierarchy.
+void composeParentPoses(size_t numJoints, const int* joints, const int* parents, AnimPose* poses);
+
 // additive blending
 void blendAdd(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
 
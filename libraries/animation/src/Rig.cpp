@@ -2474,17 +2474,15 @@ void Rig::buildAbsoluteRigPoses(const AnimPoseVec& relativePoses, AnimPoseVec& a
 
     ASSERT(_animSkeleton->getNumJoints() == (int)relativePoses.size());
 
-    absolutePosesOut.resize(relativePoses.size());
+    absolutePosesOut = relativePoses;
     AnimPose geometryToRigTransform(_geometryToRigTransform);
     for (int i = 0; i < (int)relativePoses.size(); i++) {
-        int parentIndex = _animSkeleton->getParentIndex(i);
-        if (parentIndex == -1) {
+        if (_animSkeleton->getParentIndex(i) == -1) {
             // transform all root absolute poses into rig space
             absolutePosesOut[i] = geometryToRigTransform * relativePoses[i];
-        } else {
-            absolutePosesOut[i] = absolutePosesOut[parentIndex] * relativePoses[i];
         }
     }
+    _animSkeleton->convertRelativePosesToAbsolute(absolutePosesOut);
 }
 
 int Rig::getOverrideJointCount() const {
@@ -0,0 +1,323 @@
+//
+//  AnimUtil_avx2.cpp
+//  libraries/animation/src/avx2
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <stddef.h>
+#include <immintrin.h>
+
+// AnimPose is scale[3], rot[4], trans[3]
+static const int POSE_FLOATS = 10;
+static const int ROT_OFFSET = 3;
+
+// Blends blocks of 8 poses and returns the number of poses done, the caller finishes the remainder.
+// Same math as blend() in AnimUtil.cpp: lerp scale and translation, and nlerp rotation after moving b into
+// the same hemisphere as a.  quatWIndex is the position of w within glm::quat.
+size_t blend_AVX2(size_t numPoses, const float* a, const float* b, float alpha, float* result, int quatWIndex) {
+
+    // deinterleave 8 poses at a time with gathers, so each register holds one component of 8 poses
+    const __m256i index = _mm256_setr_epi32(0, 1 * POSE_FLOATS, 2 * POSE_FLOATS, 3 * POSE_FLOATS,
+                                            4 * POSE_FLOATS, 5 * POSE_FLOATS, 6 * POSE_FLOATS, 7 * POSE_FLOATS);
+    const __m256 alpha8 = _mm256_set1_ps(alpha);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= numPoses; i += 8) {  // blocks of 8
+        const float* a0 = a + i * POSE_FLOATS;
+        const float* b0 = b + i * POSE_FLOATS;
+
+        __m256 va[POSE_FLOATS];
+        __m256 vb[POSE_FLOATS];
+        for (int c = 0; c < POSE_FLOATS; c++) {
+            va[c] = _mm256_i32gather_ps(a0 + c, index, sizeof(float));
+            vb[c] = _mm256_i32gather_ps(b0 + c, index, sizeof(float));
+        }
+
+        // flip the sign of b's rotation where dot(a, b) < 0
+        __m256 dot = _mm256_mul_ps(va[ROT_OFFSET + 0], vb[ROT_OFFSET + 0]);
+        dot = _mm256_fmadd_ps(va[ROT_OFFSET + 1], vb[ROT_OFFSET + 1], dot);
+        dot = _mm256_fmadd_ps(va[ROT_OFFSET + 2], vb[ROT_OFFSET + 2], dot);
+        dot = _mm256_fmadd_ps(va[ROT_OFFSET + 3], vb[ROT_OFFSET + 3], dot);
+        __m256 flip = _mm256_and_ps(_mm256_cmp_ps(dot, zero, _CMP_LT_OQ), signBit);
+        for (int c = ROT_OFFSET; c < ROT_OFFSET + 4; c++) {
+            vb[c] = _mm256_xor_ps(vb[c], flip);
+        }
+
+        // a + alpha * (b - a) for every component
+        __m256 r[POSE_FLOATS];
+        for (int c = 0; c < POSE_FLOATS; c++) {
+            r[c] = _mm256_fmadd_ps(_mm256_sub_ps(vb[c], va[c]), alpha8, va[c]);
+        }
+
+        // normalize the rotation, a zero length result becomes identity (as glm::normalize does)
+        __m256 len2 = _mm256_mul_ps(r[ROT_OFFSET + 0], r[ROT_OFFSET + 0]);
+        len2 = _mm256_fmadd_ps(r[ROT_OFFSET + 1], r[ROT_OFFSET + 1], len2);
+        len2 = _mm256_fmadd_ps(r[ROT_OFFSET + 2], r[ROT_OFFSET + 2], len2);
+        len2 = _mm256_fmadd_ps(r[ROT_OFFSET + 3], r[ROT_OFFSET + 3], len2);
+        __m256 valid = _mm256_cmp_ps(len2, zero, _CMP_GT_OQ);
+        __m256 invLen = _mm256_div_ps(one, _mm256_sqrt_ps(len2));
+        for (int c = ROT_OFFSET; c < ROT_OFFSET + 4; c++) {
+            r[c] = _mm256_and_ps(_mm256_mul_ps(r[c], invLen), valid);
+        }
+        r[ROT_OFFSET + quatWIndex] = _mm256_or_ps(r[ROT_OFFSET + quatWIndex], _mm256_andnot_ps(valid, one));
+
+        // interleave back into poses
+        float out[POSE_FLOATS][8];
+        for (int c = 0; c < POSE_FLOATS; c++) {
+            _mm256_storeu_ps(out[c], r[c]);
+        }
+        float* r0 = result + i * POSE_FLOATS;
+        for (int j = 0; j < 8; j++) {
+            for (int c = 0; c < POSE_FLOATS; c++) {
+                r0[j * POSE_FLOATS + c] = out[c][j];
+            }
+        }
+    }
+    return i;
+}
+
+// Blends blocks of 8 poses from numInputs pose arrays with fixed weights and returns the number of poses done.
+// Same math as blend3() and blend4() in AnimUtil.cpp: a weighted sum of scale and translation, and of rotation after
+// moving every input into the same hemisphere as the first one, then normalized.
+size_t blendN_AVX2(size_t numPoses, const float* const* inputs, const float* alphas, int numInputs, float* result, int quatWIndex) {
+    static const int MAX_INPUTS = 4;
+    if (numInputs < 1 || numInputs > MAX_INPUTS) {
+        return 0;
+    }
+
+    const __m256i index = _mm256_setr_epi32(0, 1 * POSE_FLOATS, 2 * POSE_FLOATS, 3 * POSE_FLOATS,
+                                            4 * POSE_FLOATS, 5 * POSE_FLOATS, 6 * POSE_FLOATS, 7 * POSE_FLOATS);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    __m256 alpha8[MAX_INPUTS];
+    for (int k = 0; k < numInputs; k++) {
+        alpha8[k] = _mm256_set1_ps(alphas[k]);
+    }
+
+    size_t i = 0;
+    for (; i + 8 <= numPoses; i += 8) {  // blocks of 8
+        __m256 first[POSE_FLOATS];
+        __m256 r[POSE_FLOATS];
+        for (int c = 0; c < POSE_FLOATS; c++) {
+            first[c] = _mm256_i32gather_ps(inputs[0] + i * POSE_FLOATS + c, index, sizeof(float));
+            r[c] = _mm256_mul_ps(first[c], alpha8[0]);
+        }
+
+        for (int k = 1; k < numInputs; k++) {
+            __m256 v[POSE_FLOATS];
+            for (int c = 0; c < POSE_FLOATS; c++) {
+                v[c] = _mm256_i32gather_ps(inputs[k] + i * POSE_FLOATS + c, index, sizeof(float));
+            }
+
+            // flip the sign of this input's rotation where dot(first, input) < 0
+            __m256 dot = _mm256_mul_ps(first[ROT_OFFSET + 0], v[ROT_OFFSET + 0]);
+            dot = _mm256_fmadd_ps(first[ROT_OFFSET + 1], v[ROT_OFFSET + 1], dot);
+            dot = _mm256_fmadd_ps(first[ROT_OFFSET + 2], v[ROT_OFFSET + 2], dot);
+            dot = _mm256_fmadd_ps(first[ROT_OFFSET + 3], v[ROT_OFFSET + 3], dot);
+            __m256 flip = _mm256_and_ps(_mm256_cmp_ps(dot, zero, _CMP_LT_OQ), signBit);
+            for (int c = ROT_OFFSET; c < ROT_OFFSET + 4; c++) {
+                v[c] = _mm256_xor_ps(v[c], flip);
+            }
+
+            for (int c = 0; c < POSE_FLOATS; c++) {
+                r[c] = _mm256_fmadd_ps(v[c], alpha8[k], r[c]);
+            }
+        }
+
+        // normalize the rotation, a zero length result becomes identity (as glm::normalize does)
+        __m256 len2 = _mm256_mul_ps(r[ROT_OFFSET + 0], r[ROT_OFFSET + 0]);
+        len2 = _mm256_fmadd_ps(r[ROT_OFFSET + 1], r[ROT_OFFSET + 1], len2);
+        len2 = _mm256_fmadd_ps(r[ROT_OFFSET + 2], r[ROT_OFFSET + 2], len2);
+        len2 = _mm256_fmadd_ps(r[ROT_OFFSET + 3], r[ROT_OFFSET + 3], len2);
+        __m256 valid = _mm256_cmp_ps(len2, zero, _CMP_GT_OQ);
+        __m256 invLen = _mm256_div_ps(one, _mm256_sqrt_ps(len2));
+        for (int c = ROT_OFFSET; c < ROT_OFFSET + 4; c++) {
+            r[c] = _mm256_and_ps(_mm256_mul_ps(r[c], invLen), valid);
+        }
+        r[ROT_OFFSET + quatWIndex] = _mm256_or_ps(r[ROT_OFFSET + quatWIndex], _mm256_andnot_ps(valid, one));
+
+        float out[POSE_FLOATS][8];
+        for (int c = 0; c < POSE_FLOATS; c++) {
+            _mm256_storeu_ps(out[c], r[c]);
+        }
+        float* r0 = result + i * POSE_FLOATS;
+        for (int j = 0; j < 8; j++) {
+            for (int c = 0; c < POSE_FLOATS; c++) {
+                r0[j * POSE_FLOATS + c] = out[c][j];
+            }
+        }
+    }
+    return i;
+}
+
+// Replaces blocks of 8 poses[joints[i]] with poses[parents[i]] * poses[joints[i]] and returns the number of joints
+// done.  None of the joints may be the parent of another one in the same call, so a block can be read before any of
+// it is written.  Same math as AnimPose::operator*(): the product of the two scale-rotate-translate matrices,
+// decomposed back into scale (negated when the matrix mirrors), rotation (glm::quat_cast) and translation.
+size_t composeParentPoses_AVX2(size_t numJoints, const int* joints, const int* parents, float* poses, int quatWIndex) {
+    const int X = ROT_OFFSET + (quatWIndex == 0 ? 1 : 0);
+    const int Y = X + 1;
+    const int Z = X + 2;
+    const int W = ROT_OFFSET + quatWIndex;
+    const __m256i poseFloats = _mm256_set1_epi32(POSE_FLOATS);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 epsilon = _mm256_set1_ps(0.000001f);  // EPSILON, as used by AnimPose(const glm::mat4&)
+
+    size_t i = 0;
+    for (; i + 8 <= numJoints; i += 8) {  // blocks of 8
+        __m256i childIndex = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)(joints + i)), poseFloats);
+        __m256i parentIndex = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)(parents + i)), poseFloats);
+        __m256 a[POSE_FLOATS];
+        __m256 b[POSE_FLOATS];
+        for (int c = 0; c < POSE_FLOATS; c++) {
+            a[c] = _mm256_i32gather_ps(poses + c, parentIndex, sizeof(float));
+            b[c] = _mm256_i32gather_ps(poses + c, childIndex, sizeof(float));
+        }
+
+        // rotation matrices, ra[column][row] as in glm::mat3_cast()
+        __m256 ra[3][3];
+        __m256 rb[3][3];
+        for (int k = 0; k < 2; k++) {
+            const __m256* q = k == 0 ? a : b;
+            __m256 (*m)[3] = k == 0 ? ra : rb;
+            __m256 x2 = _mm256_mul_ps(q[X], two);
+            __m256 y2 = _mm256_mul_ps(q[Y], two);
+            __m256 z2 = _mm256_mul_ps(q[Z], two);
+            __m256 xx = _mm256_mul_ps(q[X], x2);
+            __m256 yy = _mm256_mul_ps(q[Y], y2);
+            __m256 zz = _mm256_mul_ps(q[Z], z2);
+            __m256 xy = _mm256_mul_ps(q[X], y2);
+            __m256 xz = _mm256_mul_ps(q[X], z2);
+            __m256 yz = _mm256_mul_ps(q[Y], z2);
+            __m256 wx = _mm256_mul_ps(q[W], x2);
+            __m256 wy = _mm256_mul_ps(q[W], y2);
+            __m256 wz = _mm256_mul_ps(q[W], z2);
+            m[0][0] = _mm256_sub_ps(one, _mm256_add_ps(yy, zz));
+            m[0][1] = _mm256_add_ps(xy, wz);
+            m[0][2] = _mm256_sub_ps(xz, wy);
+            m[1][0] = _mm256_sub_ps(xy, wz);
+            m[1][1] = _mm256_sub_ps(one, _mm256_add_ps(xx, zz));
+            m[1][2] = _mm256_add_ps(yz, wx);
+            m[2][0] = _mm256_add_ps(xz, wy);
+            m[2][1] = _mm256_sub_ps(yz, wx);
+            m[2][2] = _mm256_sub_ps(one, _mm256_add_ps(xx, yy));
+        }
+
+        // columns of the product: m[k] = ra * (aScale * rb[k] * bScale[k]), translation = aTrans + ra * (aScale * bTrans)
+        __m256 m[4][3];
+        for (int k = 0; k < 4; k++) {
+            __m256 u[3];
+            for (int j = 0; j < 3; j++) {
+                __m256 v = k < 3 ? _mm256_mul_ps(rb[k][j], b[k]) : b[7 + j];
+                u[j] = _mm256_mul_ps(a[j], v);
+            }
+            for (int r = 0; r < 3; r++) {
+                __m256 sum = k < 3 ? _mm256_mul_ps(ra[0][r], u[0]) : _mm256_fmadd_ps(ra[0][r], u[0], a[7 + r]);
+                sum = _mm256_fmadd_ps(ra[1][r], u[1], sum);
+                m[k][r] = _mm256_fmadd_ps(ra[2][r], u[2], sum);
+            }
+        }
+
+        // scale is the length of each column, negated if the matrix mirrors
+        __m256 scale[3];
+        for (int k = 0; k < 3; k++) {
+            __m256 len2 = _mm256_mul_ps(m[k][0], m[k][0]);
+            len2 = _mm256_fmadd_ps(m[k][1], m[k][1], len2);
+            len2 = _mm256_fmadd_ps(m[k][2], m[k][2], len2);
+            scale[k] = _mm256_sqrt_ps(len2);
+        }
+        __m256 det = _mm256_mul_ps(m[0][0], _mm256_fmsub_ps(m[1][1], m[2][2], _mm256_mul_ps(m[2][1], m[1][2])));
+        det = _mm256_fnmadd_ps(m[1][0], _mm256_fmsub_ps(m[0][1], m[2][2], _mm256_mul_ps(m[2][1], m[0][2])), det);
+        det = _mm256_fmadd_ps(m[2][0], _mm256_fmsub_ps(m[0][1], m[1][2], _mm256_mul_ps(m[1][1], m[0][2])), det);
+        __m256 mirror = _mm256_and_ps(_mm256_cmp_ps(det, zero, _CMP_LT_OQ), signBit);
+        for (int k = 0; k < 3; k++) {
+            scale[k] = _mm256_xor_ps(scale[k], mirror);
+            __m256 invScale = _mm256_div_ps(one, scale[k]);
+            for (int r = 0; r < 3; r++) {
+                m[k][r] = _mm256_mul_ps(m[k][r], invScale);
+            }
+        }
+
+        // glm::quat_cast(), with the branch on the largest component done with blends
+        __m256 fourW = _mm256_add_ps(_mm256_add_ps(m[0][0], m[1][1]), m[2][2]);
+        __m256 fourX = _mm256_sub_ps(_mm256_sub_ps(m[0][0], m[1][1]), m[2][2]);
+        __m256 fourY = _mm256_sub_ps(_mm256_sub_ps(m[1][1], m[0][0]), m[2][2]);
+        __m256 fourZ = _mm256_sub_ps(_mm256_sub_ps(m[2][2], m[0][0]), m[1][1]);
+        __m256 biggest = fourW;
+        __m256 isX = _mm256_cmp_ps(fourX, biggest, _CMP_GT_OQ);
+        biggest = _mm256_blendv_ps(biggest, fourX, isX);
+        __m256 isY = _mm256_cmp_ps(fourY, biggest, _CMP_GT_OQ);
+        biggest = _mm256_blendv_ps(biggest, fourY, isY);
+        __m256 isZ = _mm256_cmp_ps(fourZ, biggest, _CMP_GT_OQ);
+        biggest = _mm256_blendv_ps(biggest, fourZ, isZ);
+        isY = _mm256_andnot_ps(isZ, isY);
+        isX = _mm256_andnot_ps(_mm256_or_ps(isY, isZ), isX);
+
+        __m256 biggestVal = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_add_ps(biggest, one)), half);
+        __m256 mult = _mm256_div_ps(quarter, biggestVal);
+        __m256 d12 = _mm256_mul_ps(_mm256_sub_ps(m[1][2], m[2][1]), mult);
+        __m256 d20 = _mm256_mul_ps(_mm256_sub_ps(m[2][0], m[0][2]), mult);
+        __m256 d01 = _mm256_mul_ps(_mm256_sub_ps(m[0][1], m[1][0]), mult);
+        __m256 s01 = _mm256_mul_ps(_mm256_add_ps(m[0][1], m[1][0]), mult);
+        __m256 s20 = _mm256_mul_ps(_mm256_add_ps(m[2][0], m[0][2]), mult);
+        __m256 s12 = _mm256_mul_ps(_mm256_add_ps(m[1][2], m[2][1]), mult);
+
+        // biggest is w: (biggestVal, d12, d20, d01), x: (d12, biggestVal, s01, s20)
+        // y: (d20, s01, biggestVal, s12), z: (d01, s20, s12, biggestVal)
+        __m256 qw = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_blendv_ps(biggestVal, d12, isX), d20, isY), d01, isZ);
+        __m256 qx = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_blendv_ps(d12, biggestVal, isX), s01, isY), s20, isZ);
+        __m256 qy = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_blendv_ps(d20, s01, isX), biggestVal, isY), s12, isZ);
+        __m256 qz = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_blendv_ps(d01, s20, isX), s12, isY), biggestVal, isZ);
+
+        // normalize where the length is off by more than EPSILON
+        __m256 len2 = _mm256_mul_ps(qx, qx);
+        len2 = _mm256_fmadd_ps(qy, qy, len2);
+        len2 = _mm256_fmadd_ps(qz, qz, len2);
+        len2 = _mm256_fmadd_ps(qw, qw, len2);
+        __m256 lenError = _mm256_andnot_ps(signBit, _mm256_sub_ps(len2, one));
+        __m256 invLen = _mm256_blendv_ps(one, _mm256_div_ps(one, _mm256_sqrt_ps(len2)),
+                                         _mm256_cmp_ps(lenError, epsilon, _CMP_GT_OQ));
+
+        __m256 r[POSE_FLOATS];
+        r[0] = scale[0];
+        r[1] = scale[1];
+        r[2] = scale[2];
+        r[X] = _mm256_mul_ps(qx, invLen);
+        r[Y] = _mm256_mul_ps(qy, invLen);
+        r[Z] = _mm256_mul_ps(qz, invLen);
+        r[W] = _mm256_mul_ps(qw, invLen);
+        r[7] = m[3][0];
+        r[8] = m[3][1];
+        r[9] = m[3][2];
+
+        // scatter back into the poses
+        float out[POSE_FLOATS][8];
+        for (int c = 0; c < POSE_FLOATS; c++) {
+            _mm256_storeu_ps(out[c], r[c]);
+        }
+        for (int j = 0; j < 8; j++) {
+            float* pose = poses + joints[i + j] * POSE_FLOATS;
+            for (int c = 0; c < POSE_FLOATS; c++) {
+                pose[c] = out[c][j];
+            }
+        }
+    }
+    return i;
+}
+
+#endif
@@ -15,6 +15,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
 #include "AudioSRCData.h"
 
 #ifndef MAX
@@ -50,6 +57,21 @@ static void aligned_free(void* ptr) {
     }
 }
 
+//
+// The polyphase filter and input steps of a conversion
+//
+class AudioSRCFilter {
+public:
+    ~AudioSRCFilter() {
+        aligned_free(polyphaseFilter);
+        delete[] stepTable;
+    }
+
+    float* polyphaseFilter { nullptr };
+    int* stepTable { nullptr };
+    int numTaps { 0 };
+};
+
 // find the greatest common divisor
 static int gcd(int a, int b)
 {
@@ -100,7 +122,7 @@ static void cubicInterpolation(const float* input, float* output, int inputSize,
     }
 }
 
-int AudioSRC::createRationalFilter(int upFactor, int downFactor, float gain, Quality quality) {
+int AudioSRC::createRationalFilter(AudioSRCFilter& filter, int upFactor, int downFactor, float gain, Quality quality) {
 
     int prototypeTaps = prototypeFilterTable[quality].taps;
     int prototypeCoefs = prototypeFilterTable[quality].coefs;
@@ -129,7 +151,7 @@ int AudioSRC::createRationalFilter(int upFactor, int downFactor, float gain, Qua
     cubicInterpolation(prototypeFilter, tempFilter, prototypeCoefs, numCoefs, gain);
 
     // create the polyphase filter
-    _polyphaseFilter = (float*)aligned_malloc(numTaps * numPhases * sizeof(float), 32); // SIMD8
+    filter.polyphaseFilter = (float*)aligned_malloc(numTaps * numPhases * sizeof(float), 32); // SIMD8
 
     // rearrange into polyphase form, ordered by use
     for (int i = 0; i < numPhases; i++) {
@@ -138,23 +160,23 @@ int AudioSRC::createRationalFilter(int upFactor, int downFactor, float gain, Qua
 
             // the filter taps are reversed, so convolution is implemented as dot-product
             float f = tempFilter[(numTaps - j - 1) * numPhases + phase];
-            _polyphaseFilter[numTaps * i + j] = f;
+            filter.polyphaseFilter[numTaps * i + j] = f;
         }
     }
 
     delete[] tempFilter;
 
     // precompute the input steps
-    _stepTable = new int[numPhases];
+    filter.stepTable = new int[numPhases];
 
     for (int i = 0; i < numPhases; i++) {
-        _stepTable[i] = (((int64_t)(i+1) * downFactor) / upFactor) - (((int64_t)(i+0) * downFactor) / upFactor);
+        filter.stepTable[i] = (((int64_t)(i+1) * downFactor) / upFactor) - (((int64_t)(i+0) * downFactor) / upFactor);
     }
 
     return numTaps;
 }
 
-int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain, Quality quality) {
+int AudioSRC::createIrrationalFilter(AudioSRCFilter& filter, int upFactor, int downFactor, float gain, Quality quality) {
 
     int prototypeTaps = prototypeFilterTable[quality].taps;
     int prototypeCoefs = prototypeFilterTable[quality].coefs;
@@ -183,7 +205,7 @@ int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain, Q
     cubicInterpolation(prototypeFilter, tempFilter, prototypeCoefs, numCoefs, gain);
 
     // create the polyphase filter, with extra phase at the end to simplify coef interpolation
-    _polyphaseFilter = (float*)aligned_malloc(numTaps * (numPhases + 1) * sizeof(float), 32);   // SIMD8
+    filter.polyphaseFilter = (float*)aligned_malloc(numTaps * (numPhases + 1) * sizeof(float), 32);   // SIMD8
 
     // rearrange into polyphase form, ordered by fractional delay
     for (int phase = 0; phase < numPhases; phase++) {
@@ -191,19 +213,19 @@ int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain, Q
 
             // the filter taps are reversed, so convolution is implemented as dot-product
             float f = tempFilter[(numTaps - j - 1) * numPhases + phase];
-            _polyphaseFilter[numTaps * phase + j] = f;
+            filter.polyphaseFilter[numTaps * phase + j] = f;
         }
     }
 
     delete[] tempFilter;
 
     // by construction, the last tap of the first phase must be zero
-    assert(_polyphaseFilter[numTaps - 1] == 0.0f);
+    assert(filter.polyphaseFilter[numTaps - 1] == 0.0f);
 
     // so the extra phase is just the first, shifted by one
-    _polyphaseFilter[numTaps * numPhases + 0] = 0.0f;
+    filter.polyphaseFilter[numTaps * numPhases + 0] = 0.0f;
     for (int j = 1; j < numTaps; j++) {
-        _polyphaseFilter[numTaps * numPhases + j] = _polyphaseFilter[j-1];
+        filter.polyphaseFilter[numTaps * numPhases + j] = filter.polyphaseFilter[j-1];
     }
 
     return numTaps;
@@ -435,18 +457,21 @@ int AudioSRC::multirateFilter4_ref(const float* input0, const float* input1, con
 #include "CPUDetect.h"
 
 int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
-    static auto f = cpuSupportsAVX2() ? &AudioSRC::multirateFilter1_AVX2 : &AudioSRC::multirateFilter1_ref;
+    static auto f = cpuSupportsAVX512() ? &AudioSRC::multirateFilter1_AVX512 :
+        (cpuSupportsAVX2() ? &AudioSRC::multirateFilter1_AVX2 : &AudioSRC::multirateFilter1_ref);
     return (this->*f)(input0, output0, inputFrames);    // dispatch
 }
 
 int AudioSRC::multirateFilter2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
-    static auto f = cpuSupportsAVX2() ? &AudioSRC::multirateFilter2_AVX2 : &AudioSRC::multirateFilter2_ref;
+    static auto f = cpuSupportsAVX512() ? &AudioSRC::multirateFilter2_AVX512 :
+        (cpuSupportsAVX2() ? &AudioSRC::multirateFilter2_AVX2 : &AudioSRC::multirateFilter2_ref);
     return (this->*f)(input0, input1, output0, output1, inputFrames);   // dispatch
 }
 
 int AudioSRC::multirateFilter4(const float* input0, const float* input1, const float* input2, const float* input3, 
                                float* output0, float* output1, float* output2, float* output3, int inputFrames) {
-    static auto f = cpuSupportsAVX2() ? &AudioSRC::multirateFilter4_AVX2 : &AudioSRC::multirateFilter4_ref;
+    static auto f = cpuSupportsAVX512() ? &AudioSRC::multirateFilter4_AVX512 :
+        (cpuSupportsAVX2() ? &AudioSRC::multirateFilter4_AVX2 : &AudioSRC::multirateFilter4_ref);
     return (this->*f)(input0, input1, input2, input3, output0, output1, output2, output3, inputFrames); // dispatch
 }
 
@@ -1426,6 +1451,23 @@ int AudioSRC::render(float** inputs, float** outputs, int inputFrames) {
     return outputFrames;
 }
 
+void AudioSRC::renderBatch(BatchStream* streams, int numStreams) {
+
+    // order the streams by filter, keeping the order of the ones that share a filter
+    std::vector<int> order(numStreams);
+    for (int i = 0; i < numStreams; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [streams](int a, int b) {
+        return std::less<const AudioSRCFilter*>()(streams[a].src->_filter.get(), streams[b].src->_filter.get());
+    });
+
+    for (int i : order) {
+        BatchStream& stream = streams[i];
+        stream.outputFrames = stream.src->render(stream.inputs, stream.outputs, stream.inputFrames);
+    }
+}
+
 AudioSRC::AudioSRC(int inputSampleRate, int outputSampleRate, int numChannels, Quality quality) {
 
     assert(inputSampleRate > 0);
@@ -1450,15 +1492,36 @@ AudioSRC::AudioSRC(int inputSampleRate, int outputSampleRate, int numChannels, Q
         _step = ((int64_t)_inputSampleRate << 32) / _outputSampleRate;
     }
 
-    _polyphaseFilter = nullptr;
-    _stepTable = nullptr;
-
-    // create the polyphase filter
-    if (_step == 0) {
-        _numTaps = createRationalFilter(_upFactor, _downFactor, 1.0f, quality);
-    } else {
-        _numTaps = createIrrationalFilter(_upFactor, _downFactor, 1.0f, quality);
+    // find or create the polyphase filter
+    static std::mutex filtersMutex;
+    static std::map<std::tuple<int, int, Quality>, std::weak_ptr<const AudioSRCFilter>> filters;
+    {
+        std::lock_guard<std::mutex> lock(filtersMutex);
+        auto key = std::make_tuple(inputSampleRate, outputSampleRate, quality);
+        _filter = filters[key].lock();
+        if (!_filter) {
+            auto filter = std::make_shared<AudioSRCFilter>();
+            if (_step == 0) {
+                filter->numTaps = createRationalFilter(*filter, _upFactor, _downFactor, 1.0f, quality);
+            } else {
+                filter->numTaps = createIrrationalFilter(*filter, _upFactor, _downFactor, 1.0f, quality);
+            }
+            _filter = filter;
+
+            // forget the filters that are no longer used
+            for (auto itr = filters.begin(); itr != filters.end();) {
+                if (itr->second.expired()) {
+                    itr = filters.erase(itr);
+                } else {
+                    ++itr;
+                }
+            }
+            filters[key] = _filter;
+        }
     }
+    _polyphaseFilter = _filter->polyphaseFilter;
+    _stepTable = _filter->stepTable;
+    _numTaps = _filter->numTaps;
 
     //printf("up=%d down=%.3f taps=%d\n", _upFactor, _downFactor + (LO32(_step)<<SRC_PHASEBITS) * Q32_TO_FLOAT, _numTaps);
 
@@ -1486,9 +1549,6 @@ AudioSRC::AudioSRC(int inputSampleRate, int outputSampleRate, int numChannels, Q
 }
 
 AudioSRC::~AudioSRC() {
-    aligned_free(_polyphaseFilter);
-    delete[] _stepTable;
-
     for (int ch = 0; ch < _numChannels; ch++) {
 
         delete[] _history[ch];
@@ -13,6 +13,7 @@
 #define hifi_AudioSRC_h
 
 #include <stdint.h>
+#include <memory>
 
 static const int SRC_MAX_CHANNELS = 4;
 
@@ -28,6 +29,9 @@ static const float Q32_TO_FLOAT = 1.0f / (1ULL << 32);
 // blocking size in frames, chosen so block processing fits in L1 cache
 static const int SRC_BLOCK = 256;
 
+class AudioSRCFilter;
+class AudioSRCTests;
+
 class AudioSRC {
 
 public:
@@ -43,6 +47,19 @@ public:
     // deinterleaved float input/output (native format)
     int render(float** inputs, float** outputs, int inputFrames);
 
+    // one stream of a batch, deinterleaved float input/output (native format)
+    struct BatchStream {
+        AudioSRC* src;
+        float** inputs;
+        float** outputs;
+        int inputFrames;
+        int outputFrames;   // set by renderBatch()
+    };
+
+    // resamples many independent streams in one call, grouped so that the streams sharing a polyphase filter
+    // run back to back while it is in cache
+    static void renderBatch(BatchStream* streams, int numStreams);
+
     // interleaved int16_t input/output
     int render(const int16_t* input, int16_t* output, int inputFrames);
 
@@ -55,8 +72,12 @@ public:
     int getMaxInput(int outputFrames);
 
 private:
-    float* _polyphaseFilter;
-    int* _stepTable;
+    friend class ::AudioSRCTests;
+
+    // the polyphase filter depends only on the rates and quality, so it is shared by every AudioSRC that has them
+    std::shared_ptr<const AudioSRCFilter> _filter;
+    const float* _polyphaseFilter;
+    const int* _stepTable;
 
     float* _history[SRC_MAX_CHANNELS];
     float* _inputs[SRC_MAX_CHANNELS];
@@ -76,8 +97,8 @@ private:
     int64_t _offset;
     int64_t _step;
 
-    int createRationalFilter(int upFactor, int downFactor, float gain, Quality quality);
-    int createIrrationalFilter(int upFactor, int downFactor, float gain, Quality quality);
+    static int createRationalFilter(AudioSRCFilter& filter, int upFactor, int downFactor, float gain, Quality quality);
+    static int createIrrationalFilter(AudioSRCFilter& filter, int upFactor, int downFactor, float gain, Quality quality);
 
     int multirateFilter1(const float* input0, float* output0, int inputFrames);
     int multirateFilter2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames);
@@ -94,6 +115,11 @@ private:
     int multirateFilter4_AVX2(const float* input0, const float* input1, const float* input2, const float* input3, 
                               float* output0, float* output1, float* output2, float* output3, int inputFrames);
 
+    int multirateFilter1_AVX512(const float* input0, float* output0, int inputFrames);
+    int multirateFilter2_AVX512(const float* input0, const float* input1, float* output0, float* output1, int inputFrames);
+    int multirateFilter4_AVX512(const float* input0, const float* input1, const float* input2, const float* input3,
+                                float* output0, float* output1, float* output2, float* output3, int inputFrames);
+
     void convertInput(const int16_t* input, float** outputs, int numFrames);
     void convertOutput(float** inputs, int16_t* output, int numFrames);
 
@@ -0,0 +1,384 @@
+//
+//  AudioSRC_avx512.cpp
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX512F__
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "../AudioSRC.h"
+
+// high/low part of int64_t
+#define LO32(a)   ((uint32_t)(a))
+#define HI32(a)   ((int32_t)((a) >> 32))
+
+// _numTaps is a multiple of 8, so the last 16 taps may be only half used
+static const __mmask16 SIMD8_MASK = 0x00ff;
+
+// add the upper and lower halves
+// (the zero-masked forms with a full mask, because the unmasked shuffle and extract use an undefined source that
+//  GCC 12 reports as uninitialized; this still compiles to a single shuffle and add)
+static inline __m256 fold512(__m512 x) {
+    __m512 swapped = _mm512_maskz_shuffle_f32x4(0xffff, x, x, _MM_SHUFFLE(1, 0, 3, 2));
+    __m512 sum = _mm512_add_ps(x, swapped);
+    return _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xf, _mm512_castps_pd(sum), 0));
+}
+
+int AudioSRC::multirateFilter1_AVX512(const float* input0, float* output0, int inputFrames) {
+    int outputFrames = 0;
+
+    assert(_numTaps % 8 == 0);  // SIMD8
+
+    if (_step == 0) {   // rational
+
+        int32_t i = HI32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+
+            int j = 0;
+            for (; j < _numTaps - 31; j += 32) {    // unrolled x 2
+
+                //float coef = c0[j];
+                __m512 coef0 = _mm512_loadu_ps(&c0[j + 0]);
+                __m512 coef1 = _mm512_loadu_ps(&c0[j + 16]);
+
+                //acc += input[i + j] * coef;
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j + 0]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j + 16]), coef1, acc1);
+            }
+            if (j < _numTaps - 15) {
+
+                __m512 coef0 = _mm512_loadu_ps(&c0[j]);
+
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j]), coef0, acc0);
+                j += 16;
+            }
+            if (j < _numTaps) {
+
+                __m512 coef1 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c0[j]);
+
+                acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input0[i + j]), coef1, acc1);
+            }
+            __m256 t = fold512(_mm512_add_ps(acc0, acc1));
+
+            // horizontal sum
+            t = _mm256_hadd_ps(t, t);
+            __m128 t0 = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+            t0 = _mm_add_ps(t0, _mm_movehdup_ps(t0));
+
+            _mm_store_ss(&output0[outputFrames], t0);
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (HI32(_offset) < inputFrames) {
+
+            int32_t i = HI32(_offset);
+            uint32_t f = LO32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float ftmp = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 frac = _mm512_set1_ps(ftmp);
+
+            int j = 0;
+            for (; j < _numTaps - 15; j += 16) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                __m512 coef0 = _mm512_loadu_ps(&c0[j]);
+                __m512 coef1 = _mm512_loadu_ps(&c1[j]);
+                coef1 = _mm512_sub_ps(coef1, coef0);
+                coef0 = _mm512_fmadd_ps(coef1, frac, coef0);
+
+                //acc += input[i + j] * coef;
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j]), coef0, acc0);
+            }
+            if (j < _numTaps) {
+
+                __m512 coef0 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c0[j]);
+                __m512 coef1 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c1[j]);
+                coef1 = _mm512_sub_ps(coef1, coef0);
+                coef0 = _mm512_fmadd_ps(coef1, frac, coef0);
+
+                acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input0[i + j]), coef0, acc0);
+            }
+            __m256 t = fold512(acc0);
+
+            // horizontal sum
+            t = _mm256_hadd_ps(t, t);
+            __m128 t0 = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+            t0 = _mm_add_ps(t0, _mm_movehdup_ps(t0));
+
+            _mm_store_ss(&output0[outputFrames], t0);
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+    _mm256_zeroupper();
+
+    return outputFrames;
+}
+
+int AudioSRC::multirateFilter2_AVX512(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
+    int outputFrames = 0;
+
+    assert(_numTaps % 8 == 0);  // SIMD8
+
+    if (_step == 0) {   // rational
+
+        int32_t i = HI32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+
+            int j = 0;
+            for (; j < _numTaps - 15; j += 16) {
+
+                //float coef = c0[j];
+                __m512 coef0 = _mm512_loadu_ps(&c0[j]);
+
+                //acc += input[i + j] * coef;
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(&input1[i + j]), coef0, acc1);
+            }
+            if (j < _numTaps) {
+
+                __m512 coef0 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c0[j]);
+
+                acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input1[i + j]), coef0, acc1);
+            }
+
+            // horizontal sum
+            __m256 t = _mm256_hadd_ps(fold512(acc0), fold512(acc1));
+            __m128 t0 = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+            t0 = _mm_add_ps(t0, _mm_movehdup_ps(t0));
+
+            _mm_store_ss(&output0[outputFrames], t0);
+            _mm_store_ss(&output1[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,2)));
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (HI32(_offset) < inputFrames) {
+
+            int32_t i = HI32(_offset);
+            uint32_t f = LO32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float ftmp = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            __m512 frac = _mm512_set1_ps(ftmp);
+
+            int j = 0;
+            for (; j < _numTaps - 15; j += 16) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                __m512 coef0 = _mm512_loadu_ps(&c0[j]);
+                __m512 coef1 = _mm512_loadu_ps(&c1[j]);
+                coef1 = _mm512_sub_ps(coef1, coef0);
+                coef0 = _mm512_fmadd_ps(coef1, frac, coef0);
+
+                //acc += input[i + j] * coef;
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(&input1[i + j]), coef0, acc1);
+            }
+            if (j < _numTaps) {
+
+                __m512 coef0 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c0[j]);
+                __m512 coef1 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c1[j]);
+                coef1 = _mm512_sub_ps(coef1, coef0);
+                coef0 = _mm512_fmadd_ps(coef1, frac, coef0);
+
+                acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input1[i + j]), coef0, acc1);
+            }
+
+            // horizontal sum
+            __m256 t = _mm256_hadd_ps(fold512(acc0), fold512(acc1));
+            __m128 t0 = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+            t0 = _mm_add_ps(t0, _mm_movehdup_ps(t0));
+
+            _mm_store_ss(&output0[outputFrames], t0);
+            _mm_store_ss(&output1[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,2)));
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+    _mm256_zeroupper();
+
+    return outputFrames;
+}
+
+int AudioSRC::multirateFilter4_AVX512(const float* input0, const float* input1, const float* input2, const float* input3,
+                                      float* output0, float* output1, float* output2, float* output3, int inputFrames) {
+    int outputFrames = 0;
+
+    assert(_numTaps % 8 == 0);  // SIMD8
+
+    if (_step == 0) {   // rational
+
+        int32_t i = HI32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            __m512 acc2 = _mm512_setzero_ps();
+            __m512 acc3 = _mm512_setzero_ps();
+
+            int j = 0;
+            for (; j < _numTaps - 15; j += 16) {
+
+                //float coef = c0[j];
+                __m512 coef0 = _mm512_loadu_ps(&c0[j]);
+
+                //acc += input[i + j] * coef;
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(&input1[i + j]), coef0, acc1);
+                acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(&input2[i + j]), coef0, acc2);
+                acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(&input3[i + j]), coef0, acc3);
+            }
+            if (j < _numTaps) {
+
+                __m512 coef0 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c0[j]);
+
+                acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input1[i + j]), coef0, acc1);
+                acc2 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input2[i + j]), coef0, acc2);
+                acc3 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input3[i + j]), coef0, acc3);
+            }
+
+            // horizontal sum
+            __m256 t = _mm256_hadd_ps(fold512(acc0), fold512(acc1));
+            __m256 u = _mm256_hadd_ps(fold512(acc2), fold512(acc3));
+            t = _mm256_hadd_ps(t, u);
+            __m128 t0 = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+
+            _mm_store_ss(&output0[outputFrames], t0);
+            _mm_store_ss(&output1[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,1)));
+            _mm_store_ss(&output2[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,2)));
+            _mm_store_ss(&output3[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,3)));
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (HI32(_offset) < inputFrames) {
+
+            int32_t i = HI32(_offset);
+            uint32_t f = LO32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float ftmp = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            __m512 acc2 = _mm512_setzero_ps();
+            __m512 acc3 = _mm512_setzero_ps();
+            __m512 frac = _mm512_set1_ps(ftmp);
+
+            int j = 0;
+            for (; j < _numTaps - 15; j += 16) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                __m512 coef0 = _mm512_loadu_ps(&c0[j]);
+                __m512 coef1 = _mm512_loadu_ps(&c1[j]);
+                coef1 = _mm512_sub_ps(coef1, coef0);
+                coef0 = _mm512_fmadd_ps(coef1, frac, coef0);
+
+                //acc += input[i + j] * coef;
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(&input1[i + j]), coef0, acc1);
+                acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(&input2[i + j]), coef0, acc2);
+                acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(&input3[i + j]), coef0, acc3);
+            }
+            if (j < _numTaps) {
+
+                __m512 coef0 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c0[j]);
+                __m512 coef1 = _mm512_maskz_loadu_ps(SIMD8_MASK, &c1[j]);
+                coef1 = _mm512_sub_ps(coef1, coef0);
+                coef0 = _mm512_fmadd_ps(coef1, frac, coef0);
+
+                acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input0[i + j]), coef0, acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input1[i + j]), coef0, acc1);
+                acc2 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input2[i + j]), coef0, acc2);
+                acc3 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(SIMD8_MASK, &input3[i + j]), coef0, acc3);
+            }
+
+            // horizontal sum
+            __m256 t = _mm256_hadd_ps(fold512(acc0), fold512(acc1));
+            __m256 u = _mm256_hadd_ps(fold512(acc2), fold512(acc3));
+            t = _mm256_hadd_ps(t, u);
+            __m128 t0 = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+
+            _mm_store_ss(&output0[outputFrames], t0);
+            _mm_store_ss(&output1[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,1)));
+            _mm_store_ss(&output2[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,2)));
+            _mm_store_ss(&output3[outputFrames], _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(0,0,0,3)));
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+    _mm256_zeroupper();
+
+    return outputFrames;
+}
+
+#endif
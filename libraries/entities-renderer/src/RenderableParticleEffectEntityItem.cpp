@@ -16,6 +16,8 @@
 
 #include <glm/gtx/transform.hpp>
 
+#include <QtConcurrent/QtConcurrentRun>
+
 using namespace render;
 using namespace render::entities;
 
@@ -40,13 +42,7 @@ static ShapePipelinePointer shapePipelineFactory(const ShapePlumber& plumber, co
     return std::make_shared<render::ShapePipeline>(texturedPipeline, nullptr, nullptr, nullptr);
 }
 
-struct GpuParticle {
-    GpuParticle(const glm::vec3& xyzIn, const glm::vec2& uvIn) : xyz(xyzIn), uv(uvIn) {}
-    glm::vec3 xyz; // Position
-    glm::vec2 uv; // Lifetime + seed
-};
-
-using GpuParticles = std::vector<GpuParticle>;
+using GpuParticle = particle::GpuParticle;
 
 ParticleEffectEntityRenderer::ParticleEffectEntityRenderer(const EntityItemPointer& entity) : Parent(entity) {
     ParticleUniforms uniforms;
@@ -64,6 +60,18 @@ ParticleEffectEntityRenderer::ParticleEffectEntityRenderer(const EntityItemPoint
     });
 }
 
+ParticleEffectEntityRenderer::~ParticleEffectEntityRenderer() {
+    _simulation.waitForFinished();
+}
+
+bool ParticleEffectEntityRenderer::needsRenderUpdate() const {
+    // the simulation is stepped with the render updates
+    if (_hasParticles || resultWithReadLock<bool>([&] { return _emitting; })) {
+        return true;
+    }
+    return Parent::needsRenderUpdate();
+}
+
 void ParticleEffectEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePointer& scene, Transaction& transaction, const TypedEntityPointer& entity) {
     auto newParticleProperties = entity->getParticleProperties();
     if (!newParticleProperties.valid()) {
@@ -71,8 +79,8 @@ void ParticleEffectEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePoi
     }
 
     if (resultWithReadLock<bool>([&] { return _particleProperties != newParticleProperties; })) {
-        _timeUntilNextEmit = 0;
         withWriteLock([&] {
+            _resetEmitTimer = true;
             _particleProperties = newParticleProperties;
             if (!_prevEmitterShouldTrailInitialized) {
                 _prevEmitterShouldTrailInitialized = true;
@@ -87,11 +95,10 @@ void ParticleEffectEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePoi
         QString compoundShapeURL = entity->getCompoundShapeURL();
         if (_compoundShapeURL != compoundShapeURL) {
             _compoundShapeURL = compoundShapeURL;
-            _hasComputedTriangles = false;
             fetchGeometryResource();
         }
+        _emitting = entity->getIsEmitting();
     });
-    _emitting = entity->getIsEmitting();
 
     bool textureEmpty = resultWithReadLock<bool>([&] { return _particleProperties.textures.isEmpty(); });
     if (textureEmpty) {
@@ -128,6 +135,13 @@ void ParticleEffectEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePoi
             _renderTransform = getModelTransform();
         });
     });
+
+    // step the simulation on a worker rather than in doRender(), unless the last step is still running
+    if (_simulation.isFinished()) {
+        _simulation = QtConcurrent::run([this] {
+            stepSimulation();
+        });
+    }
 }
 
 void ParticleEffectEntityRenderer::doRenderUpdateAsynchronousTyped(const TypedEntityPointer& entity) {
@@ -386,24 +400,35 @@ void ParticleEffectEntityRenderer::stepSimulation() {
     particle::Properties particleProperties;
     ShapeType shapeType;
     GeometryResource::Pointer geometryResource;
-    withReadLock([&] {
+    QString compoundShapeURL;
+    Transform modelTransform;
+    bool emitting;
+    withWriteLock([&] {
         particleProperties = _particleProperties;
         shapeType = _shapeType;
+        // the resource and the URL it was fetched for change together, so the worker can tell when its triangles are stale
         geometryResource = _geometryResource;
+        compoundShapeURL = _compoundShapeURL;
+        modelTransform = getModelTransform();
+        emitting = _emitting;
+        if (_resetEmitTimer) {
+            _timeUntilNextEmit = 0;
+            _resetEmitTimer = false;
+        }
     });
 
-    const auto& modelTransform = getModelTransform();
-    if (_emitting && particleProperties.emitting() &&
+    if (emitting && particleProperties.emitting() &&
         (shapeType != SHAPE_TYPE_COMPOUND || (geometryResource && geometryResource->isLoaded()))) {
         uint64_t emitInterval = particleProperties.emitIntervalUsecs();
         if (emitInterval > 0 && interval >= _timeUntilNextEmit) {
             auto timeRemaining = interval;
             while (timeRemaining > _timeUntilNextEmit) {
-                if (_shapeType == SHAPE_TYPE_COMPOUND && !_hasComputedTriangles) {
+                if (shapeType == SHAPE_TYPE_COMPOUND && (!_hasComputedTriangles || _trianglesURL != compoundShapeURL)) {
                     computeTriangles(geometryResource->getHFMModel());
+                    _trianglesURL = compoundShapeURL;
                 }
                 // emit particle
-                _cpuParticles.push_back(createParticle(now, modelTransform, particleProperties, shapeType, geometryResource, _triangleInfo));
+                _cpuParticles.push(createParticle(now, modelTransform, particleProperties, shapeType, geometryResource, _triangleInfo));
                 _timeUntilNextEmit = emitInterval;
                 if (emitInterval < timeRemaining) {
                     timeRemaining -= emitInterval;
@@ -415,39 +440,24 @@ void ParticleEffectEntityRenderer::stepSimulation() {
     }
 
     // Kill any particles that have expired or are over the max size
-    while (_cpuParticles.size() > particleProperties.maxParticles || (!_cpuParticles.empty() && _cpuParticles.front().expiration <= now)) {
-        _cpuParticles.pop_front();
-    }
+    _cpuParticles.expire(now, particleProperties.maxParticles);
 
-    const float deltaTime = (float)interval / (float)USECS_PER_SECOND;
     // update the particles
-    for (auto& particle : _cpuParticles) {
-        if (_prevEmitterShouldTrail != particleProperties.emission.shouldTrail) {
-            if (_prevEmitterShouldTrail) {
-                particle.relativePosition = particle.relativePosition + particle.basePosition - modelTransform.getTranslation();
-            }
-            particle.basePosition = modelTransform.getTranslation();
-        }
-        particle.integrate(deltaTime);
+    if (_prevEmitterShouldTrail != particleProperties.emission.shouldTrail) {
+        _cpuParticles.rebase(modelTransform.getTranslation(), _prevEmitterShouldTrail);
     }
     _prevEmitterShouldTrail = particleProperties.emission.shouldTrail;
-
-    // Build particle primitives
-    static GpuParticles gpuParticles;
-    gpuParticles.clear();
-    gpuParticles.reserve(_cpuParticles.size()); // Reserve space
-    std::transform(_cpuParticles.begin(), _cpuParticles.end(), std::back_inserter(gpuParticles), [&particleProperties, &modelTransform] (const CpuParticle& particle) {
-        glm::vec3 position = particle.relativePosition + (particleProperties.emission.shouldTrail ? particle.basePosition : modelTransform.getTranslation());
-        return GpuParticle(position, glm::vec2(particle.lifetime, particle.seed));
-    });
-
-    // Update particle buffer
-    auto& particleBuffer = _particleBuffer;
-    size_t numBytes = sizeof(GpuParticle) * gpuParticles.size();
-    particleBuffer->resize(numBytes);
-    if (numBytes != 0) {
-        particleBuffer->setData(numBytes, (const gpu::Byte*)gpuParticles.data());
+    const float deltaTime = (float)interval / (float)USECS_PER_SECOND;
+    _cpuParticles.integrate(deltaTime);
+
+    // Build particle primitives, and hand them over to doRender()
+    _cpuParticles.writeGpuParticles(particleProperties.emission.shouldTrail, modelTransform.getTranslation(), _simulatedGpuParticles);
+    {
+        std::lock_guard<std::mutex> lock(_gpuParticlesMutex);
+        std::swap(_simulatedGpuParticles, _readyGpuParticles);
+        _gpuParticlesChanged = true;
     }
+    _hasParticles = !_cpuParticles.empty();
 }
 
 void ParticleEffectEntityRenderer::doRender(RenderArgs* args) {
@@ -455,8 +465,18 @@ void ParticleEffectEntityRenderer::doRender(RenderArgs* args) {
         return;
     }
 
-    // FIXME migrate simulation to a compute stage
-    stepSimulation();
+    // Update particle buffer with the latest simulation step
+    {
+        std::lock_guard<std::mutex> lock(_gpuParticlesMutex);
+        if (_gpuParticlesChanged) {
+            size_t numBytes = sizeof(GpuParticle) * _readyGpuParticles.size();
+            _particleBuffer->resize(numBytes);
+            if (numBytes != 0) {
+                _particleBuffer->setData(numBytes, (const gpu::Byte*)_readyGpuParticles.data());
+            }
+            _gpuParticlesChanged = false;
+        }
+    }
 
     gpu::Batch& batch = *args->_batch;
     batch.setResourceTexture(0, _networkTexture->getGPUTexture());
@@ -11,7 +11,13 @@
 #ifndef hifi_RenderableParticleEffectEntityItem_h
 #define hifi_RenderableParticleEffectEntityItem_h
 
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QFuture>
+
 #include "RenderableEntityItem.h"
+#include <CpuParticles.h>
 #include <ParticleEffectEntityItem.h>
 #include <TextureCache.h>
 
@@ -23,8 +29,10 @@ class ParticleEffectEntityRenderer : public TypedEntityRenderer<ParticleEffectEn
 
 public:
     ParticleEffectEntityRenderer(const EntityItemPointer& entity);
+    ~ParticleEffectEntityRenderer();
 
 protected:
+    virtual bool needsRenderUpdate() const override;
     virtual void doRenderUpdateSynchronousTyped(const ScenePointer& scene, Transaction& transaction, const TypedEntityPointer& entity) override;
     virtual void doRenderUpdateAsynchronousTyped(const TypedEntityPointer& entity) override;
 
@@ -41,25 +49,8 @@ private:
     using Buffer = gpu::Buffer;
     using BufferView = gpu::BufferView;
 
-    // CPU particles
-    // FIXME either switch to GPU compute particles or switch to simd updating of the particles
-    struct CpuParticle {
-        float seed { 0.0f };
-        uint64_t expiration { 0 };
-        float lifetime { 0.0f };
-        glm::vec3 basePosition;
-        glm::vec3 relativePosition;
-        glm::vec3 velocity;
-        glm::vec3 acceleration;
-
-        void integrate(float deltaTime) {
-            glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * acceleration;
-            relativePosition += velocity * deltaTime + atSquared;
-            velocity += acceleration * deltaTime;
-            lifetime += deltaTime;
-        }
-    };
-    using CpuParticles = std::deque<CpuParticle>;
+    using CpuParticle = particle::CpuParticles::Particle;
+    using CpuParticles = particle::CpuParticles;
 
 
     template<typename T>
@@ -80,7 +71,6 @@ private:
     };
 
     void computeTriangles(const hfm::Model& hfmModel);
-    bool _hasComputedTriangles{ false };
     struct TriangleInfo {
         std::vector<Triangle> triangles;
         std::vector<size_t> samplesPerTriangle;
@@ -96,9 +86,22 @@ private:
     particle::Properties _particleProperties;
     bool _prevEmitterShouldTrail;
     bool _prevEmitterShouldTrailInitialized { false };
-    CpuParticles _cpuParticles;
     bool _emitting { false };
+    bool _resetEmitTimer { false };
+
+    // Only touched by stepSimulation(), which runs on a worker during the simulation phase, one step at a time
+    CpuParticles _cpuParticles;
     uint64_t _timeUntilNextEmit { 0 };
+    bool _hasComputedTriangles { false };
+    QString _trianglesURL; // the compoundShapeURL _triangleInfo was computed from
+    particle::GpuParticles _simulatedGpuParticles;
+    QFuture<void> _simulation;
+    std::atomic<bool> _hasParticles { false };
+
+    // The latest simulated particles, swapped in by the worker and copied into _particleBuffer by doRender()
+    std::mutex _gpuParticlesMutex;
+    particle::GpuParticles _readyGpuParticles;
+    bool _gpuParticlesChanged { false };
     BufferPointer _particleBuffer { std::make_shared<Buffer>() };
     BufferView _uniformBuffer;
     quint64 _lastSimulated { 0 };
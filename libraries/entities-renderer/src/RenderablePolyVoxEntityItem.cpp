@@ -18,6 +18,7 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtConcurrent/QtConcurrentRun>
 
 #include <model-networking/SimpleMeshProxy.h>
@@ -50,6 +51,7 @@
 
 #include <Model.h>
 #include <PerfStat.h>
+#include <Profile.h>
 #include <render/Scene.h>
 
 #ifdef _WIN32
@@ -92,6 +94,9 @@ const float MARCHING_CUBE_COLLISION_HULL_OFFSET = 0.5;
   _volDataDirty    -- does recomputeMesh need to be called?
   _shapeReady      -- are we ready to tell bullet our shape?
 
+  _volData is split into chunks (see PolyVoxChunks) and only the chunks with changed voxels have their mesh and collision
+  hulls rebuilt, in parallel.  _mesh and _shape are put back together from the meshes and hulls cached for every chunk.
+
 
   Here is a simplified diagram of the state machine implemented in RenderablePolyVoxEntityItem::update
 
@@ -225,6 +230,8 @@ void RenderablePolyVoxEntityItem::setVoxelSurfaceStyle(PolyVoxSurfaceStyle voxel
             volSizeChanged = true;
         }
         _voxelSurfaceStyle = voxelSurfaceStyle;
+        // the other extractor has to remesh everything
+        _chunks.markAllDirty();
         startUpdates();
     });
 
@@ -723,7 +730,7 @@ ShapeType RenderablePolyVoxEntityItem::getShapeType() const {
 }
 
 void RenderablePolyVoxEntityItem::setRegistrationPoint(const glm::vec3& value) {
-    if (value != _registrationPoint) {
+    if (value != _registrationPoint.get()) {
         _shapeReady = false;
         EntityItem::setRegistrationPoint(value);
         startUpdates();
@@ -940,6 +947,7 @@ void RenderablePolyVoxEntityItem::setVoxelVolumeSize(const glm::vec3& voxelVolum
         _volData.reset(new PolyVox::SimpleVolume<uint8_t>(PolyVox::Region(lowCorner, highCorner)));
         // having the "outside of voxel-space" value be 255 has helped me notice some problems.
         _volData->setBorderValue(255);
+        _chunks.reset(ivec3(_volData->getWidth(), _volData->getHeight(), _volData->getDepth()));
     });
 
     tellNeighborsToRecopyEdges(true);
@@ -992,6 +1000,7 @@ uint8_t RenderablePolyVoxEntityItem::getVoxelInternal(const ivec3& v) const {
 
 void RenderablePolyVoxEntityItem::setVoxelMarkNeighbors(int x, int y, int z, uint8_t toValue) {
     _volData->setVoxelAt(x, y, z, toValue);
+    _chunks.voxelChanged(ivec3(x, y, z));
     if (x == 0) {
         _neighborXNeedsUpdate = true;
         startUpdates();
@@ -1244,6 +1253,7 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
                         uint8_t prevValue = _volData->getVoxelAt(x, y, z);
                         if (prevValue != neighborValue) {
                             _volData->setVoxelAt(x, y, z, neighborValue);
+                            _chunks.voxelChanged(ivec3(x, y, z));
                             _volDataDirty = true;
                         }
                     }
@@ -1264,6 +1274,7 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
                         uint8_t prevValue = _volData->getVoxelAt(x, y, z);
                         if (prevValue != neighborValue) {
                             _volData->setVoxelAt(x, y, z, neighborValue);
+                            _chunks.voxelChanged(ivec3(x, y, z));
                             _volDataDirty = true;
                         }
                     }
@@ -1284,6 +1295,7 @@ void RenderablePolyVoxEntityItem::copyUpperEdgesFromNeighbors() {
                         uint8_t prevValue = _volData->getVoxelAt(x, y, z);
                         if (prevValue != neighborValue) {
                             _volData->setVoxelAt(x, y, z, neighborValue);
+                            _chunks.voxelChanged(ivec3(x, y, z));
                             _volDataDirty = true;
                         }
                     }
@@ -1326,73 +1338,124 @@ void RenderablePolyVoxEntityItem::tellNeighborsToRecopyEdges(bool force) {
 void RenderablePolyVoxEntityItem::recomputeMesh() {
     // use _volData to make a renderable mesh
     PolyVoxSurfaceStyle voxelSurfaceStyle;
-    withReadLock([&] {
+    int numChunks;
+    std::vector<PolyVoxChunks::Chunk> dirtyChunks;
+    withWriteLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
+        numChunks = _chunks.getNumChunks();
+        dirtyChunks = _chunks.takeDirtyChunks();
     });
 
     auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
-    QtConcurrent::run([entity, voxelSurfaceStyle] {
-        graphics::MeshPointer mesh(new graphics::Mesh());
+    QtConcurrent::run([entity, voxelSurfaceStyle, numChunks, dirtyChunks] {
+        entity->bakeMeshChunks(voxelSurfaceStyle, numChunks, dirtyChunks);
+    });
+}
+
+void RenderablePolyVoxEntityItem::bakeMeshChunks(PolyVoxSurfaceStyle voxelSurfaceStyle, int numChunks,
+                                                 std::vector<PolyVoxChunks::Chunk> dirtyChunks) {
+    PROFILE_RANGE(simulation_physics, __FUNCTION__);
+    if ((int)_chunkMeshes.size() != numChunks) {
+        // the volume was resized, so every chunk is dirty
+        _chunkMeshes.clear();
+        _chunkMeshes.resize(numChunks);
+    }
 
-        // A mesh object to hold the result of surface extraction
-        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
+    // extract the surface of each dirty chunk from its own region of the volume
+    withReadLock([&] {
+        PolyVox::SimpleVolume<uint8_t>* volData = getVolData();
+        QtConcurrent::blockingMap(dirtyChunks, [&](const PolyVoxChunks::Chunk& chunk) {
+            if (chunk.index >= numChunks) {
+                return;
+            }
+            PolyVox::Region region(PolyVox::Vector3DInt32(chunk.low.x, chunk.low.y, chunk.low.z),
+                                   PolyVox::Vector3DInt32(chunk.high.x, chunk.high.y, chunk.high.z));
 
-        entity->withReadLock([&] {
-            PolyVox::SimpleVolume<uint8_t>* volData = entity->getVolData();
+            // A mesh object to hold the result of surface extraction
+            PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> polyVoxMesh;
             switch (voxelSurfaceStyle) {
                 case PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES:
                 case PolyVoxEntityItem::SURFACE_MARCHING_CUBES: {
                     PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
+                        (volData, region, &polyVoxMesh);
                     surfaceExtractor.execute();
                     break;
                 }
                 case PolyVoxEntityItem::SURFACE_EDGED_CUBIC:
                 case PolyVoxEntityItem::SURFACE_CUBIC: {
                     PolyVox::CubicSurfaceExtractorWithNormals<PolyVox::SimpleVolume<uint8_t>> surfaceExtractor
-                        (volData, volData->getEnclosingRegion(), &polyVoxMesh);
+                        (volData, region, &polyVoxMesh);
                     surfaceExtractor.execute();
                     break;
                 }
             }
-        });
 
-        // convert PolyVox mesh to a Sam mesh
-        const std::vector<uint32_t>& vecIndices = polyVoxMesh.getIndices();
-        auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
-                                                         (gpu::Byte*)vecIndices.data());
-        auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
-        gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
-        mesh->setIndexBuffer(indexBufferView);
-
-        const std::vector<PolyVox::PositionMaterialNormal>& vecVertices = polyVoxMesh.getRawVertexData();
-        auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
-                                                          (gpu::Byte*)vecVertices.data());
-        auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
-        gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
-                                         vertexBufferPtr->getSize(),
-                                         sizeof(PolyVox::PositionMaterialNormal),
-                                         gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
-        mesh->setVertexBuffer(vertexBufferView);
-
-        // TODO -- use 3-byte normals rather than 3-float normals
-        mesh->addAttribute(gpu::Stream::NORMAL,
-                           gpu::BufferView(vertexBufferPtr,
-                                           sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
-                                           vertexBufferPtr->getSize(),
-                                           sizeof(PolyVox::PositionMaterialNormal),
-                                           gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
-
-        std::vector<graphics::Mesh::Part> parts;
-        parts.emplace_back(graphics::Mesh::Part((graphics::Index)0, // startIndex
-                                             (graphics::Index)vecIndices.size(), // numIndices
-                                             (graphics::Index)0, // baseVertex
-                                             graphics::Mesh::TRIANGLES)); // topology
-        mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(graphics::Mesh::Part), (gpu::Byte*) parts.data()),
-                                            gpu::Element::PART_DRAWCALL));
-        entity->setMesh(mesh);
+            // the extractors put the vertices relative to the region, move them back into voxel space
+            ChunkMesh& chunkMesh = _chunkMeshes[chunk.index];
+            chunkMesh.chunk = chunk;
+            chunkMesh.indices = polyVoxMesh.getIndices();
+            chunkMesh.vertices = polyVoxMesh.getRawVertexData();
+            PolyVox::Vector3DFloat offset((float)chunk.low.x, (float)chunk.low.y, (float)chunk.low.z);
+            for (auto& vertex : chunkMesh.vertices) {
+                vertex.setPosition(vertex.getPosition() + offset);
+            }
+            chunkMesh.hullsDirty = true;
+        });
     });
+
+    // put the chunks together into one mesh
+    size_t numVertices = 0;
+    size_t numIndices = 0;
+    for (const auto& chunkMesh : _chunkMeshes) {
+        numVertices += chunkMesh.vertices.size();
+        numIndices += chunkMesh.indices.size();
+    }
+    std::vector<PolyVox::PositionMaterialNormal> vecVertices;
+    std::vector<uint32_t> vecIndices;
+    vecVertices.reserve(numVertices);
+    vecIndices.reserve(numIndices);
+    for (const auto& chunkMesh : _chunkMeshes) {
+        uint32_t baseVertex = (uint32_t)vecVertices.size();
+        vecVertices.insert(vecVertices.end(), chunkMesh.vertices.begin(), chunkMesh.vertices.end());
+        for (uint32_t index : chunkMesh.indices) {
+            vecIndices.push_back(baseVertex + index);
+        }
+    }
+
+    // convert PolyVox mesh to a Sam mesh
+    graphics::MeshPointer mesh(new graphics::Mesh());
+    auto indexBuffer = std::make_shared<gpu::Buffer>(vecIndices.size() * sizeof(uint32_t),
+                                                     (gpu::Byte*)vecIndices.data());
+    auto indexBufferPtr = gpu::BufferPointer(indexBuffer);
+    gpu::BufferView indexBufferView(indexBufferPtr, gpu::Element(gpu::SCALAR, gpu::UINT32, gpu::INDEX));
+    mesh->setIndexBuffer(indexBufferView);
+
+    auto vertexBuffer = std::make_shared<gpu::Buffer>(vecVertices.size() * sizeof(PolyVox::PositionMaterialNormal),
+                                                      (gpu::Byte*)vecVertices.data());
+    auto vertexBufferPtr = gpu::BufferPointer(vertexBuffer);
+    gpu::BufferView vertexBufferView(vertexBufferPtr, 0,
+                                     vertexBufferPtr->getSize(),
+                                     sizeof(PolyVox::PositionMaterialNormal),
+                                     gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+    mesh->setVertexBuffer(vertexBufferView);
+
+    // TODO -- use 3-byte normals rather than 3-float normals
+    mesh->addAttribute(gpu::Stream::NORMAL,
+                       gpu::BufferView(vertexBufferPtr,
+                                       sizeof(float) * 3, // polyvox mesh is packed: position, normal, material
+                                       vertexBufferPtr->getSize(),
+                                       sizeof(PolyVox::PositionMaterialNormal),
+                                       gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ)));
+
+    std::vector<graphics::Mesh::Part> parts;
+    parts.emplace_back(graphics::Mesh::Part((graphics::Index)0, // startIndex
+                                         (graphics::Index)vecIndices.size(), // numIndices
+                                         (graphics::Index)0, // baseVertex
+                                         graphics::Mesh::TRIANGLES)); // topology
+    mesh->setPartBuffer(gpu::BufferView(new gpu::Buffer(parts.size() * sizeof(graphics::Mesh::Part), (gpu::Byte*) parts.data()),
+                                        gpu::Element::PART_DRAWCALL));
+    setMesh(mesh);
 }
 
 void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh) {
@@ -1413,135 +1476,137 @@ void RenderablePolyVoxEntityItem::setMesh(graphics::MeshPointer mesh) {
 
 void RenderablePolyVoxEntityItem::computeShapeInfoWorker() {
     // this creates a collision-shape for the physics engine.  The shape comes from
-    // _volData for cubic extractors and from _mesh for marching-cube extractors
-
-    EntityItemPointer entity = getThisPointer();
+    // _volData for cubic extractors and from the chunk meshes for marching-cube extractors
 
     PolyVoxSurfaceStyle voxelSurfaceStyle;
     glm::vec3 voxelVolumeSize;
-    graphics::MeshPointer mesh;
 
     withReadLock([&] {
         voxelSurfaceStyle = _voxelSurfaceStyle;
         voxelVolumeSize = _voxelVolumeSize;
-        mesh = _mesh;
     });
 
-    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize, mesh] {
-        auto polyVoxEntity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity);
-        QVector<QVector<glm::vec3>> pointCollection;
-        AABox box;
-        glm::mat4 vtoM = std::static_pointer_cast<RenderablePolyVoxEntityItem>(entity)->voxelToLocalMatrix();
+    auto entity = std::static_pointer_cast<RenderablePolyVoxEntityItem>(getThisPointer());
 
-        if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
-            voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES) {
-            // pull each triangle in the mesh into a polyhedron which can be collided with
-            unsigned int i = 0;
+    QtConcurrent::run([entity, voxelSurfaceStyle, voxelVolumeSize] {
+        entity->bakeShapeChunks(voxelSurfaceStyle, voxelVolumeSize);
+    });
+}
+
+void RenderablePolyVoxEntityItem::bakeShapeChunks(PolyVoxSurfaceStyle voxelSurfaceStyle, const glm::vec3& voxelVolumeSize) {
+    PROFILE_RANGE(simulation_physics, __FUNCTION__);
+    bool isMarchingCubes = voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_MARCHING_CUBES ||
+        voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_MARCHING_CUBES;
 
-            const gpu::BufferView& vertexBufferView = mesh->getVertexBuffer();
-            const gpu::BufferView& indexBufferView = mesh->getIndexBuffer();
+    // rebuild the hulls of the chunks that were remeshed, in voxel space
+    std::vector<ChunkMesh*> dirtyChunkMeshes;
+    for (auto& chunkMesh : _chunkMeshes) {
+        if (chunkMesh.hullsDirty) {
+            dirtyChunkMeshes.push_back(&chunkMesh);
+        }
+    }
 
-            gpu::BufferView::Iterator<const uint32_t> it = indexBufferView.cbegin<uint32_t>();
-            while (it != indexBufferView.cend<uint32_t>()) {
-                uint32_t p0Index = *(it++);
-                uint32_t p1Index = *(it++);
-                uint32_t p2Index = *(it++);
+    auto bakeHulls = [&](ChunkMesh* chunkMesh) {
+        ShapeInfo::PointCollection& hulls = chunkMesh->hulls;
+        hulls.clear();
+        chunkMesh->hullsDirty = false;
 
-                const glm::vec3& p0 = vertexBufferView.get<const glm::vec3>(p0Index);
-                const glm::vec3& p1 = vertexBufferView.get<const glm::vec3>(p1Index);
-                const glm::vec3& p2 = vertexBufferView.get<const glm::vec3>(p2Index);
+        if (isMarchingCubes) {
+            // pull each triangle in the mesh into a polyhedron which can be collided with
+            const auto& vertices = chunkMesh->vertices;
+            const auto& indices = chunkMesh->indices;
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                const auto& position0 = vertices[indices[i]].getPosition();
+                const auto& position1 = vertices[indices[i + 1]].getPosition();
+                const auto& position2 = vertices[indices[i + 2]].getPosition();
+                glm::vec3 p0(position0.getX(), position0.getY(), position0.getZ());
+                glm::vec3 p1(position1.getX(), position1.getY(), position1.getZ());
+                glm::vec3 p2(position2.getX(), position2.getY(), position2.getZ());
 
                 glm::vec3 av = (p0 + p1 + p2) / 3.0f; // center of the triangular face
                 glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
                 glm::vec3 p3 = av - normal * MARCHING_CUBE_COLLISION_HULL_OFFSET;
 
-                glm::vec3 p0Model = glm::vec3(vtoM * glm::vec4(p0, 1.0f));
-                glm::vec3 p1Model = glm::vec3(vtoM * glm::vec4(p1, 1.0f));
-                glm::vec3 p2Model = glm::vec3(vtoM * glm::vec4(p2, 1.0f));
-                glm::vec3 p3Model = glm::vec3(vtoM * glm::vec4(p3, 1.0f));
-
-                box += p0Model;
-                box += p1Model;
-                box += p2Model;
-                box += p3Model;
-
                 QVector<glm::vec3> pointsInPart;
-                pointsInPart << p0Model;
-                pointsInPart << p1Model;
-                pointsInPart << p2Model;
-                pointsInPart << p3Model;
+                pointsInPart << p0;
+                pointsInPart << p1;
+                pointsInPart << p2;
+                pointsInPart << p3;
                 // add next convex hull
-                QVector<glm::vec3> newMeshPoints;
-                pointCollection << newMeshPoints;
-                // add points to the new convex hull
-                pointCollection[i++] << pointsInPart;
+                hulls << pointsInPart;
             }
         } else {
-            unsigned int i = 0;
-            polyVoxEntity->forEachVoxelValue(voxelVolumeSize, [&](const ivec3& v, uint8_t value) {
-                if (value > 0) {
-                    const auto& x = v.x;
-                    const auto& y = v.y;
-                    const auto& z = v.z;
-                    if (glm::all(glm::greaterThan(v, ivec3(0))) &&
-                        glm::all(glm::lessThan(v, ivec3(voxelVolumeSize) - 1)) &&
-                        (polyVoxEntity->getVoxelInternal({ x - 1, y, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y - 1, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y, z - 1 }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x + 1, y, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y + 1, z }) > 0) &&
-                        (polyVoxEntity->getVoxelInternal({ x, y, z + 1 }) > 0)) {
-                        // this voxel has neighbors in every cardinal direction, so there's no need
-                        // to include it in the collision hull.
-                        return;
-                    }
-
-                    QVector<glm::vec3> pointsInPart;
-
-                    float offL = -0.5f;
-                    float offH = 0.5f;
-                    if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
-                        offL += 1.0f;
-                        offH += 1.0f;
-                    }
+            // the chunks are in _volData coordinates, which have an extra layer around the voxels when edged
+            ivec3 edgeOffset = ivec3(voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC ? 1 : 0);
+            const PolyVoxChunks::Chunk& chunk = chunkMesh->chunk;
+            loop3(glm::max(chunk.low - edgeOffset, ivec3(0)),
+                  glm::min(chunk.ownedHigh - edgeOffset + 1, ivec3(voxelVolumeSize)), [&](const ivec3& v) {
+                if (getVoxelInternal(v) == 0) {
+                    return;
+                }
+                const auto& x = v.x;
+                const auto& y = v.y;
+                const auto& z = v.z;
+                if (glm::all(glm::greaterThan(v, ivec3(0))) &&
+                    glm::all(glm::lessThan(v, ivec3(voxelVolumeSize) - 1)) &&
+                    (getVoxelInternal({ x - 1, y, z }) > 0) &&
+                    (getVoxelInternal({ x, y - 1, z }) > 0) &&
+                    (getVoxelInternal({ x, y, z - 1 }) > 0) &&
+                    (getVoxelInternal({ x + 1, y, z }) > 0) &&
+                    (getVoxelInternal({ x, y + 1, z }) > 0) &&
+                    (getVoxelInternal({ x, y, z + 1 }) > 0)) {
+                    // this voxel has neighbors in every cardinal direction, so there's no need
+                    // to include it in the collision hull.
+                    return;
+                }
 
-                    glm::vec3 p000 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offL, 1.0f));
-                    glm::vec3 p001 = glm::vec3(vtoM * glm::vec4(x + offL, y + offL, z + offH, 1.0f));
-                    glm::vec3 p010 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offL, 1.0f));
-                    glm::vec3 p011 = glm::vec3(vtoM * glm::vec4(x + offL, y + offH, z + offH, 1.0f));
-                    glm::vec3 p100 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offL, 1.0f));
-                    glm::vec3 p101 = glm::vec3(vtoM * glm::vec4(x + offH, y + offL, z + offH, 1.0f));
-                    glm::vec3 p110 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offL, 1.0f));
-                    glm::vec3 p111 = glm::vec3(vtoM * glm::vec4(x + offH, y + offH, z + offH, 1.0f));
-
-                    box += p000;
-                    box += p001;
-                    box += p010;
-                    box += p011;
-                    box += p100;
-                    box += p101;
-                    box += p110;
-                    box += p111;
-
-                    pointsInPart << p000;
-                    pointsInPart << p001;
-                    pointsInPart << p010;
-                    pointsInPart << p011;
-                    pointsInPart << p100;
-                    pointsInPart << p101;
-                    pointsInPart << p110;
-                    pointsInPart << p111;
-
-                    // add next convex hull
-                    QVector<glm::vec3> newMeshPoints;
-                    pointCollection << newMeshPoints;
-                    // add points to the new convex hull
-                    pointCollection[i++] << pointsInPart;
+                float offL = -0.5f;
+                float offH = 0.5f;
+                if (voxelSurfaceStyle == PolyVoxEntityItem::SURFACE_EDGED_CUBIC) {
+                    offL += 1.0f;
+                    offH += 1.0f;
                 }
+
+                QVector<glm::vec3> pointsInPart;
+                pointsInPart << glm::vec3(x + offL, y + offL, z + offL);
+                pointsInPart << glm::vec3(x + offL, y + offL, z + offH);
+                pointsInPart << glm::vec3(x + offL, y + offH, z + offL);
+                pointsInPart << glm::vec3(x + offL, y + offH, z + offH);
+                pointsInPart << glm::vec3(x + offH, y + offL, z + offL);
+                pointsInPart << glm::vec3(x + offH, y + offL, z + offH);
+                pointsInPart << glm::vec3(x + offH, y + offH, z + offL);
+                pointsInPart << glm::vec3(x + offH, y + offH, z + offH);
+                // add next convex hull
+                hulls << pointsInPart;
             });
         }
-        polyVoxEntity->setCollisionPoints(pointCollection, box);
-    });
+    };
+
+    if (isMarchingCubes) {
+        QtConcurrent::blockingMap(dirtyChunkMeshes, bakeHulls);
+    } else {
+        withReadLock([&] {
+            QtConcurrent::blockingMap(dirtyChunkMeshes, bakeHulls);
+        });
+    }
+
+    // put the hulls of all the chunks together, in the entity's frame
+    ShapeInfo::PointCollection pointCollection;
+    AABox box;
+    glm::mat4 vtoM = voxelToLocalMatrix();
+    for (const auto& chunkMesh : _chunkMeshes) {
+        for (const auto& hull : chunkMesh.hulls) {
+            QVector<glm::vec3> pointsInPart;
+            pointsInPart.reserve(hull.size());
+            for (const auto& point : hull) {
+                glm::vec3 pointModel = glm::vec3(vtoM * glm::vec4(point, 1.0f));
+                box += pointModel;
+                pointsInPart << pointModel;
+            }
+            pointCollection << pointsInPart;
+        }
+    }
+    setCollisionPoints(pointCollection, box);
 }
 
 void RenderablePolyVoxEntityItem::setCollisionPoints(ShapeInfo::PointCollection pointCollection, AABox box) {
@@ -1559,10 +1624,11 @@ void RenderablePolyVoxEntityItem::setCollisionPoints(ShapeInfo::PointCollection
     // include the registrationPoint in the shape key, because the offset is already
     // included in the points and the shapeManager wont know that the shape has changed.
     withWriteLock([&] {
+        glm::vec3 registrationPoint = _registrationPoint.get();
         QString shapeKey = QString(_voxelData.toBase64()) + "," +
-            QString::number(_registrationPoint.x) + "," +
-            QString::number(_registrationPoint.y) + "," +
-            QString::number(_registrationPoint.z);
+            QString::number(registrationPoint.x) + "," +
+            QString::number(registrationPoint.y) + "," +
+            QString::number(registrationPoint.z);
         _shapeInfo.setParams(SHAPE_TYPE_COMPOUND, collisionModelDimensions, shapeKey);
         _shapeInfo.setPointCollection(pointCollection);
         _shapeReady = true;
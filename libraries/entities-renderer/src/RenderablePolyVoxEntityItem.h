@@ -18,12 +18,14 @@
 
 #include <PolyVoxCore/SimpleVolume.h>
 #include <PolyVoxCore/Raycast.h>
+#include <PolyVoxCore/SurfaceMesh.h>
 
 #include <gpu/Forward.h>
 #include <gpu/Context.h>
 #include <graphics/Forward.h>
 #include <graphics/Geometry.h>
 #include <TextureCache.h>
+#include <PolyVoxChunks.h>
 #include <PolyVoxEntityItem.h>
 
 #include "RenderableEntityItem.h"
@@ -162,6 +164,8 @@ private:
     void uncompressVolumeData();
     void compressVolumeDataAndSendEditPacket();
     void computeShapeInfoWorker();
+    void bakeMeshChunks(PolyVoxSurfaceStyle voxelSurfaceStyle, int numChunks, std::vector<PolyVoxChunks::Chunk> dirtyChunks);
+    void bakeShapeChunks(PolyVoxSurfaceStyle voxelSurfaceStyle, const glm::vec3& voxelVolumeSize);
 
     // The PolyVoxEntityItem class has _voxelData which contains dimensions and compressed voxel data.  The dimensions
     // may not match _voxelVolumeSize.
@@ -179,6 +183,20 @@ private:
     std::shared_ptr<PolyVox::SimpleVolume<uint8_t>> _volData;
     int _onCount; // how many non-zero voxels are in _volData
 
+    // which parts of _volData changed since their mesh was last extracted
+    PolyVoxChunks _chunks;
+
+    // The mesh and collision hulls of each chunk, in voxel space.  These are only used by the mesh and shape workers,
+    // which the state machine never runs at the same time.
+    struct ChunkMesh {
+        PolyVoxChunks::Chunk chunk;
+        std::vector<PolyVox::PositionMaterialNormal> vertices;
+        std::vector<uint32_t> indices;
+        ShapeInfo::PointCollection hulls;
+        bool hullsDirty { true };
+    };
+    std::vector<ChunkMesh> _chunkMeshes;
+
     bool _neighborXNeedsUpdate { false };
     bool _neighborYNeedsUpdate { false };
     bool _neighborZNeedsUpdate { false };
@@ -0,0 +1,177 @@
+//
+//  CpuParticles.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CpuParticles.h"
+
+#include <algorithm>
+
+using namespace particle;
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// position += velocity * deltaTime + acceleration * (deltaTime^2 / 2), then velocity += acceleration * deltaTime
+static void integrateAxis(float* position, float* velocity, const float* acceleration, float deltaTime, size_t numParticles) {
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 halfDt2 = _mm_set1_ps(halfDeltaTimeSquared);
+
+    size_t i = 0;
+    for (; i + 4 <= numParticles; i += 4) {
+        __m128 p = _mm_loadu_ps(&position[i]);
+        __m128 v = _mm_loadu_ps(&velocity[i]);
+        __m128 a = _mm_loadu_ps(&acceleration[i]);
+
+        p = _mm_add_ps(p, _mm_add_ps(_mm_mul_ps(v, dt), _mm_mul_ps(a, halfDt2)));
+        v = _mm_add_ps(v, _mm_mul_ps(a, dt));
+
+        _mm_storeu_ps(&position[i], p);
+        _mm_storeu_ps(&velocity[i], v);
+    }
+    for (; i < numParticles; i++) {
+        position[i] += velocity[i] * deltaTime + acceleration[i] * halfDeltaTimeSquared;
+        velocity[i] += acceleration[i] * deltaTime;
+    }
+}
+
+static void addToAll(float* values, float delta, size_t numParticles) {
+    const __m128 d = _mm_set1_ps(delta);
+
+    size_t i = 0;
+    for (; i + 4 <= numParticles; i += 4) {
+        _mm_storeu_ps(&values[i], _mm_add_ps(_mm_loadu_ps(&values[i]), d));
+    }
+    for (; i < numParticles; i++) {
+        values[i] += delta;
+    }
+}
+
+#else   // portable reference code
+
+static void integrateAxis(float* position, float* velocity, const float* acceleration, float deltaTime, size_t numParticles) {
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+    for (size_t i = 0; i < numParticles; i++) {
+        position[i] += velocity[i] * deltaTime + acceleration[i] * halfDeltaTimeSquared;
+        velocity[i] += acceleration[i] * deltaTime;
+    }
+}
+
+static void addToAll(float* values, float delta, size_t numParticles) {
+    for (size_t i = 0; i < numParticles; i++) {
+        values[i] += delta;
+    }
+}
+
+#endif
+
+void CpuParticles::clear() {
+    _head = _seed.size();
+    compact();
+}
+
+void CpuParticles::push(const Particle& particle) {
+    _seed.push_back(particle.seed);
+    _expiration.push_back(particle.expiration);
+    _lifetime.push_back(0.0f);
+    _baseX.push_back(particle.basePosition.x);
+    _baseY.push_back(particle.basePosition.y);
+    _baseZ.push_back(particle.basePosition.z);
+    _relativeX.push_back(particle.relativePosition.x);
+    _relativeY.push_back(particle.relativePosition.y);
+    _relativeZ.push_back(particle.relativePosition.z);
+    _velocityX.push_back(particle.velocity.x);
+    _velocityY.push_back(particle.velocity.y);
+    _velocityZ.push_back(particle.velocity.z);
+    _accelerationX.push_back(particle.acceleration.x);
+    _accelerationY.push_back(particle.acceleration.y);
+    _accelerationZ.push_back(particle.acceleration.z);
+}
+
+void CpuParticles::expire(uint64_t now, size_t maxParticles) {
+    size_t numParticles = size();
+    size_t numExpired = numParticles > maxParticles ? numParticles - maxParticles : 0;
+    // particles are emitted in order, so the expired ones are at the front
+    while (numExpired < numParticles && _expiration[_head + numExpired] <= now) {
+        numExpired++;
+    }
+    eraseFront(numExpired);
+}
+
+void CpuParticles::rebase(const glm::vec3& basePosition, bool keepWorldPosition) {
+    size_t end = _seed.size();
+    if (keepWorldPosition) {
+        for (size_t i = _head; i < end; i++) {
+            _relativeX[i] += _baseX[i] - basePosition.x;
+            _relativeY[i] += _baseY[i] - basePosition.y;
+            _relativeZ[i] += _baseZ[i] - basePosition.z;
+        }
+    }
+    std::fill(_baseX.begin() + _head, _baseX.end(), basePosition.x);
+    std::fill(_baseY.begin() + _head, _baseY.end(), basePosition.y);
+    std::fill(_baseZ.begin() + _head, _baseZ.end(), basePosition.z);
+}
+
+void CpuParticles::integrate(float deltaTime) {
+    size_t numParticles = size();
+    integrateAxis(_relativeX.data() + _head, _velocityX.data() + _head, _accelerationX.data() + _head, deltaTime, numParticles);
+    integrateAxis(_relativeY.data() + _head, _velocityY.data() + _head, _accelerationY.data() + _head, deltaTime, numParticles);
+    integrateAxis(_relativeZ.data() + _head, _velocityZ.data() + _head, _accelerationZ.data() + _head, deltaTime, numParticles);
+    addToAll(_lifetime.data() + _head, deltaTime, numParticles);
+}
+
+void CpuParticles::writeGpuParticles(bool useBasePositions, const glm::vec3& emitterPosition, GpuParticles& gpuParticles) const {
+    size_t numParticles = size();
+    gpuParticles.resize(numParticles);
+    for (size_t i = 0; i < numParticles; i++) {
+        size_t j = _head + i;
+        glm::vec3 origin = useBasePositions ? glm::vec3(_baseX[j], _baseY[j], _baseZ[j]) : emitterPosition;
+        gpuParticles[i].xyz = origin + glm::vec3(_relativeX[j], _relativeY[j], _relativeZ[j]);
+        gpuParticles[i].uv = glm::vec2(_lifetime[j], _seed[j]);
+    }
+}
+
+void CpuParticles::eraseFront(size_t count) {
+    _head += count;
+    // once the expired particles outnumber the live ones, moving the live ones down costs no more than
+    // the expired ones did, so expiry stays linear in the number of particles emitted
+    if (_head == _seed.size() || (_head >= MIN_COMPACT_COUNT && _head >= size())) {
+        compact();
+    }
+}
+
+void CpuParticles::compact() {
+    if (_head == 0) {
+        return;
+    }
+    size_t head = _head;
+    auto eraseFrontOf = [head](auto& values) {
+        values.erase(values.begin(), values.begin() + head);
+    };
+    eraseFrontOf(_seed);
+    eraseFrontOf(_expiration);
+    eraseFrontOf(_lifetime);
+    eraseFrontOf(_baseX);
+    eraseFrontOf(_baseY);
+    eraseFrontOf(_baseZ);
+    eraseFrontOf(_relativeX);
+    eraseFrontOf(_relativeY);
+    eraseFrontOf(_relativeZ);
+    eraseFrontOf(_velocityX);
+    eraseFrontOf(_velocityY);
+    eraseFrontOf(_velocityZ);
+    eraseFrontOf(_accelerationX);
+    eraseFrontOf(_accelerationY);
+    eraseFrontOf(_accelerationZ);
+    _head = 0;
+}
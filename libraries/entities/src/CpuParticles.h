@@ -0,0 +1,95 @@
+//
+//  CpuParticles.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CpuParticles_h
+#define hifi_CpuParticles_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace particle {
+
+// The per instance vertex data of a particle, as the particle shaders read it
+struct GpuParticle {
+    GpuParticle() {}
+    GpuParticle(const glm::vec3& xyzIn, const glm::vec2& uvIn) : xyz(xyzIn), uv(uvIn) {}
+    glm::vec3 xyz; // Position
+    glm::vec2 uv; // Lifetime + seed
+};
+
+using GpuParticles = std::vector<GpuParticle>;
+
+// The live particles of an emitter, oldest first, stored as one array per component so that integrating and
+// expiring them are straight loops over floats.  Expired particles are only skipped over at the front of the
+// arrays, and the arrays are compacted once the skipped ones outnumber the live ones.
+class CpuParticles {
+public:
+    // a newly emitted particle
+    struct Particle {
+        float seed { 0.0f };
+        uint64_t expiration { 0 };
+        glm::vec3 basePosition;
+        glm::vec3 relativePosition;
+        glm::vec3 velocity;
+        glm::vec3 acceleration;
+    };
+
+    size_t size() const { return _seed.size() - _head; }
+    bool empty() const { return size() == 0; }
+    void clear();
+
+    void push(const Particle& particle);
+
+    // removes the particles that expire by now, and then the oldest ones beyond maxParticles
+    void expire(uint64_t now, size_t maxParticles);
+
+    // moves every particle to a new base position, keeping its world position when keepWorldPosition is set
+    void rebase(const glm::vec3& basePosition, bool keepWorldPosition);
+
+    void integrate(float deltaTime);
+
+    // the world positions are the relative positions plus either each particle's base position or the emitter position
+    void writeGpuParticles(bool useBasePositions, const glm::vec3& emitterPosition, GpuParticles& gpuParticles) const;
+
+    glm::vec3 getRelativePosition(size_t index) const {
+        index += _head;
+        return glm::vec3(_relativeX[index], _relativeY[index], _relativeZ[index]);
+    }
+    glm::vec3 getVelocity(size_t index) const {
+        index += _head;
+        return glm::vec3(_velocityX[index], _velocityY[index], _velocityZ[index]);
+    }
+    float getLifetime(size_t index) const { return _lifetime[_head + index]; }
+    uint64_t getExpiration(size_t index) const { return _expiration[_head + index]; }
+
+private:
+    // don't bother compacting until at least this many particles have expired
+    static const size_t MIN_COMPACT_COUNT = 64;
+
+    void eraseFront(size_t count);
+    void compact();
+
+    // the index of the oldest live particle in every array
+    size_t _head { 0 };
+
+    std::vector<float> _seed;
+    std::vector<uint64_t> _expiration;
+    std::vector<float> _lifetime;
+    std::vector<float> _baseX, _baseY, _baseZ;
+    std::vector<float> _relativeX, _relativeY, _relativeZ;
+    std::vector<float> _velocityX, _velocityY, _velocityZ;
+    std::vector<float> _accelerationX, _accelerationY, _accelerationZ;
+};
+
+} // namespace particle
+
+#endif // hifi_CpuParticles_h
@@ -11,11 +11,45 @@
 
 #include "EntityEditFilters.h"
 
+#include <QThread>
 #include <QUrl>
 
 #include <ResourceManager.h>
 #include <shared/ScriptInitializerMixin.h>
 
+// each filter gets this many engines, at most one per core, so that as many edits can be filtered concurrently
+static const int MAX_ENGINES_PER_FILTER = 4;
+
+void EntityEditFilters::FilterEnginePool::add(std::unique_ptr<FilterEngine> engine) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _availableEngines.push_back(engine.get());
+    _engines.push_back(std::move(engine));
+}
+
+EntityEditFilters::FilterEnginePool::BorrowedEngine EntityEditFilters::FilterEnginePool::borrow() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _engineReturned.wait(lock, [&] { return !_availableEngines.empty(); });
+    FilterEngine* engine = _availableEngines.back();
+    _availableEngines.pop_back();
+    return BorrowedEngine(engine, [this](FilterEngine* engine) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _availableEngines.push_back(engine);
+        }
+        _engineReturned.notify_one();
+    });
+}
+
+static bool changesOnlyIgnoredProperties(const EntityPropertyFlags& changedProperties,
+                                         const EntityPropertyFlags& ignoredProperties) {
+    for (int flag = changedProperties.firstFlag(); flag <= changedProperties.lastFlag(); flag++) {
+        if (changedProperties.getHasProperty((EntityPropertyList)flag) && !ignoredProperties.getHasProperty((EntityPropertyList)flag)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
     QList<EntityItemID> zones;
     QList<EntityItemID> missingZones;
@@ -73,10 +107,22 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 return true; // accept the message
             }
 
-            auto oldProperties = propertiesIn.getDesiredProperties();
             auto specifiedProperties = propertiesIn.getChangedProperties();
+
+            // skip the script for the edits the filter says it doesn't care about
+            if (!filterData.ignoredProperties.isEmpty() &&
+                (filterType == EntityTree::FilterType::Edit || filterType == EntityTree::FilterType::Physics) &&
+                changesOnlyIgnoredProperties(specifiedProperties, filterData.ignoredProperties)) {
+                continue;
+            }
+
+            // the pool is shared with the other threads filtering edits, and kept alive by filterData during the call
+            auto filterEngine = filterData.engines->borrow();
+            QScriptEngine* engine = filterEngine->engine.get();
+
+            auto oldProperties = propertiesIn.getDesiredProperties();
             propertiesIn.setDesiredProperties(specifiedProperties);
-            QScriptValue inputValues = propertiesIn.copyToScriptValue(filterData.engine, false, true, true);
+            QScriptValue inputValues = propertiesIn.copyToScriptValue(engine, false, true, true);
             propertiesIn.setDesiredProperties(oldProperties);
 
             auto in = QJsonValue::fromVariant(inputValues.toVariant()); // grab json copy now, because the inputValues might be side effected by the filter.
@@ -88,7 +134,7 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
             // get the current properties for then entity and include them for the filter call
             if (existingEntity && filterData.wantsOriginalProperties) {
                 auto currentProperties = existingEntity->getProperties(filterData.includedOriginalProperties);
-                QScriptValue currentValues = currentProperties.copyToScriptValue(filterData.engine, false, true, true);
+                QScriptValue currentValues = currentProperties.copyToScriptValue(engine, false, true, true);
                 args << currentValues;
             }
 
@@ -98,17 +144,17 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 auto zoneEntity = _tree->findEntityByEntityItemID(id);
                 if (zoneEntity) {
                     auto zoneProperties = zoneEntity->getProperties(filterData.includedZoneProperties);
-                    QScriptValue zoneValues = zoneProperties.copyToScriptValue(filterData.engine, false, true, true);
+                    QScriptValue zoneValues = zoneProperties.copyToScriptValue(engine, false, true, true);
 
                     if (filterData.wantsZoneBoundingBox) {
                         bool success = true;
                         AABox aaBox = zoneEntity->getAABox(success);
                         if (success) {
-                            QScriptValue boundingBox = filterData.engine->newObject();
-                            QScriptValue bottomRightNear = vec3ToScriptValue(filterData.engine, aaBox.getCorner());
-                            QScriptValue topFarLeft = vec3ToScriptValue(filterData.engine, aaBox.calcTopFarLeft());
-                            QScriptValue center = vec3ToScriptValue(filterData.engine, aaBox.calcCenter());
-                            QScriptValue boundingBoxDimensions = vec3ToScriptValue(filterData.engine, aaBox.getDimensions());
+                            QScriptValue boundingBox = engine->newObject();
+                            QScriptValue bottomRightNear = vec3ToScriptValue(engine, aaBox.getCorner());
+                            QScriptValue topFarLeft = vec3ToScriptValue(engine, aaBox.calcTopFarLeft());
+                            QScriptValue center = vec3ToScriptValue(engine, aaBox.calcCenter());
+                            QScriptValue boundingBoxDimensions = vec3ToScriptValue(engine, aaBox.getDimensions());
                             boundingBox.setProperty("brn", bottomRightNear);
                             boundingBox.setProperty("tfl", topFarLeft);
                             boundingBox.setProperty("center", center);
@@ -129,9 +175,9 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
                 }
             }
 
-            QScriptValue result = filterData.filterFn.call(_nullObjectForFilter, args);
+            QScriptValue result = filterEngine->filterFn.call(_nullObjectForFilter, args);
 
-            if (filterData.uncaughtExceptions()) {
+            if (filterEngine->uncaughtExceptions()) {
                 return false;
             }
 
@@ -165,14 +211,16 @@ bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& proper
 }
 
 void EntityEditFilters::removeFilter(EntityItemID entityID) {
+    // the engines are deleted with their pool, once the edits being filtered with them are done
     QWriteLocker writeLock(&_lock);
-    FilterData filterData = _filterDataMap.value(entityID);
-    if (filterData.valid()) {
-        delete filterData.engine;
-    }
     _filterDataMap.remove(entityID);
 }
 
+bool EntityEditFilters::hasFilters() {
+    QReadLocker readLock(&_lock);
+    return !_filterDataMap.isEmpty();
+}
+
 void EntityEditFilters::addFilter(EntityItemID entityID, QString filterURL) {
 
     QUrl scriptURL(filterURL);
@@ -248,138 +296,178 @@ static bool hadUncaughtExceptions(QScriptEngine& engine, const QString& fileName
     return false;
 }
 
-void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
-    qDebug() << "script request completed for entity " << entityID;
-    auto scriptRequest = qobject_cast<ResourceRequest*>(sender());
-    if (scriptRequest && scriptRequest->getResult() == ResourceRequest::Success) {
-        const QString urlString = scriptRequest->getUrl().toString();
-        auto scriptContents = scriptRequest->getData();
-        qInfo() << "Downloaded script:" << scriptContents;
-        QScriptProgram program(scriptContents, urlString);
-        if (hasCorrectSyntax(program)) {
-            // create a QScriptEngine for this script
-            QScriptEngine* engine = new QScriptEngine();
-            engine->setObjectName("filter:" + entityID.toString());
-            engine->setProperty("type", "edit_filter");
-            engine->setProperty("fileName", urlString);
-            engine->setProperty("entityID", entityID);
-            engine->globalObject().setProperty("Script", engine->newQObject(engine));
-            DependencyManager::get<ScriptInitializers>()->runScriptInitializers(engine);
-            engine->evaluate(scriptContents, urlString);
-            if (!hadUncaughtExceptions(*engine, urlString)) {
-                // put the engine in the engine map (so we don't leak them, etc...)
-                FilterData filterData;
-                filterData.engine = engine;
-                filterData.rejectAll = false;
-                
-                // define the uncaughtException function
-                QScriptEngine& engineRef = *engine;
-                filterData.uncaughtExceptions = [&engineRef, urlString]() { return hadUncaughtExceptions(engineRef, urlString); };
-
-                // now get the filter function
-                auto global = engine->globalObject();
-                auto entitiesObject = engine->newObject();
-                entitiesObject.setProperty("ADD_FILTER_TYPE", EntityTree::FilterType::Add);
-                entitiesObject.setProperty("EDIT_FILTER_TYPE", EntityTree::FilterType::Edit);
-                entitiesObject.setProperty("PHYSICS_FILTER_TYPE", EntityTree::FilterType::Physics);
-                entitiesObject.setProperty("DELETE_FILTER_TYPE", EntityTree::FilterType::Delete);
-                global.setProperty("Entities", entitiesObject);
-                filterData.filterFn = global.property("filter");
-                if (!filterData.filterFn.isFunction()) {
-                    qDebug() << "Filter function specified but not found. Will reject all edits for those without lock rights.";
-                    delete engine;
-                    filterData.rejectAll=true;
-                }
+// evaluates the filter script in a new engine, or returns null if it threw
+static std::unique_ptr<EntityEditFilters::FilterEngine> createFilterEngine(const EntityItemID& entityID,
+                                                                           const QString& scriptContents,
+                                                                           const QString& urlString) {
+    std::unique_ptr<EntityEditFilters::FilterEngine> filterEngine { new EntityEditFilters::FilterEngine() };
+    filterEngine->engine.reset(new QScriptEngine());
+    QScriptEngine* engine = filterEngine->engine.get();
+    engine->setObjectName("filter:" + entityID.toString());
+    engine->setProperty("type", "edit_filter");
+    engine->setProperty("fileName", urlString);
+    engine->setProperty("entityID", entityID);
+    engine->globalObject().setProperty("Script", engine->newQObject(engine));
+    DependencyManager::get<ScriptInitializers>()->runScriptInitializers(engine);
+    engine->evaluate(scriptContents, urlString);
+    if (hadUncaughtExceptions(*engine, urlString)) {
+        return nullptr;
+    }
 
-                // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterAddValue = filterData.filterFn.property("wantsToFilterAdd");
-                filterData.wantsToFilterAdd = wantsToFilterAddValue.isBool() ? wantsToFilterAddValue.toBool() : true;
-
-                // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterEditValue = filterData.filterFn.property("wantsToFilterEdit");
-                filterData.wantsToFilterEdit = wantsToFilterEditValue.isBool() ? wantsToFilterEditValue.toBool() : true;
-
-                // if the wantsToFilterPhysics is a boolean evaluate as a boolean, otherwise assume true
-                QScriptValue wantsToFilterPhysicsValue = filterData.filterFn.property("wantsToFilterPhysics");
-                filterData.wantsToFilterPhysics = wantsToFilterPhysicsValue.isBool() ? wantsToFilterPhysicsValue.toBool() : true;
-
-                // if the wantsToFilterDelete is a boolean evaluate as a boolean, otherwise assume false
-                QScriptValue wantsToFilterDeleteValue = filterData.filterFn.property("wantsToFilterDelete");
-                filterData.wantsToFilterDelete = wantsToFilterDeleteValue.isBool() ? wantsToFilterDeleteValue.toBool() : false;
-
-                // check to see if the filterFn has properties asking for Original props
-                QScriptValue wantsOriginalPropertiesValue = filterData.filterFn.property("wantsOriginalProperties");
-                // if the wantsOriginalProperties is a boolean, or a string, or list of strings, then evaluate as follows:
-                //   - boolean - true  - include all original properties
-                //               false - no properties at all
-                //   - string  - empty - no properties at all
-                //               any valid property - include just that property in the Original properties
-                //   - list of strings - include only those properties in the Original properties
-                if (wantsOriginalPropertiesValue.isBool()) {
-                    filterData.wantsOriginalProperties = wantsOriginalPropertiesValue.toBool();
-                } else if (wantsOriginalPropertiesValue.isString()) {
-                    auto stringValue = wantsOriginalPropertiesValue.toString();
-                    filterData.wantsOriginalProperties = !stringValue.isEmpty();
-                    if (filterData.wantsOriginalProperties) {
-                        EntityPropertyFlagsFromScriptValue(wantsOriginalPropertiesValue, filterData.includedOriginalProperties);
-                    }
-                } else if (wantsOriginalPropertiesValue.isArray()) {
-                    EntityPropertyFlagsFromScriptValue(wantsOriginalPropertiesValue, filterData.includedOriginalProperties);
-                    filterData.wantsOriginalProperties = !filterData.includedOriginalProperties.isEmpty();
-                }
+    // define the uncaughtException function
+    filterEngine->uncaughtExceptions = [engine, urlString]() { return hadUncaughtExceptions(*engine, urlString); };
+
+    // now get the filter function
+    auto global = engine->globalObject();
+    auto entitiesObject = engine->newObject();
+    entitiesObject.setProperty("ADD_FILTER_TYPE", EntityTree::FilterType::Add);
+    entitiesObject.setProperty("EDIT_FILTER_TYPE", EntityTree::FilterType::Edit);
+    entitiesObject.setProperty("PHYSICS_FILTER_TYPE", EntityTree::FilterType::Physics);
+    entitiesObject.setProperty("DELETE_FILTER_TYPE", EntityTree::FilterType::Delete);
+    global.setProperty("Entities", entitiesObject);
+    filterEngine->filterFn = global.property("filter");
+    return filterEngine;
+}
 
-                // check to see if the filterFn has properties asking for Zone props
-                QScriptValue wantsZonePropertiesValue = filterData.filterFn.property("wantsZoneProperties");
-                // if the wantsZoneProperties is a boolean, or a string, or list of strings, then evaluate as follows:
-                //   - boolean - true  - include all Zone properties
-                //               false - no properties at all
-                //   - string  - empty - no properties at all
-                //               any valid property - include just that property in the Zone properties
-                //   - list of strings - include only those properties in the Zone properties
-                if (wantsZonePropertiesValue.isBool()) {
-                    filterData.wantsZoneProperties = wantsZonePropertiesValue.toBool();
-                    filterData.wantsZoneBoundingBox = filterData.wantsZoneProperties; // include this too
-                } else if (wantsZonePropertiesValue.isString()) {
-                    auto stringValue = wantsZonePropertiesValue.toString();
-                    filterData.wantsZoneProperties = !stringValue.isEmpty();
-                    if (filterData.wantsZoneProperties) {
-                        if (stringValue == "boundingBox") {
-                            filterData.wantsZoneBoundingBox = true;
-                        } else {
-                            EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
-                        }
-                    }
-                } else if (wantsZonePropertiesValue.isArray()) {
-                    auto length = wantsZonePropertiesValue.property("length").toInteger();
-                    for (int i = 0; i < length; i++) {
-                        auto stringValue = wantsZonePropertiesValue.property(i).toString();
-                        if (!stringValue.isEmpty()) {
-                            filterData.wantsZoneProperties = true;
-
-                            // boundingBox is a special case since it's not a true EntityPropertyFlag, so we
-                            // need to detect it here.
-                            if (stringValue == "boundingBox") {
-                                filterData.wantsZoneBoundingBox = true;
-                                break; // we can break here, since there are no other special cases
-                            }
+bool EntityEditFilters::addFilterScript(EntityItemID entityID, const QString& scriptContents, const QString& urlString) {
+    QScriptProgram program(scriptContents, urlString);
+    if (!hasCorrectSyntax(program)) {
+        return false;
+    }
 
-                        }
-                    }
-                    if (filterData.wantsZoneProperties) {
-                        EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
-                    }
+    auto filterEngine = createFilterEngine(entityID, scriptContents, urlString);
+    if (!filterEngine) {
+        return false;
+    }
+
+    // put the engine in the engine map (so we don't leak them, etc...)
+    FilterData filterData;
+    filterData.rejectAll = false;
+
+    QScriptValue filterFn = filterEngine->filterFn;
+    if (!filterFn.isFunction()) {
+        qDebug() << "Filter function specified but not found. Will reject all edits for those without lock rights.";
+        filterData.rejectAll = true;
+    }
+
+    // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
+    QScriptValue wantsToFilterAddValue = filterFn.property("wantsToFilterAdd");
+    filterData.wantsToFilterAdd = wantsToFilterAddValue.isBool() ? wantsToFilterAddValue.toBool() : true;
+
+    // if the wantsToFilterEdit is a boolean evaluate as a boolean, otherwise assume true
+    QScriptValue wantsToFilterEditValue = filterFn.property("wantsToFilterEdit");
+    filterData.wantsToFilterEdit = wantsToFilterEditValue.isBool() ? wantsToFilterEditValue.toBool() : true;
+
+    // if the wantsToFilterPhysics is a boolean evaluate as a boolean, otherwise assume true
+    QScriptValue wantsToFilterPhysicsValue = filterFn.property("wantsToFilterPhysics");
+    filterData.wantsToFilterPhysics = wantsToFilterPhysicsValue.isBool() ? wantsToFilterPhysicsValue.toBool() : true;
+
+    // if the wantsToFilterDelete is a boolean evaluate as a boolean, otherwise assume false
+    QScriptValue wantsToFilterDeleteValue = filterFn.property("wantsToFilterDelete");
+    filterData.wantsToFilterDelete = wantsToFilterDeleteValue.isBool() ? wantsToFilterDeleteValue.toBool() : false;
+
+    // check to see if the filterFn has properties asking for Original props
+    QScriptValue wantsOriginalPropertiesValue = filterFn.property("wantsOriginalProperties");
+    // if the wantsOriginalProperties is a boolean, or a string, or list of strings, then evaluate as follows:
+    //   - boolean - true  - include all original properties
+    //               false - no properties at all
+    //   - string  - empty - no properties at all
+    //               any valid property - include just that property in the Original properties
+    //   - list of strings - include only those properties in the Original properties
+    if (wantsOriginalPropertiesValue.isBool()) {
+        filterData.wantsOriginalProperties = wantsOriginalPropertiesValue.toBool();
+    } else if (wantsOriginalPropertiesValue.isString()) {
+        auto stringValue = wantsOriginalPropertiesValue.toString();
+        filterData.wantsOriginalProperties = !stringValue.isEmpty();
+        if (filterData.wantsOriginalProperties) {
+            EntityPropertyFlagsFromScriptValue(wantsOriginalPropertiesValue, filterData.includedOriginalProperties);
+        }
+    } else if (wantsOriginalPropertiesValue.isArray()) {
+        EntityPropertyFlagsFromScriptValue(wantsOriginalPropertiesValue, filterData.includedOriginalProperties);
+        filterData.wantsOriginalProperties = !filterData.includedOriginalProperties.isEmpty();
+    }
+
+    // check to see if the filterFn has properties asking for Zone props
+    QScriptValue wantsZonePropertiesValue = filterFn.property("wantsZoneProperties");
+    // if the wantsZoneProperties is a boolean, or a string, or list of strings, then evaluate as follows:
+    //   - boolean - true  - include all Zone properties
+    //               false - no properties at all
+    //   - string  - empty - no properties at all
+    //               any valid property - include just that property in the Zone properties
+    //   - list of strings - include only those properties in the Zone properties
+    if (wantsZonePropertiesValue.isBool()) {
+        filterData.wantsZoneProperties = wantsZonePropertiesValue.toBool();
+        filterData.wantsZoneBoundingBox = filterData.wantsZoneProperties; // include this too
+    } else if (wantsZonePropertiesValue.isString()) {
+        auto stringValue = wantsZonePropertiesValue.toString();
+        filterData.wantsZoneProperties = !stringValue.isEmpty();
+        if (filterData.wantsZoneProperties) {
+            if (stringValue == "boundingBox") {
+                filterData.wantsZoneBoundingBox = true;
+            } else {
+                EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
+            }
+        }
+    } else if (wantsZonePropertiesValue.isArray()) {
+        auto length = wantsZonePropertiesValue.property("length").toInteger();
+        for (int i = 0; i < length; i++) {
+            auto stringValue = wantsZonePropertiesValue.property(i).toString();
+            if (!stringValue.isEmpty()) {
+                filterData.wantsZoneProperties = true;
+
+                // boundingBox is a special case since it's not a true EntityPropertyFlag, so we
+                // need to detect it here.
+                if (stringValue == "boundingBox") {
+                    filterData.wantsZoneBoundingBox = true;
+                    break; // we can break here, since there are no other special cases
                 }
 
-                _lock.lockForWrite();
-                _filterDataMap.insert(entityID, filterData);
-                _lock.unlock();
+            }
+        }
+        if (filterData.wantsZoneProperties) {
+            EntityPropertyFlagsFromScriptValue(wantsZonePropertiesValue, filterData.includedZoneProperties);
+        }
+    }
 
-                qDebug() << "script request filter processed for entity id " << entityID;
-                
-                emit filterAdded(entityID, true);
-                return;
+    // the filter can list the properties it doesn't look at, as a string or list of strings, so that the edits
+    // and physics updates that only change those don't wait for the script
+    QScriptValue ignoredPropertiesValue = filterFn.property("ignoredProperties");
+    if (ignoredPropertiesValue.isString() || ignoredPropertiesValue.isArray()) {
+        EntityPropertyFlagsFromScriptValue(ignoredPropertiesValue, filterData.ignoredProperties);
+    }
+
+    if (!filterData.rejectAll) {
+        // the other engines are warmed up now rather than when edits are waiting for them
+        int numEngines = std::max(1, std::min(QThread::idealThreadCount(), MAX_ENGINES_PER_FILTER));
+        filterData.engines = std::make_shared<FilterEnginePool>();
+        filterData.engines->add(std::move(filterEngine));
+        for (int i = 1; i < numEngines; i++) {
+            auto otherEngine = createFilterEngine(entityID, scriptContents, urlString);
+            if (otherEngine && otherEngine->filterFn.isFunction()) {
+                filterData.engines->add(std::move(otherEngine));
             }
-        } 
+        }
+    }
+
+    _lock.lockForWrite();
+    _filterDataMap.insert(entityID, filterData);
+    _lock.unlock();
+
+    qDebug() << "script request filter processed for entity id " << entityID;
+    return true;
+}
+
+void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
+    qDebug() << "script request completed for entity " << entityID;
+    auto scriptRequest = qobject_cast<ResourceRequest*>(sender());
+    if (scriptRequest && scriptRequest->getResult() == ResourceRequest::Success) {
+        const QString urlString = scriptRequest->getUrl().toString();
+        auto scriptContents = scriptRequest->getData();
+        qInfo() << "Downloaded script:" << scriptContents;
+        if (addFilterScript(entityID, scriptContents, urlString)) {
+            emit filterAdded(entityID, true);
+            return;
+        }
     } else if (scriptRequest) {
         const QString urlString = scriptRequest->getUrl().toString();
         qCritical() << "Failed to download script";
@@ -17,7 +17,11 @@
 #include <QScriptEngine>
 #include <glm/glm.hpp>
 
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "EntityItemID.h"
 #include "EntityItemProperties.h"
@@ -26,8 +30,32 @@
 class EntityEditFilters : public QObject, public Dependency {
     Q_OBJECT
 public:
-    struct FilterData {
+    // an engine with the filter script evaluated, ready to filter one edit at a time
+    struct FilterEngine {
+        std::unique_ptr<QScriptEngine> engine;
         QScriptValue filterFn;
+        std::function<bool()> uncaughtExceptions;
+    };
+
+    // The engines of a filter, so that several edits can be filtered at once. An engine is borrowed for one
+    // filter call and returned when the BorrowedEngine goes out of scope; callers wait when all are in use.
+    class FilterEnginePool {
+    public:
+        using BorrowedEngine = std::unique_ptr<FilterEngine, std::function<void(FilterEngine*)>>;
+
+        void add(std::unique_ptr<FilterEngine> engine);
+        BorrowedEngine borrow();
+        bool isEmpty() const { return _engines.empty(); }
+
+    private:
+        std::vector<std::unique_ptr<FilterEngine>> _engines;
+        std::vector<FilterEngine*> _availableEngines;
+        std::mutex _mutex;
+        std::condition_variable _engineReturned;
+    };
+
+    struct FilterData {
+        std::shared_ptr<FilterEnginePool> engines;
         bool wantsOriginalProperties { false };
         bool wantsZoneProperties { false };
 
@@ -40,12 +68,13 @@ public:
         EntityPropertyFlags includedZoneProperties;
         bool wantsZoneBoundingBox { false };
 
-        std::function<bool()> uncaughtExceptions;
-        QScriptEngine* engine;
+        // edits and physics updates that only change these properties are accepted without running the filter
+        EntityPropertyFlags ignoredProperties;
+
         bool rejectAll;
         
-        FilterData(): engine(nullptr), rejectAll(false) {};
-        bool valid() { return (rejectAll || (engine != nullptr && filterFn.isFunction() && uncaughtExceptions)); }
+        FilterData(): rejectAll(false) {};
+        bool valid() { return (rejectAll || (engines && !engines->isEmpty())); }
     };
 
     EntityEditFilters() {};
@@ -53,7 +82,12 @@ public:
 
     void addFilter(EntityItemID entityID, QString filterURL);
     void removeFilter(EntityItemID entityID);
+    bool hasFilters();
+
+    // loads a downloaded filter script into its pool of engines
+    bool addFilterScript(EntityItemID entityID, const QString& scriptContents, const QString& urlString);
 
+    // can be called from several threads at once
     bool filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, 
                 EntityTree::FilterType filterType, EntityItemID& entityID, EntityItemPointer& existingEntity);
 
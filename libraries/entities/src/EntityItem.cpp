@@ -37,6 +37,7 @@
 
 #include "EntityScriptingInterface.h"
 #include "EntitiesLogging.h"
+#include "EntityQueryFilter.h"
 #include "EntityTree.h"
 #include "EntitySimulation.h"
 #include "EntityDynamicFactoryInterface.h"
@@ -63,8 +64,8 @@ EntityItem::EntityItem(const EntityItemID& entityItemID) :
     locationChanged();
     dimensionsChanged();
     quint64 now = usecTimestampNow();
-    _lastSimulated = now;
-    _lastUpdated = now;
+    _lastSimulated.set(now);
+    _lastUpdated.set(now);
 }
 
 EntityItem::~EntityItem() {
@@ -235,7 +236,7 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         successTypeFits = packetData->appendRawData(encodedType);
     }
     if (successTypeFits) {
-        successCreatedFits = packetData->appendValue(_created);
+        successCreatedFits = packetData->appendValue(_created.get());
     }
     if (successCreatedFits) {
         successLastEditedFits = packetData->appendValue(lastEdited);
@@ -504,13 +505,13 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
             Q_ASSERT(parser.offset() == (unsigned int) bytesRead);
         }
 #endif
-        if (_created == UNKNOWN_CREATED_TIME) {
+        if (_created.get() == UNKNOWN_CREATED_TIME) {
             // we don't yet have a _created timestamp, so we accept this one
             createdFromBuffer -= clockSkew;
             if (createdFromBuffer > now || createdFromBuffer == UNKNOWN_CREATED_TIME) {
                 createdFromBuffer = now;
             }
-            _created = createdFromBuffer;
+            _created.set(createdFromBuffer);
         }
     }
 
@@ -525,7 +526,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         qCDebug(entities) << "------------------------------------------";
         debugDump();
         qCDebug(entities) << "------------------------------------------";
-        qCDebug(entities) << "    _created =" << _created;
+        qCDebug(entities) << "    _created =" << _created.get();
         qCDebug(entities) << "    age=" << getAge() << "seconds - " << ageAsString;
         qCDebug(entities) << "    lastEdited =" << lastEdited;
         qCDebug(entities) << "    ago=" << editedAgo << "seconds - " << agoAsString;
@@ -574,14 +575,14 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
     if (fromSameServerEdit) {
         // If this is from the same sever packet, then check against any local changes since we got
         // the most recent packet from this server time
-        if (_lastEdited > _lastEditedFromRemote) {
+        if (_lastEdited.get() > _lastEditedFromRemote) {
             ignoreServerPacket = true;
         }
     } else {
         // If this isn't from the same sever packet, then honor our skew adjusted times...
         // If we've changed our local tree more recently than the new data from this packet
         // then we will not be changing our values, instead we just read and skip the data
-        if (_lastEdited > lastEditedFromBufferAdjusted) {
+        if (_lastEdited.get() > lastEditedFromBufferAdjusted) {
             ignoreServerPacket = true;
         }
     }
@@ -611,7 +612,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
         #endif
 
         // don't allow _lastEdited to be in the future
-        _lastEdited = lastEditedFromBufferAdjusted;
+        _lastEdited.set(lastEditedFromBufferAdjusted);
         _lastEditedFromRemote = now;
         _lastEditedFromRemoteInRemoteTime = lastEditedFromBuffer;
 
@@ -637,10 +638,11 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
 #endif
 
     if (overwriteLocalData) {
-        _lastUpdated = lastEditedFromBufferAdjusted + updateDelta; // don't adjust for clock skew since we already did that
+        // don't adjust for clock skew since we already did that
+        _lastUpdated.set(lastEditedFromBufferAdjusted + updateDelta);
         #ifdef WANT_DEBUG
-            qCDebug(entities) << "                           _lastUpdated:" << debugTime(_lastUpdated, now);
-            qCDebug(entities) << "                            _lastEdited:" << debugTime(_lastEdited, now);
+            qCDebug(entities) << "                           _lastUpdated:" << debugTime(_lastUpdated.get(), now);
+            qCDebug(entities) << "                            _lastEdited:" << debugTime(_lastEdited.get(), now);
             qCDebug(entities) << "           lastEditedFromBufferAdjusted:" << debugTime(lastEditedFromBufferAdjusted, now);
         #endif
     }
@@ -669,7 +671,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
             lastSimulatedFromBufferAdjusted = now;
         }
         #ifdef WANT_DEBUG
-            qCDebug(entities) << "                            _lastEdited:" << debugTime(_lastEdited, now);
+            qCDebug(entities) << "                            _lastEdited:" << debugTime(_lastEdited.get(), now);
             qCDebug(entities) << "           lastEditedFromBufferAdjusted:" << debugTime(lastEditedFromBufferAdjusted, now);
             qCDebug(entities) << "        lastSimulatedFromBufferAdjusted:" << debugTime(lastSimulatedFromBufferAdjusted, now);
         #endif
@@ -989,7 +991,7 @@ int EntityItem::readEntityDataFromBuffer(const unsigned char* data, int bytesLef
 
     if (overwriteLocalData) {
         if (!_simulationOwner.matchesValidID(myNodeID)) {
-            _lastSimulated = now;
+            _lastSimulated.set(now);
         }
     }
 
@@ -1042,8 +1044,8 @@ float EntityItem::computeMass() const {
 void EntityItem::setDensity(float density) {
     float clampedDensity = glm::max(glm::min(density, ENTITY_ITEM_MAX_DENSITY), ENTITY_ITEM_MIN_DENSITY);
     withWriteLock([&] {
-        if (_density != clampedDensity) {
-            _density = clampedDensity;
+        if (_density.get() != clampedDensity) {
+            _density.set(clampedDensity);
             _flags |= Simulation::DIRTY_MASS;
         }
     });
@@ -1066,8 +1068,8 @@ void EntityItem::setMass(float mass) {
         newDensity = glm::max(glm::min(mass / volume, ENTITY_ITEM_MAX_DENSITY), ENTITY_ITEM_MIN_DENSITY);
     }
     withWriteLock([&] {
-        if (_density != newDensity) {
-            _density = newDensity;
+        if (_density.get() != newDensity) {
+            _density.set(newDensity);
             _flags |= Simulation::DIRTY_MASS;
         }
     });
@@ -1115,7 +1117,7 @@ void EntityItem::simulate(const quint64& now) {
         qCDebug(entities) << "    entity ID=" << getEntityItemID();
         qCDebug(entities) << "    simulator ID=" << getSimulatorID();
         qCDebug(entities) << "    now=" << now;
-        qCDebug(entities) << "    _lastSimulated=" << _lastSimulated;
+        qCDebug(entities) << "    _lastSimulated=" << _lastSimulated.get();
         qCDebug(entities) << "    timeElapsed=" << timeElapsed;
         qCDebug(entities) << "    hasVelocity=" << hasVelocity();
         qCDebug(entities) << "    hasGravity=" << hasGravity();
@@ -1146,7 +1148,7 @@ void EntityItem::simulate(const quint64& now) {
             qCDebug(entities) << "        getAge()=" << getAge();
             qCDebug(entities) << "        getLifetime()=" << getLifetime();
         }
-        qCDebug(entities) << "     ********** EntityItem::simulate() .... SETTING _lastSimulated=" << _lastSimulated;
+        qCDebug(entities) << "     ********** EntityItem::simulate() .... SETTING _lastSimulated=" << _lastSimulated.get();
     #endif
 
     if (!stepKinematicMotion(timeElapsed)) {
@@ -1573,31 +1575,31 @@ bool EntityItem::setProperties(const EntityItemProperties& properties) {
             // anything that sets the transform or velocity must update _lastSimulated which is used
             // for kinematic extrapolation (e.g. we want to extrapolate forward from this moment
             // when position and/or velocity was changed).
-            _lastSimulated = now;
+            _lastSimulated.set(now);
         }
     }
 
     // timestamps
     quint64 timestamp = properties.getCreated();
-    if (_created == UNKNOWN_CREATED_TIME && timestamp != UNKNOWN_CREATED_TIME) {
+    if (_created.get() == UNKNOWN_CREATED_TIME && timestamp != UNKNOWN_CREATED_TIME) {
         quint64 now = usecTimestampNow();
         if (timestamp > now) {
             timestamp = now;
         }
-        _created = timestamp;
+        _created.set(timestamp);
     }
 
     return somethingChanged;
 }
 
 void EntityItem::recordCreationTime() {
-    if (_created == UNKNOWN_CREATED_TIME) {
-        _created = usecTimestampNow();
+    if (_created.get() == UNKNOWN_CREATED_TIME) {
+        _created.set(usecTimestampNow());
     }
     auto now = usecTimestampNow();
-    _lastEdited = _created;
-    _lastUpdated = now;
-    _lastSimulated = now;
+    _lastEdited.set(_created.get());
+    _lastUpdated.set(now);
+    _lastSimulated.set(now);
 }
 
 const Transform EntityItem::getTransformToCenter(bool& success) const {
@@ -1619,7 +1621,8 @@ AACube EntityItem::getMaximumAACube(bool& success) const {
             // we want to compute the furthestExtent that an entity can extend out from its "position"
             // to do this we compute the max of these two vec3s: registration and 1-registration
             // and then scale by dimensions
-            glm::vec3 maxExtents = getScaledDimensions() * glm::max(_registrationPoint, glm::vec3(1.0f) - _registrationPoint);
+            glm::vec3 registrationPoint = _registrationPoint.get();
+            glm::vec3 maxExtents = getScaledDimensions() * glm::max(registrationPoint, glm::vec3(1.0f) - registrationPoint);
 
             // there exists a sphere that contains maxExtents for all rotations
             float radius = glm::length(maxExtents);
@@ -1645,8 +1648,9 @@ AACube EntityItem::getMinimumAACube(bool& success) const {
         if (success) {
             _recalcMinAACube = false;
             glm::vec3 dimensions = getScaledDimensions();
-            glm::vec3 unrotatedMinRelativeToEntity = - (dimensions * _registrationPoint);
-            glm::vec3 unrotatedMaxRelativeToEntity = dimensions * (glm::vec3(1.0f, 1.0f, 1.0f) - _registrationPoint);
+            glm::vec3 registrationPoint = _registrationPoint.get();
+            glm::vec3 unrotatedMinRelativeToEntity = - (dimensions * registrationPoint);
+            glm::vec3 unrotatedMaxRelativeToEntity = dimensions * (glm::vec3(1.0f, 1.0f, 1.0f) - registrationPoint);
             Extents extents = { unrotatedMinRelativeToEntity, unrotatedMaxRelativeToEntity };
             extents.rotate(getWorldOrientation());
 
@@ -1675,8 +1679,9 @@ AABox EntityItem::getAABox(bool& success) const {
         if (success) {
             _recalcAABox = false;
             glm::vec3 dimensions = getScaledDimensions();
-            glm::vec3 unrotatedMinRelativeToEntity = - (dimensions * _registrationPoint);
-            glm::vec3 unrotatedMaxRelativeToEntity = dimensions * (glm::vec3(1.0f, 1.0f, 1.0f) - _registrationPoint);
+            glm::vec3 registrationPoint = _registrationPoint.get();
+            glm::vec3 unrotatedMinRelativeToEntity = - (dimensions * registrationPoint);
+            glm::vec3 unrotatedMaxRelativeToEntity = dimensions * (glm::vec3(1.0f, 1.0f, 1.0f) - registrationPoint);
             Extents extents = { unrotatedMinRelativeToEntity, unrotatedMaxRelativeToEntity };
             extents.rotate(getWorldOrientation());
 
@@ -1718,7 +1723,7 @@ float EntityItem::getRadius() const {
 }
 
 void EntityItem::adjustShapeInfoByRegistration(ShapeInfo& info) const {
-    if (_registrationPoint != ENTITY_ITEM_DEFAULT_REGISTRATION_POINT) {
+    if (_registrationPoint.get() != ENTITY_ITEM_DEFAULT_REGISTRATION_POINT) {
         glm::mat4 scale = glm::scale(getScaledDimensions());
         glm::mat4 registration = scale * glm::translate(ENTITY_ITEM_DEFAULT_REGISTRATION_POINT - getRegistrationPoint());
         glm::vec3 regTransVec = glm::vec3(registration[3]); // extract position component from matrix
@@ -1792,10 +1797,10 @@ float EntityItem::getVolumeEstimate() const {
 }
 
 void EntityItem::setRegistrationPoint(const glm::vec3& value) {
-    if (value != _registrationPoint) {
+    if (value != _registrationPoint.get()) {
         withWriteLock([&] {
-            _registrationPoint = glm::clamp(value, glm::vec3(ENTITY_ITEM_MIN_REGISTRATION_POINT), 
-                                                   glm::vec3(ENTITY_ITEM_MAX_REGISTRATION_POINT));
+            _registrationPoint.set(glm::clamp(value, glm::vec3(ENTITY_ITEM_MIN_REGISTRATION_POINT),
+                                              glm::vec3(ENTITY_ITEM_MAX_REGISTRATION_POINT)));
         });
         dimensionsChanged(); // Registration Point affects the bounding box
         markDirtyFlags(Simulation::DIRTY_SHAPE);
@@ -1904,7 +1909,7 @@ void EntityItem::setUnscaledDimensions(const glm::vec3& value) {
     const float MIN_SCALE_CHANGE_SQUARED = 1.0e-6f;
     if (glm::length2(getUnscaledDimensions() - newDimensions) > MIN_SCALE_CHANGE_SQUARED) {
         withWriteLock([&] {
-            _unscaledDimensions = newDimensions;
+            _unscaledDimensions.set(newDimensions);
         });
         locationChanged();
         dimensionsChanged();
@@ -1916,9 +1921,7 @@ void EntityItem::setUnscaledDimensions(const glm::vec3& value) {
 }
 
 glm::vec3 EntityItem::getUnscaledDimensions() const {
-   return resultWithReadLock<glm::vec3>([&] {
-        return _unscaledDimensions;
-    });
+    return _unscaledDimensions.get();
 }
 
 void EntityItem::setRotation(glm::quat rotation) {
@@ -1957,8 +1960,8 @@ void EntityItem::setVelocity(const glm::vec3& value) {
 void EntityItem::setDamping(float value) {
     auto clampedDamping = glm::clamp(value, ENTITY_ITEM_MIN_DAMPING, ENTITY_ITEM_MAX_DAMPING);
     withWriteLock([&] {
-        if (_damping != clampedDamping) {
-            _damping = clampedDamping;
+        if (_damping.get() != clampedDamping) {
+            _damping.set(clampedDamping);
             _flags |= Simulation::DIRTY_MATERIAL;
         }
     });
@@ -1966,14 +1969,14 @@ void EntityItem::setDamping(float value) {
 
 void EntityItem::setGravity(const glm::vec3& value) {
     withWriteLock([&] {
-        if (_gravity != value) {
+        if (_gravity.get() != value) {
             float magnitude = glm::length(value);
             if (!glm::isnan(magnitude)) {
                 const float MAX_ACCELERATION_OF_GRAVITY = 10.0f * 9.8f; // 10g
                 if (magnitude > MAX_ACCELERATION_OF_GRAVITY) {
-                    _gravity = (MAX_ACCELERATION_OF_GRAVITY / magnitude) * value;
+                    _gravity.set((MAX_ACCELERATION_OF_GRAVITY / magnitude) * value);
                 } else {
-                    _gravity = value;
+                    _gravity.set(value);
                 }
                 _flags |= Simulation::DIRTY_LINEAR_VELOCITY;
             }
@@ -2004,8 +2007,8 @@ void EntityItem::setAngularVelocity(const glm::vec3& value) {
 void EntityItem::setAngularDamping(float value) {
     auto clampedDamping = glm::clamp(value, ENTITY_ITEM_MIN_DAMPING, ENTITY_ITEM_MAX_DAMPING);
     withWriteLock([&] {
-        if (_angularDamping != clampedDamping) {
-            _angularDamping = clampedDamping;
+        if (_angularDamping.get() != clampedDamping) {
+            _angularDamping.set(clampedDamping);
             _flags |= Simulation::DIRTY_MATERIAL;
         }
     });
@@ -2050,8 +2053,8 @@ void EntityItem::setDynamic(bool value) {
 void EntityItem::setRestitution(float value) {
     float clampedValue = glm::max(glm::min(ENTITY_ITEM_MAX_RESTITUTION, value), ENTITY_ITEM_MIN_RESTITUTION);
     withWriteLock([&] {
-        if (_restitution != clampedValue) {
-            _restitution = clampedValue;
+        if (_restitution.get() != clampedValue) {
+            _restitution.set(clampedValue);
             _flags |= Simulation::DIRTY_MATERIAL;
         }
     });
@@ -2061,8 +2064,8 @@ void EntityItem::setRestitution(float value) {
 void EntityItem::setFriction(float value) {
     float clampedValue = glm::max(glm::min(ENTITY_ITEM_MAX_FRICTION, value), ENTITY_ITEM_MIN_FRICTION);
     withWriteLock([&] {
-        if (_friction != clampedValue) {
-            _friction = clampedValue;
+        if (_friction.get() != clampedValue) {
+            _friction.set(clampedValue);
             _flags |= Simulation::DIRTY_MATERIAL;
         }
     });
@@ -2070,8 +2073,8 @@ void EntityItem::setFriction(float value) {
 
 void EntityItem::setLifetime(float value) {
     withWriteLock([&] {
-        if (_lifetime != value) {
-            _lifetime = value;
+        if (_lifetime.get() != value) {
+            _lifetime.set(value);
             _flags |= Simulation::DIRTY_LIFETIME;
         }
     });
@@ -2079,8 +2082,8 @@ void EntityItem::setLifetime(float value) {
 
 void EntityItem::setCreated(quint64 value) {
     withWriteLock([&] {
-        if (_created != value) {
-            _created = value;
+        if (_created.get() != value) {
+            _created.set(value);
             _flags |= Simulation::DIRTY_LIFETIME;
         }
     });
@@ -2655,60 +2658,44 @@ void EntityItem::globalizeProperties(EntityItemProperties& properties, const QSt
 }
 
 
-bool EntityItem::matchesJSONFilters(const QJsonObject& jsonFilters) const {
+bool EntityItem::matchesQueryFilter(const EntityQueryFilter& filter) const {
 
-    // The intention for the query JSON filter and this method is to be flexible to handle a variety of filters for
+    // The intention for the query filter and this method is to be flexible to handle a variety of filters for
     // ALL entity properties. Some work will need to be done to the property system so that it can be more flexible
     // (to grab the value and default value of a property given the string representation of that property, for example)
 
-    // currently the only property filter we handle in EntityItem is '+' for serverScripts
-    // which means that we only handle a filtered query asking for entities where the serverScripts property is non-default
-
-    static const QString SERVER_SCRIPTS_PROPERTY = "serverScripts";
-    static const QString ENTITY_TYPE_PROPERTY = "type";
+    // currently the only property filters we handle in EntityItem are '+' for serverScripts, which means
+    // entities where the serverScripts property is non-default, and the entity type
 
-    foreach(const auto& property, jsonFilters.keys()) {
-        if (property == SERVER_SCRIPTS_PROPERTY && jsonFilters[property] == EntityQueryFilterSymbol::NonDefault) {
-            // check if this entity has a non-default value for serverScripts
-            if (_serverScripts != ENTITY_ITEM_DEFAULT_SERVER_SCRIPTS) {
-                return true;
-            } else {
-                return false;
-            }
-        } else if (property == ENTITY_TYPE_PROPERTY) {
-            return (jsonFilters[property] == EntityTypes::getEntityTypeName(getType()) );
-        }
+    if (filter.wantsNonDefaultServerScripts()) {
+        return hasServerScripts();
+    }
+    if (filter.hasType()) {
+        return getType() == filter.getType();
     }
 
-    // the json filter syntax did not match what we expected, return a match
+    // the filter syntax did not match what we expected, return a match
     return true;
 }
 
 quint64 EntityItem::getLastSimulated() const {
-    quint64 result;
-    withReadLock([&] {
-        result = _lastSimulated;
-    });
-    return result;
+    return _lastSimulated.get();
 }
 
 void EntityItem::setLastSimulated(quint64 now) {
     withWriteLock([&] {
-        _lastSimulated = now;
+        _lastSimulated.set(now);
     });
 }
 
 quint64 EntityItem::getLastEdited() const {
-    quint64 result;
-    withReadLock([&] {
-        result = _lastEdited;
-    });
-    return result;
+    return _lastEdited.get();
 }
 
 void EntityItem::setLastEdited(quint64 lastEdited) {
     withWriteLock([&] {
-        _lastEdited = _lastUpdated = lastEdited;
+        _lastEdited.set(lastEdited);
+        _lastUpdated.set(lastEdited);
         _changedOnServer = glm::max(lastEdited, _changedOnServer);
     });
 }
@@ -2729,16 +2716,12 @@ quint64 EntityItem::getLastChangedOnServer() const {
 
 void EntityItem::update(const quint64& now) {
     withWriteLock([&] {
-        _lastUpdated = now;
+        _lastUpdated.set(now);
     });
 }
 
 quint64 EntityItem::getLastUpdated() const {
-    quint64 result;
-    withReadLock([&] {
-        result = _lastUpdated;
-    });
-    return result;
+    return _lastUpdated.get();
 }
 
 void EntityItem::requiresRecalcBoxes() {
@@ -2772,66 +2755,38 @@ void EntityItem::setDescription(const QString& value) {
 }
 
 glm::vec3 EntityItem::getGravity() const {
-    glm::vec3 result;
-    withReadLock([&] {
-        result = _gravity;
-    });
-    return result;
+    return _gravity.get();
 }
 
 glm::vec3 EntityItem::getAcceleration() const {
-    glm::vec3 result;
-    withReadLock([&] {
-        result = _acceleration;
-    });
-    return result;
+    return _acceleration.get();
 }
 
 void EntityItem::setAcceleration(const glm::vec3& value) {
     withWriteLock([&] {
-        _acceleration = value;
+        _acceleration.set(value);
     });
 }
 
 float EntityItem::getDamping() const {
-    float result;
-    withReadLock([&] {
-        result = _damping;
-    });
-    return result;
+    return _damping.get();
 }
 
 float EntityItem::getRestitution() const {
-    float result;
-    withReadLock([&] {
-        result = _restitution;
-    });
-    return result;
+    return _restitution.get();
 }
 
 float EntityItem::getFriction() const {
-    float result;
-    withReadLock([&] {
-        result = _friction;
-    });
-    return result;
+    return _friction.get();
 }
 
 // lifetime related properties.
 float EntityItem::getLifetime() const {
-    float result;
-    withReadLock([&] {
-        result = _lifetime;
-    });
-    return result;
+    return _lifetime.get();
 }
 
 quint64 EntityItem::getCreated() const {
-    quint64 result;
-    withReadLock([&] {
-        result = _created;
-    });
-    return result;
+    return _created.get();
 }
 
 QString EntityItem::getScript() const {
@@ -2870,11 +2825,27 @@ QString EntityItem::getServerScripts() const {
     return result;
 }
 
+bool EntityItem::hasServerScripts() const {
+    return resultWithReadLock<bool>([&] {
+        return _serverScripts != ENTITY_ITEM_DEFAULT_SERVER_SCRIPTS;
+    });
+}
+
 void EntityItem::setServerScripts(const QString& serverScripts) {
+    bool hadServerScripts;
+    bool hasServerScripts;
     withWriteLock([&] {
+        hadServerScripts = _serverScripts != ENTITY_ITEM_DEFAULT_SERVER_SCRIPTS;
         _serverScripts = serverScripts;
         _serverScriptsChangedTimestamp = usecTimestampNow();
+        hasServerScripts = _serverScripts != ENTITY_ITEM_DEFAULT_SERVER_SCRIPTS;
     });
+    if (hasServerScripts != hadServerScripts) {
+        EntityTreePointer tree = getTree();
+        if (tree) {
+            tree->updateServerScriptsIndex(getEntityItemID());
+        }
+    }
 }
 
 QString EntityItem::getCollisionSoundURL() const {
@@ -2886,19 +2857,11 @@ QString EntityItem::getCollisionSoundURL() const {
 }
 
 glm::vec3 EntityItem::getRegistrationPoint() const {
-    glm::vec3 result;
-    withReadLock([&] {
-        result = _registrationPoint;
-    });
-    return result;
+    return _registrationPoint.get();
 }
 
 float EntityItem::getAngularDamping() const {
-    float result;
-    withReadLock([&] {
-        result = _angularDamping;
-    });
-    return result;
+    return _angularDamping.get();
 }
 
 QString EntityItem::getName() const {
@@ -3184,11 +3147,7 @@ void EntityItem::clearSpecialFlags(uint32_t mask) {
 }
 
 float EntityItem::getDensity() const {
-    float result;
-    withReadLock([&] {
-        result = _density;
-    });
-    return result;
+    return _density.get();
 }
 
 EntityItem::ChangeHandlerId EntityItem::registerChangeHandler(const ChangeHandlerCallback& handler) {
@@ -3207,6 +3166,14 @@ void EntityItem::deregisterChangeHandler(const ChangeHandlerId& changeHandlerId)
 
 void EntityItem::somethingChangedNotification() {
     auto id = getEntityItemID();
+    if (!_queuedForQueryIndex.exchange(true)) {
+        EntityTreePointer tree = getTree();
+        if (tree) {
+            tree->queueQueryIndexUpdate(id);
+        } else {
+            _queuedForQueryIndex = false;
+        }
+    }
     withReadLock([&] {
         for (const auto& handler : _changeHandlers.values()) {
             handler(id);
@@ -28,6 +28,7 @@
 #include <Transform.h>
 #include <SpatiallyNestable.h>
 #include <Interpolate.h>
+#include <shared/SeqLocked.h>
 
 #include "EntityItemID.h"
 #include "EntityItemPropertiesDefaults.h"
@@ -43,6 +44,7 @@ class EntityTreeElement;
 class EntityTreeElementExtraEncodeData;
 class EntityDynamicInterface;
 class EntityItemProperties;
+class EntityQueryFilter;
 class EntityTree;
 class btCollisionShape;
 typedef std::shared_ptr<EntityTree> EntityTreePointer;
@@ -267,6 +269,7 @@ public:
 
     QString getServerScripts() const;
     void setServerScripts(const QString& serverScripts);
+    bool hasServerScripts() const; // non-default serverScripts
 
     QString getCollisionSoundURL() const;
     void setCollisionSoundURL(const QString& value);
@@ -527,7 +530,7 @@ public:
     QUuid getLastEditedBy() const { return _lastEditedBy; }
     void setLastEditedBy(QUuid value) { _lastEditedBy = value; }
 
-    virtual bool matchesJSONFilters(const QJsonObject& jsonFilters) const;
+    virtual bool matchesQueryFilter(const EntityQueryFilter& filter) const;
 
     virtual bool getMeshes(MeshProxyList& result) { return true; }
 
@@ -577,6 +580,8 @@ public:
     bool needsRenderUpdate() const { return resultWithReadLock<bool>([&] { return _needsRenderUpdate; }); }
     void setNeedsRenderUpdate(bool needsRenderUpdate) { withWriteLock([&] { _needsRenderUpdate = needsRenderUpdate; }); }
 
+    void clearQueuedForQueryIndex() { _queuedForQueryIndex = false; }
+
 signals:
     void spaceUpdate(std::pair<int32_t, glm::vec4> data);
 
@@ -593,18 +598,22 @@ protected:
 
     virtual void dimensionsChanged() override;
 
-    glm::vec3 _unscaledDimensions { ENTITY_ITEM_DEFAULT_DIMENSIONS };
+    // The properties read every frame by the simulation, physics, rendering and the senders are SeqLocked: reading
+    // them doesn't take the entity's lock. Their setters still take the write lock, to keep them consistent with the
+    // dirty flags and the rest of the properties.
+    SeqLocked<glm::vec3> _unscaledDimensions { ENTITY_ITEM_DEFAULT_DIMENSIONS };
     EntityTypes::EntityType _type { EntityTypes::Unknown };
-    quint64 _lastSimulated { 0 }; // last time this entity called simulate(), this includes velocity, angular velocity,
-                            // and physics changes
-    quint64 _lastUpdated { 0 }; // last time this entity called update(), this includes animations and non-physics changes
-    quint64 _lastEdited { 0 }; // last official local or remote edit time
+    SeqLocked<quint64> _lastSimulated { 0 }; // last time this entity called simulate(), this includes velocity,
+                                             // angular velocity, and physics changes
+    SeqLocked<quint64> _lastUpdated { 0 }; // last time this entity called update(), this includes animations and
+                                           // non-physics changes
+    SeqLocked<quint64> _lastEdited { 0 }; // last official local or remote edit time
     QUuid _lastEditedBy { ENTITY_ITEM_DEFAULT_LAST_EDITED_BY }; // id of last editor
     quint64 _lastBroadcast; // the last time we sent an edit packet about this entity
 
     quint64 _lastEditedFromRemote { 0 }; // last time we received and edit from the server
     quint64 _lastEditedFromRemoteInRemoteTime { 0 }; // last time we received an edit from the server (in server-time-frame)
-    quint64 _created { 0 };
+    SeqLocked<quint64> _created { 0 };
     quint64 _changedOnServer { 0 };
 
     mutable AABox _cachedAABox;
@@ -614,17 +623,17 @@ protected:
     mutable bool _recalcMinAACube { true };
     mutable bool _recalcMaxAACube { true };
 
-    float _density { ENTITY_ITEM_DEFAULT_DENSITY }; // kg/m^3
+    SeqLocked<float> _density { ENTITY_ITEM_DEFAULT_DENSITY }; // kg/m^3
     // NOTE: _volumeMultiplier is used to allow some mass properties code exist in the EntityItem base class
     // rather than in all of the derived classes.  If we ever collapse these classes to one we could do it a
     // different way.
     float _volumeMultiplier { 1.0f };
-    glm::vec3 _gravity { ENTITY_ITEM_DEFAULT_GRAVITY };
-    glm::vec3 _acceleration { ENTITY_ITEM_DEFAULT_ACCELERATION };
-    float _damping { ENTITY_ITEM_DEFAULT_DAMPING };
-    float _restitution { ENTITY_ITEM_DEFAULT_RESTITUTION };
-    float _friction { ENTITY_ITEM_DEFAULT_FRICTION };
-    float _lifetime { ENTITY_ITEM_DEFAULT_LIFETIME };
+    SeqLocked<glm::vec3> _gravity { ENTITY_ITEM_DEFAULT_GRAVITY };
+    SeqLocked<glm::vec3> _acceleration { ENTITY_ITEM_DEFAULT_ACCELERATION };
+    SeqLocked<float> _damping { ENTITY_ITEM_DEFAULT_DAMPING };
+    SeqLocked<float> _restitution { ENTITY_ITEM_DEFAULT_RESTITUTION };
+    SeqLocked<float> _friction { ENTITY_ITEM_DEFAULT_FRICTION };
+    SeqLocked<float> _lifetime { ENTITY_ITEM_DEFAULT_LIFETIME };
 
     QString _script { ENTITY_ITEM_DEFAULT_SCRIPT }; /// the value of the script property
     QString _loadedScript; /// the value of _script when the last preload signal was sent
@@ -640,8 +649,8 @@ protected:
     quint64 _loadedScriptTimestamp { ENTITY_ITEM_DEFAULT_SCRIPT_TIMESTAMP + 1 };
 
     QString _collisionSoundURL { ENTITY_ITEM_DEFAULT_COLLISION_SOUND_URL };
-    glm::vec3 _registrationPoint { ENTITY_ITEM_DEFAULT_REGISTRATION_POINT };
-    float _angularDamping { ENTITY_ITEM_DEFAULT_ANGULAR_DAMPING };
+    SeqLocked<glm::vec3> _registrationPoint { ENTITY_ITEM_DEFAULT_REGISTRATION_POINT };
+    SeqLocked<float> _angularDamping { ENTITY_ITEM_DEFAULT_ANGULAR_DAMPING };
     bool _visible { ENTITY_ITEM_DEFAULT_VISIBLE };
     bool _isVisibleInSecondaryCamera { ENTITY_ITEM_DEFAULT_VISIBLE_IN_SECONDARY_CAMERA };
     RenderLayer _renderLayer { RenderLayer::WORLD };
@@ -686,6 +695,7 @@ protected:
     //
 
     // DirtyFlags are set whenever a property changes that the EntitySimulation needs to know about.
+    std::atomic<bool> _queuedForQueryIndex { false }; // already waiting in the tree's EntityQueryIndex queue
     std::atomic_uint _flags { 0 };   // things that have changed from EXTERNAL changes (via script or packet) but NOT from simulation
 
     // these backpointers are only ever set/cleared by friends:
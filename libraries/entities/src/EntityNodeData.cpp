@@ -28,3 +28,11 @@ bool EntityNodeData::isEntityFlaggedAsExtra(const QUuid& entityID) const {
 
     return false;
 }
+
+QSet<QUuid> EntityNodeData::getFlaggedExtraEntities() const {
+    QSet<QUuid> result;
+    foreach(const QSet<QUuid>& entitySet, _flaggedExtraEntities) {
+        result.unite(entitySet);
+    }
+    return result;
+}
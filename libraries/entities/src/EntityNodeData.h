@@ -42,6 +42,7 @@ public:
     bool insertFlaggedExtraEntity(const QUuid& filteredEntityID, const QUuid& extraEntityID);
     
     bool isEntityFlaggedAsExtra(const QUuid& entityID) const;
+    QSet<QUuid> getFlaggedExtraEntities() const;
     void resetFlaggedExtraEntities() { _previousFlaggedExtraEntities = _flaggedExtraEntities; _flaggedExtraEntities.clear(); }
 
 private:
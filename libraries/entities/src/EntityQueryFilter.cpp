@@ -0,0 +1,42 @@
+//
+//  EntityQueryFilter.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryFilter.h"
+
+#include "EntityTree.h"
+
+EntityQueryFilter::EntityQueryFilter(const QJsonObject& jsonFilters) {
+    static const QString SERVER_SCRIPTS_PROPERTY = "serverScripts";
+    static const QString ENTITY_TYPE_PROPERTY = "type";
+    static const QString AVATAR_PRIORITY_PROPERTY = "avatarPriority";
+
+    _wantsNonDefaultServerScripts = jsonFilters.value(SERVER_SCRIPTS_PROPERTY) == EntityQueryFilterSymbol::NonDefault;
+
+    auto typeFilter = jsonFilters.find(ENTITY_TYPE_PROPERTY);
+    if (typeFilter != jsonFilters.end()) {
+        _hasType = true;
+        // a name that isn't a type matches nothing, like Unknown
+        _type = typeFilter.value().isString() ? EntityTypes::getEntityTypeFromName(typeFilter.value().toString())
+                                              : EntityTypes::Unknown;
+    }
+
+    _wantsAvatarPriority = jsonFilters.value(AVATAR_PRIORITY_PROPERTY).toBool();
+}
+
+EntityQueryFilter::Index EntityQueryFilter::getIndex() const {
+    if (_wantsNonDefaultServerScripts) {
+        // zones can still match on their avatarPriority
+        return _wantsAvatarPriority ? Index::None : Index::ServerScripts;
+    }
+    if (_hasType && (!_wantsAvatarPriority || _type == EntityTypes::Zone)) {
+        return Index::Type;
+    }
+    return Index::None;
+}
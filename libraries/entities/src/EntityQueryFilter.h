@@ -0,0 +1,50 @@
+//
+//  EntityQueryFilter.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryFilter_h
+#define hifi_EntityQueryFilter_h
+
+#include <QtCore/QJsonObject>
+
+#include "EntityTypes.h"
+
+// The JSON filter of an entity query (OctreeQuery::getJSONParameters()), parsed once so that it can be tested
+// against every entity the server considers sending without looking up and comparing strings.
+//
+// See EntityItem::matchesQueryFilter(): a non-default serverScripts filter takes precedence over a type filter,
+// unknown keys are ignored and an empty filter matches everything. ZoneEntityItem also lets zones with a
+// non-inherited avatarPriority through when the filter asks for them.
+class EntityQueryFilter {
+public:
+    enum class Index {
+        None, // has to be tested on every entity
+        ServerScripts, // only entities with non-default serverScripts can match
+        Type // only entities of getType() can match
+    };
+
+    EntityQueryFilter() {}
+    explicit EntityQueryFilter(const QJsonObject& jsonFilters);
+
+    bool wantsNonDefaultServerScripts() const { return _wantsNonDefaultServerScripts; }
+    bool hasType() const { return _hasType; }
+    EntityTypes::EntityType getType() const { return _type; }
+    bool wantsAvatarPriority() const { return _wantsAvatarPriority; }
+
+    // the EntityTree secondary index that holds every entity matching this filter
+    Index getIndex() const;
+
+private:
+    bool _wantsNonDefaultServerScripts { false };
+    bool _hasType { false };
+    EntityTypes::EntityType _type { EntityTypes::Unknown };
+    bool _wantsAvatarPriority { false };
+};
+
+#endif // hifi_EntityQueryFilter_h
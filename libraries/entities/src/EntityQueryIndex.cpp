@@ -0,0 +1,384 @@
+//
+//  EntityQueryIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryIndex.h"
+
+#include <algorithm>
+
+#include <glm/gtx/transform.hpp>
+
+#include <GeometryUtil.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "EntityItem.h"
+
+// past this age the snapshot is assumed abandoned (the tree is no longer being updated) and queries go to the tree
+static const uint64_t MAX_SNAPSHOT_AGE_USECS = 500 * USECS_PER_MSEC;
+
+bool EntityQuerySnapshot::checkFilterSettings(uint8_t filterFlags, PickFilter searchFilter) {
+    // keep this logic the same as in EntityTreeElement::checkFilterSettings()
+    bool visible = (filterFlags & VISIBLE) != 0;
+    if ((!searchFilter.doesPickVisible() && visible) || (!searchFilter.doesPickInvisible() && !visible) ||
+        (!searchFilter.doesPickDomainEntities() && (filterFlags & DOMAIN_HOST)) ||
+        (!searchFilter.doesPickAvatarEntities() && (filterFlags & AVATAR_HOST)) ||
+        (!searchFilter.doesPickLocalEntities() && (filterFlags & LOCAL_HOST))) {
+        return false;
+    }
+    if (!(filterFlags & LOCAL_HOST)) {
+        bool collidable = (filterFlags & COLLIDABLE) != 0;
+        if ((collidable && !searchFilter.doesPickCollidable()) || (!collidable && !searchFilter.doesPickNonCollidable())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+void EntityQuerySnapshot::evalSphereCandidates(const glm::vec3& center, float radius, F&& visitor) const {
+    const float radiusSquared = radius * radius;
+    uint8_t touches[CHUNK_SIZE];
+    for (const auto& chunk : _chunks) {
+        const int count = chunk->count;
+        // branch free sphere vs box distance test over the SoA bounds, which the compiler vectorizes
+        for (int i = 0; i < count; ++i) {
+            float dx = std::max(chunk->minX[i] - center.x, 0.0f) + std::max(center.x - chunk->maxX[i], 0.0f);
+            float dy = std::max(chunk->minY[i] - center.y, 0.0f) + std::max(center.y - chunk->maxY[i], 0.0f);
+            float dz = std::max(chunk->minZ[i] - center.z, 0.0f) + std::max(center.z - chunk->maxZ[i], 0.0f);
+            touches[i] = (dx * dx + dy * dy + dz * dz) <= radiusSquared;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (touches[i]) {
+                visitor(chunk->entries[i]);
+            }
+        }
+    }
+}
+
+static bool entryFindSpherePenetration(const EntityQuerySnapshot::Entry& entry, const glm::vec3& center, float radius) {
+    // keep this logic the same as in EntityTreeElement::evalEntitiesInSphere()
+    glm::vec3 penetration;
+    if (!entry.box.findSpherePenetration(center, radius, penetration)) {
+        return false;
+    }
+    if (entry.isSphere) {
+        return entry.sphereRadius >= 0.0f &&
+            findSphereSpherePenetration(center, radius, entry.sphereCenter, entry.sphereRadius, penetration);
+    }
+    glm::vec3 entityFrameSearchPosition = glm::vec3(entry.worldToEntity * glm::vec4(center, 1.0f));
+    return entry.entityFrameBox.findSpherePenetration(entityFrameSearchPosition, radius, penetration);
+}
+
+void EntityQuerySnapshot::evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter,
+                                               QVector<QUuid>& foundEntities) const {
+    evalSphereCandidates(center, radius, [&](const Entry& entry) {
+        if (checkFilterSettings(entry.filterFlags, searchFilter) && entryFindSpherePenetration(entry, center, radius)) {
+            foundEntities.push_back(entry.id);
+        }
+    });
+}
+
+void EntityQuerySnapshot::evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type,
+                                                       PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    evalSphereCandidates(center, radius, [&](const Entry& entry) {
+        if (entry.type == type && checkFilterSettings(entry.filterFlags, searchFilter) &&
+            entryFindSpherePenetration(entry, center, radius)) {
+            foundEntities.push_back(entry.id);
+        }
+    });
+}
+
+void EntityQuerySnapshot::evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    const glm::vec3 boxMin = box.getMinimumPoint();
+    const glm::vec3 boxMax = box.getMaximumPoint();
+    uint8_t overlaps[CHUNK_SIZE];
+    for (const auto& chunk : _chunks) {
+        const int count = chunk->count;
+        for (int i = 0; i < count; ++i) {
+            overlaps[i] = (chunk->minX[i] <= boxMax.x) & (chunk->maxX[i] >= boxMin.x) &
+                (chunk->minY[i] <= boxMax.y) & (chunk->maxY[i] >= boxMin.y) &
+                (chunk->minZ[i] <= boxMax.z) & (chunk->maxZ[i] >= boxMin.z);
+        }
+        for (int i = 0; i < count; ++i) {
+            // the broad phase is a superset; AABox::touches() has the final say so results match the tree query
+            if (overlaps[i]) {
+                const Entry& entry = chunk->entries[i];
+                if (checkFilterSettings(entry.filterFlags, searchFilter) && entry.box.touches(box)) {
+                    foundEntities.push_back(entry.id);
+                }
+            }
+        }
+    }
+}
+
+void EntityQueryOverlay::removeOverlaid(QVector<QUuid>& foundEntities) const {
+    if (_ids.isEmpty()) {
+        return;
+    }
+    foundEntities.erase(std::remove_if(foundEntities.begin(), foundEntities.end(), [&](const QUuid& id) {
+        return _ids.contains(EntityItemID(id));
+    }), foundEntities.end());
+}
+
+void EntityQueryOverlay::evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter,
+                                              QVector<QUuid>& foundEntities) const {
+    removeOverlaid(foundEntities);
+    for (const auto& entry : _entries) {
+        if (EntityQuerySnapshot::checkFilterSettings(entry.filterFlags, searchFilter) &&
+            entryFindSpherePenetration(entry, center, radius)) {
+            foundEntities.push_back(entry.id);
+        }
+    }
+}
+
+void EntityQueryOverlay::evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type,
+                                                      PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    removeOverlaid(foundEntities);
+    for (const auto& entry : _entries) {
+        if (entry.type == type && EntityQuerySnapshot::checkFilterSettings(entry.filterFlags, searchFilter) &&
+            entryFindSpherePenetration(entry, center, radius)) {
+            foundEntities.push_back(entry.id);
+        }
+    }
+}
+
+void EntityQueryOverlay::evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    removeOverlaid(foundEntities);
+    for (const auto& entry : _entries) {
+        if (EntityQuerySnapshot::checkFilterSettings(entry.filterFlags, searchFilter) && entry.box.touches(box)) {
+            foundEntities.push_back(entry.id);
+        }
+    }
+}
+
+void EntityQueryIndex::queueUpdate(const EntityItemID& id) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    _queue.insert(id);
+}
+
+void EntityQueryIndex::notePendingChange(const EntityItemID& id) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        generation = _queueGeneration + 1;
+    }
+    uint64_t appliedGeneration = _appliedGeneration.load();
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+    auto& pending = _pendingChanges[std::this_thread::get_id()];
+    // forget the changes that have been published since, so a thread that never queries doesn't accumulate them
+    for (auto itr = pending.begin(); itr != pending.end();) {
+        if (itr.value() <= appliedGeneration) {
+            itr = pending.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    pending.insert(id, generation);
+}
+
+QVector<EntityItemID> EntityQueryIndex::getPendingChanges(const EntityQuerySnapshot& snapshot) {
+    QVector<EntityItemID> ids;
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+    auto pendingItr = _pendingChanges.find(std::this_thread::get_id());
+    if (pendingItr == _pendingChanges.end()) {
+        return ids;
+    }
+    auto& pending = pendingItr->second;
+    for (auto itr = pending.begin(); itr != pending.end();) {
+        if (itr.value() <= snapshot._appliedGeneration) {
+            itr = pending.erase(itr);
+        } else {
+            ids.push_back(itr.key());
+            ++itr;
+        }
+    }
+    if (pending.isEmpty()) {
+        _pendingChanges.erase(pendingItr);
+    }
+    return ids;
+}
+
+static bool buildEntry(const EntityItemPointer& entity, EntityQuerySnapshot::Entry& entry) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    if (!success) {
+        return false;
+    }
+
+    entry.id = entity->getEntityItemID();
+    entry.type = entity->getType();
+    entry.box = entityBox;
+
+    uint8_t filterFlags = 0;
+    if (entity->isVisible()) {
+        filterFlags |= EntityQuerySnapshot::VISIBLE;
+    }
+    switch (entity->getEntityHostType()) {
+        case entity::HostType::DOMAIN:
+            filterFlags |= EntityQuerySnapshot::DOMAIN_HOST;
+            break;
+        case entity::HostType::AVATAR:
+            filterFlags |= EntityQuerySnapshot::AVATAR_HOST;
+            break;
+        case entity::HostType::LOCAL:
+            filterFlags |= EntityQuerySnapshot::LOCAL_HOST;
+            break;
+    }
+    if (!entity->getCollisionless() && entity->getShapeType() != SHAPE_TYPE_NONE) {
+        filterFlags |= EntityQuerySnapshot::COLLIDABLE;
+    }
+    entry.filterFlags = filterFlags;
+
+    glm::vec3 dimensions = entity->getRaycastDimensions();
+    entry.isSphere = entity->getShapeType() == SHAPE_TYPE_SPHERE && (dimensions.x == dimensions.y && dimensions.y == dimensions.z);
+    if (entry.isSphere) {
+        bool centerSuccess;
+        entry.sphereCenter = entity->getCenterPosition(centerSuccess);
+        // an unknown center never matches, as in the tree query
+        entry.sphereRadius = centerSuccess ? dimensions.x / 2.0f : -1.0f;
+    } else {
+        glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
+        glm::mat4 translation = glm::translate(entity->getWorldPosition());
+        entry.worldToEntity = glm::inverse(translation * rotation);
+        entry.entityFrameBox = AABox(-(dimensions * entity->getRegistrationPoint()), dimensions);
+    }
+    return true;
+}
+
+EntityQueryOverlay EntityQueryIndex::buildOverlay(const QVector<EntityItemID>& ids, const EntityLookup& findEntity) {
+    EntityQueryOverlay overlay;
+    EntityQuerySnapshot::Entry entry;
+    for (const auto& id : ids) {
+        overlay._ids.insert(id);
+        EntityItemPointer entity = findEntity(id);
+        if (entity && buildEntry(entity, entry)) {
+            overlay._entries.push_back(entry);
+        }
+    }
+    return overlay;
+}
+
+EntityQueryIndex::Chunk& EntityQueryIndex::editChunk(int chunkIndex) {
+    auto& chunk = _chunks[chunkIndex];
+    // chunks referenced by a published snapshot are immutable, so copy before writing
+    if (chunk.use_count() > 1) {
+        chunk = std::make_shared<Chunk>(*chunk);
+    }
+    return *chunk;
+}
+
+void EntityQueryIndex::setEntry(int slot, const EntityQuerySnapshot::Entry& entry) {
+    Chunk& chunk = editChunk(slot / EntityQuerySnapshot::CHUNK_SIZE);
+    int i = slot % EntityQuerySnapshot::CHUNK_SIZE;
+    glm::vec3 minimum = entry.box.getMinimumPoint();
+    glm::vec3 maximum = entry.box.getMaximumPoint();
+    chunk.minX[i] = minimum.x;
+    chunk.minY[i] = minimum.y;
+    chunk.minZ[i] = minimum.z;
+    chunk.maxX[i] = maximum.x;
+    chunk.maxY[i] = maximum.y;
+    chunk.maxZ[i] = maximum.z;
+    chunk.entries[i] = entry;
+    chunk.count = std::max(chunk.count, i + 1);
+}
+
+void EntityQueryIndex::removeEntry(const EntityItemID& id) {
+    auto itr = _slots.find(id);
+    if (itr == _slots.end()) {
+        return;
+    }
+    int slot = itr.value();
+    _slots.erase(itr);
+
+    // fill the hole with the last entry so the chunks stay dense
+    int lastSlot = _numEntities - 1;
+    if (slot != lastSlot) {
+        const Chunk& lastChunk = *_chunks[lastSlot / EntityQuerySnapshot::CHUNK_SIZE];
+        EntityQuerySnapshot::Entry lastEntry = lastChunk.entries[lastSlot % EntityQuerySnapshot::CHUNK_SIZE];
+        setEntry(slot, lastEntry);
+        _slots[lastEntry.id] = slot;
+    }
+    editChunk(lastSlot / EntityQuerySnapshot::CHUNK_SIZE).count--;
+    if (_chunks.back()->count == 0) {
+        _chunks.pop_back();
+    }
+    _numEntities--;
+}
+
+void EntityQueryIndex::update(const EntityLookup& findEntity) {
+    uint64_t now = usecTimestampNow();
+    QSet<EntityItemID> queue;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        queue.swap(_queue);
+        generation = ++_queueGeneration;
+    }
+    if (queue.empty() && std::atomic_load(&_snapshot)) {
+        _lastUpdate.store(now);
+        return;
+    }
+
+    EntityQuerySnapshot::Entry entry;
+    for (const auto& id : queue) {
+        EntityItemPointer entity = findEntity(id);
+        if (entity) {
+            // clear before reading so a change made while we copy queues the entity again
+            entity->clearQueuedForQueryIndex();
+        }
+        if (!entity || !buildEntry(entity, entry)) {
+            removeEntry(id);
+            continue;
+        }
+        auto itr = _slots.find(id);
+        if (itr != _slots.end()) {
+            setEntry(itr.value(), entry);
+        } else {
+            int slot = _numEntities++;
+            if (slot / EntityQuerySnapshot::CHUNK_SIZE >= (int)_chunks.size()) {
+                _chunks.push_back(std::make_shared<Chunk>());
+            }
+            _slots.insert(id, slot);
+            setEntry(slot, entry);
+        }
+    }
+
+    auto snapshot = std::make_shared<EntityQuerySnapshot>();
+    snapshot->_chunks.assign(_chunks.begin(), _chunks.end());
+    snapshot->_numEntities = _numEntities;
+    snapshot->_epoch = ++_epoch;
+    snapshot->_appliedGeneration = generation;
+    std::atomic_store(&_snapshot, EntityQuerySnapshotPointer(snapshot));
+    _appliedGeneration.store(generation);
+    _lastUpdate.store(now);
+}
+
+void EntityQueryIndex::clear() {
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _queue.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pendingChanges.clear();
+    }
+    _slots.clear();
+    _chunks.clear();
+    _numEntities = 0;
+    std::atomic_store(&_snapshot, EntityQuerySnapshotPointer());
+    _lastUpdate.store(0);
+}
+
+EntityQuerySnapshotPointer EntityQueryIndex::getSnapshot() const {
+    if (usecTimestampNow() - _lastUpdate.load() > MAX_SNAPSHOT_AGE_USECS) {
+        return EntityQuerySnapshotPointer();
+    }
+    return std::atomic_load(&_snapshot);
+}
@@ -0,0 +1,173 @@
+//
+//  EntityQueryIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryIndex_h
+#define hifi_EntityQueryIndex_h
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+#include <AABox.h>
+#include <PickFilter.h>
+
+#include "EntityItemID.h"
+#include "EntityTypes.h"
+
+// An immutable copy of the spatial state of the entities in an EntityTree, which answers the sphere
+// and box queries used by scripts without taking the tree lock. Bounds are stored as structure-of-arrays
+// in fixed size chunks so the broad phase vectorizes, and so that an update only copies the chunks it touches.
+class EntityQuerySnapshot {
+public:
+    static const int CHUNK_SIZE = 256;
+
+    struct Entry {
+        EntityItemID id;
+        EntityTypes::EntityType type { EntityTypes::Unknown };
+        uint8_t filterFlags { 0 };
+        bool isSphere { false };
+        AABox box;
+        // narrow phase data, matching EntityTreeElement::evalEntitiesInSphere()
+        glm::vec3 sphereCenter;
+        float sphereRadius { -1.0f };
+        glm::mat4 worldToEntity;
+        AABox entityFrameBox;
+    };
+
+    struct Chunk {
+        int count { 0 };
+        float minX[CHUNK_SIZE];
+        float minY[CHUNK_SIZE];
+        float minZ[CHUNK_SIZE];
+        float maxX[CHUNK_SIZE];
+        float maxY[CHUNK_SIZE];
+        float maxZ[CHUNK_SIZE];
+        Entry entries[CHUNK_SIZE];
+    };
+
+    enum FilterFlags : uint8_t {
+        VISIBLE = 0x01,
+        DOMAIN_HOST = 0x02,
+        AVATAR_HOST = 0x04,
+        LOCAL_HOST = 0x08,
+        COLLIDABLE = 0x10
+    };
+
+    static bool checkFilterSettings(uint8_t filterFlags, PickFilter searchFilter);
+
+    void evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type,
+                                      PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+
+    size_t getNumEntities() const { return _numEntities; }
+    uint64_t getEpoch() const { return _epoch; }
+
+private:
+    friend class EntityQueryIndex;
+
+    template <typename F>
+    void evalSphereCandidates(const glm::vec3& center, float radius, F&& visitor) const;
+
+    std::vector<std::shared_ptr<const Chunk>> _chunks;
+    size_t _numEntities { 0 };
+    uint64_t _epoch { 0 };
+    uint64_t _appliedGeneration { 0 };
+};
+
+using EntityQuerySnapshotPointer = std::shared_ptr<const EntityQuerySnapshot>;
+
+// The entities a thread has added, edited or deleted itself since the snapshot it is reading was built, copied
+// from the live entities. Applied after a snapshot query so that a script finds its own changes straight away,
+// without the query bringing the whole index up to date.
+class EntityQueryOverlay {
+public:
+    bool isEmpty() const { return _ids.isEmpty(); }
+
+    // these replace whatever the snapshot found for the overlaid entities with their current state
+    void evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type,
+                                      PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+    void evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+
+private:
+    friend class EntityQueryIndex;
+
+    void removeOverlaid(QVector<QUuid>& foundEntities) const;
+
+    QSet<EntityItemID> _ids;
+    // deleted entities are in _ids but have no entry
+    std::vector<EntityQuerySnapshot::Entry> _entries;
+};
+
+// Owned by the EntityTree. Entities queue themselves when their transform or properties change, and
+// the tree applies the queue once per update() and publishes a new snapshot that readers pick up atomically.
+// Queries never apply the queue themselves; a thread that has changed entities since the last update() gets
+// an EntityQueryOverlay of just those.
+class EntityQueryIndex {
+public:
+    using EntityLookup = std::function<EntityItemPointer(const EntityItemID&)>;
+
+    void queueUpdate(const EntityItemID& id);
+
+    // remembers that the calling thread changed the entity, once the change has been made and queued
+    void notePendingChange(const EntityItemID& id);
+
+    // must be called with the tree locked for reading, so that entity state is consistent while it is copied
+    void update(const EntityLookup& findEntity);
+    void clear();
+
+    // returns null when the index has not been updated recently, in which case callers should query the tree
+    EntityQuerySnapshotPointer getSnapshot() const;
+
+    // the entities the calling thread changed that snapshot doesn't include yet
+    QVector<EntityItemID> getPendingChanges(const EntityQuerySnapshot& snapshot);
+    // copies the current state of those entities; must be called with the tree locked for reading
+    static EntityQueryOverlay buildOverlay(const QVector<EntityItemID>& ids, const EntityLookup& findEntity);
+
+private:
+    using Chunk = EntityQuerySnapshot::Chunk;
+
+    Chunk& editChunk(int chunkIndex);
+    void setEntry(int slot, const EntityQuerySnapshot::Entry& entry);
+    void removeEntry(const EntityItemID& id);
+
+    std::mutex _queueMutex;
+    QSet<EntityItemID> _queue;
+    // how many times update() has taken the queue; a change queued now is applied by the next one
+    uint64_t _queueGeneration { 0 };
+
+    // per thread, the entities it changed and the queue generation that applies each change
+    std::mutex _pendingMutex;
+    std::unordered_map<std::thread::id, QHash<EntityItemID, uint64_t>> _pendingChanges;
+
+    // writer side state, only touched from update()
+    QHash<EntityItemID, int> _slots;
+    std::vector<std::shared_ptr<Chunk>> _chunks;
+    int _numEntities { 0 };
+    uint64_t _epoch { 0 };
+
+    EntityQuerySnapshotPointer _snapshot;
+    std::atomic<uint64_t> _lastUpdate { 0 };
+    std::atomic<uint64_t> _appliedGeneration { 0 };
+};
+
+#endif // hifi_EntityQueryIndex_h
@@ -527,6 +527,7 @@ bool EntityScriptingInterface::addLocalEntityCopy(EntityItemProperties& properti
         _entityTree->withWriteLock([&] {
             EntityItemPointer entity = _entityTree->addEntity(id, properties, isClone);
             if (entity) {
+                _entityTree->noteQueryIndexChange(id);
                 if (properties.queryAACubeRelatedPropertyChanged()) {
                     // due to parenting, the server may not know where something is in world-space, so include the bounding cube.
                     bool success;
@@ -780,22 +781,8 @@ QScriptValue EntityScriptingInterface::getMultipleEntityPropertiesInternal(QScri
     return finalResult;
 }
 
-QUuid EntityScriptingInterface::editEntity(const QUuid& id, const EntityItemProperties& scriptSideProperties) {
-    PROFILE_RANGE(script_entities, __FUNCTION__);
-
-    _activityTracking.editedEntityCount++;
-
-    const auto sessionID = DependencyManager::get<NodeList>()->getSessionUUID();
-
-    EntityItemProperties properties = scriptSideProperties;
-
-    EntityItemID entityID(id);
-    if (!_entityTree) {
-        properties.setLastEditedBy(sessionID);
-        queueEntityMessage(PacketType::EntityEdit, entityID, properties);
-        return id;
-    }
-
+bool EntityScriptingInterface::prepareEntityEdit(const EntityItemID& entityID, EntityItemProperties& properties,
+                                                 const QUuid& sessionID) {
     EntityItemPointer entity(nullptr);
     SimulationOwner simulationOwner;
     _entityTree->withReadLock([&] {
@@ -865,7 +852,7 @@ QUuid EntityScriptingInterface::editEntity(const QUuid& id, const EntityItemProp
         previousUserdata = entity->getUserData();
     } else if (_bidOnSimulationOwnership) {
         // bail when simulation participants don't know about entity
-        return QUuid();
+        return false;
     }
     // TODO: it is possible there is no remaining useful changes in properties and we should bail early.
     // How to check for this cheaply?
@@ -874,23 +861,122 @@ QUuid EntityScriptingInterface::editEntity(const QUuid& id, const EntityItemProp
     synchronizeEditedGrabProperties(properties, previousUserdata);
     properties.setLastEditedBy(sessionID);
 
+    return true;
+}
+
+QUuid EntityScriptingInterface::editEntity(const QUuid& id, const EntityItemProperties& scriptSideProperties) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    _activityTracking.editedEntityCount++;
+
+    const auto sessionID = DependencyManager::get<NodeList>()->getSessionUUID();
+
+    EntityItemProperties properties = scriptSideProperties;
+
+    EntityItemID entityID(id);
+    if (!_entityTree) {
+        properties.setLastEditedBy(sessionID);
+        queueEntityMessage(PacketType::EntityEdit, entityID, properties);
+        return id;
+    }
+
+    if (!prepareEntityEdit(entityID, properties, sessionID)) {
+        return QUuid();
+    }
+
     // done reading and modifying properties --> start write
-    bool updatedEntity = false;
     _entityTree->withWriteLock([&] {
-        updatedEntity = _entityTree->updateEntity(entityID, properties);
+        _entityTree->updateEntity(entityID, properties);
+    });
+    _entityTree->noteQueryIndexChange(entityID);
+
+    return queueEntityEdit(id, properties);
+}
+
+// Static method to make sure that we have the right script engine.
+// Using sender() or QtScriptable::engine() does not work for classes used by multiple threads (script-engines)
+QScriptValue EntityScriptingInterface::editEntities(QScriptContext* context, QScriptEngine* engine) {
+    const int ARGUMENT_ENTITY_IDS = 0;
+    const int ARGUMENT_PROPERTIES = 1;
+
+    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
+    const auto entityIDs = qscriptvalue_cast<QVector<QUuid>>(context->argument(ARGUMENT_ENTITY_IDS));
+
+    // either one set of properties per entity, or a single set that is applied to all of them
+    QScriptValue scriptProperties = context->argument(ARGUMENT_PROPERTIES);
+    QVector<EntityItemProperties> properties(entityIDs.size());
+    if (scriptProperties.isArray()) {
+        for (int i = 0; i < entityIDs.size(); i++) {
+            EntityItemPropertiesFromScriptValueHonorReadOnly(scriptProperties.property(i), properties[i]);
+        }
+    } else {
+        EntityItemProperties sharedProperties;
+        EntityItemPropertiesFromScriptValueHonorReadOnly(scriptProperties, sharedProperties);
+        properties.fill(sharedProperties);
+    }
+
+    return qScriptValueFromValue(engine, entityScriptingInterface->editEntitiesInternal(entityIDs, properties));
+}
+
+QVector<QUuid> EntityScriptingInterface::editEntitiesInternal(const QVector<QUuid>& entityIDs,
+                                                              QVector<EntityItemProperties>& properties) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    _activityTracking.editedEntityCount += entityIDs.size();
+
+    const auto sessionID = DependencyManager::get<NodeList>()->getSessionUUID();
+
+    QVector<QUuid> result(entityIDs.size());
+    if (!_entityTree) {
+        for (int i = 0; i < entityIDs.size(); i++) {
+            properties[i].setLastEditedBy(sessionID);
+            queueEntityMessage(PacketType::EntityEdit, entityIDs[i], properties[i]);
+            result[i] = entityIDs[i];
+        }
+        return result;
+    }
+
+    std::vector<bool> accepted(entityIDs.size());
+    for (int i = 0; i < entityIDs.size(); i++) {
+        accepted[i] = prepareEntityEdit(entityIDs[i], properties[i], sessionID);
+    }
+
+    // take the write lock once for the whole batch rather than once per entity, so that a script animating many
+    // entities doesn't bounce the lock against the render and physics threads
+    _entityTree->withWriteLock([&] {
+        for (int i = 0; i < entityIDs.size(); i++) {
+            if (accepted[i]) {
+                _entityTree->updateEntity(entityIDs[i], properties[i]);
+            }
+        }
     });
+    for (int i = 0; i < entityIDs.size(); i++) {
+        if (accepted[i]) {
+            _entityTree->noteQueryIndexChange(entityIDs[i]);
+        }
+    }
+
+    // the edit messages are queued back to back, so the sender packs them into as few packets as it can
+    for (int i = 0; i < entityIDs.size(); i++) {
+        if (accepted[i]) {
+            result[i] = queueEntityEdit(entityIDs[i], properties[i]);
+        }
+    }
+    return result;
+}
+
+QUuid EntityScriptingInterface::queueEntityEdit(const QUuid& id, EntityItemProperties& properties) {
+    EntityItemID entityID(id);
 
     // FIXME: We need to figure out a better way to handle this. Allowing these edits to go through potentially
     // breaks entities that are parented.
     //
     // To handle cases where a script needs to edit an entity with a _known_ entity id but doesn't exist
     // in the local entity tree, we need to allow those edits to go through to the server.
-    // if (!updatedEntity) {
-    //     return QUuid();
-    // }
 
     bool hasQueryAACubeRelatedChanges = properties.queryAACubeRelatedPropertyChanged();
     // done writing, send update
+    EntityItemPointer entity;
     _entityTree->withReadLock([&] {
         // find the entity again: maybe it was removed since we last found it
         entity = _entityTree->findEntityByEntityItemID(entityID);
@@ -994,6 +1080,7 @@ void EntityScriptingInterface::deleteEntity(const QUuid& id) {
                     if (!entity->isDomainEntity() || _entityTree->isServerlessMode()) {
                         shouldSendDeleteToServer = false;
                         _entityTree->deleteEntity(entityID);
+                        _entityTree->noteQueryIndexChange(entityID);
 
                         if (entity->isAvatarEntity() && getEntityPacketSender()->getMyAvatar()) {
                             getEntityPacketSender()->getMyAvatar()->clearAvatarEntity(entityID, false);
@@ -1149,9 +1236,15 @@ QVector<QUuid> EntityScriptingInterface::findEntities(const glm::vec3& center, f
     QVector<QUuid> result;
     if (_entityTree) {
         unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-        _entityTree->withReadLock([&] {
-            _entityTree->evalEntitiesInSphere(center, radius, PickFilter(searchFilter), result);
-        });
+        auto snapshot = _entityTree->getQuerySnapshot();
+        if (snapshot) {
+            snapshot->evalEntitiesInSphere(center, radius, PickFilter(searchFilter), result);
+            _entityTree->getQueryOverlay(*snapshot).evalEntitiesInSphere(center, radius, PickFilter(searchFilter), result);
+        } else {
+            _entityTree->withReadLock([&] {
+                _entityTree->evalEntitiesInSphere(center, radius, PickFilter(searchFilter), result);
+            });
+        }
     }
     return result;
 }
@@ -1162,10 +1255,16 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInBox(const glm::vec3& corn
     QVector<QUuid> result;
     if (_entityTree) {
         unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-        _entityTree->withReadLock([&] {
-            AABox box(corner, dimensions);
-            _entityTree->evalEntitiesInBox(box, PickFilter(searchFilter), result);
-        });
+        AABox box(corner, dimensions);
+        auto snapshot = _entityTree->getQuerySnapshot();
+        if (snapshot) {
+            snapshot->evalEntitiesInBox(box, PickFilter(searchFilter), result);
+            _entityTree->getQueryOverlay(*snapshot).evalEntitiesInBox(box, PickFilter(searchFilter), result);
+        } else {
+            _entityTree->withReadLock([&] {
+                _entityTree->evalEntitiesInBox(box, PickFilter(searchFilter), result);
+            });
+        }
     }
     return result;
 }
@@ -1216,9 +1315,16 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesByType(const QString entity
     QVector<QUuid> result;
     if (_entityTree) {
         unsigned int searchFilter = PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES);
-        _entityTree->withReadLock([&] {
-            _entityTree->evalEntitiesInSphereWithType(center, radius, type, PickFilter(searchFilter), result);
-        });
+        auto snapshot = _entityTree->getQuerySnapshot();
+        if (snapshot) {
+            snapshot->evalEntitiesInSphereWithType(center, radius, type, PickFilter(searchFilter), result);
+            _entityTree->getQueryOverlay(*snapshot).evalEntitiesInSphereWithType(center, radius, type,
+                                                                                 PickFilter(searchFilter), result);
+        } else {
+            _entityTree->withReadLock([&] {
+                _entityTree->evalEntitiesInSphereWithType(center, radius, type, PickFilter(searchFilter), result);
+            });
+        }
     }
     return result;
 }
@@ -203,6 +203,26 @@ public:
     static QScriptValue getMultipleEntityProperties(QScriptContext* context, QScriptEngine* engine);
     QScriptValue getMultipleEntityPropertiesInternal(QScriptEngine* engine, QVector<QUuid> entityIDs, const QScriptValue& extendedDesiredProperties);
 
+    /**jsdoc
+     * Edits multiple entities, changing one or more of their property values. This is equivalent to calling
+     * {@link Entities.editEntity|editEntity} for each entity, but the edits are applied to the local tree together and are
+     * sent to the server in as few packets as possible.
+     * @function Entities.editEntities
+     * @param {Uuid[]} entityIDs - The IDs of the entities to edit.
+     * @param {Entities.EntityProperties[]|Entities.EntityProperties} properties - The new property values for each entity, in
+     *     the same order as <code>entityIDs</code>, or a single set of property values to apply to all of the entities.
+     * @returns {Uuid[]} For each entity, its ID if the edit was successful, otherwise {@link Uuid|Uuid.NULL}.
+     * @example <caption>Spin a ring of entities.</caption>
+     * var entityIDs = Entities.findEntities(MyAvatar.position, 10);
+     * var angle = 0;
+     * Script.update.connect(function (deltaTime) {
+     *     angle += deltaTime;
+     *     Entities.editEntities(entityIDs, { rotation: Quat.fromPitchYawRollRadians(0, angle, 0) });
+     * });
+     */
+    static QScriptValue editEntities(QScriptContext* context, QScriptEngine* engine);
+    QVector<QUuid> editEntitiesInternal(const QVector<QUuid>& entityIDs, QVector<EntityItemProperties>& properties);
+
     QUuid addEntityInternal(const EntityItemProperties& properties, entity::HostType entityHostType);
 
 public slots:
@@ -2504,6 +2524,10 @@ private:
     bool polyVoxWorker(QUuid entityID, std::function<bool(PolyVoxEntityItem&)> actor);
     bool setPoints(QUuid entityID, std::function<bool(LineEntityItem&)> actor);
     void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties);
+
+    // the two halves of editEntity() either side of the tree write, shared with editEntities()
+    bool prepareEntityEdit(const EntityItemID& entityID, EntityItemProperties& properties, const QUuid& sessionID);
+    QUuid queueEntityEdit(const QUuid& id, EntityItemProperties& properties);
     bool addLocalEntityCopy(EntityItemProperties& propertiesWithSimID, EntityItemID& id, bool isClone = false);
 
     EntityItemPointer checkForTreeEntityAndTypeMatch(const QUuid& entityID,
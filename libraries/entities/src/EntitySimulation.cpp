@@ -17,6 +17,15 @@
 #include "EntitiesLogging.h"
 #include "MovingEntitiesOperator.h"
 
+// kinematic entities beyond these distances from every viewer are stepped at reduced rates
+const float KINEMATIC_FULL_RATE_DISTANCE = 50.0f; // meters
+const float KINEMATIC_REDUCED_RATE_DISTANCE = 200.0f; // meters
+const float KINEMATIC_LOW_RATE_DISTANCE = 800.0f; // meters
+const uint64_t KINEMATIC_REDUCED_RATE_PERIOD = USECS_PER_SECOND / 10;
+const uint64_t KINEMATIC_LOW_RATE_PERIOD = USECS_PER_SECOND / 4;
+// well under the one second EntityItem::stepKinematicMotion() clamps a step to, so a late step still catches up
+const uint64_t KINEMATIC_MIN_RATE_PERIOD = USECS_PER_SECOND / 2;
+
 void EntitySimulation::setEntityTree(EntityTreePointer tree) {
     if (_entityTree && _entityTree != tree) {
         _mortalEntities.clear();
@@ -230,8 +239,40 @@ void EntitySimulation::clearEntities() {
     _deadEntities.clear();
 }
 
+void EntitySimulation::setViewerPositions(const std::vector<glm::vec3>& viewerPositions) {
+    QMutexLocker lock(&_viewerPositionsMutex);
+    _viewerPositions = viewerPositions;
+}
+
+void EntitySimulation::setViewFrustums(const std::vector<ViewFrustum>& viewFrustums) {
+    QMutexLocker lock(&_viewerPositionsMutex);
+    _viewFrustums = viewFrustums;
+}
+
+uint64_t EntitySimulation::getKinematicStepPeriod(const EntityItemPointer& entity, float distanceToViewer) const {
+    if (distanceToViewer < KINEMATIC_FULL_RATE_DISTANCE) {
+        return 0;
+    } else if (distanceToViewer < KINEMATIC_REDUCED_RATE_DISTANCE) {
+        return KINEMATIC_REDUCED_RATE_PERIOD;
+    } else if (distanceToViewer < KINEMATIC_LOW_RATE_DISTANCE) {
+        return KINEMATIC_LOW_RATE_PERIOD;
+    }
+    return KINEMATIC_MIN_RATE_PERIOD;
+}
+
 void EntitySimulation::moveSimpleKinematics(uint64_t now) {
     PROFILE_RANGE_EX(simulation_physics, "MoveSimples", 0xffff00ff, (uint64_t)_simpleKinematicEntities.size());
+    std::vector<glm::vec3> viewerPositions;
+    std::vector<ViewFrustum> viewFrustums;
+    {
+        QMutexLocker lock(&_viewerPositionsMutex);
+        viewerPositions = _viewerPositions;
+        viewFrustums = _viewFrustums;
+    }
+    if (!viewerPositions.empty() && !_simpleKinematicEntities.empty()) {
+        prepareKinematicStepPeriods();
+    }
+
     SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
     while (itemItr != _simpleKinematicEntities.end()) {
         EntityItemPointer entity = *itemItr;
@@ -239,11 +280,31 @@ void EntitySimulation::moveSimpleKinematics(uint64_t now) {
         // The entity-server doesn't know where avatars are, so don't attempt to do simple extrapolation for
         // children of avatars.  See related code in EntityMotionState::remoteSimulationOutOfSync.
         bool ancestryIsKnown;
-        entity->getMaximumAACube(ancestryIsKnown);
+        AACube maximumAACube = entity->getMaximumAACube(ancestryIsKnown);
         bool hasAvatarAncestor = entity->hasAncestorOfType(NestableType::Avatar);
 
         bool isMoving = entity->isMovingRelativeToParent();
         if (isMoving && !entity->getPhysicsInfo() && ancestryIsKnown && !hasAvatarAncestor) {
+            bool isVisible = false;
+            for (const auto& viewFrustum : viewFrustums) {
+                if (viewFrustum.cubeIntersectsFrustum(maximumAACube)) {
+                    isVisible = true;
+                    break;
+                }
+            }
+            if (!isVisible && !viewerPositions.empty()) {
+                // without viewers nearby, wait until the step is due
+                glm::vec3 position = entity->getWorldPosition();
+                float minDistanceSquared = std::numeric_limits<float>::max();
+                for (const auto& viewerPosition : viewerPositions) {
+                    minDistanceSquared = glm::min(minDistanceSquared, glm::distance2(position, viewerPosition));
+                }
+                uint64_t period = getKinematicStepPeriod(entity, sqrtf(minDistanceSquared));
+                if (now < entity->getLastSimulated() + period) {
+                    ++itemItr;
+                    continue;
+                }
+            }
             entity->simulate(now);
             if (ancestryIsKnown && !hasAvatarAncestor) {
                 entity->updateQueryAACube();
@@ -14,12 +14,14 @@
 
 #include <limits>
 #include <unordered_set>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QSet>
 #include <QVector>
 
 #include <PerfStat.h>
+#include <ViewFrustum.h>
 
 #include "EntityDynamicInterface.h"
 #include "EntityItem.h"
@@ -76,6 +78,14 @@ public:
 
     void moveSimpleKinematics(uint64_t now);
 
+    /// \param viewerPositions where the viewers are, in the world frame
+    /// kinematic entities far from every viewer are stepped less often, and catch up on the skipped time when they are
+    void setViewerPositions(const std::vector<glm::vec3>& viewerPositions);
+
+    /// \param viewFrustums what the viewers can see
+    /// kinematic entities inside any of these frustums step every frame, however far they are from the viewers
+    void setViewFrustums(const std::vector<ViewFrustum>& viewFrustums);
+
     EntityTreePointer getEntityTree() { return _entityTree; }
 
     virtual void takeDeadEntities(SetOfEntities& entitiesToDelete);
@@ -98,6 +108,11 @@ protected:
     void callUpdateOnEntitiesThatNeedIt(uint64_t now);
     virtual void sortEntitiesThatMoved();
 
+    // called once per frame before getKinematicStepPeriod(), to gather whatever it needs for all the entities at once
+    virtual void prepareKinematicStepPeriods() {}
+    // how long the kinematic motion of an entity distanceToViewer from the nearest viewer can go without a step
+    virtual uint64_t getKinematicStepPeriod(const EntityItemPointer& entity, float distanceToViewer) const;
+
     QMutex _mutex{ QMutex::Recursive };
 
     SetOfEntities _entitiesToSort; // entities moved by simulation (and might need resort in EntityTree)
@@ -123,6 +138,10 @@ private:
     uint64_t _nextExpiry;
 
     SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
+
+    QMutex _viewerPositionsMutex;
+    std::vector<glm::vec3> _viewerPositions;
+    std::vector<ViewFrustum> _viewFrustums;
 };
 
 #endif // hifi_EntitySimulation_h
@@ -21,6 +21,7 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtScript/QScriptEngine>
 
 #include <Extents.h>
@@ -110,6 +111,12 @@ void EntityTree::eraseDomainAndNonOwnedEntities() {
             }
         }
         _entityMap.swap(savedEntities);
+        rebuildFilterIndexes();
+
+        _queryIndex.clear();
+        for (const auto& id : _entityMap.keys()) {
+            _queryIndex.queueUpdate(id);
+        }
     });
 
     resetClientEditStats();
@@ -139,6 +146,11 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     QHash<EntityItemID, EntityItemPointer> localMap;
     localMap.swap(_entityMap);
     this->withWriteLock([&] {
+        {
+            QWriteLocker locker(&_entityMapLock);
+            rebuildFilterIndexes();
+        }
+        _queryIndex.clear();
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
             if (element) {
@@ -1749,6 +1761,102 @@ void EntityTree::processChallengeOwnershipPacket(ReceivedMessage& message, const
     }
 }
 
+void EntityTree::limitEditPropertiesForSender(bool isAdd, EntityItemProperties& properties, const SharedNodePointer& senderNode) {
+    if ((isAdd || properties.lifetimeChanged()) &&
+        ((!senderNode->getCanRez() && senderNode->getCanRezTmp()) ||
+        (!senderNode->getCanRezCertified() && senderNode->getCanRezTmpCertified()))) {
+        // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
+        if (properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
+            properties.getLifetime() > _maxTmpEntityLifetime) {
+            properties.setLifetime(_maxTmpEntityLifetime);
+            bumpTimestamp(properties);
+        }
+    }
+
+    if (isAdd && properties.getLocked() && !senderNode->isAllowedEditor()) {
+        // if a node can't change locks, don't allow it to create an already-locked entity -- automatically
+        // clear the locked property and allow the unlocked entity to be created.
+        properties.setLocked(false);
+        bumpTimestamp(properties);
+    }
+}
+
+void EntityTree::beginEditPacket(ReceivedMessage& message, const SharedNodePointer& senderNode) {
+    _prefilteredEdits.clear();
+
+    PacketType packetType = message.getType();
+    if (!getIsServer() || !senderNode ||
+        (packetType != PacketType::EntityAdd && packetType != PacketType::EntityEdit && packetType != PacketType::EntityPhysics)) {
+        return;
+    }
+    bool isAdd = packetType == PacketType::EntityAdd;
+    bool isPhysics = packetType == PacketType::EntityPhysics;
+    // Having (un)lock rights bypasses the filter, unless it's a physics result.
+    if (!isPhysics && senderNode->isAllowedEditor()) {
+        return;
+    }
+    auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+    if (!entityEditFilters || !entityEditFilters->hasFilters()) {
+        return;
+    }
+
+    quint64 startFilter = usecTimestampNow();
+
+    // decode every record up front, the same way processEditPacketData() will
+    struct PendingEdit {
+        const unsigned char* editData;
+        PrefilteredEdit edit;
+    };
+    std::vector<PendingEdit> pendingEdits;
+    QSet<EntityItemID> editedEntities;
+    const unsigned char* editData = reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition());
+    int bytesLeft = message.getBytesLeftToRead();
+    while (bytesLeft > 0) {
+        int processedBytes = 0;
+        EntityItemID entityItemID;
+        PendingEdit pending { editData, PrefilteredEdit() };
+        bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, bytesLeft, processedBytes,
+                                                                            entityItemID, pending.edit.properties);
+        if (!validEditPacket || processedBytes <= 0) {
+            break;
+        }
+
+        // a filter sees the entity as it was before the edit, so later edits of the same entity wait their turn
+        if (!editedEntities.contains(entityItemID)) {
+            editedEntities.insert(entityItemID);
+            if (!isAdd) {
+                pending.edit.existingEntity = findEntityByEntityItemID(entityItemID);
+            }
+            if (isAdd || pending.edit.existingEntity) {
+                limitEditPropertiesForSender(isAdd, pending.edit.properties, senderNode);
+                pendingEdits.push_back(pending);
+            }
+        }
+        editData += processedBytes;
+        bytesLeft -= processedBytes;
+    }
+
+    // a packet with a single edit gains nothing from another thread
+    if (pendingEdits.size() < 2) {
+        return;
+    }
+
+    FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
+    QtConcurrent::blockingMap(pendingEdits, [this, filterType](PendingEdit& pending) {
+        PrefilteredEdit& edit = pending.edit;
+        edit.allowed = filterProperties(edit.existingEntity, edit.properties, edit.properties, edit.wasChanged, filterType);
+    });
+
+    for (auto& pending : pendingEdits) {
+        _prefilteredEdits.insert(pending.editData, pending.edit);
+    }
+    _totalFilterTime += usecTimestampNow() - startFilter;
+}
+
+void EntityTree::endEditPacket() {
+    _prefilteredEdits.clear();
+}
+
 int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                      const SharedNodePointer& senderNode) {
 
@@ -1893,23 +2001,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
             }
 
             if (!isClone) {
-                if ((isAdd || properties.lifetimeChanged()) &&
-                    ((!senderNode->getCanRez() && senderNode->getCanRezTmp()) ||
-                    (!senderNode->getCanRezCertified() && senderNode->getCanRezTmpCertified()))) {
-                    // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
-                    if (properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
-                        properties.getLifetime() > _maxTmpEntityLifetime) {
-                        properties.setLifetime(_maxTmpEntityLifetime);
-                        bumpTimestamp(properties);
-                    }
-                }
-
-                if (isAdd && properties.getLocked() && !senderNode->isAllowedEditor()) {
-                    // if a node can't change locks, don't allow it to create an already-locked entity -- automatically
-                    // clear the locked property and allow the unlocked entity to be created.
-                    properties.setLocked(false);
-                    bumpTimestamp(properties);
-                }
+                limitEditPropertiesForSender(isAdd, properties, senderNode);
             }
 
             // If we got a valid edit packet, then it could be a new entity or it could be an update to
@@ -1917,9 +2009,18 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
             if (validEditPacket) {
                 startFilter = usecTimestampNow();
                 bool wasChanged = false;
-                // Having (un)lock rights bypasses the filter, unless it's a physics result.
-                FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
-                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
+                bool allowed = true;
+                auto prefiltered = _prefilteredEdits.find(editData);
+                if (prefiltered != _prefilteredEdits.end() && prefiltered->existingEntity == existingEntity) {
+                    // beginEditPacket() already ran the filters on this record
+                    properties = prefiltered->properties;
+                    allowed = prefiltered->allowed;
+                    wasChanged = prefiltered->wasChanged;
+                } else {
+                    // Having (un)lock rights bypasses the filter, unless it's a physics result.
+                    FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
+                    allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
+                }
                 if (!allowed) {
                     auto timestamp = properties.getLastEdited();
                     properties = EntityItemProperties();
@@ -2267,6 +2368,27 @@ void EntityTree::update(bool simulate) {
             }
         });
     }
+
+    {
+        PROFILE_RANGE(simulation_physics, "QueryIndex");
+        withReadLock([&] {
+            _queryIndex.update([&](const EntityItemID& id) { return findEntityByEntityItemID(id); });
+        });
+    }
+}
+
+EntityQueryOverlay EntityTree::getQueryOverlay(const EntityQuerySnapshot& snapshot) {
+    QVector<EntityItemID> pendingChanges = _queryIndex.getPendingChanges(snapshot);
+    if (pendingChanges.isEmpty()) {
+        return EntityQueryOverlay();
+    }
+    EntityQueryOverlay overlay;
+    withReadLock([&] {
+        overlay = EntityQueryIndex::buildOverlay(pendingChanges, [&](const EntityItemID& id) {
+            return findEntityByEntityItemID(id);
+        });
+    });
+    return overlay;
 }
 
 quint64 EntityTree::getAdjustedConsiderSince(quint64 sinceTime) {
@@ -2465,11 +2587,66 @@ void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
         return;
     }
     _entityMap.insert(id, entity);
+    addToFilterIndexes(entity);
+    _queryIndex.queueUpdate(id);
 }
 
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
     QWriteLocker locker(&_entityMapLock);
-    _entityMap.remove(id);
+    EntityItemPointer entity = _entityMap.take(id);
+    if (entity) {
+        removeFromFilterIndexes(entity);
+    }
+    _queryIndex.queueUpdate(id);
+}
+
+void EntityTree::addToFilterIndexes(const EntityItemPointer& entity) {
+    EntityItemID id = entity->getEntityItemID();
+    _entitiesByType[entity->getType()].insert(id, entity);
+    if (entity->hasServerScripts()) {
+        _entitiesWithServerScripts.insert(id, entity);
+    }
+}
+
+void EntityTree::removeFromFilterIndexes(const EntityItemPointer& entity) {
+    EntityItemID id = entity->getEntityItemID();
+    _entitiesByType[entity->getType()].remove(id);
+    _entitiesWithServerScripts.remove(id);
+}
+
+void EntityTree::rebuildFilterIndexes() {
+    for (auto& entities : _entitiesByType) {
+        entities.clear();
+    }
+    _entitiesWithServerScripts.clear();
+    foreach(EntityItemPointer entity, _entityMap) {
+        addToFilterIndexes(entity);
+    }
+}
+
+void EntityTree::updateServerScriptsIndex(const EntityItemID& entityID) {
+    QWriteLocker locker(&_entityMapLock);
+    EntityItemPointer entity = _entityMap.value(entityID);
+    if (entity && entity->hasServerScripts()) {
+        _entitiesWithServerScripts.insert(entityID, entity);
+    } else {
+        _entitiesWithServerScripts.remove(entityID);
+    }
+}
+
+QHash<EntityItemID, EntityItemPointer> EntityTree::getIndexedEntities(const EntityQueryFilter& filter) const {
+    QReadLocker locker(&_entityMapLock);
+    switch (filter.getIndex()) {
+        case EntityQueryFilter::Index::ServerScripts:
+            return _entitiesWithServerScripts;
+        case EntityQueryFilter::Index::Type:
+            return _entitiesByType[filter.getType()];
+        case EntityQueryFilter::Index::None:
+        default:
+            // no index holds them all
+            assert(false);
+            return _entityMap;
+    }
 }
 
 void EntityTree::debugDumpMap() {
@@ -19,6 +19,8 @@
 #include <SpatialParentFinder.h>
 
 #include "AddEntityOperator.h"
+#include "EntityQueryFilter.h"
+#include "EntityQueryIndex.h"
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
 #include "MovingEntitiesOperator.h"
@@ -89,6 +91,8 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+    virtual void beginEditPacket(ReceivedMessage& message, const SharedNodePointer& senderNode) override;
+    virtual void endEditPacket() override;
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
@@ -130,6 +134,19 @@ public:
 
     EntityItemPointer findEntityByID(const QUuid& id) const;
     EntityItemPointer findEntityByEntityItemID(const EntityItemID& entityID) const;
+
+    void queueQueryIndexUpdate(const EntityItemID& entityID) { _queryIndex.queueUpdate(entityID); }
+    // lock-free view of entity bounds for script queries, null when the caller should fall back to the tree
+    EntityQuerySnapshotPointer getQuerySnapshot() const { return _queryIndex.getSnapshot(); }
+    // scripts note the entities they add, edit or delete, and the overlay of those not yet in a snapshot is applied
+    // after querying it, so a script finds its own changes before the next update()
+    void noteQueryIndexChange(const EntityItemID& entityID) { _queryIndex.notePendingChange(entityID); }
+    EntityQueryOverlay getQueryOverlay(const EntityQuerySnapshot& snapshot);
+
+    // the entities a filter with an index can match (see EntityQueryFilter::getIndex()), still to be tested with
+    // EntityItem::matchesQueryFilter(); the QHash is implicitly shared, so this doesn't copy the index
+    QHash<EntityItemID, EntityItemPointer> getIndexedEntities(const EntityQueryFilter& filter) const;
+    void updateServerScriptsIndex(const EntityItemID& entityID);
     virtual SpatiallyNestablePointer findByID(const QUuid& id) const override { return findEntityByID(id); }
 
     EntityItemID assignEntityID(const EntityItemID& entityItemID); /// Assigns a known ID for a creator token ID
@@ -326,6 +343,15 @@ protected:
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
 
+    EntityQueryIndex _queryIndex;
+
+    // secondary indexes for the filtered entity queries, kept with _entityMap under _entityMapLock
+    void addToFilterIndexes(const EntityItemPointer& entity);
+    void removeFromFilterIndexes(const EntityItemPointer& entity);
+    void rebuildFilterIndexes();
+    QHash<EntityItemID, EntityItemPointer> _entitiesByType[EntityTypes::NUM_TYPES];
+    QHash<EntityItemID, EntityItemPointer> _entitiesWithServerScripts;
+
     mutable QReadWriteLock _entityCertificateIDMapLock;
     QHash<QString, QList<EntityItemID>> _entityCertificateIDMap;
 
@@ -368,6 +394,17 @@ protected:
     float _maxTmpEntityLifetime { DEFAULT_MAX_TMP_ENTITY_LIFETIME };
 
     bool filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType);
+    void limitEditPropertiesForSender(bool isAdd, EntityItemProperties& properties, const SharedNodePointer& senderNode);
+
+    // the edit filter results for the edit records of the packet being processed, computed concurrently by
+    // beginEditPacket() and keyed by the record's position in the packet
+    struct PrefilteredEdit {
+        EntityItemPointer existingEntity;
+        EntityItemProperties properties;
+        bool allowed { true };
+        bool wasChanged { false };
+    };
+    QHash<const unsigned char*, PrefilteredEdit> _prefilteredEdits;
     bool _hasEntityEditFilter{ false };
     QStringList _entityScriptSourceWhitelist;
 
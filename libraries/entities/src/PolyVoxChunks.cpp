@@ -0,0 +1,69 @@
+//
+//  PolyVoxChunks.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PolyVoxChunks.h"
+
+#include <algorithm>
+
+void PolyVoxChunks::reset(const glm::ivec3& volumeSize) {
+    _volumeSize = glm::max(volumeSize, glm::ivec3(0));
+    _numChunks = (_volumeSize + (CHUNK_SIZE - 1)) / CHUNK_SIZE;
+    _dirty.assign(_numChunks.x * _numChunks.y * _numChunks.z, false);
+    markAllDirty();
+}
+
+void PolyVoxChunks::markAllDirty() {
+    std::fill(_dirty.begin(), _dirty.end(), true);
+    _numDirty = (int)_dirty.size();
+}
+
+void PolyVoxChunks::voxelChanged(const glm::ivec3& voxel) {
+    if (_dirty.empty()) {
+        return;
+    }
+    // the cells on both sides of the voxel, and the hulls of its neighbors, which can be exposed or covered by it.
+    // Marching cubes normals are central differences, so the voxel also shades the vertices one voxel further down.
+    glm::ivec3 lowChunk = glm::clamp((voxel - 2) / CHUNK_SIZE, glm::ivec3(0), _numChunks - 1);
+    glm::ivec3 highChunk = glm::clamp((voxel + 1) / CHUNK_SIZE, glm::ivec3(0), _numChunks - 1);
+    for (int z = lowChunk.z; z <= highChunk.z; z++) {
+        for (int y = lowChunk.y; y <= highChunk.y; y++) {
+            for (int x = lowChunk.x; x <= highChunk.x; x++) {
+                int index = (z * _numChunks.y + y) * _numChunks.x + x;
+                if (!_dirty[index]) {
+                    _dirty[index] = true;
+                    _numDirty++;
+                }
+            }
+        }
+    }
+}
+
+PolyVoxChunks::Chunk PolyVoxChunks::getChunk(int index) const {
+    glm::ivec3 chunkPosition(index % _numChunks.x, (index / _numChunks.x) % _numChunks.y, index / (_numChunks.x * _numChunks.y));
+    Chunk chunk;
+    chunk.index = index;
+    chunk.low = chunkPosition * CHUNK_SIZE;
+    chunk.high = glm::min(chunk.low + CHUNK_SIZE, _volumeSize - 1);
+    chunk.ownedHigh = glm::min(chunk.low + (CHUNK_SIZE - 1), _volumeSize - 1);
+    return chunk;
+}
+
+std::vector<PolyVoxChunks::Chunk> PolyVoxChunks::takeDirtyChunks() {
+    std::vector<Chunk> dirtyChunks;
+    dirtyChunks.reserve(_numDirty);
+    for (int i = 0; i < (int)_dirty.size(); i++) {
+        if (_dirty[i]) {
+            dirtyChunks.push_back(getChunk(i));
+            _dirty[i] = false;
+        }
+    }
+    _numDirty = 0;
+    return dirtyChunks;
+}
@@ -0,0 +1,56 @@
+//
+//  PolyVoxChunks.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PolyVoxChunks_h
+#define hifi_PolyVoxChunks_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Splits a voxel volume into cubes of CHUNK_SIZE voxels and keeps track of the ones whose mesh and collision hulls
+// have to be rebuilt after voxels change.
+//
+// A chunk's mesh is extracted from the region between its low corner and the low corner of the next chunk, so
+// that neighboring chunks share a layer of voxels and their meshes knit together.  Its collision hulls are those
+// of the voxels it owns, from its low corner up to, but not including, that shared layer.
+class PolyVoxChunks {
+public:
+    static const int CHUNK_SIZE = 16;
+
+    struct Chunk {
+        int index { 0 };
+        glm::ivec3 low; // first voxel
+        glm::ivec3 high; // last voxel of the region to extract the mesh from (inclusive)
+        glm::ivec3 ownedHigh; // last voxel owned by this chunk (inclusive)
+    };
+
+    // resizes the grid for a volume of volumeSize voxels, and marks every chunk dirty
+    void reset(const glm::ivec3& volumeSize);
+    void markAllDirty();
+
+    // marks the chunks whose mesh or hulls depend on the voxel, which includes the ones of its neighbors
+    void voxelChanged(const glm::ivec3& voxel);
+
+    int getNumChunks() const { return (int)_dirty.size(); }
+    int getNumDirtyChunks() const { return _numDirty; }
+    Chunk getChunk(int index) const;
+
+    // returns the dirty chunks and marks them clean
+    std::vector<Chunk> takeDirtyChunks();
+
+private:
+    glm::ivec3 _volumeSize { 0 };
+    glm::ivec3 _numChunks { 0 };
+    std::vector<bool> _dirty;
+    int _numDirty { 0 };
+};
+
+#endif // hifi_PolyVoxChunks_h
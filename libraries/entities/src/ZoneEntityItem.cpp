@@ -18,6 +18,7 @@
 
 #include "EntitiesLogging.h"
 #include "EntityItemProperties.h"
+#include "EntityQueryFilter.h"
 #include "EntityTree.h"
 #include "EntityTreeElement.h"
 #include "EntityEditFilters.h"
@@ -466,17 +467,14 @@ void ZoneEntityItem::fetchCollisionGeometryResource() {
     }
 }
 
-bool ZoneEntityItem::matchesJSONFilters(const QJsonObject& jsonFilters) const {
+bool ZoneEntityItem::matchesQueryFilter(const EntityQueryFilter& filter) const {
     // currently the only property filter we handle in ZoneEntityItem is value of avatarPriority
 
-    static const QString AVATAR_PRIORITY_PROPERTY = "avatarPriority";
-
     // If set ignore only priority-inherit zones:
-    if (jsonFilters.contains(AVATAR_PRIORITY_PROPERTY) && jsonFilters[AVATAR_PRIORITY_PROPERTY].toBool()
-        && _avatarPriority != COMPONENT_MODE_INHERIT) {
+    if (filter.wantsAvatarPriority() && _avatarPriority != COMPONENT_MODE_INHERIT) {
         return true;
     }
 
     // Chain to base:
-    return EntityItem::matchesJSONFilters(jsonFilters);
+    return EntityItem::matchesQueryFilter(filter);
 }
@@ -67,7 +67,7 @@ public:
     QString getCompoundShapeURL() const;
     virtual void setCompoundShapeURL(const QString& url);
 
-    virtual bool matchesJSONFilters(const QJsonObject& jsonFilters) const override;
+    virtual bool matchesQueryFilter(const EntityQueryFilter& filter) const override;
 
     KeyLightPropertyGroup getKeyLightProperties() const { return resultWithReadLock<KeyLightPropertyGroup>([&] { return _keyLightProperties; }); }
     AmbientLightPropertyGroup getAmbientLightProperties() const { return resultWithReadLock<AmbientLightPropertyGroup>([&] { return _ambientLightProperties; }); }
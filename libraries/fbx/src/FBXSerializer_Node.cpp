@@ -21,8 +21,11 @@
 #include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
+#include <zlib.h>
+
 #include <shared/NsightHelpers.h>
 #include <hfm/ModelFormatLogging.h>
+#include <TBBHelpers.h>
 
 template<class T>
 int streamSize() {
@@ -228,6 +231,171 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
     return node;
 }
 
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+
+// Cursor over a binary FBX file that is already fully in memory. Values are read straight out of the
+// buffer instead of going through QDataStream and QIODevice, which copy every property at least once.
+class FBXBinaryReader {
+public:
+    FBXBinaryReader(const hifi::ByteArray& data) : _begin(data.constData()), _cursor(data.constData()), _end(data.constData() + data.size()) {}
+
+    qint64 getPosition() const { return _cursor - _begin; }
+    qint64 bytesAvailable() const { return _end - _cursor; }
+
+    const char* skip(qint64 size) {
+        if (size < 0 || size > bytesAvailable()) {
+            throw QString("FBX file most likely corrupt: unexpected end of data");
+        }
+        const char* data = _cursor;
+        _cursor += size;
+        return data;
+    }
+
+    template<class T>
+    T read() {
+        T value;
+        memcpy(&value, skip(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+private:
+    const char* _begin;
+    const char* _cursor;
+    const char* _end;
+};
+
+// A compressed array whose destination has been allocated during the tree walk but is only inflated
+// once the whole file has been parsed, so that all the arrays can be inflated in parallel.
+struct FBXInflateJob {
+    const char* source;
+    uLong sourceLength;
+    char* destination;
+    uLong destinationLength;
+};
+using FBXInflateJobs = std::vector<FBXInflateJob>;
+
+template<class T>
+QVariant readBinaryArray(FBXBinaryReader& in, FBXInflateJobs& inflateJobs) {
+    quint32 arrayLength = in.read<quint32>();
+    if (arrayLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
+        throw QString("FBX file most likely corrupt: binary data exceeds data limits");
+    }
+    quint32 encoding = in.read<quint32>();
+    quint32 compressedLength = in.read<quint32>();
+    if (compressedLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
+        throw QString("FBX file most likely corrupt: compressed binary data exceeds data limits");
+    }
+
+    QVector<T> values(arrayLength);
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        const char* compressed = in.skip(compressedLength);
+        if (arrayLength > 0) {
+            // the QVariant shares the storage of values, so the inflated data lands directly in the final array
+            inflateJobs.push_back({ compressed, compressedLength, reinterpret_cast<char*>(values.data()), (uLong)(sizeof(T) * arrayLength) });
+        }
+    } else {
+        const char* raw = in.skip(sizeof(T) * arrayLength);
+        if (arrayLength > 0) {
+            memcpy(values.data(), raw, sizeof(T) * arrayLength);
+        }
+    }
+    return QVariant::fromValue(values);
+}
+
+QVariant parseBinaryFBXProperty(FBXBinaryReader& in, FBXInflateJobs& inflateJobs) {
+    char ch = in.read<char>();
+    switch (ch) {
+        case 'Y':
+            return QVariant::fromValue(in.read<qint16>());
+        case 'C':
+            return QVariant::fromValue(in.read<qint8>() != 0);
+        case 'I':
+            return QVariant::fromValue(in.read<qint32>());
+        case 'F':
+            return QVariant::fromValue(in.read<float>());
+        case 'D':
+            return QVariant::fromValue(in.read<double>());
+        case 'L':
+            return QVariant::fromValue(in.read<qint64>());
+        case 'f':
+            return readBinaryArray<float>(in, inflateJobs);
+        case 'd':
+            return readBinaryArray<double>(in, inflateJobs);
+        case 'l':
+            return readBinaryArray<qint64>(in, inflateJobs);
+        case 'i':
+            return readBinaryArray<qint32>(in, inflateJobs);
+        case 'b':
+            return readBinaryArray<bool>(in, inflateJobs);
+        case 'S':
+        case 'R': {
+            quint32 length = in.read<quint32>();
+            return QVariant::fromValue(hifi::ByteArray(in.skip(length), length));
+        }
+        default:
+            throw QString("Unknown property type: ") + ch;
+    }
+}
+
+FBXNode parseBinaryFBXNode(FBXBinaryReader& in, bool has64BitPositions, FBXInflateJobs& inflateJobs) {
+    qint64 endOffset;
+    quint64 propertyCount;
+
+    // see the QDataStream version above for the 32 vs 64 bit header layouts
+    if (has64BitPositions) {
+        endOffset = in.read<qint64>();
+        propertyCount = in.read<quint64>();
+        in.read<quint64>(); // property list length
+    } else {
+        endOffset = in.read<qint32>();
+        propertyCount = in.read<quint32>();
+        in.read<quint32>(); // property list length
+    }
+    quint8 nameLength = in.read<quint8>();
+
+    FBXNode node;
+    const int MIN_VALID_OFFSET = 40;
+    if (endOffset < MIN_VALID_OFFSET || nameLength == 0) {
+        // use a null name to indicate a null node
+        return node;
+    }
+    node.name = hifi::ByteArray(in.skip(nameLength), nameLength);
+
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseBinaryFBXProperty(in, inflateJobs));
+    }
+
+    while (endOffset > in.getPosition()) {
+        FBXNode child = parseBinaryFBXNode(in, has64BitPositions, inflateJobs);
+        if (!child.name.isNull()) {
+            node.children.append(child);
+        }
+    }
+
+    return node;
+}
+
+void inflateBinaryArrays(const FBXInflateJobs& inflateJobs) {
+    PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, (uint64_t)inflateJobs.size());
+    std::atomic<bool> corrupt { false };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, inflateJobs.size()), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const FBXInflateJob& job = inflateJobs[i];
+            uLongf inflatedLength = job.destinationLength;
+            int result = uncompress(reinterpret_cast<Bytef*>(job.destination), &inflatedLength,
+                                    reinterpret_cast<const Bytef*>(job.source), job.sourceLength);
+            if (result != Z_OK || inflatedLength != job.destinationLength) {
+                corrupt.store(true);
+            }
+        }
+    });
+    if (corrupt.load()) {
+        throw QString("corrupt fbx file");
+    }
+}
+
+#endif // Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+
 class Tokenizer {
 public:
 
@@ -403,6 +571,35 @@ FBXNode FBXSerializer::parseFBX(QIODevice* device) {
 }
 
 
+FBXNode FBXSerializer::parseFBX(const hifi::ByteArray& data) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (data.startsWith(FBX_BINARY_PROLOG)) {
+        PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, (uint64_t)data.size());
+        FBXBinaryReader in(data);
+        in.skip(FBX_HEADER_BYTES_BEFORE_VERSION);
+        quint32 fileVersion = in.read<quint32>();
+        bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+
+        FBXInflateJobs inflateJobs;
+        FBXNode top;
+        while (in.bytesAvailable()) {
+            FBXNode next = parseBinaryFBXNode(in, has64BitPositions, inflateJobs);
+            if (next.name.isNull()) {
+                break;
+            }
+            top.children.append(next);
+        }
+        inflateBinaryArrays(inflateJobs);
+        return top;
+    }
+#endif
+
+    // text files, and binary files on big endian hosts, go through the streaming parser
+    QBuffer buffer(const_cast<hifi::ByteArray*>(&data));
+    buffer.open(QIODevice::ReadOnly);
+    return parseFBX(&buffer);
+}
+
 glm::vec3 FBXSerializer::getVec3(const QVariantList& properties, int index) {
     return glm::vec3(properties.at(index).value<double>(), properties.at(index + 1).value<double>(),
         properties.at(index + 2).value<double>());
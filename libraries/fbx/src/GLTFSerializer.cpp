@@ -1836,12 +1836,6 @@ void GLTFSerializer::setHFMMaterial(HFMMaterial& hfmMat, const GLTFMaterial& mat
 template<typename T, typename L>
 bool GLTFSerializer::readArray(const hifi::ByteArray& bin, int byteOffset, int count,
                            QVector<L>& outarray, int accessorType) {
-    
-    QDataStream blobstream(bin);
-    blobstream.setByteOrder(QDataStream::LittleEndian);
-    blobstream.setVersion(QDataStream::Qt_5_9);
-    blobstream.setFloatingPointPrecision(QDataStream::FloatingPointPrecision::SinglePrecision);
-    blobstream.skipRawData(byteOffset);
 
     int bufferCount = 0;
     switch (accessorType) {
@@ -1868,24 +1862,28 @@ bool GLTFSerializer::readArray(const hifi::ByteArray& bin, int byteOffset, int c
         break;
     default:
         qWarning(modelformat) << "Unknown accessorType: " << accessorType;
-        blobstream.setDevice(nullptr);
         return false;
     }
-    for (int i = 0; i < count; ++i) {
-        for (int j = 0; j < bufferCount; ++j) {
-            if (!blobstream.atEnd()) {
-                T value;
-                blobstream >> value;
-                outarray.push_back(value);
-            } else {
-                blobstream.setDevice(nullptr);
-                return false;
-            }
-        }
+
+    // decode straight out of the buffer, stopping at the last whole value if the accessor overruns it
+    qint64 requestedValues = (qint64)count * bufferCount;
+    qint64 availableValues = (byteOffset >= 0 && byteOffset < bin.size()) ? (bin.size() - byteOffset) / (qint64)sizeof(T) : 0;
+    qint64 numValues = std::max((qint64)0, std::min(requestedValues, availableValues));
+
+    const char* source = bin.constData() + byteOffset;
+    int firstValue = outarray.size();
+    outarray.resize(firstValue + (int)numValues);
+    L* destination = outarray.data() + firstValue;
+    for (qint64 i = 0; i < numValues; ++i) {
+        T value;
+        memcpy(&value, source + i * sizeof(T), sizeof(T));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        std::reverse(reinterpret_cast<char*>(&value), reinterpret_cast<char*>(&value) + sizeof(T));
+#endif
+        destination[i] = (L)value;
     }
 
-    blobstream.setDevice(nullptr);
-    return true;
+    return numValues == requestedValues;
 }
 template<typename T>
 bool GLTFSerializer::addArrayOfType(const hifi::ByteArray& bin, int byteOffset, int count,
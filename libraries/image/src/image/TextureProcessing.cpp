@@ -11,6 +11,8 @@
 
 #include "TextureProcessing.h"
 
+#include <thread>
+
 #include <glm/gtc/packing.hpp>
 
 #include <QtCore/QtGlobal>
@@ -23,6 +25,7 @@
 #include <Profile.h>
 #include <StatTracker.h>
 #include <GLMHelpers.h>
+#include <TBBHelpers.h>
 
 #include "TGAReader.h"
 #if !defined(Q_OS_ANDROID)
@@ -45,6 +48,7 @@ static const glm::uvec2 MAX_TEXTURE_SIZE_GL(4096);
 bool DEV_DECIMATE_TEXTURES = false;
 std::atomic<size_t> DECIMATED_TEXTURE_COUNT{ 0 };
 std::atomic<size_t> RECTIFIED_TEXTURE_COUNT{ 0 };
+static std::atomic<int> MAX_COMPRESSION_THREADS{ 0 };
 
 // we use a ref here to work around static order initialization
 // possibly causing the element not to be constructed yet
@@ -81,6 +85,20 @@ const QStringList getSupportedFormats() {
     return stringFormats;
 }
 
+void setMaxCompressionThreads(int maxThreads) {
+    MAX_COMPRESSION_THREADS.store(std::max(maxThreads, 0));
+}
+
+int getMaxCompressionThreads() {
+    return MAX_COMPRESSION_THREADS.load();
+}
+
+static int getCompressionConcurrency() {
+    int maxThreads = MAX_COMPRESSION_THREADS.load();
+    int numCores = std::max((int)std::thread::hardware_concurrency(), 1);
+    return (maxThreads > 0) ? std::min(maxThreads, numCores) : numCores;
+}
+
 
 // On GLES, we don't use HDR skyboxes
 bool isHDRTextureFormatEnabledForTarget(BackendTarget target) {
@@ -501,21 +519,42 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
 };
 
 #if defined(NVTT_API)
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+// NVTT splits each mip into independent block compression tasks, so we spread them over the TBB pool.
+// The arena caps how many cores a single texture can take, and every chunk checks the abort flag
+// so that a cancelled texture stops compressing as soon as the in-flight chunks complete.
+class ParallelTaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing = false) : _abortProcessing(abortProcessing) {
+    ParallelTaskDispatcher(const std::atomic<bool>& abortProcessing) :
+        _abortProcessing(abortProcessing),
+        _arena(getCompressionConcurrency()) {
     }
 
     const std::atomic<bool>& _abortProcessing;
+    tbb::task_arena _arena;
 
     void dispatch(nvtt::Task* task, void* context, int count) override {
-        for (int i = 0; i < count; i++) {
-            if (!_abortProcessing.load()) {
+        static const int TASK_GRAIN_SIZE = 16;
+
+        if (count <= TASK_GRAIN_SIZE || _arena.max_concurrency() <= 1) {
+            for (int i = 0; i < count; i++) {
+                if (_abortProcessing.load()) {
+                    break;
+                }
                 task(context, i);
-            } else {
-                break;
             }
+            return;
         }
+
+        _arena.execute([&] {
+            tbb::parallel_for(tbb::blocked_range<int>(0, count, TASK_GRAIN_SIZE), [&](const tbb::blocked_range<int>& range) {
+                if (_abortProcessing.load()) {
+                    return;
+                }
+                for (int i = range.begin(); i < range.end(); i++) {
+                    task(context, i);
+                }
+            });
+        });
     }
 };
 #endif
@@ -622,8 +661,7 @@ void convertImageToHDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
     surface.setAlphaMode(nvtt::AlphaMode_None);
     surface.setWrapMode(nvtt::WrapMode_Mirror);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
+    ParallelTaskDispatcher dispatcher(abortProcessing);
     context.setTaskDispatcher(&dispatcher);
 
     context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
@@ -759,8 +797,9 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
         MyErrorHandler errorHandler;
         outputOptions.setErrorHandler(&errorHandler);
 
-        SequentialTaskDispatcher dispatcher(abortProcessing);
+        ParallelTaskDispatcher dispatcher(abortProcessing);
         nvtt::Compressor context;
+        context.setTaskDispatcher(&dispatcher);
 
         context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
         if (buildMips) {
@@ -807,13 +846,19 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
 
         const Etc::ErrorMetric errorMetric = Etc::ErrorMetric::RGBA;
         const float effort = 1.0f;
-        const int numEncodeThreads = 4;
+        const unsigned int numEncodeThreads = (unsigned int)getCompressionConcurrency();
         int encodingTime;
 
         if (localCopy.getFormat() != Image::Format_RGBAF) {
             localCopy = localCopy.getConvertedToFormat(Image::Format_RGBAF);
         }
 
+        // Etc2Comp can't be interrupted once started, so bail out before committing to the encode
+        if (abortProcessing.load()) {
+            delete[] mipMaps;
+            return;
+        }
+
         Etc::EncodeMipmaps(
             (float *)localCopy.editBits(), width, height,
             etcFormat, errorMetric, effort,
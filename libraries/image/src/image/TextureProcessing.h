@@ -121,6 +121,10 @@ gpu::TexturePointer processCubeTextureColorFromImage(Image&& srcImage, const std
 
 const QStringList getSupportedFormats();
 
+// Caps the number of threads compressing a single texture (0 means use every core)
+void setMaxCompressionThreads(int maxThreads);
+int getMaxCompressionThreads();
+
 gpu::TexturePointer processImage(std::shared_ptr<QIODevice> content, const std::string& url, ColorChannel sourceChannel,
                                  int maxNumPixels, TextureUsage::Type textureType,
                                  bool compress, gpu::BackendTarget target, const std::atomic<bool>& abortProcessing = false);
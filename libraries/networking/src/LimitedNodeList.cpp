@@ -35,6 +35,7 @@
 #include "Assignment.h"
 #include "HifiSockAddr.h"
 #include "NetworkLogging.h"
+#include "udt/BBRCC.h"
 #include "udt/Packet.h"
 #include "HMACAuth.h"
 
@@ -229,6 +230,24 @@ QUdpSocket& LimitedNodeList::getDTLSSocket() {
     return *_dtlsSocket;
 }
 
+bool LimitedNodeList::setCongestionControl(const QString& name) {
+    if (name == CONGESTION_CONTROL_VEGAS) {
+        _nodeSocket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory> {
+            new udt::CongestionControlFactory<udt::TCPVegasCC>()
+        });
+    } else if (name == CONGESTION_CONTROL_BBR) {
+        _nodeSocket.setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory> {
+            new udt::CongestionControlFactory<udt::BBRCC>()
+        });
+    } else {
+        qCWarning(networking) << "Unknown congestion control" << name << "- keeping the current one";
+        return false;
+    }
+
+    qCInfo(networking) << "Using" << name << "congestion control for new connections";
+    return true;
+}
+
 bool LimitedNodeList::isPacketVerifiedWithSource(const udt::Packet& packet, Node* sourceNode) {
     // We track bandwidth when doing packet verification to avoid needing to do a node lookup
     // later when we already do it in packetSourceAndHashMatchAndTrackBandwidth. A node lookup
@@ -66,6 +66,9 @@ const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::Lo
 
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 
+const QString CONGESTION_CONTROL_VEGAS = "vegas";
+const QString CONGESTION_CONTROL_BBR = "bbr";
+
 using ConnectionID = int64_t;
 const ConnectionID NULL_CONNECTION_ID { -1 };
 const ConnectionID INITIAL_CONNECTION_ID { 0 };
@@ -311,6 +314,9 @@ public:
 
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
 
+    // Picks the congestion control of the reliable connections created from now on, CONGESTION_CONTROL_VEGAS by default
+    bool setCongestionControl(const QString& name);
+
     void setPacketFilterOperator(udt::PacketFilterOperator filterOperator) { _nodeSocket.setPacketFilterOperator(filterOperator); }
     bool packetVersionMatch(const udt::Packet& packet);
 
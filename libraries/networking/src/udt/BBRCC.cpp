@@ -0,0 +1,393 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <cmath>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+using namespace udt;
+using namespace std::chrono;
+
+// 2 / ln(2), the smallest gain that doubles the sending rate every round trip
+static const double HIGH_GAIN = 2.885;
+static const double PROBE_BANDWIDTH_WINDOW_GAIN = 2.0;
+
+// one round trip probing for more bandwidth, one draining the queue it made, then six cruising
+static const double PROBE_BANDWIDTH_GAINS[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int NUM_PROBE_BANDWIDTH_GAINS = sizeof(PROBE_BANDWIDTH_GAINS) / sizeof(PROBE_BANDWIDTH_GAINS[0]);
+static const int DRAIN_PROBE_BANDWIDTH_GAIN_INDEX = 1;
+
+static const int BANDWIDTH_FILTER_ROUNDS = 10;
+static const auto MIN_RTT_FILTER_LENGTH = seconds(10);
+static const auto PROBE_RTT_DURATION = milliseconds(200);
+
+static const double FULL_PIPE_GROWTH = 1.25;
+static const int FULL_PIPE_ROUNDS = 3;
+
+static const int INITIAL_WINDOW_PACKETS = 10;
+static const int MIN_WINDOW_PACKETS = 4;
+static const int WINDOW_QUANTUM_PACKETS = 3; // room for the receiver's ACK batching
+
+static const int MAX_RTT_SAMPLE_MICROSECONDS = 10000000;
+// before any RTT sample, long enough for the first packets to make it across the world and back
+static const int INITIAL_TIMEOUT_MICROSECONDS = 1000000;
+static const int MAX_TIMEOUT_BACKOFF = 16;
+static const int RENO_FAST_RETRANSMIT_DUPLICATE_COUNT = 3;
+
+BBRCC::BBRCC() :
+    _pacingGain(HIGH_GAIN),
+    _windowGain(HIGH_GAIN)
+{
+    // no pacing until the first bandwidth sample, the initial window goes out at once
+    _packetSendPeriod = 0.0;
+    _congestionWindowSize = INITIAL_WINDOW_PACKETS;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (_sentPacketDatas.empty()) {
+        // nothing was in flight, the delivery rate is measured from now on
+        _firstSendTime = timePoint;
+        _deliveredTime = timePoint;
+    }
+
+    // a packet sent later than paced while the window had room means there was nothing to send,
+    // the delivery rate it measures says more about the application than about the network
+    int packetsInFlight = std::max(seqoff(_lastACK, seqNum) - 1, 0);
+    auto sinceLastSend = duration_cast<microseconds>(timePoint - _lastSendTime).count();
+    bool isAppLimited = packetsInFlight + 1 < _congestionWindowSize && sinceLastSend > 2 * _packetSendPeriod;
+    _lastSendTime = timePoint;
+
+    SentPacketData data;
+    data.sequenceNumber = seqNum;
+    data.sendTime = timePoint;
+    data.firstSendTime = _firstSendTime;
+    data.deliveredTime = _deliveredTime;
+    data.delivered = _delivered;
+    data.isAppLimited = isAppLimited;
+    _sentPacketDatas.push_back(data);
+}
+
+void BBRCC::onPacketReSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    auto it = std::lower_bound(_sentPacketDatas.begin(), _sentPacketDatas.end(), seqNum,
+                               [](const SentPacketData& data, SequenceNumber seqNum) {
+        return data.sequenceNumber < seqNum;
+    });
+
+    // if it wasn't ACKed yet, it can't be used for RTT or delivery rate samples anymore
+    if (it != _sentPacketDatas.end() && it->sequenceNumber == seqNum) {
+        it->wasResent = true;
+        it->resendTime = timePoint;
+        it->resendDeliveredBound = _delivered + _numDuplicateACKs + getPacketsInFlight();
+    }
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    bool wasDuplicateACK = (ack == _lastACK);
+
+    if (ack > _lastACK) {
+        int numACKed = seqoff(_lastACK, ack);
+        _lastACK = ack;
+        _duplicateACKCount = 0;
+        _congestionWindowSize -= _windowInflation;
+        _windowInflation = 0;
+
+        _delivered += numACKed;
+        _deliveredTime = receiveTime;
+
+        // the most recently sent of the packets this ACK covers gives the samples
+        bool hasSample = false;
+        SentPacketData sample;
+        while (!_sentPacketDatas.empty() && _sentPacketDatas.front().sequenceNumber <= ack) {
+            sample = _sentPacketDatas.front();
+            hasSample = true;
+            _sentPacketDatas.pop_front();
+        }
+
+        _isRoundStart = false;
+        if (hasSample) {
+            _firstSendTime = sample.sendTime;
+
+            if (sample.delivered >= _nextRoundDelivered) {
+                _nextRoundDelivered = _delivered;
+                ++_round;
+                _isRoundStart = true;
+            }
+
+            if (!sample.wasResent) {
+                updateRTT((int)duration_cast<microseconds>(receiveTime - sample.sendTime).count(), receiveTime);
+                updateBandwidth(sample, receiveTime);
+            }
+        }
+
+        checkFullPipe();
+        updateMode(receiveTime);
+        updateControls(numACKed);
+    } else if (wasDuplicateACK) {
+        ++_numDuplicateACKs;
+
+        // the ACKs are cumulative, so while a loss holds them back the packets sent after it look in flight.
+        // Each duplicate ACK is one of them out of the network though, let another one in for it (like Reno's
+        // fast recovery) until the ACKs move again
+        if (_congestionWindowSize < udt::MAX_PACKETS_IN_FLIGHT) {
+            ++_congestionWindowSize;
+            ++_windowInflation;
+        }
+    }
+
+    return needsFastRetransmit(ack, wasDuplicateACK, receiveTime);
+}
+
+void BBRCC::onTimeout() {
+    // everything in flight is going to be re-sent, none of it can be used for samples
+    for (auto& data : _sentPacketDatas) {
+        data.wasResent = true;
+    }
+
+    // start over from a small window, the ACKs grow it back to what the model says
+    _congestionWindowSize = MIN_WINDOW_PACKETS;
+    _windowInflation = 0;
+
+    // a startup that lost a whole window overshot the bottleneck's buffer, what it measured so far is the pipe
+    if (_mode == Mode::Startup && _delivered > 0) {
+        _isPipeFull = true;
+    }
+
+    // and wait longer next time, in case the RTT grew past the timeout (no sample would ever say so otherwise)
+    _timeoutBackoff = std::min(_timeoutBackoff * 2, MAX_TIMEOUT_BACKOFF);
+}
+
+int BBRCC::estimatedTimeout() const {
+    return getRetransmitTimeout() * _timeoutBackoff;
+}
+
+int BBRCC::getRetransmitTimeout() const {
+    return _ewmaRTT == -1 ? INITIAL_TIMEOUT_MICROSECONDS : _ewmaRTT + _rttVariance * 4;
+}
+
+void BBRCC::updateRTT(int rtt, p_high_resolution_clock::time_point now) {
+    if (rtt < 0) {
+        Q_ASSERT_X(false, __FUNCTION__, "calculated an RTT that is not > 0");
+        return;
+    }
+    rtt = std::min(std::max(rtt, 1), MAX_RTT_SAMPLE_MICROSECONDS);
+    _timeoutBackoff = 1;
+
+    // Jacobson's estimation, for the timeouts only
+    if (_ewmaRTT == -1) {
+        _ewmaRTT = rtt;
+        _rttVariance = rtt / 2;
+    } else {
+        static const int RTT_ESTIMATION_ALPHA = 8;
+        static const int RTT_ESTIMATION_VARIANCE_ALPHA = 4;
+
+        _ewmaRTT = (_ewmaRTT * (RTT_ESTIMATION_ALPHA - 1) + rtt) / RTT_ESTIMATION_ALPHA;
+        _rttVariance = (_rttVariance * (RTT_ESTIMATION_VARIANCE_ALPHA - 1)
+                        + abs(rtt - _ewmaRTT)) / RTT_ESTIMATION_VARIANCE_ALPHA;
+    }
+
+    // the propagation delay is the min RTT, re-measured once it gets too old since queues only ever add to it
+    _isMinRTTExpired = _minRTT != -1 && now > _minRTTTimestamp + MIN_RTT_FILTER_LENGTH;
+    if (_minRTT == -1 || rtt <= _minRTT || _isMinRTTExpired) {
+        _minRTT = rtt;
+        _minRTTTimestamp = now;
+    }
+}
+
+void BBRCC::updateBandwidth(const SentPacketData& packet, p_high_resolution_clock::time_point now) {
+    // the slowest of the send and ACK rates over the packet's flight, ACKs bunched up on the way back would
+    // otherwise make the bandwidth look higher than it is
+    auto sendInterval = duration_cast<microseconds>(packet.sendTime - packet.firstSendTime).count();
+    auto ackInterval = duration_cast<microseconds>(now - packet.deliveredTime).count();
+    auto interval = std::max(sendInterval, ackInterval);
+    if (interval <= 0) {
+        return;
+    }
+
+    double packetsPerSecond = (double)(_delivered - packet.delivered) * USECS_PER_SECOND / interval;
+
+    // application limited samples only say the bandwidth is at least that much
+    _isSampleAppLimited = packet.isAppLimited;
+    if (packet.isAppLimited && packetsPerSecond < getBandwidth()) {
+        return;
+    }
+
+    // windowed max: older samples below a new one can never be the max again
+    while (!_bandwidthFilter.empty() && _bandwidthFilter.back().packetsPerSecond <= packetsPerSecond) {
+        _bandwidthFilter.pop_back();
+    }
+    _bandwidthFilter.push_back({ _round, packetsPerSecond });
+    while (_bandwidthFilter.front().round + BANDWIDTH_FILTER_ROUNDS <= _round) {
+        _bandwidthFilter.pop_front();
+    }
+}
+
+double BBRCC::getBandwidthDelayProduct() const {
+    double bandwidth = getBandwidth();
+    if (_minRTT == -1 || bandwidth == 0.0) {
+        return INITIAL_WINDOW_PACKETS;
+    }
+    return bandwidth * _minRTT / USECS_PER_SECOND;
+}
+
+void BBRCC::checkFullPipe() {
+    // the pipe is full once the bandwidth stops growing by a quarter for a few rounds
+    if (_isPipeFull || !_isRoundStart || _isSampleAppLimited) {
+        return;
+    }
+
+    double bandwidth = getBandwidth();
+    if (bandwidth >= _fullBandwidth * FULL_PIPE_GROWTH) {
+        _fullBandwidth = bandwidth;
+        _numRoundsWithoutGrowth = 0;
+        return;
+    }
+
+    if (++_numRoundsWithoutGrowth >= FULL_PIPE_ROUNDS) {
+        _isPipeFull = true;
+    }
+}
+
+void BBRCC::enterProbeBandwidth(p_high_resolution_clock::time_point now) {
+    _mode = Mode::ProbeBandwidth;
+    _windowGain = PROBE_BANDWIDTH_WINDOW_GAIN;
+
+    // start anywhere but in the draining phase, so that connections sharing a link don't probe in lockstep
+    _cycleIndex = randIntInRange(0, NUM_PROBE_BANDWIDTH_GAINS - 2);
+    if (_cycleIndex >= DRAIN_PROBE_BANDWIDTH_GAIN_INDEX) {
+        ++_cycleIndex;
+    }
+    _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+    _cycleStart = now;
+}
+
+void BBRCC::updateMode(p_high_resolution_clock::time_point now) {
+    double bandwidthDelayProduct = getBandwidthDelayProduct();
+    int packetsInFlight = getPacketsInFlight();
+
+    if (_mode == Mode::Startup && _isPipeFull) {
+        // drain the queue startup made
+        _mode = Mode::Drain;
+        _pacingGain = 1.0 / HIGH_GAIN;
+        _windowGain = HIGH_GAIN;
+    }
+
+    if (_mode == Mode::Drain && packetsInFlight <= bandwidthDelayProduct) {
+        enterProbeBandwidth(now);
+    }
+
+    if (_mode == Mode::ProbeBandwidth) {
+        // each phase lasts a min RTT, the probing one until it had a chance to fill the pipe above the estimate
+        // and the draining one only until the extra is gone
+        auto phaseDuration = now - _cycleStart;
+        auto minRTT = microseconds(_minRTT);
+        double gain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+
+        bool isPhaseDone = phaseDuration > minRTT;
+        if (gain > 1.0) {
+            isPhaseDone = isPhaseDone && (packetsInFlight >= gain * bandwidthDelayProduct || phaseDuration > 2 * minRTT);
+        } else if (gain < 1.0) {
+            isPhaseDone = isPhaseDone || packetsInFlight <= bandwidthDelayProduct;
+        }
+
+        if (isPhaseDone) {
+            _cycleIndex = (_cycleIndex + 1) % NUM_PROBE_BANDWIDTH_GAINS;
+            _pacingGain = PROBE_BANDWIDTH_GAINS[_cycleIndex];
+            _cycleStart = now;
+        }
+    }
+
+    if (_mode != Mode::ProbeRTT && _isMinRTTExpired) {
+        // the min RTT wasn't seen in a while, briefly empty the queues to measure it again
+        _mode = Mode::ProbeRTT;
+        _pacingGain = 1.0;
+        _windowGain = 1.0;
+        _windowBeforeProbeRTT = _congestionWindowSize;
+        _probeRTTDoneRound = -1;
+        _isMinRTTExpired = false;
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        if (_probeRTTDoneRound == -1) {
+            if (packetsInFlight <= MIN_WINDOW_PACKETS) {
+                // hold the small window for a while and a round trip
+                _probeRTTDoneTime = now + PROBE_RTT_DURATION;
+                _probeRTTDoneRound = _round + 1;
+            }
+        } else if (now >= _probeRTTDoneTime && _round >= _probeRTTDoneRound) {
+            _minRTTTimestamp = now;
+            _congestionWindowSize = std::max(_congestionWindowSize, _windowBeforeProbeRTT);
+
+            if (_isPipeFull) {
+                enterProbeBandwidth(now);
+            } else {
+                _mode = Mode::Startup;
+                _pacingGain = HIGH_GAIN;
+                _windowGain = HIGH_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::updateControls(int numACKed) {
+    double bandwidth = getBandwidth();
+    if (bandwidth > 0.0) {
+        setPacketSendPeriod(USECS_PER_SECOND / (_pacingGain * bandwidth));
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = std::min(_congestionWindowSize, MIN_WINDOW_PACKETS);
+        return;
+    }
+
+    // the window follows the model, growing by what is ACKed so that it never lets out a burst
+    int targetWindowSize = (int)std::ceil(_windowGain * getBandwidthDelayProduct()) + WINDOW_QUANTUM_PACKETS;
+    if (_isPipeFull) {
+        _congestionWindowSize = std::min(_congestionWindowSize + numACKed, targetWindowSize);
+    } else if (_congestionWindowSize < targetWindowSize || _delivered < INITIAL_WINDOW_PACKETS) {
+        _congestionWindowSize += numACKed;
+    }
+
+    _congestionWindowSize = std::min(std::max(_congestionWindowSize, MIN_WINDOW_PACKETS), udt::MAX_PACKETS_IN_FLIGHT);
+}
+
+bool BBRCC::needsFastRetransmit(SequenceNumber ack, bool wasDuplicateACK, p_high_resolution_clock::time_point now) {
+    if (wasDuplicateACK) {
+        ++_duplicateACKCount;
+    }
+
+    if (_sentPacketDatas.empty() || _sentPacketDatas.front().sequenceNumber != ack + 1) {
+        return false;
+    }
+
+    // losses don't change the model, but the packet holding the ACK back should go again soon: after a few
+    // duplicate ACKs (like Reno) or a timeout since it was sent. Once re-sent, it is lost again when what was in
+    // flight with it and a few more got through first, or after a timeout. The timeouts don't back off here,
+    // the ACKs are still coming
+    auto& next = _sentPacketDatas.front();
+    auto timeout = microseconds(getRetransmitTimeout());
+    if (next.wasResent && now - next.resendTime < timeout) {
+        int64_t numDeliveredSinceResend = _delivered + _numDuplicateACKs - next.resendDeliveredBound;
+        if (numDeliveredSinceResend >= RENO_FAST_RETRANSMIT_DUPLICATE_COUNT) {
+            _duplicateACKCount = 0;
+            return true;
+        }
+        return false;
+    }
+
+    if (_duplicateACKCount >= RENO_FAST_RETRANSMIT_DUPLICATE_COUNT || now - next.sendTime >= timeout) {
+        _duplicateACKCount = 0;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,126 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <algorithm>
+#include <deque>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Model based congestion control, after BBR: the bottleneck bandwidth is the max of the delivery rates measured over
+// the last few round trips and the propagation delay is the min RTT over the last few seconds. Packets are paced at
+// a gain times the bandwidth and the window is a gain times their product, so queues at the bottleneck stay short and
+// random losses don't slow the connection down the way they do loss or delay based controls.
+// Sizes are in packets, like the rest of the send queue.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onTimeout() override;
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+    virtual void onPacketReSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+    virtual int estimatedTimeout() const override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    enum class Mode { Startup, Drain, ProbeBandwidth, ProbeRTT };
+
+    struct SentPacketData {
+        SequenceNumber sequenceNumber;
+        p_high_resolution_clock::time_point sendTime;
+        p_high_resolution_clock::time_point firstSendTime; // send time of the last delivered packet when this was sent
+        p_high_resolution_clock::time_point deliveredTime; // time of the last delivery when this was sent
+        int64_t delivered; // packets delivered when this was sent
+        bool isAppLimited;
+        bool wasResent { false };
+        p_high_resolution_clock::time_point resendTime;
+        int64_t resendDeliveredBound { 0 }; // deliveries and duplicate ACKs by the time it should have made it
+    };
+
+    struct BandwidthSample {
+        int64_t round;
+        double packetsPerSecond;
+    };
+
+    void updateRTT(int rtt, p_high_resolution_clock::time_point now);
+    void updateBandwidth(const SentPacketData& packet, p_high_resolution_clock::time_point now);
+    void checkFullPipe();
+    void updateMode(p_high_resolution_clock::time_point now);
+    void enterProbeBandwidth(p_high_resolution_clock::time_point now);
+    void updateControls(int numACKed);
+
+    int getRetransmitTimeout() const;
+    bool needsFastRetransmit(SequenceNumber ack, bool wasDuplicateACK, p_high_resolution_clock::time_point now);
+
+    double getBandwidth() const { return _bandwidthFilter.empty() ? 0.0 : _bandwidthFilter.front().packetsPerSecond; }
+    double getBandwidthDelayProduct() const; // in packets
+    int getPacketsInFlight() const { return std::max(seqoff(_lastACK, _sendCurrSeqNum), 0); }
+
+    std::deque<SentPacketData> _sentPacketDatas; // not ACKed yet, in sequence number order
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _windowGain;
+
+    // delivery rate estimation
+    int64_t _delivered { 0 };
+    p_high_resolution_clock::time_point _deliveredTime;
+    p_high_resolution_clock::time_point _firstSendTime;
+    p_high_resolution_clock::time_point _lastSendTime;
+
+    // round trips, a round ends when a packet sent after it started is ACKed
+    int64_t _round { 0 };
+    int64_t _nextRoundDelivered { 0 };
+    bool _isRoundStart { false };
+
+    std::deque<BandwidthSample> _bandwidthFilter; // decreasing max over the last rounds
+    bool _isSampleAppLimited { false };
+
+    // full pipe detection, to leave startup
+    bool _isPipeFull { false };
+    double _fullBandwidth { 0.0 };
+    int _numRoundsWithoutGrowth { 0 };
+
+    int _minRTT { -1 }; // microseconds
+    p_high_resolution_clock::time_point _minRTTTimestamp;
+    bool _isMinRTTExpired { false };
+    p_high_resolution_clock::time_point _probeRTTDoneTime;
+    int64_t _probeRTTDoneRound { -1 };
+    int _windowBeforeProbeRTT { 0 };
+
+    int _cycleIndex { 0 };
+    p_high_resolution_clock::time_point _cycleStart;
+
+    // for the timeouts
+    int _ewmaRTT { -1 };
+    int _rttVariance { 0 };
+    int _timeoutBackoff { 1 };
+
+    SequenceNumber _lastACK;
+    int _duplicateACKCount { 0 };
+    int _windowInflation { 0 }; // packets added to the window for the duplicate ACKs
+    int64_t _numDuplicateACKs { 0 };
+};
+
+}
+
+#endif // hifi_BBRCC_h
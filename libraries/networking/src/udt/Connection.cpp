@@ -67,21 +67,13 @@ Connection::~Connection() {
 }
 
 void Connection::stopSendQueue() {
-    if (auto sendQueue = _sendQueue.release()) {
-        // grab the send queue thread so we can wait on it
-        QThread* sendQueueThread = sendQueue->thread();
-        
+    if (auto sendQueue = std::move(_sendQueue)) {
         // tell the send queue to stop and be deleted
-        
         sendQueue->stop();
 
         _lastMessageNumber = sendQueue->getCurrentMessageNumber();
 
-        sendQueue->deleteLater();
-        
-        // wait on the send queue thread so we know the send queue is gone
-        sendQueueThread->quit();
-        sendQueueThread->wait();
+        // deleting the send queue waits for the scheduler to be done with it, so we know the send queue is gone
     }
 }
 
@@ -95,14 +87,15 @@ SendQueue& Connection::getSendQueue() {
         // receiver is getting the sequence numbers it expects (given that the connection must still be active)
 
         // Lasily create send queue
+        auto scheduler = _parentSocket->getSendQueueScheduler();
 
         if (!_hasReceivedHandshakeACK) {
             // First time creating a send queue for this connection
-            _sendQueue = SendQueue::create(_parentSocket, _destination, _initialSequenceNumber - 1, _lastMessageNumber, _hasReceivedHandshakeACK);
+            _sendQueue = SendQueue::create(_parentSocket, scheduler, _destination, _initialSequenceNumber - 1, _lastMessageNumber, _hasReceivedHandshakeACK);
             _lastReceivedACK = _sendQueue->getCurrentSequenceNumber();
         } else {
             // Connection already has a handshake from a previous send queue
-            _sendQueue = SendQueue::create(_parentSocket, _destination, _lastReceivedACK, _lastMessageNumber, _hasReceivedHandshakeACK);
+            _sendQueue = SendQueue::create(_parentSocket, scheduler, _destination, _lastReceivedACK, _lastMessageNumber, _hasReceivedHandshakeACK);
         }
 
 #ifdef UDT_CONNECTION_DEBUG
@@ -11,174 +11,283 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "ControlPacket.h"
 
 using namespace udt;
-using namespace std;
 
-void LossList::append(SequenceNumber seq) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < seq), "LossList::append(SequenceNumber)",
-               "SequenceNumber appended is not greater than the last SequenceNumber in the list");
-    
-    if (getLength() > 0 && _lossList.back().second + 1 == seq) {
-        ++_lossList.back().second;
-    } else {
-        _lossList.push_back(make_pair(seq, seq));
+static const size_t MIN_NUM_WORDS = 4;
+
+static inline int countTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+static inline int countLeadingZeros(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, bits);
+    return 63 - (int)index;
+#else
+    return __builtin_clzll(bits);
+#endif
+}
+
+static inline int countBits(uint64_t bits) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(bits);
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+// bits first to last (included) of a word
+static inline uint64_t bitRange(int first, int last) {
+    return (~uint64_t(0) << first) & (~uint64_t(0) >> (63 - last));
+}
+
+void LossList::clear() {
+    for (int i = 0; i < numWords(); ++i) {
+        word(i) = 0;
     }
-    _length += 1;
+    _firstWord = 0;
+    _numBits = 0;
+    _length = 0;
 }
 
 void LossList::append(SequenceNumber start, SequenceNumber end) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < start),
+    Q_ASSERT_X(isEmpty() || (_first + (_numBits - 1) < start),
                "LossList::append(SequenceNumber, SequenceNumber)",
                "SequenceNumber range appended is not greater than the last SequenceNumber in the list");
-    Q_ASSERT_X(start <= end,
-               "LossList::append(SequenceNumber, SequenceNumber)", "Range start greater than range end");
 
-    if (getLength() > 0 && _lossList.back().second + 1 == start) {
-        _lossList.back().second = end;
-    } else {
-        _lossList.push_back(make_pair(start, end));
-    }
-    _length += seqlen(start, end);
+    insert(start, end);
 }
 
 void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
-    
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
-    
-    if (it == _lossList.end() || end < it->first) {
-        // No overlap, simply insert
-        _length += seqlen(start, end);
-        _lossList.insert(it, make_pair(start, end));
-    } else {
-        // If it starts before segment, extend segment
-        if (start < it->first) {
-            _length += seqlen(start, it->first - 1);
-            it->first = start;
-        }
-        
-        // If it ends after segment, extend segment
-        if (end > it->second) {
-            _length += seqlen(it->second + 1, end);
-            it->second = end;
-        }
-        
-        auto it2 = it;
-        ++it2;
-        // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
-            // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
-            }
-            
-            // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
+
+    if (seqlen(start, end) > MAX_SPAN) {
+        start = end - (MAX_SPAN - 1);
+    }
+
+    // forget the losses that would be too far behind before growing the ring for them
+    if (_length > 0) {
+        int endOffset = seqoff(_first, end);
+        if (endOffset >= MAX_SPAN) {
+            _length -= clearBits(0, endOffset - MAX_SPAN);
+            trim();
         }
     }
+
+    if (_length == 0) {
+        _first = start;
+        _firstWord = 0;
+        _numBits = 0;
+    } else if (start < _first) {
+        // move the front of the ring back by whole words, they are already clear
+        int numNewWords = (seqoff(start, _first) + 63) / 64;
+        reserve(_numBits + numNewWords * 64);
+        _firstWord = (_firstWord - numNewWords) & (_words.size() - 1);
+        _first -= numNewWords * 64;
+        _numBits += numNewWords * 64;
+    }
+
+    int lastOffset = seqoff(_first, end);
+    reserve(lastOffset + 1);
+    _length += setBits(seqoff(_first, start), lastOffset);
+
+    if (_numBits > MAX_SPAN + 64) {
+        _length -= clearBits(0, _numBits - MAX_SPAN - 1);
+        trim();
+    }
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
-    
-    if (it != end(_lossList)) {
-        if (it->first == it->second) {
-            _lossList.erase(it);
-        } else if (seq == it->first) {
-            ++it->first;
-        } else if (seq == it->second) {
-            --it->second;
-        } else {
-            auto temp = it->second;
-            it->second = seq - 1;
-            _lossList.insert(++it, make_pair(seq + 1, temp));
-        }
-        _length -= 1;
-        
-        // this sequence number was found in the loss list, return true
-        return true;
-    } else {
+    if (_length == 0) {
+        return false;
+    }
+
+    int offset = seqoff(_first, seq);
+    if (offset < 0 || offset >= _numBits) {
         // this sequence number was not found in the loss list, return false
         return false;
     }
+
+    uint64_t& bits = word(offset / 64);
+    uint64_t mask = uint64_t(1) << (offset % 64);
+    if ((bits & mask) == 0) {
+        return false;
+    }
+
+    bits &= ~mask;
+    --_length;
+    trim();
+
+    // this sequence number was found in the loss list, return true
+    return true;
 }
 
 void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
-    // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
-    });
-    
-    // If we found one
-    if (it != _lossList.end()) {
-        
-        // While the end of the current segment is contained, either shorten it (first one only - sometimes)
-        // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
-            } else {
-                // Beginning of segment not contained, modify end of segment.
-                // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
-            }
-        }
-        
-        // There might be more to remove
-        if (it != _lossList.end() && it->first <= end) {
-            if (start <= it->first) {
-                // Truncate beginning of segment
-                _length -= seqlen(it->first, end);
-                it->first = end + 1;
-            } else {
-                // Cut it in half if the range we are removing is contained within one segment
-                _length -= seqlen(start, end);
-                auto temp = it->second;
-                it->second = start - 1;
-                _lossList.insert(++it, make_pair(end + 1, temp));
-            }
-        }
+
+    if (_length == 0) {
+        return;
+    }
+
+    int first = std::max(seqoff(_first, start), 0);
+    int last = std::min(seqoff(_first, end), _numBits - 1);
+    if (first <= last) {
+        _length -= clearBits(first, last);
+        trim();
     }
 }
 
 SequenceNumber LossList::getFirstSequenceNumber() const {
     Q_ASSERT_X(getLength() > 0, "LossList::getFirstSequenceNumber()", "Trying to get first element of an empty list");
-    return _lossList.front().first;
+
+    // the first word is never empty
+    return _first + countTrailingZeros(word(0));
 }
 
 SequenceNumber LossList::popFirstSequenceNumber() {
     auto front = getFirstSequenceNumber();
-    remove(front);
+
+    uint64_t& bits = word(0);
+    bits &= bits - 1;
+    --_length;
+    trim();
+
     return front;
 }
 
 void LossList::write(ControlPacket& packet, int maxPairs) {
     int writtenPairs = 0;
-    
-    for (const auto& pair : _lossList) {
-        packet.writePrimitive(pair.first);
-        packet.writePrimitive(pair.second);
-        
+
+    int start = findSet(0);
+    while (start < _numBits) {
+        int end = findClear(start);
+
+        packet.writePrimitive(_first + start);
+        packet.writePrimitive(_first + (end - 1));
+
         ++writtenPairs;
-        
+
         // check if we've written the maximum number we were told to write
         if (maxPairs != -1 && writtenPairs >= maxPairs) {
             break;
         }
+
+        start = findSet(end);
+    }
+}
+
+void LossList::reserve(int numBits) {
+    size_t numNeededWords = (size_t)(numBits + 63) / 64;
+    if (numNeededWords <= _words.size()) {
+        return;
+    }
+
+    size_t size = std::max(_words.size(), MIN_NUM_WORDS);
+    while (size < numNeededWords) {
+        size *= 2;
+    }
+
+    std::vector<uint64_t> words(size, 0);
+    for (int i = 0; i < numWords(); ++i) {
+        words[i] = word(i);
+    }
+    _words.swap(words);
+    _firstWord = 0;
+}
+
+int LossList::setBits(int first, int last) {
+    int numSet = 0;
+    int firstIndex = first / 64;
+    int lastIndex = last / 64;
+    for (int i = firstIndex; i <= lastIndex; ++i) {
+        uint64_t mask = bitRange(i == firstIndex ? first % 64 : 0, i == lastIndex ? last % 64 : 63);
+        uint64_t& bits = word(i);
+        numSet += countBits(mask & ~bits);
+        bits |= mask;
+    }
+    _numBits = std::max(_numBits, last + 1);
+    return numSet;
+}
+
+int LossList::clearBits(int first, int last) {
+    int numCleared = 0;
+    int firstIndex = first / 64;
+    int lastIndex = last / 64;
+    for (int i = firstIndex; i <= lastIndex; ++i) {
+        uint64_t mask = bitRange(i == firstIndex ? first % 64 : 0, i == lastIndex ? last % 64 : 63);
+        uint64_t& bits = word(i);
+        numCleared += countBits(mask & bits);
+        bits &= ~mask;
+    }
+    return numCleared;
+}
+
+void LossList::trim() {
+    if (_length == 0) {
+        // all the words are clear already
+        _firstWord = 0;
+        _numBits = 0;
+        return;
+    }
+
+    while (word(0) == 0) {
+        _firstWord = (_firstWord + 1) & (_words.size() - 1);
+        _first += 64;
+        _numBits -= 64;
+    }
+
+    int lastIndex = numWords() - 1;
+    while (word(lastIndex) == 0) {
+        --lastIndex;
+    }
+    _numBits = lastIndex * 64 + 64 - countLeadingZeros(word(lastIndex));
+}
+
+int LossList::findSet(int from) const {
+    if (from >= _numBits) {
+        return _numBits;
+    }
+
+    int index = from / 64;
+    uint64_t bits = word(index) & (~uint64_t(0) << (from % 64));
+    while (bits == 0) {
+        if (++index >= numWords()) {
+            return _numBits;
+        }
+        bits = word(index);
+    }
+    return index * 64 + countTrailingZeros(bits);
+}
+
+int LossList::findClear(int from) const {
+    if (from >= _numBits) {
+        return _numBits;
+    }
+
+    int index = from / 64;
+    uint64_t bits = ~word(index) & (~uint64_t(0) << (from % 64));
+    while (bits == 0) {
+        if (++index >= numWords()) {
+            return _numBits;
+        }
+        bits = ~word(index);
     }
+    return std::min(index * 64 + countTrailingZeros(bits), _numBits);
 }
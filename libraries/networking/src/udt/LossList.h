@@ -12,25 +12,29 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <cstdint>
+#include <vector>
 
 #include "SequenceNumber.h"
 
 namespace udt {
 
 class ControlPacket;
-    
+
+// The lost sequence numbers are bits in a ring of words that starts at the first loss, so adding and removing
+// losses is a few word operations and doesn't allocate once the ring is big enough for the losses in flight.
+// Losses further than MAX_SPAN behind the last one are forgotten.
 class LossList {
 public:
     LossList() {}
     
-    void clear() { _length = 0; _lossList.clear(); }
+    void clear();
     
-    // must always add at the end - faster than insert
-    void append(SequenceNumber seq);
+    // must always add at the end
+    void append(SequenceNumber seq) { append(seq, seq); }
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere
     void insert(SequenceNumber start, SequenceNumber end);
     
     bool remove(SequenceNumber seq);
@@ -42,9 +46,25 @@ public:
     SequenceNumber popFirstSequenceNumber();
     
     void write(ControlPacket& packet, int maxPairs = -1);
+
+    static const int MAX_SPAN = 1 << 20;
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    uint64_t& word(int index) { return _words[(_firstWord + index) & (_words.size() - 1)]; }
+    uint64_t word(int index) const { return _words[(_firstWord + index) & (_words.size() - 1)]; }
+    int numWords() const { return (_numBits + 63) / 64; }
+
+    void reserve(int numBits);
+    int setBits(int first, int last); // returns the number of bits that were not set
+    int clearBits(int first, int last); // returns the number of bits that were set
+    void trim(); // drops the empty words at the front and the clear bits at the back
+    int findSet(int from) const;
+    int findClear(int from) const;
+
+    std::vector<uint64_t> _words; // power of two size, the words outside of the used ones are always zero
+    SequenceNumber _first; // sequence number of the first bit of the first used word
+    size_t _firstWord { 0 };
+    int _numBits { 0 }; // one past the last loss
     int _length { 0 };
 };
     
@@ -15,10 +15,7 @@
 
 using namespace udt;
 
-PacketQueue::PacketQueue(MessageNumber messageNumber) : _currentMessageNumber(messageNumber) {
-    _channels.emplace_front(new std::list<PacketPointer>());
-    _currentChannel = _channels.begin();
-}
+PacketQueue::PacketQueue(MessageNumber messageNumber) : _currentMessageNumber(messageNumber) {}
 
 MessageNumber PacketQueue::getNextMessageNumber() {
     static const MessageNumber MAX_MESSAGE_NUMBER = MessageNumber(1) << MESSAGE_NUMBER_SIZE;
@@ -30,7 +27,7 @@ bool PacketQueue::isEmpty() const {
     LockGuard locker(_packetsLock);
 
     // Only the main channel and it is empty
-    return _channels.size() == 1 && _channels.front()->empty();
+    return _channels.empty() && _mainChannel.empty();
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
@@ -41,27 +38,34 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     }
 
     // handle the case where we are looking at the first channel and it is empty
-    if (_currentChannel == _channels.begin() && (*_currentChannel)->empty()) {
+    if (_currentChannel == 0 && _mainChannel.empty()) {
         ++_currentChannel;
     }
 
     // at this point the current channel should always not be at the end and should also not be empty
-    Q_ASSERT(_currentChannel != _channels.end());
+    Q_ASSERT(_currentChannel <= _channels.size());
 
-    auto& channel = *_currentChannel;
+    PacketPointer packet;
+    if (_currentChannel == 0) {
+        // Take front packet
+        packet = std::move(_mainChannel.front());
+        _mainChannel.pop_front();
+        ++_currentChannel;
+    } else {
+        auto& channel = _channels[_currentChannel - 1];
 
-    Q_ASSERT(!channel->empty());
+        Q_ASSERT(!channel.empty());
 
-    // Take front packet
-    auto packet = std::move(channel->front());
-    channel->pop_front();
+        // Take front packet
+        packet = std::move(channel.front());
+        channel.pop_front();
 
-    // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentChannel != _channels.begin()) {
-        // erase the current channel and slide the iterator to the next channel
-        _currentChannel = _channels.erase(_currentChannel);
-    } else {
-        ++_currentChannel;
+        // Remove now empty channel, the next channel slides in its place
+        if (channel.empty()) {
+            _channels.erase(_channels.begin() + (_currentChannel - 1));
+        } else {
+            ++_currentChannel;
+        }
     }
 
     // push forward our number of channels taken from
@@ -71,9 +75,9 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     // to respect our capped number of channels considered concurrently
     static const int MAX_CHANNELS_SENT_CONCURRENTLY = 16;
 
-    if (_currentChannel == _channels.end() || _channelsVisitedCount >= MAX_CHANNELS_SENT_CONCURRENTLY) {
+    if (_currentChannel > _channels.size() || _channelsVisitedCount >= MAX_CHANNELS_SENT_CONCURRENTLY) {
         _channelsVisitedCount = 0;
-        _currentChannel = _channels.begin();
+        _currentChannel = 0;
     }
 
     return packet;
@@ -81,7 +85,7 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _mainChannel.push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
@@ -90,6 +94,6 @@ void PacketQueue::queuePacketList(PacketListPointer packetList) {
     }
 
     LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    _channels.emplace_back();
+    _channels.back().swap(packetList->_packets);
 }
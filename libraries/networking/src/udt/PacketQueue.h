@@ -12,6 +12,7 @@
 #ifndef hifi_PacketQueue_h
 #define hifi_PacketQueue_h
 
+#include <deque>
 #include <list>
 #include <vector>
 #include <memory>
@@ -30,9 +31,8 @@ class PacketQueue {
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
-    using RawChannel = std::list<PacketPointer>;
-    using Channel = std::unique_ptr<RawChannel>;
-    using Channels = std::list<Channel>;
+    using Channel = std::list<PacketPointer>; // Taken from the packet list, its nodes are reused
+    using Channels = std::deque<Channel>;
     
 public:
     PacketQueue(MessageNumber messageNumber = 0);
@@ -52,9 +52,10 @@ private:
     MessageNumber _currentMessageNumber { 0 };
     
     mutable Mutex _packetsLock; // Protects the packets to be sent.
-    Channels _channels; // One channel per packet list + Main channel
+    std::deque<PacketPointer> _mainChannel; // Single packets, its blocks are reused as packets go through
+    Channels _channels; // One channel per packet list
 
-    Channels::iterator _currentChannel;
+    size_t _currentChannel { 0 }; // 0 is the main channel, then _channels[_currentChannel - 1]
     unsigned int _channelsVisitedCount { 0 };
 };
 
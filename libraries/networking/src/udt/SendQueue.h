@@ -13,15 +13,12 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 
 #include <QtCore/QObject>
-#include <QtCore/QReadWriteLock>
 
 #include <PortableHighResolutionClock.h>
 
@@ -29,6 +26,7 @@
 
 #include "Constants.h"
 #include "PacketQueue.h"
+#include "SentPacketBuffer.h"
 #include "SequenceNumber.h"
 #include "LossList.h"
 
@@ -39,7 +37,10 @@ class ControlPacket;
 class Packet;
 class PacketList;
 class Socket;
-    
+class SendQueueScheduler;
+
+// Sends the reliable packets of a Connection. It has no thread of its own: its Socket's SendQueueScheduler services
+// it whenever it has something to do, paced by the congestion control.
 class SendQueue : public QObject {
     Q_OBJECT
     
@@ -50,7 +51,7 @@ public:
         Stopped
     };
     
-    static std::unique_ptr<SendQueue> create(Socket* socket, HifiSockAddr destination,
+    static std::unique_ptr<SendQueue> create(Socket* socket, SendQueueScheduler* scheduler, HifiSockAddr destination,
                                              SequenceNumber currentSequenceNumber, MessageNumber currentMessageNumber,
                                              bool hasReceivedHandshakeACK);
 
@@ -85,15 +86,20 @@ signals:
 
     void timeout();
     
-private slots:
-    void run();
-    
 private:
-    SendQueue(Socket* socket, HifiSockAddr dest, SequenceNumber currentSequenceNumber,
+    friend class SendQueueScheduler;
+
+    SendQueue(Socket* socket, SendQueueScheduler* scheduler, HifiSockAddr dest, SequenceNumber currentSequenceNumber,
               MessageNumber currentMessageNumber, bool hasReceivedHandshakeACK);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
+    // Called by the scheduler: sends what is due at now, returns in how many microseconds it wants to be serviced again
+    // or SendQueueScheduler::SERVICE_WHEN_WOKEN to wait for new packets, ACKs or losses
+    int64_t service(p_high_resolution_clock::time_point now);
+    int64_t serviceWhileIdle(p_high_resolution_clock::time_point now);
+    void wake();
+
     void sendHandshake();
     
     int sendPacket(const Packet& packet);
@@ -102,7 +108,6 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
     void deactivate(); // makes the queue inactive and cleans it up
 
     bool isFlowWindowFull() const;
@@ -113,6 +118,10 @@ private:
     PacketQueue _packets;
     
     Socket* _socket { nullptr }; // Socket to send packet on
+    SendQueueScheduler* _scheduler { nullptr };
+    int _schedulerWorkerIndex { -1 }; // Set by the scheduler
+
+    std::mutex _destinationLock; // Protects the destination, changed from the connection's thread
     HifiSockAddr _destination; // Destination addr
     
     std::atomic<uint32_t> _lastACKSequenceNumber { 0 }; // Last ACKed sequence number
@@ -130,17 +139,17 @@ private:
     mutable std::mutex _naksLock; // Protects the naks list.
     LossList _naks; // Sequence numbers of packets to resend
     
-    mutable QReadWriteLock _sentLock; // Protects the sent packet list
-    using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
-    std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
+    mutable std::mutex _sentLock; // Protects the sent packet list
+    SentPacketBuffer _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
 
-    std::chrono::high_resolution_clock::time_point _lastPacketSentAt;
+    // Only used by service(), on the scheduler's thread
+    p_high_resolution_clock::time_point _nextHandshakeTimestamp;
+    p_high_resolution_clock::time_point _nextPacketTimestamp;
+    p_high_resolution_clock::time_point _lastPacketSentAt;
+    p_high_resolution_clock::time_point _idleSince; // when the receiver ACKed everything and there was nothing left to send
+    p_high_resolution_clock::time_point _stuckSince; // when the queue started waiting for ACKs with nothing to send
 
     static const std::chrono::microseconds MAXIMUM_ESTIMATED_TIMEOUT;
     static const std::chrono::microseconds MINIMUM_ESTIMATED_TIMEOUT;
@@ -0,0 +1,303 @@
+//
+//  SendQueueScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueScheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#include <QtCore/QThread>
+
+#include <NumericalConstants.h>
+#include <PortableHighResolutionClock.h>
+#include <TimerWheel.h>
+
+#include "SendQueue.h"
+
+using namespace udt;
+using namespace std::chrono;
+
+// Services due sooner than this are kept in a heap and timed to the microsecond (packet pacing),
+// later ones go on the millisecond timer wheel (handshake re-sends, timeouts)
+static const int64_t MAX_PACED_SERVICE_USECS = 2000;
+
+class SendQueueScheduler::Worker : public QThread {
+public:
+    Worker(int index);
+    ~Worker();
+
+    void add(SendQueue* queue);
+    void remove(SendQueue* queue);
+    void wake(SendQueue* queue);
+
+    size_t getNumQueues();
+
+protected:
+    void run() override;
+
+private:
+    using Clock = p_high_resolution_clock;
+
+    struct Entry {
+        TimerWheel::TimerID timerID { TimerWheel::INVALID_TIMER_ID };
+        uint64_t pacedToken { 0 }; // matches the heap entry of the next paced service, zero when there is none
+        bool ready { false };
+    };
+
+    struct PacedService {
+        Clock::time_point time;
+        SendQueue* queue;
+        uint64_t token;
+        bool operator>(const PacedService& other) const { return time > other.time; }
+    };
+
+    uint64_t toMsecs(Clock::time_point time) const { return duration_cast<milliseconds>(time - _epoch).count(); }
+
+    void makeReady(SendQueue* queue, Entry& entry);
+    void schedule(SendQueue* queue, Entry& entry, int64_t usecs, Clock::time_point now);
+    void unschedule(Entry& entry);
+    void collectDueServices(Clock::time_point now);
+    void waitForServices(std::unique_lock<std::mutex>& lock, Clock::time_point now);
+
+    std::mutex _mutex;
+    std::condition_variable _condition; // wakes the worker
+    std::condition_variable _servicedCondition; // wakes remove()
+    bool _stopping { false };
+
+    std::unordered_map<SendQueue*, Entry> _queues;
+    std::deque<SendQueue*> _ready;
+    std::priority_queue<PacedService, std::vector<PacedService>, std::greater<PacedService>> _pacedServices;
+    uint64_t _nextPacedToken { 1 };
+
+    const Clock::time_point _epoch { Clock::now() };
+    TimerWheel _timers { 0 };
+    std::unordered_map<TimerWheel::TimerID, SendQueue*> _timerQueues;
+    std::vector<TimerWheel::TimerID> _expiredTimers;
+
+    SendQueue* _servicing { nullptr };
+};
+
+SendQueueScheduler::Worker::Worker(int index) {
+    setObjectName("Networking: SendQueueScheduler " + QString::number(index)); // Name thread for easier debug
+    start();
+}
+
+SendQueueScheduler::Worker::~Worker() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_one();
+    wait();
+}
+
+void SendQueueScheduler::Worker::add(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        makeReady(queue, _queues[queue]);
+    }
+    _condition.notify_one();
+}
+
+void SendQueueScheduler::Worker::remove(SendQueue* queue) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _servicedCondition.wait(lock, [&] { return _servicing != queue; });
+
+    auto itr = _queues.find(queue);
+    if (itr != _queues.end()) {
+        // a stale pointer may stay in the ready list or in the heap, it is skipped since its entry is gone
+        unschedule(itr->second);
+        _queues.erase(itr);
+    }
+}
+
+void SendQueueScheduler::Worker::wake(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto itr = _queues.find(queue);
+        if (itr == _queues.end() || itr->second.ready) {
+            return;
+        }
+        makeReady(queue, itr->second);
+    }
+    _condition.notify_one();
+}
+
+size_t SendQueueScheduler::Worker::getNumQueues() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queues.size();
+}
+
+void SendQueueScheduler::Worker::makeReady(SendQueue* queue, Entry& entry) {
+    if (!entry.ready) {
+        entry.ready = true;
+        _ready.push_back(queue);
+    }
+}
+
+void SendQueueScheduler::Worker::schedule(SendQueue* queue, Entry& entry, int64_t usecs, Clock::time_point now) {
+    if (usecs == SERVICE_WHEN_WOKEN) {
+        return;
+    } else if (usecs <= SERVICE_NOW) {
+        // behind the other ready queues, so that a busy queue doesn't starve them
+        makeReady(queue, entry);
+    } else if (usecs < MAX_PACED_SERVICE_USECS) {
+        entry.pacedToken = _nextPacedToken++;
+        _pacedServices.push({ now + microseconds(usecs), queue, entry.pacedToken });
+    } else {
+        uint32_t msecs = (uint32_t)((usecs + (int64_t)USECS_PER_MSEC - 1) / (int64_t)USECS_PER_MSEC);
+        entry.timerID = _timers.add(toMsecs(now), msecs, true);
+        _timerQueues[entry.timerID] = queue;
+    }
+}
+
+void SendQueueScheduler::Worker::unschedule(Entry& entry) {
+    if (entry.timerID != TimerWheel::INVALID_TIMER_ID) {
+        _timers.remove(entry.timerID);
+        _timerQueues.erase(entry.timerID);
+        entry.timerID = TimerWheel::INVALID_TIMER_ID;
+    }
+    entry.pacedToken = 0;
+}
+
+void SendQueueScheduler::Worker::collectDueServices(Clock::time_point now) {
+    while (!_pacedServices.empty() && _pacedServices.top().time <= now) {
+        PacedService service = _pacedServices.top();
+        _pacedServices.pop();
+        auto itr = _queues.find(service.queue);
+        if (itr != _queues.end() && itr->second.pacedToken == service.token) {
+            itr->second.pacedToken = 0;
+            makeReady(service.queue, itr->second);
+        }
+    }
+
+    if (!_timers.isEmpty()) {
+        _expiredTimers.clear();
+        _timers.advance(toMsecs(now), _expiredTimers);
+        for (auto timerID : _expiredTimers) {
+            auto timerItr = _timerQueues.find(timerID);
+            if (timerItr == _timerQueues.end()) {
+                continue;
+            }
+            SendQueue* queue = timerItr->second;
+            _timerQueues.erase(timerItr);
+            auto itr = _queues.find(queue);
+            if (itr != _queues.end() && itr->second.timerID == timerID) {
+                itr->second.timerID = TimerWheel::INVALID_TIMER_ID;
+                makeReady(queue, itr->second);
+            }
+        }
+    }
+}
+
+void SendQueueScheduler::Worker::waitForServices(std::unique_lock<std::mutex>& lock, Clock::time_point now) {
+    int64_t waitUsecs = -1;
+    if (!_pacedServices.empty()) {
+        waitUsecs = std::max((int64_t)0, (int64_t)duration_cast<microseconds>(_pacedServices.top().time - now).count());
+    }
+    int64_t timerMsecs = _timers.msecsUntilNextExpiry(toMsecs(now));
+    if (timerMsecs >= 0 && (waitUsecs < 0 || timerMsecs * (int64_t)USECS_PER_MSEC < waitUsecs)) {
+        waitUsecs = timerMsecs * (int64_t)USECS_PER_MSEC;
+    }
+
+    if (waitUsecs < 0) {
+        _condition.wait(lock);
+    } else if (waitUsecs > 0) {
+        _condition.wait_for(lock, microseconds(waitUsecs));
+    }
+}
+
+void SendQueueScheduler::Worker::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopping) {
+        auto now = Clock::now();
+        collectDueServices(now);
+
+        if (_ready.empty()) {
+            waitForServices(lock, now);
+            continue;
+        }
+
+        SendQueue* queue = _ready.front();
+        _ready.pop_front();
+        auto itr = _queues.find(queue);
+        if (itr == _queues.end()) {
+            continue;
+        }
+        // the queue says when it wants to be serviced next, forget what it asked for before
+        itr->second.ready = false;
+        unschedule(itr->second);
+
+        _servicing = queue;
+        lock.unlock();
+
+        int64_t nextServiceUsecs = queue->service(now);
+
+        lock.lock();
+        _servicing = nullptr;
+        _servicedCondition.notify_all();
+
+        // remove() waits for the service to end, so the entry is still there
+        itr = _queues.find(queue);
+        if (itr != _queues.end()) {
+            schedule(queue, itr->second, nextServiceUsecs, Clock::now());
+        }
+    }
+}
+
+SendQueueScheduler::SendQueueScheduler(int numThreads) :
+    _numThreads(numThreads > 0 ? numThreads : std::max(1, std::min(4, QThread::idealThreadCount() / 4)))
+{
+}
+
+SendQueueScheduler::~SendQueueScheduler() {
+    std::lock_guard<std::mutex> lock(_workersMutex);
+    _workers.clear();
+}
+
+void SendQueueScheduler::add(SendQueue* queue) {
+    Worker* leastBusyWorker = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_workersMutex);
+        if (_workers.empty()) {
+            for (int i = 0; i < _numThreads; ++i) {
+                _workers.emplace_back(new Worker(i));
+            }
+        }
+
+        size_t leastNumQueues = 0;
+        for (size_t i = 0; i < _workers.size(); ++i) {
+            size_t numQueues = _workers[i]->getNumQueues();
+            if (!leastBusyWorker || numQueues < leastNumQueues) {
+                leastBusyWorker = _workers[i].get();
+                leastNumQueues = numQueues;
+                queue->_schedulerWorkerIndex = (int)i;
+            }
+        }
+    }
+    leastBusyWorker->add(queue);
+}
+
+void SendQueueScheduler::remove(SendQueue* queue) {
+    // the workers are only created once, by the first add(), so they can be used without _workersMutex
+    if (queue->_schedulerWorkerIndex >= 0) {
+        _workers[queue->_schedulerWorkerIndex]->remove(queue);
+    }
+}
+
+void SendQueueScheduler::wake(SendQueue* queue) {
+    if (queue->_schedulerWorkerIndex >= 0) {
+        _workers[queue->_schedulerWorkerIndex]->wake(queue);
+    }
+}
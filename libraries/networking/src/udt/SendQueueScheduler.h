@@ -0,0 +1,53 @@
+//
+//  SendQueueScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendQueueScheduler_h
+#define hifi_SendQueueScheduler_h
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace udt {
+
+class SendQueue;
+
+// Drives the SendQueues of a Socket from a few shared threads, instead of one thread per reliable connection.
+// A queue is serviced when it is woken up (new packets, ACKs, losses, handshake ACK) or when the time it asked for
+// comes: paced sends are scheduled precisely, longer waits (handshake re-sends, timeouts) go on a timer wheel.
+// Each queue stays on the same thread, so it is never serviced by two threads at once.
+class SendQueueScheduler {
+public:
+    SendQueueScheduler(int numThreads = 0); // 0 picks a number of threads from the number of cores
+    ~SendQueueScheduler();
+
+    void add(SendQueue* queue);
+    // Blocks until the queue isn't being serviced, it is never serviced again after that
+    void remove(SendQueue* queue);
+    // Services the queue as soon as possible
+    void wake(SendQueue* queue);
+
+    int getNumThreads() const { return _numThreads; }
+
+    // What SendQueue::service returns
+    static const int64_t SERVICE_WHEN_WOKEN = -1;
+    static const int64_t SERVICE_NOW = 0;
+
+private:
+    class Worker;
+
+    int _numThreads;
+    std::mutex _workersMutex;
+    std::vector<std::unique_ptr<Worker>> _workers; // started with the first queue
+};
+
+}
+
+#endif // hifi_SendQueueScheduler_h
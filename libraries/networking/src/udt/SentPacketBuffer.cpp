@@ -0,0 +1,83 @@
+//
+//  SentPacketBuffer.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketBuffer.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+static const size_t MIN_NUM_ENTRIES = 64;
+
+void SentPacketBuffer::add(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet) {
+    if (_count == 0) {
+        _first = sequenceNumber;
+    }
+
+    int offset = seqoff(_first, sequenceNumber);
+    Q_ASSERT_X(offset == _count, "SentPacketBuffer::add()", "Packet added out of sequence number order");
+    if (offset < 0) {
+        return;
+    }
+
+    // leave a hole for skipped sequence numbers, they are never found
+    while (offset >= (int)_entries.size()) {
+        grow();
+    }
+    if (offset < _count) {
+        entry(offset).numResends = 0;
+        entry(offset).packet = std::move(packet);
+        return;
+    }
+    _count = offset + 1;
+    entry(offset).packet = std::move(packet);
+}
+
+void SentPacketBuffer::removeUpTo(SequenceNumber sequenceNumber) {
+    if (_count == 0) {
+        return;
+    }
+
+    int numRemoved = std::min(seqoff(_first, sequenceNumber) + 1, _count);
+    for (int i = 0; i < numRemoved; ++i) {
+        auto& removed = entry(i);
+        removed.numResends = 0;
+        removed.packet.reset();
+    }
+
+    if (numRemoved > 0) {
+        _head = (_head + numRemoved) & (_entries.size() - 1);
+        _first += numRemoved;
+        _count -= numRemoved;
+    }
+}
+
+SentPacketBuffer::Entry* SentPacketBuffer::find(SequenceNumber sequenceNumber) {
+    if (_count == 0) {
+        return nullptr;
+    }
+
+    int offset = seqoff(_first, sequenceNumber);
+    if (offset < 0 || offset >= _count) {
+        return nullptr;
+    }
+
+    auto& found = entry(offset);
+    return found.packet ? &found : nullptr;
+}
+
+void SentPacketBuffer::grow() {
+    std::vector<Entry> entries(std::max(_entries.size() * 2, MIN_NUM_ENTRIES));
+    for (int i = 0; i < _count; ++i) {
+        entries[i] = std::move(entry(i));
+    }
+    _entries.swap(entries);
+    _head = 0;
+}
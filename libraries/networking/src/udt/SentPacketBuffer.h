@@ -0,0 +1,57 @@
+//
+//  SentPacketBuffer.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SentPacketBuffer_h
+#define hifi_SentPacketBuffer_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Packet.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+// The packets sent and waiting for an ACK, in a ring indexed by their offset from the oldest one.
+// Packets are added in sequence number order and ACKed from the front, so nothing is hashed or allocated per packet
+// once the ring is as big as the flow window.
+class SentPacketBuffer {
+public:
+    struct Entry {
+        uint8_t numResends { 0 };
+        std::unique_ptr<Packet> packet;
+    };
+
+    // Packets must be added with the sequence number following the last one added
+    void add(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet);
+
+    // Releases the packets up to and including this sequence number
+    void removeUpTo(SequenceNumber sequenceNumber);
+
+    // Returns nullptr if this packet was ACKed already, or was never sent
+    Entry* find(SequenceNumber sequenceNumber);
+
+    bool isEmpty() const { return _count == 0; }
+    int getCount() const { return _count; }
+
+private:
+    Entry& entry(int offset) { return _entries[(_head + offset) & (_entries.size() - 1)]; }
+    void grow();
+
+    std::vector<Entry> _entries; // power of two size
+    size_t _head { 0 };
+    int _count { 0 };
+    SequenceNumber _first; // sequence number of the entry at the head
+};
+
+}
+
+#endif // hifi_SentPacketBuffer_h
@@ -491,6 +491,9 @@ void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* r
 }
 
 void Socket::setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory) {
+    // findOrCreateConnection() uses the factory under the connections lock, and this can be changed at runtime
+    Lock connectionsLock(_connectionsHashMutex);
+
     // swap the current unique_ptr for the new factory
     _ccFactory.swap(ccFactory);
 }
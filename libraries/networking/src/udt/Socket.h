@@ -26,6 +26,7 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "SendQueueScheduler.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -89,6 +90,8 @@ public:
     
     StatsVector sampleStatsForAllConnections();
 
+    SendQueueScheduler* getSendQueueScheduler() { return &_sendQueueScheduler; }
+
 #if (PR_BUILD || DEV_BUILD)
     void sendFakedHandshakeRequest(const HifiSockAddr& sockAddr);
 #endif
@@ -131,6 +134,9 @@ private:
     Mutex _unreliableSequenceNumbersMutex;
     Mutex _connectionsHashMutex;
 
+    // services the send queues of all the connections, declared before them so that it outlives them
+    SendQueueScheduler _sendQueueScheduler;
+
     std::unordered_map<HifiSockAddr, BasePacketHandler> _unfilteredHandlers;
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
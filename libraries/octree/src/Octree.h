@@ -138,6 +138,10 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+    // called under the write lock before and after the edit records of one packet are processed, so that a tree can
+    // do work for all of them at once; the message is at its first edit record and must be left there
+    virtual void beginEditPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { }
+    virtual void endEditPacket() { }
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
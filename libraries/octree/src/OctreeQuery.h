@@ -34,6 +34,7 @@ public:
     int parseData(ReceivedMessage& message) override;
 
     bool hasConicalViews() const { QMutexLocker lock(&_conicalViewsLock); return !_conicalViews.empty(); }
+    ConicalViewFrustums getConicalViews() const { QMutexLocker lock(&_conicalViewsLock); return _conicalViews; }
     void setConicalViews(ConicalViewFrustums views)
         { QMutexLocker lock(&_conicalViewsLock); _conicalViews = views; }
     void clearConicalViews() { QMutexLocker lock(&_conicalViewsLock); _conicalViews.clear(); }
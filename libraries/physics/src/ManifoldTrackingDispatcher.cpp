@@ -0,0 +1,53 @@
+//
+//  ManifoldTrackingDispatcher.cpp
+//  libraries/physics/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ManifoldTrackingDispatcher.h"
+
+#include <algorithm>
+
+ManifoldTrackingDispatcher::ManifoldTrackingDispatcher(btCollisionConfiguration* collisionConfiguration) :
+    btCollisionDispatcher(collisionConfiguration) {
+}
+
+btPersistentManifold* ManifoldTrackingDispatcher::getNewManifold(const btCollisionObject* body0, const btCollisionObject* body1) {
+    btPersistentManifold* manifold = btCollisionDispatcher::getNewManifold(body0, body1);
+    _manifoldsByObject[body0].push_back(manifold);
+    _manifoldsByObject[body1].push_back(manifold);
+    return manifold;
+}
+
+void ManifoldTrackingDispatcher::releaseManifold(btPersistentManifold* manifold) {
+    removeManifold(manifold->getBody0(), manifold);
+    removeManifold(manifold->getBody1(), manifold);
+    btCollisionDispatcher::releaseManifold(manifold);
+}
+
+const ManifoldTrackingDispatcher::Manifolds& ManifoldTrackingDispatcher::getManifolds(const btCollisionObject* object) const {
+    static const Manifolds NO_MANIFOLDS;
+    auto itr = _manifoldsByObject.find(object);
+    return itr != _manifoldsByObject.end() ? itr->second : NO_MANIFOLDS;
+}
+
+void ManifoldTrackingDispatcher::removeManifold(const btCollisionObject* object, btPersistentManifold* manifold) {
+    auto itr = _manifoldsByObject.find(object);
+    if (itr == _manifoldsByObject.end()) {
+        return;
+    }
+    Manifolds& manifolds = itr->second;
+    auto manifoldItr = std::find(manifolds.begin(), manifolds.end(), manifold);
+    if (manifoldItr != manifolds.end()) {
+        *manifoldItr = manifolds.back();
+        manifolds.pop_back();
+    }
+    if (manifolds.empty()) {
+        // forget objects without manifolds, they may be deleted
+        _manifoldsByObject.erase(itr);
+    }
+}
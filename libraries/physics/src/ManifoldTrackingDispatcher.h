@@ -0,0 +1,39 @@
+//
+//  ManifoldTrackingDispatcher.h
+//  libraries/physics/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ManifoldTrackingDispatcher_h
+#define hifi_ManifoldTrackingDispatcher_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <btBulletDynamicsCommon.h>
+
+// A collision dispatcher that keeps track of the contact manifolds of every collision object as Bullet creates and
+// releases them, so that the contacts of one object are found without scanning every manifold of the world.
+class ManifoldTrackingDispatcher : public btCollisionDispatcher {
+public:
+    using Manifolds = std::vector<btPersistentManifold*>;
+
+    ManifoldTrackingDispatcher(btCollisionConfiguration* collisionConfiguration);
+
+    btPersistentManifold* getNewManifold(const btCollisionObject* body0, const btCollisionObject* body1) override;
+    void releaseManifold(btPersistentManifold* manifold) override;
+
+    // the manifolds between object and other objects, some of them may have no contact points
+    const Manifolds& getManifolds(const btCollisionObject* object) const;
+
+private:
+    void removeManifold(const btCollisionObject* object, btPersistentManifold* manifold);
+
+    std::unordered_map<const btCollisionObject*, Manifolds> _manifoldsByObject;
+};
+
+#endif // hifi_ManifoldTrackingDispatcher_h
@@ -218,6 +218,25 @@ void PhysicalEntitySimulation::clearEntitiesInternal() {
     _entitiesToDeleteLater.clear();
 }
 
+void PhysicalEntitySimulation::prepareKinematicStepPeriods() {
+    // one copy of the regions per frame, rather than taking the space's lock for every entity
+    if (_space) {
+        _space->copyRegions(_kinematicRegions);
+    } else {
+        _kinematicRegions.clear();
+    }
+}
+
+uint64_t PhysicalEntitySimulation::getKinematicStepPeriod(const EntityItemPointer& entity, float distanceToViewer) const {
+    // kinematic entities in the physics regions move among physical ones, so they keep stepping every frame
+    int32_t spaceIndex = entity->getSpaceIndex();
+    if (spaceIndex >= 0 && spaceIndex < (int32_t)_kinematicRegions.size() &&
+            _kinematicRegions[spaceIndex] < workload::Region::R3) {
+        return 0;
+    }
+    return EntitySimulation::getKinematicStepPeriod(entity, distanceToViewer);
+}
+
 // virtual
 void PhysicalEntitySimulation::prepareEntityForDelete(EntityItemPointer entity) {
     // this can be called on any thread
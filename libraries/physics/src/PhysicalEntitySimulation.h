@@ -74,6 +74,8 @@ protected: // only called by EntitySimulation
     virtual void removeEntityInternal(EntityItemPointer entity) override;
     void processChangedEntity(const EntityItemPointer& entity) override;
     virtual void clearEntitiesInternal() override;
+    void prepareKinematicStepPeriods() override;
+    uint64_t getKinematicStepPeriod(const EntityItemPointer& entity, float distanceToViewer) const override;
 
     void removeOwnershipData(EntityMotionState* motionState);
     void clearOwnershipData();
@@ -124,6 +126,7 @@ private:
     SetOfEntities _deadAvatarEntities;
     std::vector<EntityItemPointer> _entitiesToDeleteLater;
     workload::SpacePointer _space;
+    std::vector<uint8_t> _kinematicRegions; // the space's regions, copied once per frame for getKinematicStepPeriod()
     uint64_t _nextBidExpiry;
     uint32_t _lastStepSendPackets { 0 };
     uint32_t _lastWorkDeliveryCount { 0 };
@@ -11,6 +11,7 @@
 
 #include "PhysicsEngine.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <QFile>
@@ -18,6 +19,7 @@
 #include <PerfStat.h>
 #include <PhysicsCollisionGroups.h>
 #include <Profile.h>
+#include <TBBHelpers.h>
 #include <BulletCollision/CollisionShapes/btTriangleShape.h>
 
 #include "CharacterController.h"
@@ -45,7 +47,7 @@ PhysicsEngine::~PhysicsEngine() {
 void PhysicsEngine::init() {
     if (!_dynamicsWorld) {
         _collisionConfig = new btDefaultCollisionConfiguration();
-        _collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+        _collisionDispatcher = new ManifoldTrackingDispatcher(_collisionConfig);
         _broadphaseFilter = new btDbvtBroadphase();
         _constraintSolver = new btSequentialImpulseConstraintSolver;
         _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolver, _collisionConfig);
@@ -242,6 +244,10 @@ void PhysicsEngine::addObjects(const VectorOfMotionStates& objects) {
 void PhysicsEngine::reinsertObject(ObjectMotionState* object) {
     // remove object from DynamicsWorld
     bumpAndPruneContacts(object);
+    reinsertBody(object);
+}
+
+void PhysicsEngine::reinsertBody(ObjectMotionState* object) {
     btRigidBody* body = object->getRigidBody();
     if (body) {
         _dynamicsWorld->removeRigidBody(body);
@@ -251,9 +257,14 @@ void PhysicsEngine::reinsertObject(ObjectMotionState* object) {
 }
 
 void PhysicsEngine::processTransaction(PhysicsEngine::Transaction& transaction) {
+    // the contacts of removed and reinserted objects are pruned together, in one pass over the contact map
+    std::vector<ObjectMotionState*> prunedObjects;
+    prunedObjects.reserve(transaction.objectsToRemove.size() + transaction.objectsToReinsert.size());
+
     // removes
     for (auto object : transaction.objectsToRemove) {
-        bumpAndPruneContacts(object);
+        bumpContacts(object);
+        prunedObjects.push_back(object);
         btRigidBody* body = object->getRigidBody();
         if (body) {
             if (body->isStaticObject() && _activeStaticBodies.size() > 0) {
@@ -279,8 +290,11 @@ void PhysicsEngine::processTransaction(PhysicsEngine::Transaction& transaction)
 
     // reinserts
     for (auto object : transaction.objectsToReinsert) {
-        reinsertObject(object);
+        bumpContacts(object);
+        prunedObjects.push_back(object);
+        reinsertBody(object);
     }
+    pruneContacts(prunedObjects);
 
     for (auto object : transaction.activeStaticObjects) {
         btRigidBody* body = object->getRigidBody();
@@ -301,6 +315,24 @@ void PhysicsEngine::removeContacts(ObjectMotionState* motionState) {
     }
 }
 
+void PhysicsEngine::pruneContacts(std::vector<ObjectMotionState*>& motionStates) {
+    if (motionStates.empty()) {
+        return;
+    }
+    std::sort(motionStates.begin(), motionStates.end());
+    auto isPruned = [&](void* motionState) {
+        return std::binary_search(motionStates.begin(), motionStates.end(), static_cast<ObjectMotionState*>(motionState));
+    };
+    ContactMap::iterator contactItr = _contactMap.begin();
+    while (contactItr != _contactMap.end()) {
+        if (isPruned(contactItr->first._a) || isPruned(contactItr->first._b)) {
+            contactItr = _contactMap.erase(contactItr);
+        } else {
+            ++contactItr;
+        }
+    }
+}
+
 void PhysicsEngine::stepSimulation() {
     CProfileManager::Reset();
     BT_PROFILE("stepSimulation");
@@ -403,17 +435,23 @@ void PhysicsEngine::harvestPerformanceStats() {
 
     CProfileIterator* itr = CProfileManager::Get_Iterator();
     if (itr) {
-        // hunt for stepSimulation context
+        // hunt for stepSimulation context, and for the post step work that runs outside of it
+        const QStringList HARVESTED_CONTEXTS { "stepSimulation", "collisionEvents", "copyOutgoingChanges" };
         itr->First();
         for (int32_t childIndex = 0; !itr->Is_Done(); ++childIndex) {
-            if (QString(itr->Get_Current_Name()) == "stepSimulation") {
+            if (HARVESTED_CONTEXTS.contains(QString(itr->Get_Current_Name()))) {
                 itr->Enter_Child(childIndex);
                 StatsHarvester harvester;
                 harvester.recurse(itr, "physics/");
-                break;
+                // recurse() leaves the iterator on this context's parent, which is the root
+                itr->First();
+                for (int32_t i = 0; i < childIndex; ++i) {
+                    itr->Next();
+                }
             }
             itr->Next();
         }
+        CProfileManager::Release_Iterator(itr);
     }
 }
 
@@ -434,66 +472,100 @@ void PhysicsEngine::printPerformanceStatsToFile(const QString& filename) {
     }
 }
 
-void PhysicsEngine::doOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB) {
-    BT_PROFILE("ownershipInfection");
-
-    const btCollisionObject* characterObject = _myAvatarController ? _myAvatarController->getCollisionObject() : nullptr;
-
+PhysicsEngine::Infection PhysicsEngine::computeOwnershipInfection(const btCollisionObject* objectA,
+        const btCollisionObject* objectB, const btCollisionObject* characterObject, const QUuid& sessionID) const {
+    Infection infection;
     ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(objectA->getUserPointer());
     ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(objectB->getUserPointer());
 
     if (motionStateB &&
-        ((motionStateA && motionStateA->getSimulatorID() == Physics::getSessionUUID() && !objectA->isStaticObject()) ||
+        ((motionStateA && motionStateA->getSimulatorID() == sessionID && !objectA->isStaticObject()) ||
          (objectA == characterObject))) {
         // NOTE: we might own the simulation of a kinematic object (A)
         // but we don't claim ownership of kinematic objects (B) based on collisions here.
-        if (!objectB->isStaticOrKinematicObject() && motionStateB->getSimulatorID() != Physics::getSessionUUID()) {
-            uint8_t priorityA = motionStateA ? motionStateA->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
-            motionStateB->bump(priorityA);
+        if (!objectB->isStaticOrKinematicObject() && motionStateB->getSimulatorID() != sessionID) {
+            infection.motionState = motionStateB;
+            infection.priority = motionStateA ? motionStateA->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
         }
     } else if (motionStateA &&
-               ((motionStateB && motionStateB->getSimulatorID() == Physics::getSessionUUID() && !objectB->isStaticObject()) ||
+               ((motionStateB && motionStateB->getSimulatorID() == sessionID && !objectB->isStaticObject()) ||
                 (objectB == characterObject))) {
         // SIMILARLY: we might own the simulation of a kinematic object (B)
         // but we don't claim ownership of kinematic objects (A) based on collisions here.
-        if (!objectA->isStaticOrKinematicObject() && motionStateA->getSimulatorID() != Physics::getSessionUUID()) {
-            uint8_t priorityB = motionStateB ? motionStateB->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
-            motionStateA->bump(priorityB);
+        if (!objectA->isStaticOrKinematicObject() && motionStateA->getSimulatorID() != sessionID) {
+            infection.motionState = motionStateA;
+            infection.priority = motionStateB ? motionStateB->getSimulationPriority() : PERSONAL_SIMULATION_PRIORITY;
         }
     }
+    return infection;
 }
 
+// Below these counts the post step work stays on the physics thread, above them it is spread over the TBB pool
+const int32_t MIN_PARALLEL_MANIFOLDS = 1024;
+const size_t PARALLEL_MANIFOLDS_GRAIN = 256;
+const size_t MIN_PARALLEL_CONSTRAINTS = 256;
+
 void PhysicsEngine::updateContactMap() {
     DETAILED_PROFILE_RANGE(simulation_physics, "updateContactMap");
     BT_PROFILE("updateContactMap");
     ++_numContactFrames;
 
-    // update all contacts every frame
-    int numManifolds = _collisionDispatcher->getNumManifolds();
-    for (int i = 0; i < numManifolds; ++i) {
-        btPersistentManifold* contactManifold =  _collisionDispatcher->getManifoldByIndexInternal(i);
-        if (contactManifold->getNumContacts() > 0) {
-            // TODO: require scripts to register interest in callbacks for specific objects
-            // so we can filter out most collision events right here.
-            const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
-            const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
-
-            if (!(objectA->isActive() || objectB->isActive())) {
-                // both objects are inactive so stop tracking this contact,
-                // which will eventually trigger a CONTACT_EVENT_TYPE_END
-                continue;
-            }
+    const QUuid& sessionID = Physics::getSessionUUID();
+    const bool infectOwnership = !sessionID.isNull();
+    const btCollisionObject* characterObject = _myAvatarController ? _myAvatarController->getCollisionObject() : nullptr;
 
-            ObjectMotionState* a = static_cast<ObjectMotionState*>(objectA->getUserPointer());
-            ObjectMotionState* b = static_cast<ObjectMotionState*>(objectB->getUserPointer());
-            if (a || b) {
-                // the manifold has up to 4 distinct points, but only extract info from the first
-                _contactMap[ContactKey(a, b)].update(_numContactFrames, contactManifold->getContactPoint(0));
+    // update all contacts every frame
+    int32_t numManifolds = _collisionDispatcher->getNumManifolds();
+    _manifoldContacts.resize(numManifolds);
+    auto gatherContacts = [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; ++i) {
+            ManifoldContact& contact = _manifoldContacts[i];
+            contact = ManifoldContact();
+            const btPersistentManifold* contactManifold = _collisionDispatcher->getManifoldByIndexInternal(i);
+            if (contactManifold->getNumContacts() > 0) {
+                // TODO: require scripts to register interest in callbacks for specific objects
+                // so we can filter out most collision events right here.
+                const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
+                const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
+
+                if (!(objectA->isActive() || objectB->isActive())) {
+                    // both objects are inactive so stop tracking this contact,
+                    // which will eventually trigger a CONTACT_EVENT_TYPE_END
+                    continue;
+                }
+                contact.manifold = contactManifold;
+                if (infectOwnership) {
+                    contact.infection = computeOwnershipInfection(objectA, objectB, characterObject, sessionID);
+                }
             }
+        }
+    };
+    {
+        BT_PROFILE("gatherContacts");
+        if (numManifolds < MIN_PARALLEL_MANIFOLDS) {
+            gatherContacts(0, numManifolds);
+        } else {
+            tbb::parallel_for(tbb::blocked_range<int32_t>(0, numManifolds, PARALLEL_MANIFOLDS_GRAIN),
+                [&](const tbb::blocked_range<int32_t>& range) {
+                    gatherContacts(range.begin(), range.end());
+                });
+        }
+    }
 
-            if (!Physics::getSessionUUID().isNull()) {
-                doOwnershipInfection(objectA, objectB);
-            }
+    // the contact map and the motion states are only modified here, on the physics thread, in manifold order
+    BT_PROFILE("applyContacts");
+    for (const auto& contact : _manifoldContacts) {
+        if (!contact.manifold) {
+            continue;
+        }
+        ObjectMotionState* a = static_cast<ObjectMotionState*>(contact.manifold->getBody0()->getUserPointer());
+        ObjectMotionState* b = static_cast<ObjectMotionState*>(contact.manifold->getBody1()->getUserPointer());
+        if (a || b) {
+            // the manifold has up to 4 distinct points, but only extract info from the first
+            _contactMap[ContactKey(a, b)].update(_numContactFrames, contact.manifold->getContactPoint(0));
+        }
+        if (contact.infection.motionState) {
+            contact.infection.motionState->bump(contact.infection.priority);
         }
     }
 }
@@ -501,52 +573,77 @@ void PhysicsEngine::updateContactMap() {
 void PhysicsEngine::doOwnershipInfectionForConstraints() {
     BT_PROFILE("ownershipInfectionForConstraints");
     const btCollisionObject* characterObject = _myAvatarController ? _myAvatarController->getCollisionObject() : nullptr;
+    const QUuid& sessionID = Physics::getSessionUUID();
+
+    // only constraints join several bodies
+    _constraintDynamics.clear();
     foreach(const auto& dynamic, _objectDynamics) {
-        if (!dynamic) {
-            continue;
-        }
-        QList<btRigidBody*> bodies = std::static_pointer_cast<ObjectDynamic>(dynamic)->getRigidBodies();
-        if (bodies.size() > 1) {
-            int32_t numOwned = 0;
-            int32_t numStatic = 0;
-            uint8_t priority = VOLUNTEER_SIMULATION_PRIORITY;
-            foreach(btRigidBody* body, bodies) {
-                ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getUserPointer());
-                if (body->isStaticObject()) {
-                    ++numStatic;
-                } else if (motionState->getType() == MOTIONSTATE_TYPE_AVATAR) {
-                    // we can never take ownership of this constraint
-                    numOwned = 0;
-                    break;
-                } else {
-                    if (motionState && motionState->getSimulatorID() == Physics::getSessionUUID()) {
-                        priority = glm::max(priority, motionState->getSimulationPriority());
-                    } else if (body == characterObject) {
-                        priority = glm::max(priority, PERSONAL_SIMULATION_PRIORITY);
+        if (dynamic && dynamic->isConstraint()) {
+            _constraintDynamics.push_back(std::static_pointer_cast<ObjectDynamic>(dynamic));
+        }
+    }
+
+    // find the priority each constraint bumps its bodies to, without modifying them
+    _constraintBumpPriorities.assign(_constraintDynamics.size(), 0);
+    auto computeBumps = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            QList<btRigidBody*> bodies = _constraintDynamics[i]->getRigidBodies();
+            if (bodies.size() > 1) {
+                int32_t numOwned = 0;
+                int32_t numStatic = 0;
+                uint8_t priority = VOLUNTEER_SIMULATION_PRIORITY;
+                foreach(btRigidBody* body, bodies) {
+                    ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getUserPointer());
+                    if (body->isStaticObject()) {
+                        ++numStatic;
+                    } else if (motionState->getType() == MOTIONSTATE_TYPE_AVATAR) {
+                        // we can never take ownership of this constraint
+                        numOwned = 0;
+                        break;
+                    } else {
+                        if (motionState && motionState->getSimulatorID() == sessionID) {
+                            priority = glm::max(priority, motionState->getSimulationPriority());
+                        } else if (body == characterObject) {
+                            priority = glm::max(priority, PERSONAL_SIMULATION_PRIORITY);
+                        }
+                        numOwned++;
                     }
-                    numOwned++;
                 }
-            }
 
-            if (numOwned > 0) {
-                if (numOwned + numStatic != bodies.size()) {
+                if (numOwned > 0 && numOwned + numStatic != bodies.size()) {
                     // we have partial ownership but it isn't complete so we walk each object
                     // and bump the simulation priority to the highest priority we encountered earlier
-                    foreach(btRigidBody* body, bodies) {
-                        ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getUserPointer());
-                        if (motionState) {
-                            // NOTE: we submit priority+1 because the default behavior of bump() is to actually use priority - 1
-                            // and we want all priorities of the objects to be at the SAME level
-                            motionState->bump(priority + 1);
-                        }
-                    }
+                    // NOTE: we submit priority+1 because the default behavior of bump() is to actually use priority - 1
+                    // and we want all priorities of the objects to be at the SAME level
+                    _constraintBumpPriorities[i] = priority + 1;
+                }
+            }
+        }
+    };
+    if (_constraintDynamics.size() < MIN_PARALLEL_CONSTRAINTS) {
+        computeBumps(0, _constraintDynamics.size());
+    } else {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, _constraintDynamics.size()),
+            [&](const tbb::blocked_range<size_t>& range) {
+                computeBumps(range.begin(), range.end());
+            });
+    }
+
+    for (size_t i = 0; i < _constraintDynamics.size(); ++i) {
+        if (_constraintBumpPriorities[i] > 0) {
+            foreach(btRigidBody* body, _constraintDynamics[i]->getRigidBodies()) {
+                ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getUserPointer());
+                if (motionState) {
+                    motionState->bump(_constraintBumpPriorities[i]);
                 }
             }
         }
     }
+    _constraintDynamics.clear();
 }
 
 const CollisionEvents& PhysicsEngine::getCollisionEvents() {
+    BT_PROFILE("collisionEvents");
     _collisionEvents.clear();
 
     // scan known contacts and trigger events
@@ -654,38 +751,35 @@ void PhysicsEngine::saveNextPhysicsStats(QString filename) {
 // CF_DISABLE_SPU_COLLISION_PROCESSING = 64//disable parallel/SPU processing
 
 void PhysicsEngine::bumpAndPruneContacts(ObjectMotionState* motionState) {
+    bumpContacts(motionState);
+    removeContacts(motionState);
+}
+
+void PhysicsEngine::bumpContacts(ObjectMotionState* motionState) {
     // Find all objects that touch the object corresponding to motionState and flag the other objects
     // for simulation ownership by the local simulation.
 
     assert(motionState);
     btCollisionObject* object = motionState->getRigidBody();
+    if (!object) {
+        return;
+    }
 
-    int numManifolds = _collisionDispatcher->getNumManifolds();
-    for (int i = 0; i < numManifolds; ++i) {
-        btPersistentManifold* contactManifold =  _collisionDispatcher->getManifoldByIndexInternal(i);
+    // the dispatcher knows the manifolds of the object, no need to scan all of them
+    for (btPersistentManifold* contactManifold : _collisionDispatcher->getManifolds(object)) {
         if (contactManifold->getNumContacts() > 0) {
             const btCollisionObject* objectA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
             const btCollisionObject* objectB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
-            if (objectB == object) {
-                if (!objectA->isStaticOrKinematicObject()) {
-                    ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(objectA->getUserPointer());
-                    if (motionStateA) {
-                        motionStateA->bump(VOLUNTEER_SIMULATION_PRIORITY);
-                        objectA->setActivationState(ACTIVE_TAG);
-                    }
-                }
-            } else if (objectA == object) {
-                if (!objectB->isStaticOrKinematicObject()) {
-                    ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(objectB->getUserPointer());
-                    if (motionStateB) {
-                        motionStateB->bump(VOLUNTEER_SIMULATION_PRIORITY);
-                        objectB->setActivationState(ACTIVE_TAG);
-                    }
+            const btCollisionObject* otherObject = (objectA == object) ? objectB : objectA;
+            if (!otherObject->isStaticOrKinematicObject()) {
+                ObjectMotionState* otherMotionState = static_cast<ObjectMotionState*>(otherObject->getUserPointer());
+                if (otherMotionState) {
+                    otherMotionState->bump(VOLUNTEER_SIMULATION_PRIORITY);
+                    otherObject->setActivationState(ACTIVE_TAG);
                 }
             }
         }
     }
-    removeContacts(motionState);
 }
 
 void PhysicsEngine::setCharacterController(CharacterController* character) {
@@ -22,6 +22,7 @@
 
 #include "BulletUtil.h"
 #include "ContactInfo.h"
+#include "ManifoldTrackingDispatcher.h"
 #include "ObjectMotionState.h"
 #include "ThreadSafeDynamicsWorld.h"
 #include "ObjectAction.h"
@@ -165,12 +166,29 @@ private:
 
     /// \brief bump any objects that touch this one, then remove contact info
     void bumpAndPruneContacts(ObjectMotionState* motionState);
-
-    void doOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB);
+    void bumpContacts(ObjectMotionState* motionState);
+    /// \brief remove the contact info of several objects in one pass over the contact map
+    void pruneContacts(std::vector<ObjectMotionState*>& motionStates);
+    void reinsertBody(ObjectMotionState* object);
+
+    // The motion state bumped by the ownership infection of a contact, and the priority it is bumped to
+    struct Infection {
+        ObjectMotionState* motionState { nullptr };
+        uint8_t priority { 0 };
+    };
+    // does not modify anything so contacts can be infected in parallel, the bumps are applied afterwards
+    Infection computeOwnershipInfection(const btCollisionObject* objectA, const btCollisionObject* objectB,
+                                        const btCollisionObject* characterObject, const QUuid& sessionID) const;
+
+    // What updateContactMap gathers from one manifold
+    struct ManifoldContact {
+        const btPersistentManifold* manifold { nullptr }; // null when the manifold has no tracked contact
+        Infection infection;
+    };
 
     btClock _clock;
     btDefaultCollisionConfiguration* _collisionConfig = NULL;
-    btCollisionDispatcher* _collisionDispatcher = NULL;
+    ManifoldTrackingDispatcher* _collisionDispatcher = NULL;
     btBroadphaseInterface* _broadphaseFilter = NULL;
     btSequentialImpulseConstraintSolver* _constraintSolver = NULL;
     ThreadSafeDynamicsWorld* _dynamicsWorld = NULL;
@@ -178,6 +196,9 @@ private:
     std::unique_ptr<PhysicsDebugDraw> _physicsDebugDraw;
 
     ContactMap _contactMap;
+    std::vector<ManifoldContact> _manifoldContacts;
+    std::vector<ObjectDynamicPointer> _constraintDynamics;
+    std::vector<uint8_t> _constraintBumpPriorities; // zero for constraints that don't bump their bodies
     CollisionEvents _collisionEvents;
     QHash<QUuid, EntityDynamicPointer> _objectDynamics;
     QHash<btRigidBody*, QSet<QUuid>> _objectDynamicsByBody;
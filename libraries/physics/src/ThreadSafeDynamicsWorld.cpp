@@ -17,10 +17,18 @@
 
 #include "ThreadSafeDynamicsWorld.h"
 
+#include <algorithm>
+
 #include <LinearMath/btQuickprof.h>
 
+#include <TBBHelpers.h>
+
 #include "Profile.h"
 
+// Below this many bodies the interpolated transforms are computed on the physics thread, above it on the TBB pool
+const int MIN_PARALLEL_SYNC_BODIES = 2048;
+const int PARALLEL_SYNC_GRAIN = 512;
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
@@ -110,11 +118,15 @@ void ThreadSafeDynamicsWorld::synchronizeMotionState(btRigidBody* body) {
         return;
     }
     btTransform interpolatedTransform;
+    computeInterpolatedTransform(body, interpolatedTransform);
+    body->getMotionState()->setWorldTransform(interpolatedTransform);
+}
+
+void ThreadSafeDynamicsWorld::computeInterpolatedTransform(const btRigidBody* body, btTransform& interpolatedTransform) const {
     btTransformUtil::integrateTransform(body->getInterpolationWorldTransform(),
         body->getInterpolationLinearVelocity(),body->getInterpolationAngularVelocity(),
         (m_latencyMotionStateInterpolation && m_fixedTimeStep) ? m_localTime - m_fixedTimeStep : m_localTime*body->getHitFraction(),
         interpolatedTransform);
-    body->getMotionState()->setWorldTransform(interpolatedTransform);
 }
 
 void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
@@ -140,20 +152,59 @@ void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
         // that remembers a list of objects deactivated last step
         _activeStates.clear();
         _deactivatedStates.clear();
-        for (int i=0;i<m_nonStaticRigidBodies.size();i++) {
+
+        // first sort the bodies and compute their interpolated transforms into flat arrays, which only reads
+        // the bodies so it can be spread over threads...
+        int numBodies = m_nonStaticRigidBodies.size();
+        _bodySyncStates.resize(numBodies);
+        _interpolatedTransforms.resize(numBodies);
+        auto computeSyncStates = [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                const btRigidBody* body = m_nonStaticRigidBodies[i];
+                if (!body->getMotionState()) {
+                    _bodySyncStates[i] = BODY_WITHOUT_MOTION_STATE;
+                } else if (body->isActive()) {
+                    _bodySyncStates[i] = BODY_ACTIVE;
+                    if (!body->isKinematicObject()) {
+                        computeInterpolatedTransform(body, _interpolatedTransforms[i]);
+                    }
+                } else {
+                    _bodySyncStates[i] = BODY_INACTIVE;
+                }
+            }
+        };
+        {
+            BT_PROFILE("interpolateTransforms");
+            if (numBodies < MIN_PARALLEL_SYNC_BODIES) {
+                computeSyncStates(0, numBodies);
+            } else {
+                tbb::parallel_for(tbb::blocked_range<int>(0, numBodies, PARALLEL_SYNC_GRAIN),
+                    [&](const tbb::blocked_range<int>& range) {
+                        computeSyncStates(range.begin(), range.end());
+                    });
+            }
+        }
+
+        // ...then hand them to the MotionStates, which update objects outside of the physics engine
+        BT_PROFILE("setWorldTransforms");
+        for (int i = 0; i < numBodies; ++i) {
             btRigidBody* body = m_nonStaticRigidBodies[i];
             ObjectMotionState* motionState = static_cast<ObjectMotionState*>(body->getMotionState());
-            if (motionState) {
-                if (body->isActive()) {
+            if (_bodySyncStates[i] == BODY_ACTIVE) {
+                if (body->isKinematicObject()) {
                     synchronizeMotionState(body);
-                    _changedMotionStates.push_back(motionState);
-                    _activeStates.insert(motionState);
-                } else if (_lastActiveStates.find(motionState) != _lastActiveStates.end()) {
-                    // this object was active last frame but is no longer
-                    _deactivatedStates.push_back(motionState);
+                } else {
+                    motionState->setWorldTransform(_interpolatedTransforms[i]);
                 }
+                _changedMotionStates.push_back(motionState);
+                _activeStates.push_back(motionState);
+            } else if (_bodySyncStates[i] == BODY_INACTIVE &&
+                       std::binary_search(_lastActiveStates.begin(), _lastActiveStates.end(), motionState)) {
+                // this object was active last frame but is no longer
+                _deactivatedStates.push_back(motionState);
             }
         }
+        std::sort(_activeStates.begin(), _activeStates.end());
     }
     _activeStates.swap(_lastActiveStates);
 }
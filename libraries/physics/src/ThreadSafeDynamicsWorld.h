@@ -24,6 +24,7 @@
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <vector>
 
 using SubStepCallback = std::function<void()>;
 
@@ -56,15 +57,28 @@ public:
     virtual void debugDrawObject(const btTransform& worldTransform, const btCollisionShape* shape, const btVector3& color) override;
 
 private:
+    enum BodySyncState : uint8_t {
+        BODY_WITHOUT_MOTION_STATE = 0,
+        BODY_ACTIVE,
+        BODY_INACTIVE
+    };
+
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
+    // the transform synchronizeMotionState() gives to the MotionState of a dynamic body
+    void computeInterpolatedTransform(const btRigidBody* body, btTransform& interpolatedTransform) const;
     void drawConnectedSpheres(btIDebugDraw* drawer, btScalar radius1, btScalar radius2, const btVector3& position1, 
                               const btVector3& position2, const btVector3& color);
 
     VectorOfMotionStates _changedMotionStates;
     VectorOfMotionStates _deactivatedStates;
-    SetOfMotionStates _activeStates;
-    SetOfMotionStates _lastActiveStates;
+    // sorted, so that the states deactivated since the last step are found by binary search
+    std::vector<ObjectMotionState*> _activeStates;
+    std::vector<ObjectMotionState*> _lastActiveStates;
+
+    // what synchronizeMotionStates() computes for each non static body, before it calls the MotionStates
+    std::vector<uint8_t> _bodySyncStates;
+    btAlignedObjectArray<btTransform> _interpolatedTransforms;
     int _numSubsteps { 0 };
 };
 
@@ -22,6 +22,12 @@
 using namespace recording;
 
 Clip::Pointer Clip::fromFile(const QString& filePath) {
+    // files written by this build are indexed, older ones are parsed frame by frame
+    auto indexedClip = std::make_shared<IndexedFileClip>(filePath);
+    if (indexedClip->frameCount() > 0) {
+        return indexedClip;
+    }
+
     auto result = std::make_shared<FileClip>(filePath);
     if (result->frameCount() == 0) {
         return Clip::Pointer();
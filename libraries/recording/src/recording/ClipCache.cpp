@@ -12,6 +12,7 @@
 
 #include <shared/QtHelpers.h>
 
+#include "impl/IndexedClip.h"
 #include "impl/PointerClip.h"
 #include "Logging.h"
 
@@ -26,9 +27,20 @@ NetworkClipLoader::NetworkClipLoader(const QUrl& url) :
     }
 }
 
+NetworkClip::NetworkClip(const QUrl& url) :
+    WrapperClip(std::make_shared<PointerClip>()),
+    _url(url)
+{
+}
+
 void NetworkClip::init(const QByteArray& clipData) {
     _clipData = clipData;
-    PointerClip::init((uchar*)_clipData.data(), _clipData.size());
+    auto data = (uchar*)_clipData.data();
+    if (IndexedClip::isIndexed(data, _clipData.size())) {
+        _wrappedClip = std::make_shared<IndexedClip>(data, _clipData.size());
+    } else {
+        _wrappedClip = std::make_shared<PointerClip>(data, _clipData.size());
+    }
 }
 
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
@@ -12,17 +12,19 @@
 #include <ResourceCache.h>
 
 #include "Forward.h"
-#include "impl/PointerClip.h"
+#include "impl/WrapperClip.h"
 
 namespace recording {
 
-class NetworkClip : public PointerClip {
+// Wraps a clip over the downloaded data, in either the indexed or the legacy layout
+class NetworkClip : public WrapperClip {
 public:
     using Pointer = std::shared_ptr<NetworkClip>;
 
-    NetworkClip(const QUrl& url) : _url(url) {}
+    NetworkClip(const QUrl& url);
     virtual void init(const QByteArray& clipData);
     virtual QString getName() const override { return _url.toString(); }
+    virtual Clip::Pointer duplicate() const override { return _wrappedClip->duplicate(); }
 
 private:
     QByteArray _clipData;
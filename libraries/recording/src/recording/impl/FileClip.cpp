@@ -54,7 +54,7 @@ bool FileClip::write(const QString& fileName, Clip::Pointer clip) {
     }
 
     Finally closer([&] { outputFile.close(); });
-    return clip->write(outputFile);
+    return IndexedClip::write(outputFile, clip);
 }
 
 FileClip::~FileClip() {
@@ -65,3 +65,35 @@ FileClip::~FileClip() {
     }
     reset();
 }
+
+IndexedFileClip::IndexedFileClip(const QString& fileName) : _file(fileName) {
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(recordingLog) << "Unable to open file " << fileName;
+        return;
+    }
+
+    auto size = _file.size();
+    _mappedData = _file.map(0, size);
+    if (!_mappedData || !init(_mappedData, size)) {
+        if (_mappedData) {
+            _file.unmap(_mappedData);
+            _mappedData = nullptr;
+        }
+        _file.close();
+    }
+}
+
+QString IndexedFileClip::getName() const {
+    return _file.fileName();
+}
+
+IndexedFileClip::~IndexedFileClip() {
+    Locker lock(_mutex);
+    reset();
+    if (_mappedData) {
+        _file.unmap(_mappedData);
+    }
+    if (_file.isOpen()) {
+        _file.close();
+    }
+}
@@ -10,6 +10,7 @@
 #ifndef hifi_Recording_Impl_FileClip_h
 #define hifi_Recording_Impl_FileClip_h
 
+#include "IndexedClip.h"
 #include "PointerClip.h"
 
 #include <QtCore/QFile>
@@ -31,6 +32,22 @@ private:
     QFile _file;
 };
 
+// A clip over a file written in the indexed layout. The file is mapped read only, so the processes playing the same
+// file share its pages.
+class IndexedFileClip : public IndexedClip {
+public:
+    using Pointer = std::shared_ptr<IndexedFileClip>;
+
+    IndexedFileClip(const QString& file);
+    virtual ~IndexedFileClip();
+
+    virtual QString getName() const override;
+
+private:
+    QFile _file;
+    uchar* _mappedData { nullptr };
+};
+
 }
 
 #endif
@@ -0,0 +1,501 @@
+//
+//  IndexedClip.cpp
+//  libraries/recording/src/recording/impl
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "IndexedClip.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <QtCore/QDebug>
+#include <QtCore/QIODevice>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSet>
+
+#include "../Logging.h"
+
+using namespace recording;
+
+// Every part of an indexed clip is wrapped in a regular frame, so that builds only knowing the legacy layout skip them
+// as frames of unknown types:
+//   - the header frame, the same as in the legacy layout
+//   - block frames, runs of frames compressed together
+//   - index frames, an entry per block
+//   - the footer frame, always the last FOOTER_FRAME_SIZE bytes, pointing at the first index frame
+// The reserved types below are stored types, the frame type map of the header never uses them.
+static const FrameType BLOCK_FRAME_TYPE = 0xFFFE;
+static const FrameType INDEX_FRAME_TYPE = 0xFFFD;
+static const FrameType FOOTER_FRAME_TYPE = 0xFFFC;
+
+static const size_t FRAME_HEADER_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
+static const int MAX_FRAME_DATA_SIZE = std::numeric_limits<FrameSize>::max();
+
+// frames in a block: type, time offset, data size and data
+static const size_t BLOCK_FRAME_HEADER_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(uint32_t);
+// a block is closed once it reaches this many uncompressed bytes, small enough to fit in a frame once compressed
+static const int TARGET_BLOCK_SIZE = 32 * 1024;
+// qCompress() prefixes the data with its uncompressed size, and deflate expands data at most 1032:1
+static const size_t COMPRESSED_SIZE_PREFIX_SIZE = sizeof(uint32_t);
+static const size_t MAX_DEFLATE_RATIO = 1032;
+
+// block offset, first time, last time, first frame, number of frames
+static const size_t INDEX_ENTRY_SIZE = sizeof(uint64_t) + 4 * sizeof(uint32_t);
+static const size_t INDEX_ENTRIES_PER_FRAME = 2048;
+static const size_t INDEX_FRAME_STRIDE = FRAME_HEADER_SIZE + INDEX_ENTRIES_PER_FRAME * INDEX_ENTRY_SIZE;
+
+// index offset, number of blocks, number of frames, version, magic
+static const size_t FOOTER_SIZE = sizeof(uint64_t) + 4 * sizeof(uint32_t);
+static const size_t FOOTER_FRAME_SIZE = FRAME_HEADER_SIZE + FOOTER_SIZE;
+static const uint32_t INDEX_VERSION = 1;
+static const uint32_t INDEX_MAGIC = 0x49524648; // HFRI
+
+template <typename T>
+static T readValue(const uchar*& current) {
+    T value;
+    memcpy(&value, current, sizeof(T));
+    current += sizeof(T);
+    return value;
+}
+
+template <typename T>
+static void appendValue(QByteArray& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static bool writeRawFrame(QIODevice& output, FrameType type, Frame::Time timeOffset, const QByteArray& data,
+                          uint64_t& written) {
+    if (data.size() > MAX_FRAME_DATA_SIZE) {
+        return false;
+    }
+
+    QByteArray frame;
+    frame.reserve((int)FRAME_HEADER_SIZE + data.size());
+    appendValue(frame, type);
+    appendValue(frame, timeOffset);
+    appendValue(frame, (FrameSize)data.size());
+    frame.append(data);
+    if (output.write(frame) != frame.size()) {
+        return false;
+    }
+    written += frame.size();
+    return true;
+}
+
+bool IndexedClip::isIndexed(const uchar* data, size_t size) {
+    // at least a header frame and the footer
+    if (!data || size < FRAME_HEADER_SIZE + FOOTER_FRAME_SIZE) {
+        return false;
+    }
+
+    const uchar* current = data + size - FOOTER_FRAME_SIZE;
+    auto type = readValue<FrameType>(current);
+    current += sizeof(Frame::Time);
+    auto footerSize = readValue<FrameSize>(current);
+    if (type != FOOTER_FRAME_TYPE || footerSize != FOOTER_SIZE) {
+        return false;
+    }
+
+    current += sizeof(uint64_t) + 2 * sizeof(uint32_t);
+    auto version = readValue<uint32_t>(current);
+    auto magic = readValue<uint32_t>(current);
+    return version == INDEX_VERSION && magic == INDEX_MAGIC;
+}
+
+bool IndexedClip::init(const uchar* data, size_t size) {
+    Locker lock(_mutex);
+    reset();
+
+    if (!isIndexed(data, size)) {
+        return false;
+    }
+
+    const uchar* current = data + size - FOOTER_SIZE;
+    auto indexOffset = readValue<uint64_t>(current);
+    auto numBlocks = readValue<uint32_t>(current);
+    auto numFrames = readValue<uint32_t>(current);
+
+    // the index must sit between the header frame and the footer
+    uint64_t indexEnd = size - FOOTER_FRAME_SIZE;
+    if (indexOffset > indexEnd) {
+        qCWarning(recordingLog) << "Index out of bounds, invalid file";
+        return false;
+    }
+    if (numBlocks > 0) {
+        uint64_t lastEntry = numBlocks - 1;
+        uint64_t indexSize = (lastEntry / INDEX_ENTRIES_PER_FRAME) * INDEX_FRAME_STRIDE + FRAME_HEADER_SIZE +
+            (lastEntry % INDEX_ENTRIES_PER_FRAME + 1) * INDEX_ENTRY_SIZE;
+        if (indexSize > indexEnd - indexOffset) {
+            qCWarning(recordingLog) << "Index out of bounds, invalid file";
+            return false;
+        }
+    }
+
+    current = data;
+    auto headerType = readValue<FrameType>(current);
+    current += sizeof(Frame::Time);
+    auto headerSize = readValue<FrameSize>(current);
+    if (headerType != Frame::TYPE_HEADER || FRAME_HEADER_SIZE + headerSize > indexOffset) {
+        qCWarning(recordingLog) << "Missing header frame, invalid file";
+        return false;
+    }
+
+    // Unlike the legacy layout, frames of types this process doesn't know about are kept and their types registered,
+    // so that frame counts and positions come straight from the index
+    auto header = QJsonDocument::fromBinaryData(QByteArray(reinterpret_cast<const char*>(current), headerSize));
+    auto frameTypeObj = header.object()[FRAME_TYPE_MAP].toObject();
+    if (frameTypeObj.isEmpty()) {
+        qCWarning(recordingLog) << "Header missing frame type map, invalid file";
+        return false;
+    }
+    for (const auto& frameTypeName : frameTypeObj.keys()) {
+        auto storedType = static_cast<FrameType>(frameTypeObj[frameTypeName].toInt());
+        if (storedType >= _typeTranslation.size()) {
+            _typeTranslation.resize(storedType + 1, (FrameType)Frame::TYPE_INVALID);
+        }
+        _typeTranslation[storedType] = Frame::registerFrameType(frameTypeName);
+    }
+
+    _data = data;
+    _size = size;
+    _indexOffset = indexOffset;
+    _numBlocks = numBlocks;
+    _numFrames = numFrames;
+
+    // the frame counts of the index size the frame tables of the blocks, so they must agree with the footer and
+    // with what the block data can hold
+    for (size_t blockIndex = 0; blockIndex < _numBlocks; ++blockIndex) {
+        auto entry = readEntry(blockIndex);
+        if ((uint64_t)entry.firstFrame + entry.numFrames > _numFrames || entry.numFrames > getMaxBlockFrames(entry)) {
+            qCWarning(recordingLog) << "Index entry" << blockIndex << "out of bounds, invalid file";
+            reset();
+            return false;
+        }
+    }
+    return true;
+}
+
+void IndexedClip::reset() {
+    _data = nullptr;
+    _size = 0;
+    _indexOffset = 0;
+    _numBlocks = 0;
+    _numFrames = 0;
+    _typeTranslation.clear();
+    _blockIndex = 0;
+    _frameInBlock = 0;
+    _loadedBlock = (size_t)-1;
+    _blockData.clear();
+    _blockFrames.clear();
+}
+
+// Internal only function, needs no locking
+IndexedClip::BlockEntry IndexedClip::readEntry(size_t blockIndex) const {
+    const uchar* current = _data + _indexOffset + (blockIndex / INDEX_ENTRIES_PER_FRAME) * INDEX_FRAME_STRIDE +
+        FRAME_HEADER_SIZE + (blockIndex % INDEX_ENTRIES_PER_FRAME) * INDEX_ENTRY_SIZE;
+    BlockEntry entry;
+    entry.offset = readValue<uint64_t>(current);
+    entry.firstTime = readValue<Frame::Time>(current);
+    entry.lastTime = readValue<Frame::Time>(current);
+    entry.firstFrame = readValue<uint32_t>(current);
+    entry.numFrames = readValue<uint32_t>(current);
+    return entry;
+}
+
+// Internal only function, needs no locking
+size_t IndexedClip::getMaxBlockFrames(const BlockEntry& entry) const {
+    if (entry.offset < FRAME_HEADER_SIZE || entry.offset > _indexOffset) {
+        return 0;
+    }
+    const uchar* current = _data + entry.offset - FRAME_HEADER_SIZE;
+    auto type = readValue<FrameType>(current);
+    current += sizeof(Frame::Time);
+    auto compressedSize = readValue<FrameSize>(current);
+    if (type != BLOCK_FRAME_TYPE || compressedSize < COMPRESSED_SIZE_PREFIX_SIZE ||
+        compressedSize > _indexOffset - entry.offset) {
+        return 0;
+    }
+    // the prefix is big endian, and a block claiming more than deflate can produce is corrupt
+    uint64_t uncompressedSize = ((uint32_t)current[0] << 24) | ((uint32_t)current[1] << 16) |
+        ((uint32_t)current[2] << 8) | (uint32_t)current[3];
+    if (uncompressedSize > (compressedSize - COMPRESSED_SIZE_PREFIX_SIZE) * MAX_DEFLATE_RATIO) {
+        return 0;
+    }
+    return (size_t)(uncompressedSize / BLOCK_FRAME_HEADER_SIZE);
+}
+
+// Internal only function, needs no locking
+void IndexedClip::loadBlock(size_t blockIndex) const {
+    if (blockIndex == _loadedBlock) {
+        return;
+    }
+    _loadedBlock = blockIndex;
+    _blockData.clear();
+    _blockFrames.clear();
+
+    auto entry = readEntry(blockIndex);
+    // init() checked the entry against this, but never trust the index to size an allocation
+    size_t maxFrames = std::min<size_t>(entry.numFrames, getMaxBlockFrames(entry));
+    bool valid = false;
+    if (entry.offset >= FRAME_HEADER_SIZE && entry.offset <= _indexOffset) {
+        const uchar* current = _data + entry.offset - FRAME_HEADER_SIZE;
+        auto type = readValue<FrameType>(current);
+        current += sizeof(Frame::Time);
+        auto compressedSize = readValue<FrameSize>(current);
+        if (type == BLOCK_FRAME_TYPE && compressedSize <= _indexOffset - entry.offset) {
+            _blockData = qUncompress(current, compressedSize);
+
+            const uchar* start = reinterpret_cast<const uchar*>(_blockData.constData());
+            const uchar* end = start + _blockData.size();
+            current = start;
+            _blockFrames.reserve(maxFrames);
+            while ((size_t)(end - current) >= BLOCK_FRAME_HEADER_SIZE && _blockFrames.size() < maxFrames) {
+                BlockFrame frame;
+                auto storedType = readValue<FrameType>(current);
+                frame.type = storedType < _typeTranslation.size() ? _typeTranslation[storedType] : Frame::TYPE_INVALID;
+                frame.timeOffset = readValue<Frame::Time>(current);
+                auto frameSize = readValue<uint32_t>(current);
+                if (frameSize > (size_t)(end - current)) {
+                    break;
+                }
+                frame.dataOffset = (int)(current - start);
+                frame.size = (int)frameSize;
+                current += frameSize;
+                _blockFrames.push_back(frame);
+            }
+            valid = current == end && _blockFrames.size() == entry.numFrames;
+        }
+    }
+
+    if (!valid) {
+        // keep the frame count of the index, so that positions in the clip stay consistent
+        qCWarning(recordingLog) << "Corrupt block" << blockIndex << "in indexed clip";
+        _blockData.clear();
+        _blockFrames.assign(maxFrames, { Frame::TYPE_INVALID, entry.firstTime, 0, 0 });
+    }
+}
+
+// Internal only function, needs no locking
+FramePointer IndexedClip::readBlockFrame(size_t frameIndex) const {
+    const auto& blockFrame = _blockFrames[frameIndex];
+    auto result = std::make_shared<Frame>();
+    result->type = blockFrame.type;
+    result->timeOffset = blockFrame.timeOffset;
+    if (blockFrame.size) {
+        result->data = QByteArray(_blockData.constData() + blockFrame.dataOffset, blockFrame.size);
+    }
+    return result;
+}
+
+// Internal only function, needs no locking
+void IndexedClip::skipFrameInternal() {
+    if (_blockIndex < _numBlocks && ++_frameInBlock >= readEntry(_blockIndex).numFrames) {
+        ++_blockIndex;
+        _frameInBlock = 0;
+    }
+}
+
+Clip::Pointer IndexedClip::duplicate() const {
+    auto result = newClip();
+    Locker lock(_mutex);
+    for (size_t blockIndex = 0; blockIndex < _numBlocks; ++blockIndex) {
+        loadBlock(blockIndex);
+        for (size_t frameIndex = 0; frameIndex < _blockFrames.size(); ++frameIndex) {
+            result->addFrame(readBlockFrame(frameIndex));
+        }
+    }
+    return result;
+}
+
+float IndexedClip::duration() const {
+    Locker lock(_mutex);
+    if (_numBlocks == 0) {
+        return 0;
+    }
+    return Frame::frameTimeToSeconds(readEntry(_numBlocks - 1).lastTime);
+}
+
+size_t IndexedClip::frameCount() const {
+    Locker lock(_mutex);
+    return _numFrames;
+}
+
+void IndexedClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+
+    // the first block ending at or after the offset holds the first frame at or after it
+    size_t low = 0;
+    size_t high = _numBlocks;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (readEntry(middle).lastTime < offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    _blockIndex = low;
+    _frameInBlock = 0;
+    if (_blockIndex < _numBlocks) {
+        loadBlock(_blockIndex);
+        auto itr = std::lower_bound(_blockFrames.begin(), _blockFrames.end(), offset,
+            [](const BlockFrame& a, Frame::Time b)->bool {
+                return a.timeOffset < b;
+            }
+        );
+        _frameInBlock = itr - _blockFrames.begin();
+        if (_frameInBlock >= _blockFrames.size()) {
+            ++_blockIndex;
+            _frameInBlock = 0;
+        }
+    }
+}
+
+Frame::Time IndexedClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    Frame::Time result = Frame::INVALID_TIME;
+    if (_blockIndex < _numBlocks) {
+        loadBlock(_blockIndex);
+        if (_frameInBlock < _blockFrames.size()) {
+            result = _blockFrames[_frameInBlock].timeOffset;
+        }
+    }
+    return result;
+}
+
+FrameConstPointer IndexedClip::peekFrame() const {
+    Locker lock(_mutex);
+    FrameConstPointer result;
+    if (_blockIndex < _numBlocks) {
+        loadBlock(_blockIndex);
+        if (_frameInBlock < _blockFrames.size()) {
+            result = readBlockFrame(_frameInBlock);
+        }
+    }
+    return result;
+}
+
+FrameConstPointer IndexedClip::nextFrame() {
+    Locker lock(_mutex);
+    FrameConstPointer result;
+    if (_blockIndex < _numBlocks) {
+        loadBlock(_blockIndex);
+        if (_frameInBlock < _blockFrames.size()) {
+            result = readBlockFrame(_frameInBlock);
+        }
+        skipFrameInternal();
+    }
+    return result;
+}
+
+void IndexedClip::skipFrame() {
+    Locker lock(_mutex);
+    skipFrameInternal();
+}
+
+void IndexedClip::addFrame(FrameConstPointer) {
+    throw std::runtime_error("Indexed clips are read only, use duplicate to create a read/write clip");
+}
+
+bool IndexedClip::write(QIODevice& output, const Clip::Pointer& clip) {
+    auto frameTypes = Frame::getFrameTypes();
+    QJsonObject frameTypeObj;
+    QSet<FrameType> registeredTypes;
+    for (const auto& frameTypeName : frameTypes.keys()) {
+        frameTypeObj[frameTypeName] = frameTypes[frameTypeName];
+        registeredTypes.insert(frameTypes[frameTypeName]);
+    }
+
+    QJsonObject rootObject;
+    rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
+    rootObject.insert(FRAME_COMREPSSION_FLAG, true);
+    uint64_t written = 0;
+    if (!writeRawFrame(output, Frame::TYPE_HEADER, 0, QJsonDocument(rootObject).toBinaryData(), written)) {
+        return false;
+    }
+
+    std::vector<BlockEntry> entries;
+    BlockEntry entry;
+    QByteArray block;
+    auto writeBlock = [&]()->bool {
+        if (entry.numFrames == 0) {
+            return true;
+        }
+        QByteArray compressedBlock = qCompress(block);
+        if (compressedBlock.size() > MAX_FRAME_DATA_SIZE) {
+            qCWarning(recordingLog) << "Frame too large to be written:" << block.size() << "bytes";
+            return false;
+        }
+        entry.offset = written + FRAME_HEADER_SIZE;
+        if (!writeRawFrame(output, BLOCK_FRAME_TYPE, entry.firstTime, compressedBlock, written)) {
+            return false;
+        }
+        entries.push_back(entry);
+
+        BlockEntry nextEntry;
+        nextEntry.firstFrame = entry.firstFrame + entry.numFrames;
+        entry = nextEntry;
+        block.clear();
+        return true;
+    };
+
+    clip->seek(0);
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        // frames of unregistered types could not be read back
+        if (!registeredTypes.contains(frame->type)) {
+            continue;
+        }
+
+        if (entry.numFrames > 0 && block.size() + (int)BLOCK_FRAME_HEADER_SIZE + frame->data.size() > TARGET_BLOCK_SIZE) {
+            if (!writeBlock()) {
+                return false;
+            }
+        }
+        if (entry.numFrames == 0) {
+            entry.firstTime = frame->timeOffset;
+        }
+        entry.lastTime = frame->timeOffset;
+        entry.numFrames++;
+
+        appendValue(block, frame->type);
+        appendValue(block, frame->timeOffset);
+        appendValue(block, (uint32_t)frame->data.size());
+        block.append(frame->data);
+    }
+    if (!writeBlock()) {
+        return false;
+    }
+
+    uint64_t indexOffset = written;
+    for (size_t i = 0; i < entries.size(); i += INDEX_ENTRIES_PER_FRAME) {
+        QByteArray indexData;
+        auto end = std::min(entries.size(), i + INDEX_ENTRIES_PER_FRAME);
+        indexData.reserve((int)((end - i) * INDEX_ENTRY_SIZE));
+        for (size_t j = i; j < end; ++j) {
+            appendValue(indexData, entries[j].offset);
+            appendValue(indexData, entries[j].firstTime);
+            appendValue(indexData, entries[j].lastTime);
+            appendValue(indexData, entries[j].firstFrame);
+            appendValue(indexData, entries[j].numFrames);
+        }
+        if (!writeRawFrame(output, INDEX_FRAME_TYPE, 0, indexData, written)) {
+            return false;
+        }
+    }
+
+    QByteArray footer;
+    appendValue(footer, indexOffset);
+    appendValue(footer, (uint32_t)entries.size());
+    appendValue(footer, entry.firstFrame);
+    appendValue(footer, INDEX_VERSION);
+    appendValue(footer, INDEX_MAGIC);
+    return writeRawFrame(output, FOOTER_FRAME_TYPE, 0, footer, written);
+}
@@ -0,0 +1,100 @@
+//
+//  IndexedClip.h
+//  libraries/recording/src/recording/impl
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_IndexedClip_h
+#define hifi_Recording_Impl_IndexedClip_h
+
+#include "../Clip.h"
+
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+#include "../Frame.h"
+
+class QIODevice;
+
+namespace recording {
+
+// A read only clip over the indexed clip layout, usually memory mapped.
+// Frames are stored in blocks compressed together, and a trailing index holds the time range of every block:
+// opening a clip only reads its header, index and footer, and seeking is a binary search over the index followed by the
+// decompression of a single block. Nothing is copied from the data except the block being played.
+class IndexedClip : public Clip {
+public:
+    using Pointer = std::shared_ptr<IndexedClip>;
+
+    IndexedClip() {}
+    IndexedClip(const uchar* data, size_t size) { init(data, size); }
+
+    // The data must outlive the clip
+    bool init(const uchar* data, size_t size);
+
+    virtual QString getName() const override { return QString(); }
+    virtual Clip::Pointer duplicate() const override;
+
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+    virtual void addFrame(FrameConstPointer) override;
+
+    static bool isIndexed(const uchar* data, size_t size);
+    static bool write(QIODevice& output, const Clip::Pointer& clip);
+
+protected:
+    virtual void reset() override;
+
+private:
+    struct BlockEntry {
+        uint64_t offset { 0 }; // of the compressed block data
+        Frame::Time firstTime { 0 };
+        Frame::Time lastTime { 0 };
+        uint32_t firstFrame { 0 };
+        uint32_t numFrames { 0 };
+    };
+
+    struct BlockFrame {
+        FrameType type;
+        Frame::Time timeOffset;
+        int dataOffset;
+        int size;
+    };
+
+    BlockEntry readEntry(size_t blockIndex) const;
+    size_t getMaxBlockFrames(const BlockEntry& entry) const;
+    void loadBlock(size_t blockIndex) const;
+    FramePointer readBlockFrame(size_t frameIndex) const;
+    void skipFrameInternal();
+
+    const uchar* _data { nullptr };
+    size_t _size { 0 };
+    uint64_t _indexOffset { 0 };
+    size_t _numBlocks { 0 };
+    size_t _numFrames { 0 };
+    std::vector<FrameType> _typeTranslation; // stored type => registered type
+
+    size_t _blockIndex { 0 };
+    size_t _frameInBlock { 0 };
+
+    mutable size_t _loadedBlock { (size_t)-1 };
+    mutable QByteArray _blockData;
+    mutable std::vector<BlockFrame> _blockFrames;
+};
+
+}
+
+#endif
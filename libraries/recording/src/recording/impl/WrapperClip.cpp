@@ -27,7 +27,7 @@ void WrapperClip::seekFrameTime(Frame::Time offset) {
 }
 
 Frame::Time WrapperClip::positionFrameTime() const {
-    return _wrappedClip->position();
+    return _wrappedClip->positionFrameTime();
 }
 
 FrameConstPointer WrapperClip::peekFrame() const {
@@ -39,7 +39,7 @@ public:
 protected:
     virtual void reset() override;
 
-    const Clip::Pointer _wrappedClip;
+    Clip::Pointer _wrappedClip;
 };
 
 }
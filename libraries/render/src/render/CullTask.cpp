@@ -16,6 +16,7 @@
 
 #include <PerfStat.h>
 #include <OctreeUtils.h>
+#include <TBBHelpers.h>
 
 using namespace render;
 
@@ -64,43 +65,198 @@ bool CullTest::solidAngleTest(const AABox& bound) {
     return true;
 }
 
+namespace {
+    enum CullResult : uint8_t {
+        CULL_FILTERED = 0,
+        CULL_RENDER,
+        CULL_OUT_OF_VIEW,
+        CULL_TOO_SMALL,
+    };
+
+    // Below this many items the cull runs on the calling thread, above it the list is split across the TBB pool
+    const size_t PARALLEL_CULL_MIN_ITEMS = 4096;
+    const size_t PARALLEL_CULL_GRAIN_SIZE = 1024;
+    // Bounds tested together by FrustumBoundsTest, small enough for the components to stay on the stack
+    const size_t CULL_BLOCK_SIZE = 64;
+
+    // The frustum planes split into components, so that the box test can run plane by plane over a block of bounds
+    // stored as structure of arrays, which the compiler vectorizes.
+    // Same test as ViewFrustum::boxIntersectsFrustum(): a box is out if its farthest vertex along a plane normal is
+    // behind that plane.
+    class FrustumBoundsTest {
+    public:
+        FrustumBoundsTest(const ViewFrustum& frustum) {
+            const ::Plane* planes = frustum.getPlanes();
+            for (int i = 0; i < NUM_FRUSTUM_PLANES; i++) {
+                const glm::vec3& normal = planes[i].getNormal();
+                _normalX[i] = normal.x;
+                _normalY[i] = normal.y;
+                _normalZ[i] = normal.z;
+                _farthestX[i] = (float)(normal.x > 0.0f);
+                _farthestY[i] = (float)(normal.y > 0.0f);
+                _farthestZ[i] = (float)(normal.z > 0.0f);
+                _d[i] = planes[i].getDCoefficient();
+            }
+        }
+
+        // Marks the CULL_RENDER entries of results whose bound is outside the frustum as CULL_OUT_OF_VIEW
+        void test(const ItemBound* items, size_t numItems, uint8_t* results) const {
+            float cornerX[CULL_BLOCK_SIZE], cornerY[CULL_BLOCK_SIZE], cornerZ[CULL_BLOCK_SIZE];
+            float scaleX[CULL_BLOCK_SIZE], scaleY[CULL_BLOCK_SIZE], scaleZ[CULL_BLOCK_SIZE];
+            uint8_t inView[CULL_BLOCK_SIZE];
+
+            for (size_t first = 0; first < numItems; first += CULL_BLOCK_SIZE) {
+                const size_t count = std::min(CULL_BLOCK_SIZE, numItems - first);
+                const ItemBound* block = items + first;
+
+                for (size_t i = 0; i < count; i++) {
+                    const glm::vec3& corner = block[i].bound.getCorner();
+                    const glm::vec3& scale = block[i].bound.getScale();
+                    cornerX[i] = corner.x;
+                    cornerY[i] = corner.y;
+                    cornerZ[i] = corner.z;
+                    scaleX[i] = scale.x;
+                    scaleY[i] = scale.y;
+                    scaleZ[i] = scale.z;
+                    inView[i] = 1;
+                }
+
+                for (int p = 0; p < NUM_FRUSTUM_PLANES; p++) {
+                    const float nx = _normalX[p], ny = _normalY[p], nz = _normalZ[p];
+                    const float fx = _farthestX[p], fy = _farthestY[p], fz = _farthestZ[p];
+                    const float d = _d[p];
+                    for (size_t i = 0; i < count; i++) {
+                        // distance of the farthest vertex along the normal
+                        float distance = nx * (cornerX[i] + fx * scaleX[i]) + ny * (cornerY[i] + fy * scaleY[i]) +
+                            nz * (cornerZ[i] + fz * scaleZ[i]) + d;
+                        inView[i] &= (uint8_t)(distance >= 0.0f);
+                    }
+                }
+
+                uint8_t* blockResults = results + first;
+                for (size_t i = 0; i < count; i++) {
+                    if (blockResults[i] == CULL_RENDER && !inView[i]) {
+                        blockResults[i] = CULL_OUT_OF_VIEW;
+                    }
+                }
+            }
+        }
+
+    private:
+        float _normalX[NUM_FRUSTUM_PLANES], _normalY[NUM_FRUSTUM_PLANES], _normalZ[NUM_FRUSTUM_PLANES];
+        float _farthestX[NUM_FRUSTUM_PLANES], _farthestY[NUM_FRUSTUM_PLANES], _farthestZ[NUM_FRUSTUM_PLANES];
+        float _d[NUM_FRUSTUM_PLANES];
+    };
+
+    // Runs cullRange(begin, end) over [0, numItems), in parallel chunks when there are enough items
+    template <typename F>
+    void forEachCullRange(size_t numItems, F cullRange) {
+        if (numItems >= PARALLEL_CULL_MIN_ITEMS) {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, numItems, PARALLEL_CULL_GRAIN_SIZE),
+                [&](const tbb::blocked_range<size_t>& range) {
+                cullRange(range.begin(), range.end());
+            });
+        } else if (numItems > 0) {
+            cullRange(0, numItems);
+        }
+    }
+
+    // Filters and culls the selected ids, then appends the items to render (and the sub items of meta cull groups)
+    // to outItems in selection order. The per item work runs in parallel, the output and the stats are serial.
+    void cullSelectedItems(RenderArgs* args, Scene& scene, const ItemFilter& filter, const ItemIDs& ids,
+                           const FrustumBoundsTest* frustumTest, const CullFunctor* solidAngleFunctor,
+                           RenderDetails::Item& details, ItemBounds& outItems) {
+        const size_t numItems = ids.size();
+        ItemBounds bounds(numItems);
+        std::vector<uint8_t> results(numItems);
+
+        forEachCullRange(numItems, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto& item = scene.getItem(ids[i]);
+                if (filter.test(item.getKey())) {
+                    bounds[i] = ItemBound(ids[i], item.getBound());
+                    results[i] = CULL_RENDER;
+                } else {
+                    results[i] = CULL_FILTERED;
+                }
+            }
+            if (frustumTest) {
+                frustumTest->test(bounds.data() + begin, end - begin, results.data() + begin);
+            }
+            if (solidAngleFunctor) {
+                for (size_t i = begin; i < end; i++) {
+                    if (results[i] == CULL_RENDER && !(*solidAngleFunctor)(args, bounds[i].bound)) {
+                        results[i] = CULL_TOO_SMALL;
+                    }
+                }
+            }
+        });
+
+        for (size_t i = 0; i < numItems; i++) {
+            switch (results[i]) {
+                case CULL_RENDER: {
+                    outItems.emplace_back(bounds[i]);
+                    auto& item = scene.getItem(ids[i]);
+                    if (item.getKey().isMetaCullGroup()) {
+                        item.fetchMetaSubItemBounds(outItems, scene);
+                    }
+                    break;
+                }
+                case CULL_OUT_OF_VIEW:
+                    details._outOfView++;
+                    break;
+                case CULL_TOO_SMALL:
+                    details._tooSmall++;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
 void render::cullItems(const RenderContextPointer& renderContext, const CullFunctor& cullFunctor, RenderDetails::Item& details,
                        const ItemBounds& inItems, ItemBounds& outItems) {
     assert(renderContext->args);
     assert(renderContext->args->hasViewFrustum());
 
     RenderArgs* args = renderContext->args;
-    const ViewFrustum& frustum = args->getViewFrustum();
+    const FrustumBoundsTest frustumTest(args->getViewFrustum());
 
     details._considered += (int)inItems.size();
 
     // Culling / LOD
-    for (auto item : inItems) {
-        if (item.bound.isNull()) {
-            outItems.emplace_back(item); // One more Item to render
-            continue;
-        }
-
-        // TODO: some entity types (like lights) might want to be rendered even
-        // when they are outside of the view frustum...
-        bool inView;
-        {
-            PerformanceTimer perfTimer("boxIntersectsFrustum");
-            inView = frustum.boxIntersectsFrustum(item.bound);
-        }
-        if (inView) {
-            bool bigEnoughToRender;
-            {
-                PerformanceTimer perfTimer("shouldRender");
-                bigEnoughToRender = cullFunctor(args, item.bound);
+    // TODO: some entity types (like lights) might want to be rendered even
+    // when they are outside of the view frustum...
+    std::vector<uint8_t> results(inItems.size(), CULL_RENDER);
+    {
+        PerformanceTimer perfTimer("cullItems");
+        forEachCullRange(inItems.size(), [&](size_t begin, size_t end) {
+            frustumTest.test(inItems.data() + begin, end - begin, results.data() + begin);
+            for (size_t i = begin; i < end; i++) {
+                const auto& item = inItems[i];
+                if (item.bound.isNull()) {
+                    results[i] = CULL_RENDER;
+                } else if (results[i] == CULL_RENDER && !cullFunctor(args, item.bound)) {
+                    results[i] = CULL_TOO_SMALL;
+                }
             }
-            if (bigEnoughToRender) {
-                outItems.emplace_back(item); // One more Item to render
-            } else {
+        });
+    }
+
+    for (size_t i = 0; i < inItems.size(); i++) {
+        switch (results[i]) {
+            case CULL_RENDER:
+                outItems.emplace_back(inItems[i]); // One more Item to render
+                break;
+            case CULL_OUT_OF_VIEW:
+                details._outOfView++;
+                break;
+            case CULL_TOO_SMALL:
                 details._tooSmall++;
-            }
-        } else {
-            details._outOfView++;
+                break;
+            default:
+                break;
         }
     }
     details._rendered += (int)outItems.size();
@@ -203,8 +359,6 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
         args->pushViewFrustum(_frozenFrustum); // replace the true view frustum by the frozen one
     }
 
-    CullTest test(_cullFunctor, args, details);
-
     // Now we have a selection of items to render
     outItems.clear();
     outItems.reserve(inSelection.numItems());
@@ -212,141 +366,41 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
     const auto srcFilter = inputs.get1();
     if (!srcFilter.selectsNothing()) {
         auto filter = render::ItemFilter::Builder(srcFilter).withoutSubMetaCulled().build();
+        const FrustumBoundsTest frustumTest(args->getViewFrustum());
 
         // Now get the bound, and
         // filter individually against the _filter
         // visibility cull if partially selected ( octree cell contianing it was partial)
         // distance cull if was a subcell item ( octree cell is way bigger than the item bound itself, so now need to test per item)
-        if (_skipCulling || _overrideSkipCulling) {
-            // inside & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
+        // When culling is disabled, all the lists are only filtered
+        bool culling = !(_skipCulling || _overrideSkipCulling);
+        const FrustumBoundsTest* partialFrustumTest = culling ? &frustumTest : nullptr;
+        const CullFunctor* subcellSolidAngleFunctor = culling ? &_cullFunctor : nullptr;
 
-            // inside & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-        } else {
-
-            // inside & fit items: easy, just filter
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
+        // inside & fit items: easy, just filter
+        {
+            PerformanceTimer perfTimer("insideFitItems");
+            cullSelectedItems(args, *scene, filter, inSelection.insideItems, nullptr, nullptr, details, outItems);
+        }
 
-            // inside & subcell items: filter & distance cull
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.solidAngleTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
+        // inside & subcell items: filter & distance cull
+        {
+            PerformanceTimer perfTimer("insideSmallItems");
+            cullSelectedItems(args, *scene, filter, inSelection.insideSubcellItems, nullptr, subcellSolidAngleFunctor,
+                              details, outItems);
+        }
 
-            // partial & fit items: filter & frustum cull
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
+        // partial & fit items: filter & frustum cull
+        {
+            PerformanceTimer perfTimer("partialFitItems");
+            cullSelectedItems(args, *scene, filter, inSelection.partialItems, partialFrustumTest, nullptr, details, outItems);
+        }
 
-            // partial & subcell items:: filter & frutum cull & solidangle cull
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            if (test.solidAngleTest(itemBound.bound)) {
-                                outItems.emplace_back(itemBound);
-                                if (item.getKey().isMetaCullGroup()) {
-                                    item.fetchMetaSubItemBounds(outItems, (*scene));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+        // partial & subcell items:: filter & frutum cull & solidangle cull
+        {
+            PerformanceTimer perfTimer("partialSmallItems");
+            cullSelectedItems(args, *scene, filter, inSelection.partialSubcellItems, partialFrustumTest,
+                              subcellSolidAngleFunctor, details, outItems);
         }
     }
 
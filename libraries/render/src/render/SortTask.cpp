@@ -14,9 +14,14 @@
 
 #include <assert.h>
 #include <ViewFrustum.h>
+#include <TBBHelpers.h>
 
 using namespace render;
 
+// Lists at least this long compute their depths and sort on the TBB pool
+const size_t PARALLEL_SORT_MIN_ITEMS = 4096;
+const size_t PARALLEL_SORT_GRAIN_SIZE = 1024;
+
 struct ItemBoundSort {
     float _centerDepth = 0.0f;
     float _nearDepth = 0.0f;
@@ -29,13 +34,13 @@ struct ItemBoundSort {
 };
 
 struct FrontToBackSort {
-    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) {
+    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) const {
         return (left._centerDepth < right._centerDepth);
     }
 };
 
 struct BackToFrontSort {
-    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) {
+    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) const {
         return (left._centerDepth > right._centerDepth);
     }
 };
@@ -45,34 +50,49 @@ void render::depthSortItems(const RenderContextPointer& renderContext, bool fron
     assert(renderContext->args);
     assert(renderContext->args->hasViewFrustum());
 
-    auto& scene = renderContext->_scene;
     RenderArgs* args = renderContext->args;
-
+    const ViewFrustum& frustum = args->getViewFrustum();
+    const size_t numItems = inItems.size();
+    const bool parallel = numItems >= PARALLEL_SORT_MIN_ITEMS;
 
     // Allocate and simply copy
     outItems.clear();
-    outItems.reserve(inItems.size());
-
+    outItems.reserve(numItems);
 
     // Make a local dataset of the center distance and closest point distance
-    std::vector<ItemBoundSort> itemBoundSorts;
-    itemBoundSorts.reserve(outItems.size());
-
-    for (auto itemDetails : inItems) {
-        auto item = scene->getItem(itemDetails.id);
-        auto bound = itemDetails.bound; // item.getBound();
-        float distanceSquared = args->getViewFrustum().distanceToCameraSquared(bound.calcCenter());
-
-        itemBoundSorts.emplace_back(ItemBoundSort(distanceSquared, distanceSquared, distanceSquared, itemDetails.id, bound));
+    std::vector<ItemBoundSort> itemBoundSorts(numItems);
+    auto computeDepths = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const auto& itemDetails = inItems[i];
+            const auto& bound = itemDetails.bound;
+            float distanceSquared = frustum.distanceToCameraSquared(bound.calcCenter());
+            itemBoundSorts[i] = ItemBoundSort(distanceSquared, distanceSquared, distanceSquared, itemDetails.id, bound);
+        }
+    };
+    if (parallel) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, numItems, PARALLEL_SORT_GRAIN_SIZE),
+            [&](const tbb::blocked_range<size_t>& range) {
+            computeDepths(range.begin(), range.end());
+        });
+    } else {
+        computeDepths(0, numItems);
     }
 
     // sort against Z
     if (frontToBack) {
         FrontToBackSort frontToBackSort;
-        std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), frontToBackSort);
+        if (parallel) {
+            tbb::parallel_sort(itemBoundSorts.begin(), itemBoundSorts.end(), frontToBackSort);
+        } else {
+            std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), frontToBackSort);
+        }
     } else {
         BackToFrontSort  backToFrontSort;
-        std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), backToFrontSort);
+        if (parallel) {
+            tbb::parallel_sort(itemBoundSorts.begin(), itemBoundSorts.end(), backToFrontSort);
+        } else {
+            std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), backToFrontSort);
+        }
     }
 
     // Finally once sorted result to a list of itemID and keep uniques
@@ -12,6 +12,7 @@
 #include "ScriptEngine.h"
 
 #include <chrono>
+#include <limits>
 #include <thread>
 
 #include <QtCore/QCoreApplication>
@@ -181,7 +182,6 @@ ScriptEngine::ScriptEngine(Context context, const QString& scriptContents, const
     BaseScriptEngine(),
     _context(context),
     _scriptContents(scriptContents),
-    _timerFunctionMap(),
     _fileNameString(fileNameString),
     _arrayBufferClass(new ArrayBufferClass(this)),
     _assetScriptingInterface(new AssetScriptingInterface(this))
@@ -212,6 +212,14 @@ ScriptEngine::ScriptEngine(Context context, const QString& scriptContents, const
         }
     }, Qt::DirectConnection);
 
+    _timerClock.start();
+    _timerWheelTimer = new QTimer(this);
+    _timerWheelTimer->setSingleShot(true);
+    _timerWheelTimer->setTimerType(Qt::PreciseTimer);
+    connect(_timerWheelTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+    // make sure the timers stop when the script does
+    connect(this, &ScriptEngine::scriptEnding, _timerWheelTimer, &QTimer::stop);
+
     setProcessEventsInterval(MSECS_PER_SECOND);
     if (isEntityServerScript()) {
         qCDebug(scriptengine) << "isEntityServerScript() -- limiting maxRetries to 1";
@@ -769,6 +777,7 @@ void ScriptEngine::init() {
 
     registerGlobalObject("Entities", entityScriptingInterface.data());
     registerFunction("Entities", "getMultipleEntityProperties", EntityScriptingInterface::getMultipleEntityProperties);
+    registerFunction("Entities", "editEntities", EntityScriptingInterface::editEntities);
     registerGlobalObject("Quat", &_quatLibrary);
     registerGlobalObject("Vec3", &_vec3Library);
     registerGlobalObject("Mat4", &_mat4Library);
@@ -1333,32 +1342,25 @@ void ScriptEngine::run() {
 // NOTE: This is private because it must be called on the same thread that created the timers, which is why
 // we want to only call it in our own run "shutdown" processing.
 void ScriptEngine::stopAllTimers() {
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
-    int j {0};
-    while (i.hasNext()) {
-        i.next();
-        QTimer* timer = i.key();
-        qCDebug(scriptengine) << getFilename() << "stopAllTimers[" << j++ << "]";
-        stopTimer(timer);
+    if (!_timers.empty()) {
+        qCDebug(scriptengine) << getFilename() << "stopAllTimers" << _timers.size();
+    }
+    for (auto& timer : _timers) {
+        delete timer.second.handle;
     }
+    _timers.clear();
+    _timerHandles.clear();
+    _timerWheel.clear();
+    _timerWheelTimer->stop();
 }
 
 void ScriptEngine::stopAllTimersForEntityScript(const EntityItemID& entityID) {
-     // We could maintain a separate map of entityID => QTimer, but someone will have to prove to me that it's worth the complexity. -HRS
-    QVector<QTimer*> toDelete;
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
-    while (i.hasNext()) {
-        i.next();
-        if (i.value().definingEntityIdentifier != entityID) {
-            continue;
-        }
-        QTimer* timer = i.key();
-        toDelete << timer; // don't delete while we're iterating. save it.
+    // the timer wheel groups the timers by defining entity
+    std::vector<TimerWheel::TimerID> removed;
+    _timerWheel.removeGroup(entityID, removed);
+    for (auto timerID : removed) {
+        removeTimer(timerID);
     }
-    for (auto timer:toDelete) { // now reap 'em
-        stopTimer(timer);
-    }
-
 }
 
 void ScriptEngine::stop(bool marshal) {
@@ -1420,50 +1422,58 @@ void ScriptEngine::timerFired() {
         }
     }
 
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
-    CallbackData timerData = _timerFunctionMap.value(callingTimer);
-
-    if (!callingTimer->isActive()) {
-        // this timer is done, we can kill it
-        _timerFunctionMap.remove(callingTimer);
-        delete callingTimer;
-    }
+    // all the timers due by now fire in one batch
+    std::vector<TimerWheel::TimerID> expired;
+    _timerWheel.advance(_timerClock.elapsed(), expired);
 
-    // call the associated JS function, if it exists
-    if (timerData.function.isValid()) {
-        PROFILE_RANGE(script, __FUNCTION__);
-        auto preTimer = p_high_resolution_clock::now();
-        callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
-        auto postTimer = p_high_resolution_clock::now();
-        auto elapsed = (postTimer - preTimer);
-        _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
-    } else {
-        qCWarning(scriptengine) << "timerFired -- invalid function" << timerData.function.toVariant().toString();
-    }
-}
+    for (auto timerID : expired) {
+        auto timerItr = _timers.find(timerID);
+        if (timerItr == _timers.end()) {
+            continue; // cleared by an earlier callback of this batch
+        }
+        CallbackData timerData = timerItr->second.callback;
 
-QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
-    // create the timer, add it to the map, and start it
-    QTimer* newTimer = new QTimer(this);
-    newTimer->setSingleShot(isSingleShot);
+        if (!_timerWheel.contains(timerID)) {
+            // this timer is done, we can kill it
+            removeTimer(timerID);
+        }
 
-    // The default timer type is not very accurate below about 200ms http://doc.qt.io/qt-5/qt.html#TimerType-enum
-    static const int MIN_TIMEOUT_FOR_COARSE_TIMER = 200;
-    if (intervalMS < MIN_TIMEOUT_FOR_COARSE_TIMER) {
-        newTimer->setTimerType(Qt::PreciseTimer);
+        // call the associated JS function, if it exists
+        if (timerData.function.isValid()) {
+            PROFILE_RANGE(script, __FUNCTION__);
+            auto preTimer = p_high_resolution_clock::now();
+            callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
+            auto postTimer = p_high_resolution_clock::now();
+            auto elapsed = (postTimer - preTimer);
+            _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        } else {
+            qCWarning(scriptengine) << "timerFired -- invalid function" << timerData.function.toVariant().toString();
+        }
     }
 
-    connect(newTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+    updateTimerWheelTimer();
+}
 
-    // make sure the timer stops when the script does
-    connect(this, &ScriptEngine::scriptEnding, newTimer, &QTimer::stop);
+void ScriptEngine::updateTimerWheelTimer() {
+    int64_t msecsUntilNextExpiry = _timerWheel.msecsUntilNextExpiry(_timerClock.elapsed());
+    if (msecsUntilNextExpiry < 0) {
+        _timerWheelTimer->stop();
+    } else if (!_timerWheelTimer->isActive() || _timerWheelTimer->remainingTime() > msecsUntilNextExpiry) {
+        _timerWheelTimer->start((int)std::min(msecsUntilNextExpiry, (int64_t)std::numeric_limits<int>::max()));
+    }
+}
 
+QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
+    // add the timer to the wheel, the handle is what the script gets back
+    QObject* handle = new QObject(this);
+    auto timerID = _timerWheel.add(_timerClock.elapsed(), (uint32_t)std::max(intervalMS, 0), isSingleShot, currentEntityIdentifier);
 
     CallbackData timerData = { function, currentEntityIdentifier, currentSandboxURL };
-    _timerFunctionMap.insert(newTimer, timerData);
+    _timers[timerID] = { timerData, handle };
+    _timerHandles.insert(handle, timerID);
 
-    newTimer->start(intervalMS);
-    return newTimer;
+    updateTimerWheelTimer();
+    return handle;
 }
 
 QObject* ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
@@ -1486,13 +1496,27 @@ QObject* ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
     return setupTimerWithInterval(function, timeoutMS, true);
 }
 
-void ScriptEngine::stopTimer(QTimer *timer) {
-    if (_timerFunctionMap.contains(timer)) {
-        timer->stop();
-        _timerFunctionMap.remove(timer);
-        delete timer;
+void ScriptEngine::stopTimer(QObject* timer) {
+    auto handleItr = _timerHandles.find(timer);
+    if (handleItr != _timerHandles.end()) {
+        _timerWheel.remove(handleItr.value());
+        removeTimer(handleItr.value());
+        if (_timerWheel.isEmpty()) {
+            _timerWheelTimer->stop();
+        }
     } else {
-        qCDebug(scriptengine) << "stopTimer -- not in _timerFunctionMap" << timer;
+        qCDebug(scriptengine) << "stopTimer -- not a timer of this script" << timer;
+    }
+}
+
+// Forgets a timer that is no longer in the wheel, and deletes its handle
+void ScriptEngine::removeTimer(TimerWheel::TimerID timerID) {
+    auto timerItr = _timers.find(timerID);
+    if (timerItr != _timers.end()) {
+        QObject* handle = timerItr->second.handle;
+        _timerHandles.remove(handle);
+        _timers.erase(timerItr);
+        delete handle;
     }
 }
 
@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QSet>
@@ -31,6 +32,7 @@
 #include <EntityItemID.h>
 #include <EntitiesScriptEngineProvider.h>
 #include <EntityScriptUtils.h>
+#include <TimerWheel.h>
 
 #include "PointerEvent.h"
 #include "ArrayBufferClass.h"
@@ -47,6 +49,7 @@
 #include "Profile.h"
 
 class QScriptEngineDebugger;
+class QTimer;
 
 static const QString NO_SCRIPT("");
 
@@ -481,7 +484,7 @@ public:
      *     Script.clearInterval(timer);
      * }, 10000);
      */
-    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(timer); }
 
     /**jsdoc
      * Stops a timeout timer set by {@link Script.setTimeout|setTimeout}.
@@ -496,7 +499,7 @@ public:
      * // Uncomment the following line to stop the timer from firing.
      * //Script.clearTimeout(timer);
      */
-    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(timer); }
 
     /**jsdoc
      * Prints a message to the program log.
@@ -906,7 +909,9 @@ protected:
     void setParentURL(const QString& parentURL) { _parentURL = parentURL; }
 
     QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
-    void stopTimer(QTimer* timer);
+    void stopTimer(QObject* timer);
+    void removeTimer(TimerWheel::TimerID timerID);
+    void updateTimerWheelTimer();
 
     QHash<EntityItemID, RegisteredEventHandlers> _registeredHandlers;
     void forwardHandlerCall(const EntityItemID& entityID, const QString& eventName, QScriptValueList eventHanderArgs);
@@ -936,7 +941,19 @@ protected:
     std::atomic<bool> _isRunning { false };
     std::atomic<bool> _isStopping { false };
     bool _isInitialized { false };
-    QHash<QTimer*, CallbackData> _timerFunctionMap;
+
+    // Script timers live in a timer wheel driven by a single Qt timer. Scripts get a plain QObject per timer as the
+    // handle to pass to clearTimeout/clearInterval.
+    struct ScriptTimer {
+        CallbackData callback;
+        QObject* handle;
+    };
+    TimerWheel _timerWheel;
+    QTimer* _timerWheelTimer { nullptr };
+    QElapsedTimer _timerClock;
+    std::unordered_map<TimerWheel::TimerID, ScriptTimer> _timers;
+    QHash<QObject*, TimerWheel::TimerID> _timerHandles;
+
     QSet<QUrl> _includedURLs;
     mutable QReadWriteLock _entityScriptsLock { QReadWriteLock::Recursive };
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
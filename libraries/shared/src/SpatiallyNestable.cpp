@@ -29,6 +29,7 @@ SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
     _transform.setTranslation(glm::vec3(0.0f));
     _transform.setRotation(glm::quat());
     _transform.setScale(1.0f);
+    _publishedTransform.set({ _transform.getRotation(), _transform.getScale(), _transform.getTranslation() });
     _scaleChanged = usecTimestampNow();
     _translationChanged = usecTimestampNow();
     _rotationChanged = usecTimestampNow();
@@ -40,6 +41,23 @@ SpatiallyNestable::~SpatiallyNestable() {
     });
 }
 
+template <typename F>
+void SpatiallyNestable::withTransformWriteLock(F&& f) {
+    _transformLock.withWriteLock([&] {
+        f();
+        _publishedTransform.set({ _transform.getRotation(), _transform.getScale(), _transform.getTranslation() });
+    });
+}
+
+Transform SpatiallyNestable::getPublishedTransform() const {
+    TransformComponents components = _publishedTransform.get();
+    Transform transform;
+    transform.setRotation(components.rotation);
+    transform.setScale(components.scale);
+    transform.setTranslation(components.translation);
+    return transform;
+}
+
 const QUuid SpatiallyNestable::getID() const {
     QUuid result;
     _idLock.withReadLock([&] {
@@ -498,7 +516,7 @@ void SpatiallyNestable::setWorldTransform(const glm::vec3& position, const glm::
     Transform parentTransform = getParentTransform(success);
     if (success) {
         bool changed = false;
-        _transformLock.withWriteLock([&] {
+        withTransformWriteLock([&] {
             Transform myWorldTransform;
             Transform::mult(myWorldTransform, parentTransform, _transform);
             if (myWorldTransform.getRotation() != orientation) {
@@ -549,7 +567,7 @@ void SpatiallyNestable::setWorldPosition(const glm::vec3& position, bool& succes
     bool changed = false;
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         Transform::mult(myWorldTransform, parentTransform, _transform);
         if (myWorldTransform.getTranslation() != position) {
             changed = true;
@@ -602,7 +620,7 @@ void SpatiallyNestable::setWorldOrientation(const glm::quat& orientation, bool&
     bool changed = false;
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         Transform::mult(myWorldTransform, parentTransform, _transform);
         if (myWorldTransform.getRotation() != orientation) {
             changed = true;
@@ -636,11 +654,8 @@ glm::vec3 SpatiallyNestable::getWorldVelocity(bool& success) const {
     if (!success) {
         return result;
     }
-    _velocityLock.withReadLock([&] {
-        // TODO: take parent angularVelocity into account.
-        result = parentVelocity + parentTransform.getRotation() * _velocity;
-    });
-    return result;
+    // TODO: take parent angularVelocity into account.
+    return parentVelocity + parentTransform.getRotation() * _velocity.get();
 }
 
 glm::vec3 SpatiallyNestable::getWorldVelocity() const {
@@ -655,20 +670,18 @@ glm::vec3 SpatiallyNestable::getWorldVelocity() const {
 void SpatiallyNestable::setWorldVelocity(const glm::vec3& velocity, bool& success) {
     glm::vec3 parentVelocity = getParentVelocity(success);
     Transform parentTransform = getParentTransform(success);
-    _velocityLock.withWriteLock([&] {
-        // HACK: until we are treating _velocity the same way we treat _position (meaning,
-        // _velocity is a vs parent value and any request for a world-frame velocity must
-        // be computed), do this to avoid equipped (parenting-grabbed) things from drifting.
-        // turning a zero velocity into a non-zero _velocity (because the avatar is moving)
-        // causes EntityItem::stepKinematicMotion to have an effect on the equipped entity,
-        // which causes it to drift from the hand.
-        if (hasAncestorOfType(NestableType::Avatar)) {
-            _velocity = velocity;
-        } else {
-            // TODO: take parent angularVelocity into account.
-            _velocity = glm::inverse(parentTransform.getRotation()) * (velocity - parentVelocity);
-        }
-    });
+    // HACK: until we are treating _velocity the same way we treat _position (meaning,
+    // _velocity is a vs parent value and any request for a world-frame velocity must
+    // be computed), do this to avoid equipped (parenting-grabbed) things from drifting.
+    // turning a zero velocity into a non-zero _velocity (because the avatar is moving)
+    // causes EntityItem::stepKinematicMotion to have an effect on the equipped entity,
+    // which causes it to drift from the hand.
+    if (hasAncestorOfType(NestableType::Avatar)) {
+        _velocity.set(velocity);
+    } else {
+        // TODO: take parent angularVelocity into account.
+        _velocity.set(glm::inverse(parentTransform.getRotation()) * (velocity - parentVelocity));
+    }
 }
 
 void SpatiallyNestable::setWorldVelocity(const glm::vec3& velocity) {
@@ -701,10 +714,7 @@ glm::vec3 SpatiallyNestable::getWorldAngularVelocity(bool& success) const {
     if (!success) {
         return result;
     }
-    _angularVelocityLock.withReadLock([&] {
-        result = parentAngularVelocity + parentTransform.getRotation() * _angularVelocity;
-    });
-    return result;
+    return parentAngularVelocity + parentTransform.getRotation() * _angularVelocity.get();
 }
 
 glm::vec3 SpatiallyNestable::getWorldAngularVelocity() const {
@@ -719,9 +729,7 @@ glm::vec3 SpatiallyNestable::getWorldAngularVelocity() const {
 void SpatiallyNestable::setWorldAngularVelocity(const glm::vec3& angularVelocity, bool& success) {
     glm::vec3 parentAngularVelocity = getParentAngularVelocity(success);
     Transform parentTransform = getParentTransform(success);
-    _angularVelocityLock.withWriteLock([&] {
-        _angularVelocity = glm::inverse(parentTransform.getRotation()) * (angularVelocity - parentAngularVelocity);
-    });
+    _angularVelocity.set(glm::inverse(parentTransform.getRotation()) * (angularVelocity - parentAngularVelocity));
 }
 
 void SpatiallyNestable::setWorldAngularVelocity(const glm::vec3& angularVelocity) {
@@ -748,9 +756,7 @@ const Transform SpatiallyNestable::getTransform(bool& success, int depth) const
     Transform result;
     // return a world-space transform for this object's location
     Transform parentTransform = getParentTransform(success, depth);
-    _transformLock.withReadLock([&] {
-        Transform::mult(result, parentTransform, _transform);
-    });
+    Transform::mult(result, parentTransform, getPublishedTransform());
     return result;
 }
 
@@ -810,7 +816,7 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
     Transform parentTransform = getParentTransform(success);
     if (success) {
         bool changed = false;
-        _transformLock.withWriteLock([&] {
+        withTransformWriteLock([&] {
             Transform beforeTransform = _transform;
             Transform::inverseMult(_transform, parentTransform, transform);
             if (_transform != beforeTransform) {
@@ -865,7 +871,7 @@ void SpatiallyNestable::setSNScale(const glm::vec3& scale, bool& success) {
     bool changed = false;
     Transform parentTransform = getParentTransform(success);
     Transform myWorldTransform;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         Transform::mult(myWorldTransform, parentTransform, _transform);
         if (myWorldTransform.getScale() != scale) {
             changed = true;
@@ -880,11 +886,7 @@ void SpatiallyNestable::setSNScale(const glm::vec3& scale, bool& success) {
 }
 
 Transform SpatiallyNestable::getLocalTransform() const {
-    Transform result;
-    _transformLock.withReadLock([&] {
-        result =_transform;
-    });
-    return result;
+    return getPublishedTransform();
 }
 
 void SpatiallyNestable::setLocalTransform(const Transform& transform) {
@@ -895,7 +897,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
     }
 
     bool changed = false;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform != transform) {
             _transform = transform;
             changed = true;
@@ -911,11 +913,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
 }
 
 glm::vec3 SpatiallyNestable::getLocalPosition() const {
-    glm::vec3 result;
-    _transformLock.withReadLock([&] {
-        result = _transform.getTranslation();
-    });
-    return result;
+    return _publishedTransform.get().translation;
 }
 
 void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhysics) {
@@ -925,7 +923,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
         return;
     }
     bool changed = false;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform.getTranslation() != position) {
             _transform.setTranslation(position);
             changed = true;
@@ -938,11 +936,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
 }
 
 glm::quat SpatiallyNestable::getLocalOrientation() const {
-    glm::quat result;
-    _transformLock.withReadLock([&] {
-        result = _transform.getRotation();
-    });
-    return result;
+    return _publishedTransform.get().rotation;
 }
 
 void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
@@ -952,7 +946,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
         return;
     }
     bool changed = false;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform.getRotation() != orientation) {
             _transform.setRotation(orientation);
             changed = true;
@@ -965,39 +959,23 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
 }
 
 glm::vec3 SpatiallyNestable::getLocalVelocity() const {
-    glm::vec3 result;
-    _velocityLock.withReadLock([&] {
-        result = _velocity;
-    });
-    return result;
+    return _velocity.get();
 }
 
 void SpatiallyNestable::setLocalVelocity(const glm::vec3& velocity) {
-    _velocityLock.withWriteLock([&] {
-        _velocity = velocity;
-    });
+    _velocity.set(velocity);
 }
 
 glm::vec3 SpatiallyNestable::getLocalAngularVelocity() const {
-    glm::vec3 result;
-    _angularVelocityLock.withReadLock([&] {
-        result = _angularVelocity;
-    });
-    return result;
+    return _angularVelocity.get();
 }
 
 void SpatiallyNestable::setLocalAngularVelocity(const glm::vec3& angularVelocity) {
-    _angularVelocityLock.withWriteLock([&] {
-        _angularVelocity = angularVelocity;
-    });
+    _angularVelocity.set(angularVelocity);
 }
 
 glm::vec3 SpatiallyNestable::getLocalSNScale() const {
-    glm::vec3 result;
-    _transformLock.withReadLock([&] {
-        result = _transform.getScale();
-    });
-    return result;
+    return _publishedTransform.get().scale;
 }
 
 void SpatiallyNestable::setLocalSNScale(const glm::vec3& scale) {
@@ -1008,7 +986,7 @@ void SpatiallyNestable::setLocalSNScale(const glm::vec3& scale) {
     }
 
     bool changed = false;
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform.getScale() != scale) {
             _transform.setScale(scale);
             changed = true;
@@ -1291,18 +1269,9 @@ void SpatiallyNestable::getLocalTransformAndVelocities(
         Transform& transform,
         glm::vec3& velocity,
         glm::vec3& angularVelocity) const {
-    // transform
-    _transformLock.withReadLock([&] {
-        transform = _transform;
-    });
-    // linear velocity
-    _velocityLock.withReadLock([&] {
-        velocity = _velocity;
-    });
-    // angular velocity
-    _angularVelocityLock.withReadLock([&] {
-        angularVelocity = _angularVelocity;
-    });
+    transform = getPublishedTransform();
+    velocity = _velocity.get();
+    angularVelocity = _angularVelocity.get();
 }
 
 void SpatiallyNestable::setLocalTransformAndVelocities(
@@ -1313,7 +1282,7 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
     bool changed = false;
 
     // transform
-    _transformLock.withWriteLock([&] {
+    withTransformWriteLock([&] {
         if (_transform != localTransform) {
             _transform = localTransform;
             changed = true;
@@ -1322,14 +1291,8 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
             _rotationChanged = usecTimestampNow();
         }
     });
-    // linear velocity
-    _velocityLock.withWriteLock([&] {
-        _velocity = localVelocity;
-    });
-    // angular velocity
-    _angularVelocityLock.withWriteLock([&] {
-        _angularVelocity = localAngularVelocity;
-    });
+    _velocity.set(localVelocity);
+    _angularVelocity.set(localAngularVelocity);
 
     if (changed) {
         locationChanged(false);
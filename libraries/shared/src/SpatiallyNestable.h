@@ -18,6 +18,7 @@
 #include "AACube.h"
 #include "SpatialParentFinder.h"
 #include "shared/ReadWriteLockable.h"
+#include "shared/SeqLocked.h"
 #include "Grab.h"
 
 class SpatiallyNestable;
@@ -253,13 +254,23 @@ private:
     QUuid _parentID; // what is this thing's transform relative to?
     quint16 _parentJointIndex { INVALID_JOINT_INDEX }; // which joint of the parent is this relative to?
 
-    mutable ReadWriteLockable _transformLock;
+    struct TransformComponents {
+        glm::quat rotation;
+        glm::vec3 scale { 1.0f };
+        glm::vec3 translation;
+    };
+
+    template <typename F>
+    void withTransformWriteLock(F&& f);
+    Transform getPublishedTransform() const;
+
+    mutable ReadWriteLockable _transformLock; // serializes the changes to _transform
     mutable ReadWriteLockable _idLock;
-    mutable ReadWriteLockable _velocityLock;
-    mutable ReadWriteLockable _angularVelocityLock;
     Transform _transform; // this is to be combined with parent's world-transform to produce this' world-transform.
-    glm::vec3 _velocity;
-    glm::vec3 _angularVelocity;
+    // what readers get of _transform, without waiting on its lock
+    SeqLocked<TransformComponents> _publishedTransform;
+    SeqLocked<glm::vec3> _velocity;
+    SeqLocked<glm::vec3> _angularVelocity;
     mutable bool _parentKnowsMe { false };
     bool _isDead { false };
     bool _queryAACubeIsPuffed { false };
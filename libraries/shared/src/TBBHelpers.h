@@ -21,6 +21,8 @@
 #include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range2d.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
 #ifdef _WIN32
 #pragma warning( pop )
@@ -0,0 +1,323 @@
+//
+//  TimerWheel.cpp
+//  libraries/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Level L has NUM_SLOTS slots of 2^(SLOT_BITS * L) ticks each. A timer goes in the lowest level whose span covers
+// its delay, and moves down a level (cascades) when the wheel reaches the start of its slot. Level 0 slots are one
+// tick each and expire their timers.
+
+static inline int countTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+static inline uint64_t rotateRight(uint64_t bits, int count) {
+    return count == 0 ? bits : (bits >> count) | (bits << (64 - count));
+}
+
+TimerWheel::TimerWheel(uint64_t nowMsecs) : _tick(nowMsecs) {
+    std::fill(std::begin(_slotHeads), std::end(_slotHeads), NONE);
+    std::fill(std::begin(_slotTails), std::end(_slotTails), NONE);
+    std::fill(std::begin(_occupied), std::end(_occupied), 0);
+}
+
+TimerWheel::TimerID TimerWheel::makeID(int32_t index) const {
+    return ((TimerID)_nodes[index].generation << 32) | (TimerID)(uint32_t)index;
+}
+
+int32_t TimerWheel::findNode(TimerID id) const {
+    uint32_t index = (uint32_t)(id & 0xffffffff);
+    uint32_t generation = (uint32_t)(id >> 32);
+    if (index >= _nodes.size()) {
+        return NONE;
+    }
+    const Node& node = _nodes[index];
+    if (!node.active || node.generation != generation) {
+        return NONE;
+    }
+    return (int32_t)index;
+}
+
+TimerWheel::TimerID TimerWheel::add(uint64_t nowMsecs, uint32_t intervalMsecs, bool singleShot, const QUuid& group) {
+    int32_t index;
+    if (!_freeNodes.empty()) {
+        index = _freeNodes.back();
+        _freeNodes.pop_back();
+    } else {
+        index = (int32_t)_nodes.size();
+        _nodes.emplace_back();
+    }
+
+    Node& node = _nodes[index];
+    node.active = true;
+    node.singleShot = singleShot;
+    // a zero interval repeating timer fires once per tick
+    node.interval = singleShot ? intervalMsecs : std::max(intervalMsecs, (uint32_t)1);
+    node.expiry = nowMsecs + node.interval;
+    node.group = group;
+    schedule(index);
+    linkGroup(index);
+    _size++;
+    return makeID(index);
+}
+
+bool TimerWheel::remove(TimerID id) {
+    int32_t index = findNode(id);
+    if (index == NONE) {
+        return false;
+    }
+    unschedule(index);
+    unlinkGroup(index);
+    freeNode(index);
+    return true;
+}
+
+void TimerWheel::removeGroup(const QUuid& group, std::vector<TimerID>& removed) {
+    auto groupItr = _groups.find(group);
+    if (groupItr == _groups.end()) {
+        return;
+    }
+    int32_t index = groupItr->second;
+    _groups.erase(groupItr);
+    while (index != NONE) {
+        int32_t next = _nodes[index].groupNext;
+        removed.push_back(makeID(index));
+        unschedule(index);
+        _nodes[index].groupPrev = NONE;
+        _nodes[index].groupNext = NONE;
+        freeNode(index);
+        index = next;
+    }
+}
+
+void TimerWheel::clear() {
+    _freeNodes.clear();
+    for (int32_t i = (int32_t)_nodes.size() - 1; i >= 0; i--) {
+        Node& node = _nodes[i];
+        if (node.active) {
+            node.prev = node.next = node.slot = NONE;
+            node.groupPrev = node.groupNext = NONE;
+            freeNode(i);
+        } else {
+            _freeNodes.push_back(i);
+        }
+    }
+    std::fill(std::begin(_slotHeads), std::end(_slotHeads), NONE);
+    std::fill(std::begin(_slotTails), std::end(_slotTails), NONE);
+    std::fill(std::begin(_occupied), std::end(_occupied), 0);
+    _groups.clear();
+    _size = 0;
+}
+
+bool TimerWheel::contains(TimerID id) const {
+    return findNode(id) != NONE;
+}
+
+void TimerWheel::freeNode(int32_t index) {
+    Node& node = _nodes[index];
+    node.active = false;
+    node.group = QUuid();
+    // invalidate the outstanding ids of this node
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    _freeNodes.push_back(index);
+    _size--;
+}
+
+void TimerWheel::schedule(int32_t index) {
+    static const uint64_t WHEEL_SPAN = (uint64_t)1 << (SLOT_BITS * NUM_LEVELS);
+
+    Node& node = _nodes[index];
+    uint64_t expiry = std::max(node.expiry, _tick);
+    uint64_t delta = expiry - _tick;
+    if (delta >= WHEEL_SPAN) {
+        // beyond the top level, park it in the last top level slot, it is rescheduled from there with its real expiry
+        expiry = _tick + WHEEL_SPAN - 1;
+        delta = WHEEL_SPAN - 1;
+    }
+    int level = 0;
+    while (level < NUM_LEVELS - 1 && delta >= ((uint64_t)1 << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    int slotIndex = (int)((expiry >> (SLOT_BITS * level)) & (NUM_SLOTS - 1));
+    int32_t slot = level * NUM_SLOTS + slotIndex;
+
+    node.slot = slot;
+    node.next = NONE;
+    node.prev = _slotTails[slot];
+    if (node.prev != NONE) {
+        _nodes[node.prev].next = index;
+    } else {
+        _slotHeads[slot] = index;
+    }
+    _slotTails[slot] = index;
+    _occupied[level] |= (uint64_t)1 << slotIndex;
+}
+
+void TimerWheel::unschedule(int32_t index) {
+    Node& node = _nodes[index];
+    int32_t slot = node.slot;
+    if (slot == NONE) {
+        return;
+    }
+    if (node.prev != NONE) {
+        _nodes[node.prev].next = node.next;
+    } else {
+        _slotHeads[slot] = node.next;
+    }
+    if (node.next != NONE) {
+        _nodes[node.next].prev = node.prev;
+    } else {
+        _slotTails[slot] = node.prev;
+    }
+    if (_slotHeads[slot] == NONE) {
+        _occupied[slot / NUM_SLOTS] &= ~((uint64_t)1 << (slot % NUM_SLOTS));
+    }
+    node.prev = node.next = node.slot = NONE;
+}
+
+void TimerWheel::linkGroup(int32_t index) {
+    Node& node = _nodes[index];
+    node.groupPrev = node.groupNext = NONE;
+    if (node.group.isNull()) {
+        return;
+    }
+    auto groupItr = _groups.find(node.group);
+    if (groupItr != _groups.end()) {
+        node.groupNext = groupItr->second;
+        _nodes[groupItr->second].groupPrev = index;
+        groupItr->second = index;
+    } else {
+        _groups.emplace(node.group, index);
+    }
+}
+
+void TimerWheel::unlinkGroup(int32_t index) {
+    Node& node = _nodes[index];
+    if (node.group.isNull()) {
+        return;
+    }
+    if (node.groupPrev != NONE) {
+        _nodes[node.groupPrev].groupNext = node.groupNext;
+    } else if (node.groupNext != NONE) {
+        _groups[node.group] = node.groupNext;
+    } else {
+        _groups.erase(node.group);
+    }
+    if (node.groupNext != NONE) {
+        _nodes[node.groupNext].groupPrev = node.groupPrev;
+    }
+    node.groupPrev = node.groupNext = NONE;
+}
+
+uint64_t TimerWheel::nextEventTick() const {
+    // The slots of a level are visited at the ticks that start them, so the next event is the earliest visit of an
+    // occupied slot over all levels.
+    uint64_t next = UINT64_MAX;
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        if (_occupied[level] == 0) {
+            continue;
+        }
+        int shift = SLOT_BITS * level;
+        uint64_t slotSize = (uint64_t)1 << shift;
+        uint64_t firstSlot = (_tick + slotSize - 1) >> shift;
+        int position = (int)(firstSlot & (NUM_SLOTS - 1));
+        uint64_t slot = firstSlot + countTrailingZeros(rotateRight(_occupied[level], position));
+        next = std::min(next, slot << shift);
+    }
+    return next;
+}
+
+void TimerWheel::cascade(int32_t slot) {
+    int32_t index = _slotHeads[slot];
+    _slotHeads[slot] = NONE;
+    _slotTails[slot] = NONE;
+    _occupied[slot / NUM_SLOTS] &= ~((uint64_t)1 << (slot % NUM_SLOTS));
+    while (index != NONE) {
+        int32_t next = _nodes[index].next;
+        schedule(index);
+        index = next;
+    }
+}
+
+void TimerWheel::processTick(uint64_t nowMsecs, std::vector<TimerID>& expired) {
+    const uint64_t tick = _tick;
+
+    // move the timers of the higher level slots starting at this tick down
+    for (int level = 1; level < NUM_LEVELS; level++) {
+        int shift = SLOT_BITS * level;
+        if ((tick & (((uint64_t)1 << shift) - 1)) != 0) {
+            break;
+        }
+        cascade(level * NUM_SLOTS + (int32_t)((tick >> shift) & (NUM_SLOTS - 1)));
+    }
+
+    int32_t slot = (int32_t)(tick & (NUM_SLOTS - 1));
+    int32_t index = _slotHeads[slot];
+    _slotHeads[slot] = NONE;
+    _slotTails[slot] = NONE;
+    _occupied[0] &= ~((uint64_t)1 << slot);
+
+    while (index != NONE) {
+        Node& node = _nodes[index];
+        int32_t next = node.next;
+        node.prev = node.next = node.slot = NONE;
+        expired.push_back(makeID(index));
+        if (node.singleShot) {
+            unlinkGroup(index);
+            freeNode(index);
+        } else {
+            // like a Qt timer, a late repeating timer fires once and then keeps its interval from now
+            node.expiry = tick + node.interval;
+            if (node.expiry <= nowMsecs) {
+                node.expiry = nowMsecs + node.interval;
+            }
+            schedule(index);
+        }
+        index = next;
+    }
+
+    _tick = tick + 1;
+}
+
+void TimerWheel::advance(uint64_t nowMsecs, std::vector<TimerID>& expired) {
+    while (_size > 0) {
+        uint64_t next = nextEventTick();
+        if (next > nowMsecs) {
+            break;
+        }
+        _tick = std::max(_tick, next);
+        processTick(nowMsecs, expired);
+    }
+    if (_tick <= nowMsecs) {
+        _tick = nowMsecs + 1;
+    }
+}
+
+int64_t TimerWheel::msecsUntilNextExpiry(uint64_t nowMsecs) const {
+    if (_size == 0) {
+        return -1;
+    }
+    uint64_t next = nextEventTick();
+    return next > nowMsecs ? (int64_t)(next - nowMsecs) : 0;
+}
@@ -0,0 +1,101 @@
+//
+//  TimerWheel.h
+//  libraries/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheel_h
+#define hifi_TimerWheel_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QUuid>
+
+#include "UUIDHasher.h"
+
+// A hierarchical timer wheel with millisecond ticks, for keeping many timers without an OS or Qt timer each.
+// Adding, removing and expiring a timer are O(1), and all the timers of a group (e.g. an entity script) can be
+// removed without looking at the others. The owner drives the wheel: it calls advance() with the current time and
+// uses msecsUntilNextExpiry() to decide when to call it again. Not thread safe.
+class TimerWheel {
+public:
+    using TimerID = uint64_t;
+    static const TimerID INVALID_TIMER_ID = 0;
+
+    TimerWheel(uint64_t nowMsecs = 0);
+
+    // Adds a timer expiring intervalMsecs after nowMsecs, and then every intervalMsecs unless it is single shot.
+    TimerID add(uint64_t nowMsecs, uint32_t intervalMsecs, bool singleShot, const QUuid& group = QUuid());
+
+    // Returns false if the timer was already removed, or has expired and was single shot.
+    bool remove(TimerID id);
+
+    // Removes all the timers of the group and appends their ids to removed.
+    void removeGroup(const QUuid& group, std::vector<TimerID>& removed);
+
+    void clear();
+
+    // Advances the wheel to nowMsecs and appends the ids of the expired timers to expired, in expiry order.
+    // Repeating timers are rescheduled, single shot timers are removed.
+    void advance(uint64_t nowMsecs, std::vector<TimerID>& expired);
+
+    // How long the owner can wait before calling advance() again, -1 if there are no timers.
+    // This is a lower bound: timers far in the future are only moved closer at coarser tick boundaries.
+    int64_t msecsUntilNextExpiry(uint64_t nowMsecs) const;
+
+    bool contains(TimerID id) const;
+    size_t size() const { return _size; }
+    bool isEmpty() const { return _size == 0; }
+
+private:
+    static const int SLOT_BITS = 6;
+    static const int NUM_SLOTS = 1 << SLOT_BITS;
+    static const int NUM_LEVELS = 4;
+    static const int32_t NONE = -1;
+
+    struct Node {
+        uint64_t expiry { 0 };
+        uint32_t interval { 0 };
+        uint32_t generation { 1 };
+        bool singleShot { true };
+        bool active { false };
+        int32_t prev { NONE };
+        int32_t next { NONE };
+        int32_t slot { NONE }; // level * NUM_SLOTS + index
+        int32_t groupPrev { NONE };
+        int32_t groupNext { NONE };
+        QUuid group;
+    };
+
+    TimerID makeID(int32_t index) const;
+    int32_t findNode(TimerID id) const;
+
+    void schedule(int32_t index);
+    void unschedule(int32_t index);
+    void linkGroup(int32_t index);
+    void unlinkGroup(int32_t index);
+    void freeNode(int32_t index);
+
+    uint64_t nextEventTick() const;
+    void processTick(uint64_t nowMsecs, std::vector<TimerID>& expired);
+    void cascade(int32_t slot);
+
+    std::vector<Node> _nodes;
+    std::vector<int32_t> _freeNodes;
+    int32_t _slotHeads[NUM_LEVELS * NUM_SLOTS];
+    int32_t _slotTails[NUM_LEVELS * NUM_SLOTS];
+    uint64_t _occupied[NUM_LEVELS]; // one bit per non empty slot
+    std::unordered_map<QUuid, int32_t> _groups; // group => first timer of the group
+
+    uint64_t _tick; // the next tick to process
+    size_t _size { 0 };
+};
+
+#endif // hifi_TimerWheel_h
@@ -0,0 +1,95 @@
+//
+//  SeqLocked.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_SeqLocked_h
+#define hifi_SeqLocked_h
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+// A small value behind a sequence lock: readers never block nor write to shared memory, they copy the value and
+// try again if a writer published a new one meanwhile. Writers are exclusive, they briefly spin on each other.
+// Meant for values that are read much more often than they are written, from many threads.
+template <typename T>
+class SeqLocked {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLocked values are copied while they can be written");
+
+public:
+    SeqLocked() {}
+    SeqLocked(const T& value) : _value(value) {}
+
+    SeqLocked(const SeqLocked&) = delete;
+    SeqLocked& operator=(const SeqLocked&) = delete;
+
+    T get() const;
+    void set(const T& value);
+
+    // f modifies the value in place, readers see all of its changes or none
+    template <typename F>
+    void update(F&& f);
+
+private:
+    uint32_t beginWrite();
+    void endWrite(uint32_t sequence) { _sequence.store(sequence + 1, std::memory_order_release); }
+
+    // odd while a writer is publishing
+    mutable std::atomic<uint32_t> _sequence { 0 };
+    T _value;
+};
+
+template <typename T>
+inline T SeqLocked<T>::get() const {
+    T result;
+    uint32_t sequence;
+    do {
+        sequence = _sequence.load(std::memory_order_acquire);
+        while (sequence & 1) {
+            std::this_thread::yield();
+            sequence = _sequence.load(std::memory_order_acquire);
+        }
+        result = _value;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (_sequence.load(std::memory_order_relaxed) != sequence);
+    return result;
+}
+
+template <typename T>
+inline void SeqLocked<T>::set(const T& value) {
+    uint32_t sequence = beginWrite();
+    _value = value;
+    endWrite(sequence);
+}
+
+template <typename T>
+template <typename F>
+inline void SeqLocked<T>::update(F&& f) {
+    uint32_t sequence = beginWrite();
+    f(_value);
+    endWrite(sequence);
+}
+
+template <typename T>
+inline uint32_t SeqLocked<T>::beginWrite() {
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    while ((sequence & 1) || !_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire)) {
+        if (sequence & 1) {
+            std::this_thread::yield();
+            sequence = _sequence.load(std::memory_order_relaxed);
+        }
+    }
+    // the odd sequence number must be visible before any of the new value
+    std::atomic_thread_fence(std::memory_order_release);
+    return sequence + 1;
+}
+
+#endif // hifi_SeqLocked_h
@@ -15,22 +15,123 @@
 #include "Space.h"
 #include <cstring>
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <TBBHelpers.h>
+
 using namespace workload;
 
+namespace {
+    // Below this many proxies the classification runs on the calling thread, above it blocks are split across the TBB pool
+    const uint32_t PARALLEL_CLASSIFY_MIN_PROXIES = 8192;
+    const size_t PARALLEL_CLASSIFY_GRAIN_BLOCKS = 16;
+
+    // The region spheres of every view, flattened as a structure of arrays
+    struct RegionSpheres {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+        std::vector<uint8_t> region;
+
+        RegionSpheres(const Views& views) {
+            for (const auto& view : views) {
+                for (uint8_t k = 0; k < Region::NUM_TRACKED_REGIONS; ++k) {
+                    x.push_back(view.regions[k].x);
+                    y.push_back(view.regions[k].y);
+                    z.push_back(view.regions[k].z);
+                    radius.push_back(view.regions[k].w);
+                    region.push_back(k);
+                }
+            }
+        }
+    };
+
+    // Classifies count proxies, one region sphere at a time over all of them. The inner loop only compares squared
+    // distances, so that it has no branch or sqrt and GCC vectorizes it at -O3.
+    // A proxy is in the smallest region whose sphere it touches, for any view, and in R4 if it touches none.
+    // Returns a lower bound of the distance between the valid proxies and the closest region boundary, the most the
+    // regions can move before one of these proxies changes region.
+    float classifyBlock(const RegionSpheres& spheres, const float* proxyX, const float* proxyY, const float* proxyZ,
+                        const float* proxyRadius, uint32_t count, const uint8_t* currentRegions, uint8_t* newRegions) {
+        uint8_t regions[64];
+        float gaps2[64];
+        float maxDistances2[64];
+        float maxTouchDistances[64];
+        for (uint32_t i = 0; i < count; ++i) {
+            regions[i] = Region::R4;
+            gaps2[i] = FLT_MAX;
+            maxDistances2[i] = 0.0f;
+            maxTouchDistances[i] = 0.0f;
+        }
+
+        for (size_t s = 0; s < spheres.region.size(); ++s) {
+            const float sx = spheres.x[s];
+            const float sy = spheres.y[s];
+            const float sz = spheres.z[s];
+            const float sr = spheres.radius[s];
+            const uint8_t sregion = spheres.region[s];
+            for (uint32_t i = 0; i < count; ++i) {
+                float dx = proxyX[i] - sx;
+                float dy = proxyY[i] - sy;
+                float dz = proxyZ[i] - sz;
+                float distance2 = dx * dx + dy * dy + dz * dz;
+                float touchDistance = proxyRadius[i] + sr;
+                float touchDistance2 = touchDistance * touchDistance;
+                uint8_t touchRegion = distance2 < touchDistance2 ? sregion : (uint8_t)Region::R4;
+                regions[i] = std::min(regions[i], touchRegion);
+                gaps2[i] = std::min(gaps2[i], std::abs(distance2 - touchDistance2));
+                maxDistances2[i] = std::max(maxDistances2[i], distance2);
+                maxTouchDistances[i] = std::max(maxTouchDistances[i], touchDistance);
+            }
+        }
+
+        float blockMargin = FLT_MAX;
+        for (uint32_t i = 0; i < count; ++i) {
+            // UNKNOWN proxies get classified, INVALID ones are not in the space
+            if (currentRegions[i] < Region::INVALID) {
+                newRegions[i] = regions[i];
+                // |d - t| = |d^2 - t^2| / (d + t), and d + t is at most the largest distance plus the largest touch
+                // distance, so one sqrt per proxy bounds its distance to every boundary
+                float bound = std::sqrt(maxDistances2[i]) + maxTouchDistances[i];
+                blockMargin = std::min(blockMargin, bound > 0.0f ? gaps2[i] / bound : 0.0f);
+            } else {
+                newRegions[i] = currentRegions[i];
+            }
+        }
+        return blockMargin;
+    }
+}
+
 Space::Space() : Collection() {
 }
 
+void Space::resizeProxies(uint32_t numProxies) {
+    _proxyX.resize(numProxies, 0.0f);
+    _proxyY.resize(numProxies, 0.0f);
+    _proxyZ.resize(numProxies, 0.0f);
+    _proxyRadius.resize(numProxies, 0.0f);
+    for (auto& regions : _regionBuffers) {
+        regions.resize(numProxies, Region::INVALID);
+    }
+    _owners.resize(numProxies);
+
+    uint32_t numBlocks = (numProxies + PROXY_BLOCK_SIZE - 1) / PROXY_BLOCK_SIZE;
+    _blockDirty.resize(numBlocks, true);
+    _blockStableUntilDrift.resize(numBlocks, 0.0);
+}
+
 void Space::processTransactionFrame(const Transaction& transaction) {
+    std::unique_lock<std::mutex> classificationLock(_classificationMutex);
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     // Here we should be able to check the value of last ProxyID allocated
     // and allocate new proxies accordingly
     ProxyID maxID = _IDAllocator.getNumAllocatedIndices();
-    if (maxID > (Index) _proxies.size()) {
-        _proxies.resize(maxID + 100); // allocate the maxId and more
-        _owners.resize(maxID + 100);
+    if (maxID > (Index) _proxyX.size()) {
+        resizeProxies(maxID + 100); // allocate the maxId and more
     }
     // Now we know for sure that we have enough items in the array to
     // capture anything coming from the transaction
@@ -49,11 +150,15 @@ void Space::processResets(const Transaction::Resets& transactions) {
         if (!_IDAllocator.checkIndex(proxyID)) {
             continue;
         }
-        auto& item = _proxies[proxyID];
 
         // Reset the item with a new payload
-        item.sphere = (std::get<1>(reset));
-        item.prevRegion = item.region = Region::UNKNOWN;
+        const Sphere& sphere = std::get<1>(reset);
+        _proxyX[proxyID] = sphere.x;
+        _proxyY[proxyID] = sphere.y;
+        _proxyZ[proxyID] = sphere.z;
+        _proxyRadius[proxyID] = sphere.w;
+        _regionBuffers[_previousRegions][proxyID] = _regionBuffers[_currentRegions][proxyID] = Region::UNKNOWN;
+        markDirty(proxyID);
 
         _owners[proxyID] = (std::get<2>(reset));
     }
@@ -66,11 +171,9 @@ void Space::processRemoves(const Transaction::Removes& transactions) {
         }
         _IDAllocator.freeIndex(removedID);
 
-        // Access the true item
-        auto& item = _proxies[removedID];
-
         // Kill it
-        item.prevRegion = item.region = Region::INVALID;
+        _regionBuffers[_previousRegions][removedID] = _regionBuffers[_currentRegions][removedID] = Region::INVALID;
+        markDirty(removedID);
         _owners[removedID] = Owner();
     }
 }
@@ -82,54 +185,85 @@ void Space::processUpdates(const Transaction::Updates& transactions) {
             continue;
         }
 
-        // Access the true item
-        auto& item = _proxies[updateID];
-
         // Update the item
-        item.sphere = (std::get<1>(update));
+        const Sphere& sphere = std::get<1>(update);
+        _proxyX[updateID] = sphere.x;
+        _proxyY[updateID] = sphere.y;
+        _proxyZ[updateID] = sphere.z;
+        _proxyRadius[updateID] = sphere.w;
+        markDirty(updateID);
     }
 }
 
 void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
-    std::unique_lock<std::mutex> lock(_proxiesMutex);
-    uint32_t numProxies = (uint32_t)_proxies.size();
-    uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Region::INVALID) {
-            glm::vec3 proxyCenter = glm::vec3(proxy.sphere);
-            float proxyRadius = proxy.sphere.w;
-            uint8_t region = Region::R4;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                auto& view = _views[j];
-                // for each 'view' we need only increment 'k' below the current value of 'region'
-                for (uint8_t k = 0; k < region; ++k) {
-                    float touchDistance = proxyRadius + view.regions[k].w;
-                    if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
-                        region = k;
-                        break;
-                    }
-                }
-            }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+    // Only the transactions edit the proxies, so the classification can read them without _proxiesMutex
+    std::unique_lock<std::mutex> classificationLock(_classificationMutex);
+    uint32_t numProxies = (uint32_t)_proxyX.size();
+    uint32_t numBlocks = (uint32_t)_blockDirty.size();
+    uint8_t nextRegions = 3 - _currentRegions - _previousRegions;
+    const uint8_t* currentRegions = _regionBuffers[_currentRegions].data();
+    uint8_t* newRegions = _regionBuffers[nextRegions].data();
+
+    if (_viewsChanged) {
+        std::fill(_blockDirty.begin(), _blockDirty.end(), true);
+        _viewsChanged = false;
+    }
+
+    const RegionSpheres spheres(_views);
+    auto classifyBlocks = [&](uint32_t firstBlock, uint32_t endBlock) {
+        for (uint32_t block = firstBlock; block < endBlock; ++block) {
+            uint32_t first = block * PROXY_BLOCK_SIZE;
+            uint32_t count = std::min((uint32_t)PROXY_BLOCK_SIZE, numProxies - first);
+            if (!_blockDirty[block] && _viewDrift < _blockStableUntilDrift[block]) {
+                // nothing in this block can have changed region
+                memcpy(newRegions + first, currentRegions + first, count);
+                continue;
             }
+            float margin = classifyBlock(spheres, _proxyX.data() + first, _proxyY.data() + first, _proxyZ.data() + first,
+                                         _proxyRadius.data() + first, count, currentRegions + first, newRegions + first);
+            _blockStableUntilDrift[block] = _viewDrift + margin;
         }
+    };
+
+    if (numProxies < PARALLEL_CLASSIFY_MIN_PROXIES) {
+        classifyBlocks(0, numBlocks);
+    } else {
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, numBlocks, PARALLEL_CLASSIFY_GRAIN_BLOCKS),
+            [&](const tbb::blocked_range<uint32_t>& range) {
+                classifyBlocks(range.begin(), range.end());
+            });
     }
+    // std::vector<bool> packs its values, so the blocks are marked clean once the parallel work is done
+    std::fill(_blockDirty.begin(), _blockDirty.end(), false);
+
+    for (uint32_t i = 0; i < numProxies; ++i) {
+        if (newRegions[i] != currentRegions[i]) {
+            changes.emplace_back(Space::Change((int32_t)i, newRegions[i], currentRegions[i]));
+        }
+    }
+
+    // publish the new regions, the current ones become the previous ones
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+    _previousRegions = _currentRegions;
+    _currentRegions = nextRegions;
 }
 
 uint32_t Space::copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    auto numCopied = std::min(numDestProxies, (uint32_t)_proxies.size());
-    memcpy(proxies, _proxies.data(), numCopied * sizeof(Proxy));
+    auto numCopied = std::min(numDestProxies, (uint32_t)_proxyX.size());
+    const auto& regions = _regionBuffers[_currentRegions];
+    const auto& prevRegions = _regionBuffers[_previousRegions];
+    for (uint32_t i = 0; i < numCopied; ++i) {
+        proxies[i].sphere = Sphere(_proxyX[i], _proxyY[i], _proxyZ[i], _proxyRadius[i]);
+        proxies[i].region = regions[i];
+        proxies[i].prevRegion = prevRegions[i];
+    }
     return numCopied;
 }
 
 const Owner Space::getOwner(int32_t proxyID) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    if (isAllocatedID(proxyID) && (proxyID < (Index)_proxies.size())) {
+    if (isAllocatedID(proxyID) && (proxyID < (Index)_owners.size())) {
         return _owners[proxyID];
     }
     return Owner();
@@ -137,22 +271,46 @@ const Owner Space::getOwner(int32_t proxyID) const {
 
 uint8_t Space::getRegion(int32_t proxyID) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    if (isAllocatedID(proxyID) && (proxyID < (Index)_proxies.size())) {
-        return _proxies[proxyID].region;
+    if (isAllocatedID(proxyID) && (proxyID < (Index)_proxyX.size())) {
+        return _regionBuffers[_currentRegions][proxyID];
     }
     return (uint8_t)Region::INVALID;
 }
 
+void Space::copyRegions(std::vector<uint8_t>& regions) const {
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+    regions = _regionBuffers[_currentRegions];
+}
+
 void Space::clear() {
     Collection::clear();
+    std::unique_lock<std::mutex> classificationLock(_classificationMutex);
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     _IDAllocator.clear();
-    _proxies.clear();
-    _owners.clear();
+    resizeProxies(0);
+    _viewDrift = 0.0;
+    _viewsChanged = true;
     _views.clear();
 }
 
 void Space::setViews(const Views& views) {
+    std::unique_lock<std::mutex> classificationLock(_classificationMutex);
+    if (views.size() != _views.size()) {
+        _viewsChanged = true;
+    } else {
+        // a region boundary moves by at most the distance its sphere moved plus the change of its radius
+        float drift = 0.0f;
+        for (size_t j = 0; j < views.size(); ++j) {
+            for (uint32_t k = 0; k < Region::NUM_TRACKED_REGIONS; ++k) {
+                const Sphere& region = views[j].regions[k];
+                const Sphere& prevRegion = _views[j].regions[k];
+                float regionDrift = glm::distance(glm::vec3(region), glm::vec3(prevRegion)) +
+                    std::abs(region.w - prevRegion.w);
+                drift = std::max(drift, regionDrift);
+            }
+        }
+        _viewDrift += drift;
+    }
     _views = views;
 }
 
@@ -50,6 +50,8 @@ public:
 
     const Owner getOwner(int32_t proxyID) const;
     uint8_t getRegion(int32_t proxyID) const;
+    // copies the current region of every proxy, indexed by proxyID, under a single lock
+    void copyRegions(std::vector<uint8_t>& regions) const;
 
     void clear() override;
 private:
@@ -59,11 +61,36 @@ private:
     void processRemoves(const Transaction::Removes& transactions);
     void processUpdates(const Transaction::Updates& transactions);
 
-    // The database of proxies is protected for editing by a mutex
+    void resizeProxies(uint32_t numProxies);
+    void markDirty(int32_t proxyID) { _blockDirty[proxyID / PROXY_BLOCK_SIZE] = true; }
+
+    // Proxies are classified by blocks, a block is skipped while none of its proxies changed and the views have
+    // drifted less than the distance between its proxies and the closest region boundary
+    static const uint32_t PROXY_BLOCK_SIZE = 64;
+
+    // Held by the classification and by the transactions, which both edit the proxies. The classification runs
+    // without _proxiesMutex, so that readers are only blocked while transactions are applied and regions published.
+    mutable std::mutex _classificationMutex;
+
+    // The published proxies, protected by a mutex
     mutable std::mutex _proxiesMutex;
-    Proxy::Vector _proxies;
+    // proxy spheres as a structure of arrays
+    std::vector<float> _proxyX;
+    std::vector<float> _proxyY;
+    std::vector<float> _proxyZ;
+    std::vector<float> _proxyRadius;
+    // current, previous and next regions, the next regions are published by rotating the buffers
+    std::vector<uint8_t> _regionBuffers[3];
+    uint8_t _currentRegions { 0 };
+    uint8_t _previousRegions { 1 };
     std::vector<Owner> _owners;
 
+    std::vector<bool> _blockDirty;
+    std::vector<double> _blockStableUntilDrift;
+    // how far the view regions moved or grew since the space was created, summed over frames
+    double _viewDrift { 0.0 };
+    bool _viewsChanged { true };
+
     Views _views;
 };
 
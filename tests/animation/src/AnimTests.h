@@ -13,6 +13,8 @@
 #include <QtTest/QtTest>
 #include <glm/glm.hpp>
 
+//#define MANUAL_TEST
+
 class AnimTests : public QObject {
     Q_OBJECT
 public:
@@ -23,13 +25,22 @@ private slots:
     void testClipInternalState();
     void testClipEvaulate();
     void testClipEvaulateWithVars();
+    void testClipSharedFrames();
+    void testClipMirroredFrames();
     void testLoader();
     void testVariant();
     void testAccumulateTime();
     void testAnimPose();
+    void testBlend();
+    void testBlendN();
+    void testRelativeToAbsolute();
     void testExpressionTokenizer();
     void testExpressionParser();
     void testExpressionEvaluator();
+
+#ifdef MANUAL_TEST
+    void benchmarkAnimGraph();
+#endif
 };
 
 #endif // hifi_AnimTests_h
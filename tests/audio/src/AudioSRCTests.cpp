@@ -0,0 +1,255 @@
+//
+//  AudioSRCTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSRCTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <AudioSRC.h>
+#include <CPUDetect.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioSRCTests)
+
+void AudioSRCTests::renderBatchTests() {
+    // a batch of streams with different rates and channels gives what rendering each stream on its own gives
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    const int NUM_BLOCKS = 4;
+    struct Config {
+        int inputSampleRate;
+        int outputSampleRate;
+        int numChannels;
+    };
+    const std::vector<Config> configs = {
+        { 44100, AudioConstants::SAMPLE_RATE, 2 },
+        { 48000, AudioConstants::SAMPLE_RATE, 1 },
+        { 44100, AudioConstants::SAMPLE_RATE, 2 },
+        { AudioConstants::SAMPLE_RATE, 44101, 4 },  // irrational
+    };
+    const int numStreams = (int)configs.size();
+
+    std::vector<float> inputs[SRC_MAX_CHANNELS];
+    float* inputPointers[SRC_MAX_CHANNELS];
+    for (int ch = 0; ch < SRC_MAX_CHANNELS; ch++) {
+        inputs[ch].resize(NUM_FRAMES);
+        inputPointers[ch] = inputs[ch].data();
+    }
+
+    std::vector<std::unique_ptr<AudioSRC>> batchSRCs, singleSRCs;
+    std::vector<std::vector<float>> batchOutputs, singleOutputs;
+    std::vector<std::vector<float*>> batchOutputPointers, singleOutputPointers;
+    for (const auto& config : configs) {
+        batchSRCs.emplace_back(new AudioSRC(config.inputSampleRate, config.outputSampleRate, config.numChannels));
+        singleSRCs.emplace_back(new AudioSRC(config.inputSampleRate, config.outputSampleRate, config.numChannels));
+        int maxOutputFrames = batchSRCs.back()->getMaxOutput(NUM_FRAMES);
+        batchOutputPointers.emplace_back();
+        singleOutputPointers.emplace_back();
+        for (int ch = 0; ch < config.numChannels; ch++) {
+            batchOutputs.emplace_back(maxOutputFrames);
+            singleOutputs.emplace_back(maxOutputFrames);
+            batchOutputPointers.back().push_back(batchOutputs.back().data());
+            singleOutputPointers.back().push_back(singleOutputs.back().data());
+        }
+    }
+
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        for (int ch = 0; ch < SRC_MAX_CHANNELS; ch++) {
+            for (int i = 0; i < NUM_FRAMES; i++) {
+                inputs[ch][i] = randFloatInRange(-1.0f, 1.0f);
+            }
+        }
+
+        std::vector<AudioSRC::BatchStream> streams(numStreams);
+        for (int s = 0; s < numStreams; s++) {
+            streams[s] = { batchSRCs[s].get(), inputPointers, batchOutputPointers[s].data(), NUM_FRAMES, 0 };
+        }
+        AudioSRC::renderBatch(streams.data(), numStreams);
+
+        for (int s = 0; s < numStreams; s++) {
+            int outputFrames = singleSRCs[s]->render(inputPointers, singleOutputPointers[s].data(), NUM_FRAMES);
+            QCOMPARE(streams[s].outputFrames, outputFrames);
+            QVERIFY(outputFrames >= singleSRCs[s]->getMinOutput(NUM_FRAMES));
+            QVERIFY(outputFrames <= singleSRCs[s]->getMaxOutput(NUM_FRAMES));
+            for (int ch = 0; ch < configs[s].numChannels; ch++) {
+                for (int i = 0; i < outputFrames; i++) {
+                    QCOMPARE(batchOutputPointers[s][ch][i], singleOutputPointers[s][ch][i]);
+                }
+            }
+        }
+    }
+}
+
+void AudioSRCTests::multirateFilterTests() {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    // each SIMD kernel the CPU supports gives what the scalar reference gives, and leaves the same phase and offset
+    using Filter1 = int (AudioSRC::*)(const float*, float*, int);
+    using Filter2 = int (AudioSRC::*)(const float*, const float*, float*, float*, int);
+    using Filter4 = int (AudioSRC::*)(const float*, const float*, const float*, const float*,
+                                      float*, float*, float*, float*, int);
+    struct Kernels {
+        const char* name;
+        Filter1 filter1;
+        Filter2 filter2;
+        Filter4 filter4;
+    };
+    const Kernels REFERENCE = { "reference", &AudioSRC::multirateFilter1_ref, &AudioSRC::multirateFilter2_ref,
+                                &AudioSRC::multirateFilter4_ref };
+    std::vector<Kernels> kernels;
+    if (cpuSupportsAVX2()) {
+        kernels.push_back({ "AVX2", &AudioSRC::multirateFilter1_AVX2, &AudioSRC::multirateFilter2_AVX2,
+                            &AudioSRC::multirateFilter4_AVX2 });
+    }
+    if (cpuSupportsAVX512()) {
+        kernels.push_back({ "AVX512", &AudioSRC::multirateFilter1_AVX512, &AudioSRC::multirateFilter2_AVX512,
+                            &AudioSRC::multirateFilter4_AVX512 });
+    }
+    if (kernels.empty()) {
+        QSKIP("This CPU has no SIMD resampler kernels");
+    }
+
+    auto filter = [](AudioSRC& src, const Kernels& kernel, int numChannels, float** inputs, float** outputs,
+                     int inputFrames) {
+        switch (numChannels) {
+            case 1:
+                return (src.*kernel.filter1)(inputs[0], outputs[0], inputFrames);
+            case 2:
+                return (src.*kernel.filter2)(inputs[0], inputs[1], outputs[0], outputs[1], inputFrames);
+            default:
+                return (src.*kernel.filter4)(inputs[0], inputs[1], inputs[2], inputs[3],
+                                             outputs[0], outputs[1], outputs[2], outputs[3], inputFrames);
+        }
+    };
+
+    struct Rates {
+        int inputSampleRate;
+        int outputSampleRate;
+    };
+    const std::vector<Rates> ratePairs = {
+        { 44100, 48000 },   // rational
+        { 48000, 44100 },
+        { 24000, 48000 },
+        { 48000, 16000 },
+        { 44101, 48000 },   // irrational
+        { 48000, 44101 },
+    };
+    const AudioSRC::Quality qualities[] = { AudioSRC::LOW_QUALITY, AudioSRC::MEDIUM_QUALITY, AudioSRC::HIGH_QUALITY };
+    const int channelCounts[] = { 1, 2, 4 };
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    const int NUM_BLOCKS = 3;
+    // relative to the largest output, the sums only differ in the order of their terms
+    const float TOLERANCE = 1.0e-5f;
+
+    std::vector<float> inputs[SRC_MAX_CHANNELS];
+    std::vector<float> referenceOutputs[SRC_MAX_CHANNELS];
+    std::vector<float> kernelOutputs[SRC_MAX_CHANNELS];
+    float* inputPointers[SRC_MAX_CHANNELS];
+    float* referencePointers[SRC_MAX_CHANNELS];
+    float* kernelPointers[SRC_MAX_CHANNELS];
+
+    for (const auto& kernel : kernels) {
+        for (const auto& rates : ratePairs) {
+            for (auto quality : qualities) {
+                for (int numChannels : channelCounts) {
+                    AudioSRC reference(rates.inputSampleRate, rates.outputSampleRate, numChannels, quality);
+                    AudioSRC src(rates.inputSampleRate, rates.outputSampleRate, numChannels, quality);
+                    // the filters read numTaps - 1 frames past the last input frame
+                    int inputSize = NUM_FRAMES + reference._numTaps;
+                    int outputSize = reference.getMaxOutput(NUM_FRAMES) + 1;
+                    for (int ch = 0; ch < SRC_MAX_CHANNELS; ch++) {
+                        inputs[ch].resize(inputSize);
+                        referenceOutputs[ch].assign(outputSize, 0.0f);
+                        kernelOutputs[ch].assign(outputSize, 0.0f);
+                        inputPointers[ch] = inputs[ch].data();
+                        referencePointers[ch] = referenceOutputs[ch].data();
+                        kernelPointers[ch] = kernelOutputs[ch].data();
+                    }
+
+                    float maxError = 0.0f;
+                    float maxOutput = 0.0f;
+                    for (int block = 0; block < NUM_BLOCKS; block++) {
+                        for (int ch = 0; ch < SRC_MAX_CHANNELS; ch++) {
+                            for (auto& sample : inputs[ch]) {
+                                sample = randFloatInRange(-1.0f, 1.0f);
+                            }
+                        }
+                        int referenceFrames = filter(reference, REFERENCE, numChannels, inputPointers, referencePointers,
+                                                     NUM_FRAMES);
+                        int kernelFrames = filter(src, kernel, numChannels, inputPointers, kernelPointers, NUM_FRAMES);
+                        QCOMPARE(kernelFrames, referenceFrames);
+                        QCOMPARE(src._phase, reference._phase);
+                        QCOMPARE(src._offset, reference._offset);
+                        for (int ch = 0; ch < numChannels; ch++) {
+                            for (int i = 0; i < referenceFrames; i++) {
+                                maxError = std::max(maxError, std::abs(kernelOutputs[ch][i] - referenceOutputs[ch][i]));
+                                maxOutput = std::max(maxOutput, std::abs(referenceOutputs[ch][i]));
+                            }
+                        }
+                    }
+                    if (maxError > TOLERANCE * std::max(maxOutput, 1.0f)) {
+                        QFAIL(qPrintable(QString("%1 kernel, %2 to %3 Hz, quality %4, %5 channels: error %6")
+                            .arg(kernel.name).arg(rates.inputSampleRate).arg(rates.outputSampleRate)
+                            .arg((int)quality).arg(numChannels).arg(maxError)));
+                    }
+                }
+            }
+        }
+    }
+#else
+    QSKIP("The SIMD resampler kernels are x86 only");
+#endif
+}
+
+#ifdef MANUAL_TEST
+void AudioSRCTests::benchmarkRenderBatch() {
+    // how many injected streams one core can resample to the mixer's rate in real time, one network frame each
+    const int NUM_STREAMS = 64;
+    const int NUM_ITERATIONS = 1000;
+    const int NUM_FRAMES = 441;    // 10 msec at 44.1kHz
+
+    std::vector<float> inputs[2];
+    std::vector<float> outputs[NUM_STREAMS][2];
+    float* inputPointers[2];
+    float* outputPointers[NUM_STREAMS][2];
+    for (int ch = 0; ch < 2; ch++) {
+        inputs[ch].resize(NUM_FRAMES);
+        for (auto& sample : inputs[ch]) {
+            sample = randFloatInRange(-1.0f, 1.0f);
+        }
+        inputPointers[ch] = inputs[ch].data();
+    }
+
+    std::vector<std::unique_ptr<AudioSRC>> srcs;
+    std::vector<AudioSRC::BatchStream> streams(NUM_STREAMS);
+    for (int s = 0; s < NUM_STREAMS; s++) {
+        // half of the sounds are 44.1kHz and half are 48kHz
+        int inputSampleRate = (s % 2) ? 48000 : 44100;
+        srcs.emplace_back(new AudioSRC(inputSampleRate, AudioConstants::SAMPLE_RATE, 2));
+        for (int ch = 0; ch < 2; ch++) {
+            outputs[s][ch].resize(srcs.back()->getMaxOutput(NUM_FRAMES));
+            outputPointers[s][ch] = outputs[s][ch].data();
+        }
+        streams[s] = { srcs.back().get(), inputPointers, outputPointers[s], NUM_FRAMES, 0 };
+    }
+
+    auto start = usecTimestampNow();
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        AudioSRC::renderBatch(streams.data(), NUM_STREAMS);
+    }
+    float usecsPerStream = (float)(usecTimestampNow() - start) / (NUM_ITERATIONS * NUM_STREAMS);
+    float usecsPerFrame = (float)USECS_PER_SECOND * NUM_FRAMES / 44100.0f;
+    std::cout << "renderBatch: " << usecsPerStream << " usec per stream frame, "
+        << usecsPerFrame / usecsPerStream << " streams per core" << std::endl;
+}
+#endif
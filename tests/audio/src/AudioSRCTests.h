@@ -0,0 +1,28 @@
+//
+//  AudioSRCTests.h
+//  tests/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSRCTests_h
+#define hifi_AudioSRCTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AudioSRCTests : public QObject {
+    Q_OBJECT
+private slots:
+    void renderBatchTests();
+    void multirateFilterTests();
+#ifdef MANUAL_TEST
+    void benchmarkRenderBatch();
+#endif
+};
+
+#endif // hifi_AudioSRCTests_h
@@ -0,0 +1,141 @@
+//
+//  FBXParsingTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXParsingTests.h"
+
+#include <iostream>
+
+#include <QtCore/QBuffer>
+
+#include <FBXSerializer.h>
+#include <SharedUtil.h>
+
+#include "TestModels.h"
+
+QTEST_MAIN(FBXParsingTests)
+
+template <class T>
+static bool compareArrayProperty(const QVariant& a, const QVariant& b, bool& isArray) {
+    if (a.userType() != qMetaTypeId<QVector<T>>()) {
+        return false;
+    }
+    isArray = true;
+    return a.value<QVector<T>>() == b.value<QVector<T>>();
+}
+
+static bool compareNodes(const FBXNode& a, const FBXNode& b) {
+    if (a.name != b.name || a.properties.size() != b.properties.size() || a.children.size() != b.children.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.properties.size(); ++i) {
+        const QVariant& propertyA = a.properties.at(i);
+        const QVariant& propertyB = b.properties.at(i);
+        if (propertyA.userType() != propertyB.userType()) {
+            return false;
+        }
+        bool isArray = false;
+        bool equal = compareArrayProperty<float>(propertyA, propertyB, isArray) ||
+            compareArrayProperty<double>(propertyA, propertyB, isArray) ||
+            compareArrayProperty<qint64>(propertyA, propertyB, isArray) ||
+            compareArrayProperty<qint32>(propertyA, propertyB, isArray) ||
+            compareArrayProperty<bool>(propertyA, propertyB, isArray);
+        if (isArray ? !equal : propertyA != propertyB) {
+            return false;
+        }
+    }
+    for (int i = 0; i < a.children.size(); ++i) {
+        if (!compareNodes(a.children.at(i), b.children.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FBXParsingTests::testInMemoryBinaryParsing() {
+    QFile file(TestModels::getTestModelPath());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    hifi::ByteArray data = file.readAll();
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    FBXNode streamed = FBXSerializer::parseFBX(&buffer);
+    FBXNode inMemory = FBXSerializer::parseFBX(data);
+
+    QVERIFY(!inMemory.children.isEmpty());
+    QVERIFY(compareNodes(streamed, inMemory));
+
+    // a truncated file must be reported as an error rather than read past the end of the buffer
+    hifi::ByteArray truncated = data.left(data.size() / 2);
+    bool threw = false;
+    try {
+        FBXSerializer::parseFBX(truncated);
+    } catch (const QString&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+}
+
+#ifdef MANUAL_TEST
+
+static int64_t getProcessUsedMemoryBytes() {
+    MemoryInfo memoryInfo;
+    return getMemoryInfo(memoryInfo) ? (int64_t)memoryInfo.processUsedMemoryBytes : 0;
+}
+
+void FBXParsingTests::benchmarkParsing() {
+    QStringList modelPaths = TestModels::getCorpusModelPaths();
+
+    const int NUM_ITERATIONS = 10;
+    std::cout << "[model, bytes, streamUsec, inMemoryUsec, streamNodeBytes, inMemoryNodeBytes] = [" << std::endl;
+    for (const auto& modelPath : modelPaths) {
+        QFile file(modelPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        hifi::ByteArray data = file.readAll();
+
+        uint64_t streamUsec = 0;
+        uint64_t inMemoryUsec = 0;
+        for (int i = 0; i < NUM_ITERATIONS; ++i) {
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::ReadOnly);
+            uint64_t startTime = usecTimestampNow();
+            FBXSerializer::parseFBX(&buffer);
+            streamUsec += usecTimestampNow() - startTime;
+
+            startTime = usecTimestampNow();
+            FBXSerializer::parseFBX(data);
+            inMemoryUsec += usecTimestampNow() - startTime;
+        }
+
+        // the memory held by the parsed nodes, measured from a baseline taken just before each parse
+        int64_t streamNodeBytes = 0;
+        int64_t inMemoryNodeBytes = 0;
+        {
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::ReadOnly);
+            int64_t baseline = getProcessUsedMemoryBytes();
+            FBXNode streamed = FBXSerializer::parseFBX(&buffer);
+            streamNodeBytes = getProcessUsedMemoryBytes() - baseline;
+        }
+        {
+            int64_t baseline = getProcessUsedMemoryBytes();
+            FBXNode inMemory = FBXSerializer::parseFBX(data);
+            inMemoryNodeBytes = getProcessUsedMemoryBytes() - baseline;
+        }
+
+        std::cout << "    " << QFileInfo(modelPath).fileName().toStdString() << ", " << data.size() << ", "
+            << streamUsec / NUM_ITERATIONS << ", " << inMemoryUsec / NUM_ITERATIONS << ", "
+            << streamNodeBytes << ", " << inMemoryNodeBytes << std::endl;
+    }
+    std::cout << "];" << std::endl;
+}
+
+#endif // MANUAL_TEST
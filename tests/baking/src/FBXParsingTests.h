@@ -0,0 +1,28 @@
+//
+//  FBXParsingTests.h
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXParsingTests_h
+#define hifi_FBXParsingTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class FBXParsingTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testInMemoryBinaryParsing();
+#ifdef MANUAL_TEST
+    void benchmarkParsing();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_FBXParsingTests_h
@@ -0,0 +1,106 @@
+//
+//  ModelBakerTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ModelBakerTests.h"
+
+#include <iostream>
+
+#include <tbb/task_arena.h>
+
+#include <FBXSerializer.h>
+#include <SharedUtil.h>
+#include <model-baker/Baker.h>
+
+#include "TestModels.h"
+
+QTEST_MAIN(ModelBakerTests)
+
+struct BakeResult {
+    std::vector<hifi::ByteArray> dracoMeshes;
+    std::vector<std::vector<hifi::ByteArray>> dracoMaterialLists;
+    std::vector<bool> dracoErrors;
+    uint64_t usecs { 0 };
+};
+
+// bakes the model the way ModelBaker does, with at most maxThreads worker threads
+static BakeResult bakeModel(const hifi::ByteArray& data, const QUrl& url, int maxThreads) {
+    hifi::VariantHash mapping;
+    mapping["combineParts"] = true;
+    mapping["deduplicateIndices"] = true;
+    hfm::Model::Pointer hfmModel = FBXSerializer().read(data, mapping, url);
+
+    BakeResult result;
+    baker::Baker baker(hfmModel, mapping, url);
+    baker.getConfiguration()->getJobConfig("BuildDracoMesh")->setEnabled(true);
+    tbb::task_arena arena(maxThreads);
+    arena.execute([&] {
+        uint64_t startTime = usecTimestampNow();
+        baker.run();
+        result.usecs = usecTimestampNow() - startTime;
+    });
+    result.dracoMeshes = baker.getDracoMeshes();
+    result.dracoMaterialLists = baker.getDracoMaterialLists();
+    result.dracoErrors = baker.getDracoErrors();
+    return result;
+}
+
+void ModelBakerTests::testParallelBakeIsDeterministic() {
+    QFile file(TestModels::getTestModelPath());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    hifi::ByteArray data = file.readAll();
+    QUrl url = QUrl::fromLocalFile(file.fileName());
+
+    BakeResult serial = bakeModel(data, url, 1);
+    BakeResult parallel = bakeModel(data, url, tbb::task_arena::automatic);
+
+    QVERIFY(!serial.dracoMeshes.empty());
+    QVERIFY(serial.dracoMeshes == parallel.dracoMeshes);
+    QVERIFY(serial.dracoMaterialLists == parallel.dracoMaterialLists);
+    QVERIFY(serial.dracoErrors == parallel.dracoErrors);
+}
+
+#ifdef MANUAL_TEST
+
+void ModelBakerTests::benchmarkBaking() {
+    QStringList modelPaths = TestModels::getCorpusModelPaths();
+
+    const int NUM_ITERATIONS = 5;
+    uint64_t totalSerialUsec = 0;
+    uint64_t totalParallelUsec = 0;
+    std::cout << "[model, bytes, serialUsec, parallelUsec, identical] = [" << std::endl;
+    for (const auto& modelPath : modelPaths) {
+        QFile file(modelPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        hifi::ByteArray data = file.readAll();
+        QUrl url = QUrl::fromLocalFile(modelPath);
+
+        uint64_t serialUsec = 0;
+        uint64_t parallelUsec = 0;
+        bool identical = true;
+        for (int i = 0; i < NUM_ITERATIONS; ++i) {
+            BakeResult serial = bakeModel(data, url, 1);
+            BakeResult parallel = bakeModel(data, url, tbb::task_arena::automatic);
+            serialUsec += serial.usecs;
+            parallelUsec += parallel.usecs;
+            identical = identical && serial.dracoMeshes == parallel.dracoMeshes;
+        }
+        totalSerialUsec += serialUsec / NUM_ITERATIONS;
+        totalParallelUsec += parallelUsec / NUM_ITERATIONS;
+        std::cout << "    " << QFileInfo(modelPath).fileName().toStdString() << ", " << data.size() << ", "
+            << serialUsec / NUM_ITERATIONS << ", " << parallelUsec / NUM_ITERATIONS << ", " << identical << std::endl;
+    }
+    std::cout << "];" << std::endl;
+    std::cout << "total: " << totalSerialUsec << " usec serial, " << totalParallelUsec << " usec on "
+        << tbb::this_task_arena::max_concurrency() << " threads" << std::endl;
+}
+
+#endif // MANUAL_TEST
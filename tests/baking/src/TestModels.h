@@ -0,0 +1,43 @@
+//
+//  TestModels.h
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TestModels_h
+#define hifi_TestModels_h
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QStringList>
+
+namespace TestModels {
+
+// the FBX model the baking tests read, from the repository
+inline QString getTestModelPath() {
+    QFileInfo file(__FILE__);
+    return QDir::cleanPath(file.absolutePath() + "/../../../unpublishedScripts/marketplace/shortbow/bow/models/arrow.fbx");
+}
+
+// every FBX model in the directory named by HIFI_MODEL_CORPUS_DIR, or just the test model when it isn't set
+inline QStringList getCorpusModelPaths() {
+    QString corpusDir = QProcessEnvironment::systemEnvironment().value("HIFI_MODEL_CORPUS_DIR");
+    QStringList modelPaths;
+    if (corpusDir.isEmpty()) {
+        modelPaths << getTestModelPath();
+    } else {
+        for (const auto& fileInfo : QDir(corpusDir).entryInfoList(QStringList { "*.fbx" }, QDir::Files)) {
+            modelPaths << fileInfo.absoluteFilePath();
+        }
+    }
+    return modelPaths;
+}
+
+} // namespace TestModels
+
+#endif // hifi_TestModels_h
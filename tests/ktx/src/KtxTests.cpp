@@ -8,13 +8,17 @@
 
 #include "KtxTests.h"
 
+#include <iostream>
 #include <mutex>
+#include <thread>
 
 #include <QtTest/QtTest>
 
 #include <ktx/KTX.h>
 #include <gpu/Texture.h>
 #include <image/Image.h>
+#include <image/TextureProcessing.h>
+#include <SharedUtil.h>
 
 
 QTEST_GUILESS_MAIN(KtxTests)
@@ -142,6 +146,73 @@ void KtxTests::testKtxSerialization() {
     testTexture->setKtxBacking(TEST_IMAGE_KTX.fileName().toStdString());
 }
 
+#ifdef MANUAL_TEST
+
+static image::Image generateBenchmarkImage(int size, bool hdr) {
+    image::Image result(size, size, hdr ? image::Image::Format_RGBAF : image::Image::Format_ARGB32);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            // gradients plus hash noise so the encoders can't take shortcuts on flat blocks
+            float noise = (float)((x * 73856093 ^ y * 19349663) & 0xFF) / 255.0f;
+            glm::vec4 color((float)x / size, (float)y / size, noise, 1.0f);
+            if (hdr) {
+                // push some texels past 1.0 to exercise the HDR encoder
+                result.setFloatPixel(x, y, color * glm::vec4(4.0f, 4.0f, 4.0f, 1.0f));
+            } else {
+                result.setPackedPixel(x, y, qRgba((int)(color.r * 255.0f), (int)(color.g * 255.0f), (int)(color.b * 255.0f), 255));
+            }
+        }
+    }
+    return result;
+}
+
+void KtxTests::benchmarkTextureCompression() {
+    struct Format {
+        const char* name;
+        gpu::Element element;
+        gpu::BackendTarget target;
+        bool hdr;
+    };
+    const std::vector<Format> formats {
+        { "BC1", gpu::Element::COLOR_COMPRESSED_BCX_SRGB, gpu::BackendTarget::GL45, false },
+        { "BC3", gpu::Element::COLOR_COMPRESSED_BCX_SRGBA, gpu::BackendTarget::GL45, false },
+        { "BC5", gpu::Element::COLOR_COMPRESSED_BCX_XY, gpu::BackendTarget::GL45, false },
+        { "BC6H", gpu::Element::COLOR_COMPRESSED_BCX_HDR_RGB, gpu::BackendTarget::GL45, true },
+        { "BC7", gpu::Element::COLOR_COMPRESSED_BCX_SRGBA_HIGH, gpu::BackendTarget::GL45, false },
+        { "ETC2", gpu::Element::COLOR_COMPRESSED_ETC2_SRGBA, gpu::BackendTarget::GLES32, false }
+    };
+    const int IMAGE_SIZE = 2048;
+    const int numCores = (int)std::thread::hardware_concurrency();
+    std::vector<int> threadCounts { 1, 2, 4 };
+    if (numCores > 4) {
+        threadCounts.push_back(numCores);
+    }
+
+    const int previousMaxThreads = image::getMaxCompressionThreads();
+    std::atomic<bool> abortProcessing { false };
+    std::cout << "[format, threads, megapixels/sec] = [" << std::endl;
+    for (const auto& format : formats) {
+        for (int threads : threadCounts) {
+            image::setMaxCompressionThreads(threads);
+            auto image = generateBenchmarkImage(IMAGE_SIZE, format.hdr);
+            auto texture = gpu::Texture::create2D(format.element, IMAGE_SIZE, IMAGE_SIZE, gpu::Texture::MAX_NUM_MIPS);
+            texture->setStoredMipFormat(format.element);
+
+            uint64_t startTime = usecTimestampNow();
+            image::convertToTextureWithMips(texture.get(), std::move(image), format.target, abortProcessing);
+            uint64_t usec = usecTimestampNow() - startTime;
+
+            // count the whole mip chain, which is ~4/3 of the base level
+            float megapixels = (4.0f / 3.0f) * (float)(IMAGE_SIZE * IMAGE_SIZE) / 1.0e6f;
+            std::cout << "    " << format.name << ", " << threads << ", " << megapixels / ((float)usec / USECS_PER_SECOND) << std::endl;
+        }
+    }
+    std::cout << "];" << std::endl;
+    image::setMaxCompressionThreads(previousMaxThreads);
+}
+
+#endif // MANUAL_TEST
+
 #if 0
 
 static const QString TEST_FOLDER { "H:/ktx_cacheold" };
@@ -8,6 +8,8 @@
 
 #include <QtCore/QObject>
 
+//#define MANUAL_TEST
+
 class KtxTests : public QObject {
     Q_OBJECT
 private slots:
@@ -16,6 +18,9 @@ private slots:
     void testKtxEvalFunctions();
     void testKhronosCompressionFunctions();
     void testKtxSerialization();
+#ifdef MANUAL_TEST
+    void benchmarkTextureCompression();
+#endif // MANUAL_TEST
 };
 
 
@@ -0,0 +1,268 @@
+//
+//  CongestionControlTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CongestionControlTests.h"
+
+#include <deque>
+#include <queue>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <udt/BBRCC.h>
+#include <udt/Constants.h>
+#include <udt/TCPVegasCC.h>
+
+QTEST_MAIN(CongestionControlTests)
+
+using namespace udt;
+using namespace std::chrono;
+
+namespace {
+
+struct Link {
+    double megabitsPerSecond;
+    int oneWayDelayMsecs;
+    int bufferPackets; // at the bottleneck, deeper buffers let more of a queue build up
+    double lossRate; // random, on top of the drops of a full buffer
+};
+
+struct LinkResults {
+    double megabitsPerSecond { 0.0 }; // goodput, unique packets delivered
+    double averageQueueingMsecs { 0.0 };
+    int numRetransmissions { 0 };
+};
+
+// Gives access to what the connection reads from its congestion control
+template <class T>
+class SimulatedCC : public T {
+public:
+    void start(SequenceNumber currentSequenceNumber) { this->setInitialSendSequenceNumber(currentSequenceNumber); }
+    void setCurrentSequenceNumber(SequenceNumber sequenceNumber) { this->setSendCurrentSequenceNumber(sequenceNumber); }
+    double getPacketSendPeriod() const { return this->_packetSendPeriod; }
+    int getCongestionWindowSize() const { return this->_congestionWindowSize; }
+};
+
+// A bulk transfer over one bottleneck link, driving a congestion control the way Connection and SendQueue do:
+// the sender is paced by the send period and limited by the window, re-sends what the congestion control asks for
+// and everything in flight after a timeout, and the receiver ACKs every packet with the last contiguous one.
+// Time is simulated, or real when the congestion control reads the clock itself.
+template <class T>
+LinkResults simulateLink(const Link& link, microseconds duration, bool realTime) {
+    enum EventType { SenderWakeUp, ReceiverArrival, ACKArrival };
+    struct Event {
+        int64_t time;
+        EventType type;
+        int sequenceNumber;
+        bool operator>(const Event& other) const { return time > other.time; }
+    };
+
+    const int PACKET_SIZE_BYTES = MAX_PACKET_SIZE_WITH_UDP_HEADER;
+    const int64_t serializationUsecs = (int64_t)(PACKET_SIZE_BYTES * 8 / link.megabitsPerSecond);
+    const int64_t oneWayDelayUsecs = link.oneWayDelayMsecs * 1000;
+    const int64_t MIN_TIMEOUT_USECS = 10000;
+    // sequence numbers are offsets from a start that doesn't wrap during the simulation
+    const SequenceNumber firstSequenceNumber(1000);
+
+    SimulatedCC<T> congestionControl;
+    congestionControl.start(firstSequenceNumber - 1);
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> lossDistribution(0.0, 1.0);
+    auto start = p_high_resolution_clock::now();
+
+    // sender
+    int lastSent = -1;
+    int lastACK = -1;
+    std::set<int> losses;
+    int64_t nextSendTime = 0;
+    int64_t wakeUpTime = -1;
+    int64_t stuckSince = -1;
+
+    // bottleneck
+    std::deque<int64_t> departures;
+    int64_t linkFreeTime = 0;
+    int64_t totalQueueingUsecs = 0;
+    int64_t numQueued = 0;
+
+    // receiver
+    std::set<int> received;
+    int lastContiguous = -1;
+
+    LinkResults results;
+
+    auto toTimePoint = [&](int64_t time) { return start + microseconds(time); };
+    auto scheduleWakeUp = [&](int64_t time) {
+        if (wakeUpTime == -1 || time < wakeUpTime) {
+            wakeUpTime = time;
+            events.push({ time, SenderWakeUp, 0 });
+        }
+    };
+
+    auto transmit = [&](int sequenceNumber, int64_t now) {
+        while (!departures.empty() && departures.front() <= now) {
+            departures.pop_front();
+        }
+        if ((int)departures.size() >= link.bufferPackets || lossDistribution(random) < link.lossRate) {
+            return;
+        }
+        int64_t departure = std::max(now, linkFreeTime) + serializationUsecs;
+        linkFreeTime = departure;
+        departures.push_back(departure);
+        totalQueueingUsecs += departure - serializationUsecs - now;
+        ++numQueued;
+        events.push({ departure + oneWayDelayUsecs, ReceiverArrival, sequenceNumber });
+    };
+
+    auto send = [&](int64_t now) {
+        if (now < nextSendTime) {
+            scheduleWakeUp(nextSendTime);
+            return;
+        }
+
+        if (losses.empty() && lastSent - lastACK > congestionControl.getCongestionWindowSize()) {
+            // the window is full, wait for an ACK or time out and re-send everything in flight
+            int64_t timeout = std::max((int64_t)congestionControl.estimatedTimeout(), MIN_TIMEOUT_USECS);
+            if (stuckSince == -1) {
+                stuckSince = now;
+            }
+            if (now - stuckSince < timeout) {
+                scheduleWakeUp(stuckSince + timeout);
+                return;
+            }
+            for (int sequenceNumber = lastACK + 1; sequenceNumber <= lastSent; ++sequenceNumber) {
+                losses.insert(sequenceNumber);
+            }
+            congestionControl.onTimeout();
+        }
+        stuckSince = -1;
+
+        int sequenceNumber;
+        if (!losses.empty()) {
+            sequenceNumber = *losses.begin();
+            losses.erase(losses.begin());
+            congestionControl.onPacketReSent(PACKET_SIZE_BYTES, firstSequenceNumber + sequenceNumber, toTimePoint(now));
+            ++results.numRetransmissions;
+        } else {
+            sequenceNumber = ++lastSent;
+            congestionControl.onPacketSent(PACKET_SIZE_BYTES, firstSequenceNumber + sequenceNumber, toTimePoint(now));
+        }
+        transmit(sequenceNumber, now);
+
+        nextSendTime = std::max(nextSendTime + (int64_t)congestionControl.getPacketSendPeriod(), now);
+        scheduleWakeUp(nextSendTime);
+    };
+
+    auto receiveACK = [&](int ack, int64_t now) {
+        if (ack < lastACK) {
+            return;
+        }
+        if (ack > lastACK) {
+            lastACK = ack;
+            losses.erase(losses.begin(), losses.upper_bound(ack));
+        }
+
+        congestionControl.setCurrentSequenceNumber(firstSequenceNumber + lastSent);
+        if (congestionControl.onACK(firstSequenceNumber + ack, toTimePoint(now))) {
+            losses.insert(ack + 1);
+        }
+        scheduleWakeUp(now);
+    };
+
+    scheduleWakeUp(0);
+
+    const int64_t durationUsecs = duration.count();
+    while (!events.empty() && events.top().time < durationUsecs) {
+        Event event = events.top();
+        events.pop();
+
+        if (realTime) {
+            std::this_thread::sleep_until(toTimePoint(event.time));
+        }
+
+        switch (event.type) {
+            case SenderWakeUp:
+                // earlier wake ups replace the later ones
+                if (event.time == wakeUpTime) {
+                    wakeUpTime = -1;
+                    send(event.time);
+                }
+                break;
+            case ReceiverArrival:
+                received.insert(event.sequenceNumber);
+                while (received.count(lastContiguous + 1)) {
+                    received.erase(lastContiguous + 1);
+                    ++lastContiguous;
+                }
+                events.push({ event.time + oneWayDelayUsecs, ACKArrival, lastContiguous });
+                break;
+            case ACKArrival:
+                receiveACK(event.sequenceNumber, event.time);
+                break;
+        }
+    }
+
+    results.megabitsPerSecond = (double)(lastContiguous + 1) * PACKET_SIZE_BYTES * 8 / durationUsecs;
+    results.averageQueueingMsecs = numQueued > 0 ? (double)totalQueueingUsecs / numQueued / 1000.0 : 0.0;
+    return results;
+}
+
+}
+
+// 20 Mb/s with a 50 ms RTT and a buffer of twice the bandwidth delay product
+static const Link BLOATED_LINK { 20.0, 25, 170, 0.0 };
+static const auto SIMULATION_DURATION = seconds(20);
+
+void CongestionControlTests::bbrFillsLinkTest() {
+    auto results = simulateLink<BBRCC>(BLOATED_LINK, SIMULATION_DURATION, false);
+    QVERIFY(results.megabitsPerSecond > 0.85 * BLOATED_LINK.megabitsPerSecond);
+}
+
+void CongestionControlTests::bbrKeepsQueueShortTest() {
+    // the buffer could hold 100 ms of queue, the pacing should keep it to a fraction of the RTT
+    auto results = simulateLink<BBRCC>(BLOATED_LINK, SIMULATION_DURATION, false);
+    QVERIFY(results.averageQueueingMsecs < BLOATED_LINK.oneWayDelayMsecs);
+}
+
+void CongestionControlTests::bbrRandomLossTest() {
+    // random losses don't make it back off, the throughput only pays for the round trips spent re-sending
+    Link lossyLink = BLOATED_LINK;
+    lossyLink.lossRate = 0.005;
+    auto results = simulateLink<BBRCC>(lossyLink, SIMULATION_DURATION, false);
+    QVERIFY(results.megabitsPerSecond > 0.7 * lossyLink.megabitsPerSecond);
+}
+
+#ifdef MANUAL_TEST
+
+void CongestionControlTests::linkComparisonBenchmark() {
+    // Vegas reads the clock itself, so both run in real time
+    const auto DURATION = seconds(10);
+    const std::vector<std::pair<const char*, Link>> LINKS {
+        { "LAN 100 Mb/s, 1 ms RTT", { 100.0, 0, 100, 0.0 } },
+        { "Broadband 20 Mb/s, 50 ms RTT, bloated", BLOATED_LINK },
+        { "Overseas 20 Mb/s, 200 ms RTT", { 20.0, 100, 400, 0.0 } },
+        { "Overseas 20 Mb/s, 200 ms RTT, 1% loss", { 20.0, 100, 400, 0.01 } },
+        { "Wifi 10 Mb/s, 30 ms RTT, 2% loss", { 10.0, 15, 50, 0.02 } }
+    };
+
+    for (const auto& link : LINKS) {
+        auto vegas = simulateLink<TCPVegasCC>(link.second, DURATION, true);
+        auto bbr = simulateLink<BBRCC>(link.second, DURATION, true);
+        qDebug() << link.first;
+        qDebug() << "    Vegas:" << vegas.megabitsPerSecond << "Mb/s," << vegas.averageQueueingMsecs << "ms queueing,"
+            << vegas.numRetransmissions << "re-sends";
+        qDebug() << "    BBR:  " << bbr.megabitsPerSecond << "Mb/s," << bbr.averageQueueingMsecs << "ms queueing,"
+            << bbr.numRetransmissions << "re-sends";
+    }
+}
+
+#endif
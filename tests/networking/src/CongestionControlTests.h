@@ -0,0 +1,29 @@
+//
+//  CongestionControlTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionControlTests_h
+#define hifi_CongestionControlTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class CongestionControlTests : public QObject {
+    Q_OBJECT
+private slots:
+    void bbrFillsLinkTest();
+    void bbrKeepsQueueShortTest();
+    void bbrRandomLossTest();
+#ifdef MANUAL_TEST
+    void linkComparisonBenchmark();
+#endif
+};
+
+#endif // hifi_CongestionControlTests_h
@@ -0,0 +1,141 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <vector>
+
+#include <udt/ControlPacket.h>
+#include <udt/LossList.h>
+
+QTEST_MAIN(LossListTests)
+
+using namespace udt;
+
+using Range = std::pair<int, int>;
+
+// the ranges the list writes in a NAK
+static std::vector<Range> writtenRanges(LossList& lossList) {
+    auto packet = ControlPacket::create(ControlPacket::ACK);
+    lossList.write(*packet);
+    packet->seek(0);
+
+    std::vector<Range> ranges;
+    SequenceNumber start, end;
+    while (packet->bytesLeftToRead() >= (qint64)(2 * sizeof(SequenceNumber))) {
+        packet->readPrimitive(&start);
+        packet->readPrimitive(&end);
+        ranges.emplace_back((SequenceNumber::Type)start, (SequenceNumber::Type)end);
+    }
+    return ranges;
+}
+
+void LossListTests::appendTest() {
+    LossList lossList;
+    QVERIFY(lossList.isEmpty());
+
+    lossList.append(SequenceNumber(10));
+    lossList.append(SequenceNumber(11), SequenceNumber(20));
+    lossList.append(SequenceNumber(100), SequenceNumber(300));
+
+    QCOMPARE(lossList.getLength(), 11 + 201);
+    QCOMPARE(lossList.getFirstSequenceNumber(), SequenceNumber(10));
+    QCOMPARE(writtenRanges(lossList), std::vector<Range>({ { 10, 20 }, { 100, 300 } }));
+
+    lossList.clear();
+    QVERIFY(lossList.isEmpty());
+    QVERIFY(writtenRanges(lossList).empty());
+}
+
+void LossListTests::removeTest() {
+    LossList lossList;
+    lossList.append(SequenceNumber(10), SequenceNumber(200));
+
+    QVERIFY(lossList.remove(SequenceNumber(100)));
+    QVERIFY(!lossList.remove(SequenceNumber(100)));
+    QVERIFY(!lossList.remove(SequenceNumber(5)));
+    QVERIFY(!lossList.remove(SequenceNumber(201)));
+    QCOMPARE(writtenRanges(lossList), std::vector<Range>({ { 10, 99 }, { 101, 200 } }));
+
+    lossList.remove(SequenceNumber(0), SequenceNumber(20));
+    lossList.remove(SequenceNumber(150), SequenceNumber(160));
+    QCOMPARE(lossList.getLength(), 79 + 89);
+    QCOMPARE(writtenRanges(lossList), std::vector<Range>({ { 21, 99 }, { 101, 149 }, { 161, 200 } }));
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), SequenceNumber(21));
+    QCOMPARE(lossList.getFirstSequenceNumber(), SequenceNumber(22));
+
+    lossList.remove(SequenceNumber(0), SequenceNumber(1000));
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::insertTest() {
+    LossList lossList;
+    lossList.insert(SequenceNumber(500), SequenceNumber(600));
+    lossList.insert(SequenceNumber(100), SequenceNumber(200));
+    lossList.insert(SequenceNumber(150), SequenceNumber(520));
+    QCOMPARE(lossList.getLength(), 501);
+    QCOMPARE(lossList.getFirstSequenceNumber(), SequenceNumber(100));
+    QCOMPARE(writtenRanges(lossList), std::vector<Range>({ { 100, 600 } }));
+
+    lossList.insert(SequenceNumber(1000), SequenceNumber(1000));
+    lossList.insert(SequenceNumber(700), SequenceNumber(800));
+    QCOMPARE(lossList.getLength(), 501 + 1 + 101);
+    QCOMPARE(writtenRanges(lossList), std::vector<Range>({ { 100, 600 }, { 700, 800 }, { 1000, 1000 } }));
+}
+
+void LossListTests::rolloverTest() {
+    LossList lossList;
+    SequenceNumber start = SequenceNumber(SequenceNumber::MAX - 10);
+    lossList.append(start, start + 20);
+    QCOMPARE(lossList.getLength(), 21);
+    QCOMPARE(lossList.getFirstSequenceNumber(), start);
+
+    QVERIFY(lossList.remove(SequenceNumber(0)));
+    lossList.remove(start, SequenceNumber(SequenceNumber::MAX));
+    QCOMPARE(lossList.getFirstSequenceNumber(), SequenceNumber(1));
+    QCOMPARE(writtenRanges(lossList), std::vector<Range>({ { 1, 9 } }));
+
+    lossList.insert(start - 100, start - 90);
+    QCOMPARE(lossList.getFirstSequenceNumber(), start - 100);
+    QCOMPARE(lossList.getLength(), 9 + 11);
+}
+
+void LossListTests::insertBeforeRolloverTest() {
+    QCOMPARE(SequenceNumber(0) - 1, SequenceNumber(SequenceNumber::MAX));
+    QCOMPARE(SequenceNumber(3) - 10, SequenceNumber(SequenceNumber::MAX - 6));
+
+    // a loss that arrives late, from before the sequence numbers wrapped
+    LossList lossList;
+    lossList.append(SequenceNumber(5), SequenceNumber(6));
+    lossList.insert(SequenceNumber(SequenceNumber::MAX - 3), SequenceNumber(SequenceNumber::MAX - 2));
+    QCOMPARE(lossList.getLength(), 4);
+    QCOMPARE(lossList.getFirstSequenceNumber(), SequenceNumber(SequenceNumber::MAX - 3));
+    QCOMPARE(writtenRanges(lossList), std::vector<Range>({ { SequenceNumber::MAX - 3, SequenceNumber::MAX - 2 }, { 5, 6 } }));
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), SequenceNumber(SequenceNumber::MAX - 3));
+    QCOMPARE(lossList.popFirstSequenceNumber(), SequenceNumber(SequenceNumber::MAX - 2));
+    QCOMPARE(lossList.popFirstSequenceNumber(), SequenceNumber(5));
+}
+
+void LossListTests::spanTest() {
+    LossList lossList;
+    lossList.append(SequenceNumber(10), SequenceNumber(20));
+
+    // losses too far behind the last one are forgotten rather than growing the list without bounds
+    SequenceNumber farStart = SequenceNumber(10) + 4 * LossList::MAX_SPAN;
+    lossList.append(farStart, farStart + 5);
+    QCOMPARE(lossList.getLength(), 6);
+    QCOMPARE(lossList.getFirstSequenceNumber(), farStart);
+
+    lossList.clear();
+    lossList.append(SequenceNumber(0), SequenceNumber(SequenceNumber::THRESHOLD - 1));
+    QCOMPARE(lossList.getLength(), (int)LossList::MAX_SPAN);
+}
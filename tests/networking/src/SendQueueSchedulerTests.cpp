@@ -0,0 +1,238 @@
+//
+//  SendQueueSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueSchedulerTests.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <udt/Packet.h>
+#include <udt/Socket.h>
+
+#ifdef MANUAL_TEST
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+#endif
+
+QTEST_MAIN(SendQueueSchedulerTests)
+
+using namespace udt;
+
+namespace {
+
+// A client receiving reliable packets from the server, each packet carries its index
+struct Client {
+    Client() {
+        socket.bind(QHostAddress::LocalHost);
+        sockAddr = HifiSockAddr(QHostAddress::LocalHost, socket.localPort());
+        socket.setPacketHandler([this](std::unique_ptr<Packet> packet) {
+            int index;
+            packet->readPrimitive(&index);
+            indices.push_back(index);
+            arrivals.push_back(usecTimestampNow());
+        });
+    }
+
+    Socket socket;
+    HifiSockAddr sockAddr;
+    std::vector<int> indices;
+    std::vector<quint64> arrivals;
+};
+
+void sendReliablePacket(Socket& socket, const HifiSockAddr& sockAddr, int index, bool fillPayload = false) {
+    auto packet = Packet::create(-1, true);
+    packet->writePrimitive(index);
+    if (fillPayload) {
+        packet->setPayloadSize(packet->getPayloadCapacity());
+    }
+    socket.writePacket(std::move(packet), sockAddr);
+}
+
+int totalReceived(const std::vector<std::unique_ptr<Client>>& clients) {
+    int total = 0;
+    for (const auto& client : clients) {
+        total += (int)client->indices.size();
+    }
+    return total;
+}
+
+}
+
+void SendQueueSchedulerTests::reliableDeliveryTest() {
+    // more connections than scheduler threads, so that the threads are shared
+    const int NUM_CLIENTS = 32;
+    const int NUM_PACKETS = 50;
+
+    Socket server;
+    server.bind(QHostAddress::LocalHost);
+    QVERIFY(server.getSendQueueScheduler()->getNumThreads() < NUM_CLIENTS);
+
+    std::vector<std::unique_ptr<Client>> clients;
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients.emplace_back(new Client());
+    }
+
+    for (int index = 0; index < NUM_PACKETS; ++index) {
+        for (const auto& client : clients) {
+            sendReliablePacket(server, client->sockAddr, index);
+        }
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(totalReceived(clients), NUM_CLIENTS * NUM_PACKETS, 10000);
+
+    for (const auto& client : clients) {
+        auto indices = client->indices;
+        std::sort(indices.begin(), indices.end());
+        for (int index = 0; index < NUM_PACKETS; ++index) {
+            QCOMPARE(indices[index], index);
+        }
+    }
+}
+
+void SendQueueSchedulerTests::connectionRemovalTest() {
+    const int NUM_PACKETS = 20;
+
+    Socket server;
+    server.bind(QHostAddress::LocalHost);
+
+    Client first;
+    Client second;
+    for (int index = 0; index < NUM_PACKETS; ++index) {
+        sendReliablePacket(server, first.sockAddr, index);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT((int)first.indices.size(), NUM_PACKETS, 10000);
+
+    // dropping a connection takes its queue off the scheduler, the other queues keep being serviced
+    server.cleanupConnection(first.sockAddr);
+    for (int index = 0; index < NUM_PACKETS; ++index) {
+        sendReliablePacket(server, second.sockAddr, index);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT((int)second.indices.size(), NUM_PACKETS, 10000);
+    QCOMPARE((int)first.indices.size(), NUM_PACKETS);
+}
+
+#ifdef MANUAL_TEST
+
+static int countProcessThreads() {
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        for (const auto& line : status.readAll().split('\n')) {
+            if (line.startsWith("Threads:")) {
+                return line.mid(8).trimmed().toInt();
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+void SendQueueSchedulerTests::connectionScalingBenchmark() {
+    // a mixer like load: one server socket sending a reliable packet to every client at a fixed rate
+    const int SEND_INTERVAL_MSECS = 20;
+    const int NUM_SENDS = 100;
+
+    for (int numClients : { 10, 100, 300, 1000 }) {
+        Socket server;
+        server.bind(QHostAddress::LocalHost);
+
+        std::vector<std::unique_ptr<Client>> clients;
+        for (int i = 0; i < numClients; ++i) {
+            clients.emplace_back(new Client());
+        }
+
+        int threadsBefore = countProcessThreads();
+        int maxThreads = threadsBefore;
+
+        auto start = usecTimestampNow();
+        for (int index = 0; index < NUM_SENDS; ++index) {
+            for (const auto& client : clients) {
+                sendReliablePacket(server, client->sockAddr, index);
+            }
+            maxThreads = std::max(maxThreads, countProcessThreads());
+            QTest::qWait(SEND_INTERVAL_MSECS);
+        }
+        QTRY_COMPARE_WITH_TIMEOUT(totalReceived(clients), numClients * NUM_SENDS, 30000);
+        auto elapsed = usecTimestampNow() - start;
+
+        // jitter is how far apart two consecutive packets arrived from the send interval
+        std::vector<quint64> jitters;
+        for (const auto& client : clients) {
+            for (size_t i = 1; i < client->arrivals.size(); ++i) {
+                qint64 interval = (qint64)(client->arrivals[i] - client->arrivals[i - 1]);
+                jitters.push_back((quint64)std::abs(interval - SEND_INTERVAL_MSECS * (qint64)USECS_PER_MSEC));
+            }
+        }
+        std::sort(jitters.begin(), jitters.end());
+        quint64 totalJitter = 0;
+        for (auto jitter : jitters) {
+            totalJitter += jitter;
+        }
+
+        qDebug() << numClients << "connections:" << server.getSendQueueScheduler()->getNumThreads() << "send threads,"
+            << maxThreads - threadsBefore << "more process threads,"
+            << "avg jitter" << (float)totalJitter / jitters.size() << "usecs,"
+            << "p99 jitter" << jitters[jitters.size() * 99 / 100] << "usecs,"
+            << "elapsed" << (float)elapsed / USECS_PER_SECOND << "secs";
+    }
+}
+
+// user and system time used by the process, all threads included
+static quint64 processCpuUsecs() {
+#ifdef Q_OS_WIN
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime);
+    ULARGE_INTEGER kernel, user;
+    memcpy(&kernel, &kernelTime, sizeof(FILETIME));
+    memcpy(&user, &userTime, sizeof(FILETIME));
+    return (kernel.QuadPart + user.QuadPart) / 10; // 100ns units
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (quint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * USECS_PER_SECOND +
+        usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+void SendQueueSchedulerTests::reliableThroughputBenchmark() {
+    // full packets on one connection: sending, ACKs and losses on both ends run in this process
+    const int NUM_PACKETS = 50000;
+
+    Socket server;
+    server.bind(QHostAddress::LocalHost);
+    Client client;
+
+    auto startCpu = processCpuUsecs();
+    auto start = usecTimestampNow();
+    for (int index = 0; index < NUM_PACKETS; ++index) {
+        sendReliablePacket(server, client.sockAddr, index, true);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT((int)client.indices.size(), NUM_PACKETS, 120000);
+    auto elapsed = usecTimestampNow() - start;
+    auto cpu = processCpuUsecs() - startCpu;
+
+    float megabytes = (float)NUM_PACKETS * Packet::maxPayloadSize() / (BYTES_PER_KILOBYTE * BYTES_PER_KILOBYTE);
+    auto stats = server.sampleStatsForAllConnections();
+    qDebug() << megabytes << "MB in" << (float)elapsed / USECS_PER_SECOND << "secs:"
+        << megabytes * USECS_PER_SECOND / elapsed << "MB/s,"
+        << (float)cpu / USECS_PER_MSEC / megabytes << "CPU msecs per MB";
+    for (const auto& connectionStats : stats) {
+        qDebug() << "retransmitted" << connectionStats.second.retransmittedPackets << "packets";
+    }
+}
+
+#endif
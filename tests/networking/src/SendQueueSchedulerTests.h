@@ -0,0 +1,29 @@
+//
+//  SendQueueSchedulerTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendQueueSchedulerTests_h
+#define hifi_SendQueueSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class SendQueueSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void reliableDeliveryTest();
+    void connectionRemovalTest();
+#ifdef MANUAL_TEST
+    void connectionScalingBenchmark();
+    void reliableThroughputBenchmark();
+#endif
+};
+
+#endif // hifi_SendQueueSchedulerTests_h
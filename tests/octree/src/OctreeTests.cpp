@@ -14,16 +14,46 @@
 
 #include "OctreeTests.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+
 #include <QDebug>
+#include <QScriptEngine>
 
+#include <AccountManager.h>
+#include <AddressManager.h>
 #include <ByteCountCoding.h>
+#include <CpuParticles.h>
+#include <EntityEditFilters.h>
 #include <EntityItem.h>
+#include <EntityQueryFilter.h>
+#include <EntityQueryIndex.h>
+#include <EntityScriptingInterface.h>
 #include <EntityTree.h>
 #include <EntityTreeElement.h>
+#include <Node.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
 #include <Octree.h>
 #include <OctreeConstants.h>
+#include <PolyVoxChunks.h>
 #include <PropertyFlags.h>
+#include <ReceivedMessage.h>
+#include <RegisteredMetaTypes.h>
 #include <SharedUtil.h>
+#include <SimpleEntitySimulation.h>
+#include <ViewFrustum.h>
+#include <shared/ScriptInitializerMixin.h>
+
+#ifdef MANUAL_TEST
+#include <PolyVoxCore/MarchingCubesSurfaceExtractor.h>
+#include <PolyVoxCore/SimpleVolume.h>
+#include <PolyVoxCore/SurfaceMesh.h>
+#endif
 
 enum ExamplePropertyList {
     EXAMPLE_PROP_PAGED_PROPERTY,
@@ -827,3 +857,1137 @@ void OctreeTests::elementAddChildTests() {
         }
     }
 }
+
+void OctreeTests::entityQueryFilterTests() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    auto addEntity = [&](EntityTypes::EntityType type, const QString& serverScripts) {
+        EntityItemProperties properties;
+        properties.setType(type);
+        properties.setServerScripts(serverScripts);
+        EntityItemID entityID(QUuid::createUuid());
+        tree->withWriteLock([&] {
+            tree->addEntity(entityID, properties);
+        });
+        return tree->findEntityByID(entityID);
+    };
+    auto box = addEntity(EntityTypes::Box, "");
+    auto scriptedBox = addEntity(EntityTypes::Box, "http://example.com/server.js");
+    auto zone = addEntity(EntityTypes::Zone, "");
+    QVERIFY(box && scriptedBox && zone);
+
+    QJsonObject serverScriptsQuery;
+    serverScriptsQuery["serverScripts"] = EntityQueryFilterSymbol::NonDefault;
+    serverScriptsQuery["type"] = "Zone"; // ignored, serverScripts takes precedence
+    EntityQueryFilter serverScriptsFilter(serverScriptsQuery);
+    QCOMPARE(serverScriptsFilter.getIndex(), EntityQueryFilter::Index::ServerScripts);
+    QVERIFY(!box->matchesQueryFilter(serverScriptsFilter));
+    QVERIFY(scriptedBox->matchesQueryFilter(serverScriptsFilter));
+    QVERIFY(!zone->matchesQueryFilter(serverScriptsFilter));
+    auto indexed = tree->getIndexedEntities(serverScriptsFilter);
+    QCOMPARE(indexed.size(), 1);
+    QVERIFY(indexed.contains(scriptedBox->getEntityItemID()));
+
+    // the index follows changes to serverScripts
+    box->setServerScripts("http://example.com/other.js");
+    scriptedBox->setServerScripts("");
+    indexed = tree->getIndexedEntities(serverScriptsFilter);
+    QCOMPARE(indexed.size(), 1);
+    QVERIFY(indexed.contains(box->getEntityItemID()));
+
+    QJsonObject zoneQuery;
+    zoneQuery["avatarPriority"] = true;
+    zoneQuery["type"] = "Zone";
+    EntityQueryFilter zoneFilter(zoneQuery);
+    QCOMPARE(zoneFilter.getIndex(), EntityQueryFilter::Index::Type);
+    QVERIFY(!box->matchesQueryFilter(zoneFilter));
+    QVERIFY(zone->matchesQueryFilter(zoneFilter));
+    indexed = tree->getIndexedEntities(zoneFilter);
+    QCOMPARE(indexed.size(), 1);
+    QVERIFY(indexed.contains(zone->getEntityItemID()));
+
+    QJsonObject unknownTypeQuery;
+    unknownTypeQuery["type"] = "NotAType";
+    EntityQueryFilter unknownTypeFilter(unknownTypeQuery);
+    QVERIFY(!box->matchesQueryFilter(unknownTypeFilter));
+    QVERIFY(tree->getIndexedEntities(unknownTypeFilter).isEmpty());
+
+    // without a serverScripts or type filter every entity is a candidate
+    QJsonObject priorityQuery;
+    priorityQuery["avatarPriority"] = true;
+    EntityQueryFilter priorityFilter(priorityQuery);
+    QCOMPARE(priorityFilter.getIndex(), EntityQueryFilter::Index::None);
+    QVERIFY(box->matchesQueryFilter(priorityFilter));
+    QVERIFY(EntityQueryFilter().getIndex() == EntityQueryFilter::Index::None);
+    QVERIFY(box->matchesQueryFilter(EntityQueryFilter()));
+
+    tree->withWriteLock([&] {
+        tree->deleteEntity(zone->getEntityItemID(), true);
+    });
+    QVERIFY(tree->getIndexedEntities(zoneFilter).isEmpty());
+}
+
+void OctreeTests::entityQueryIndexTests() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    PickFilter searchFilter(PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) |
+        PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES));
+
+    // nothing has been indexed yet, so queries go to the tree
+    QVERIFY(!tree->getQuerySnapshot());
+
+    auto addEntity = [&](EntityTypes::EntityType type, const glm::vec3& position) {
+        EntityItemProperties properties;
+        properties.setType(type);
+        properties.setPosition(position);
+        properties.setDimensions(glm::vec3(1.0f));
+        EntityItemID entityID(QUuid::createUuid());
+        tree->withWriteLock([&] {
+            tree->addEntity(entityID, properties);
+        });
+        return QUuid(entityID);
+    };
+    auto sorted = [](QVector<QUuid> ids) {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    // the snapshot must answer exactly as the tree does
+    auto findInSphere = [&](const glm::vec3& center, float radius) {
+        QVector<QUuid> found;
+        auto snapshot = tree->getQuerySnapshot();
+        if (!snapshot) {
+            return QVector<QUuid>({ QUuid() });
+        }
+        snapshot->evalEntitiesInSphere(center, radius, searchFilter, found);
+        QVector<QUuid> expected;
+        tree->withReadLock([&] {
+            tree->evalEntitiesInSphere(center, radius, searchFilter, expected);
+        });
+        return sorted(found) == sorted(expected) ? sorted(found) : QVector<QUuid>({ QUuid() });
+    };
+
+    // added entities are found once EntityTree::update() publishes them
+    QUuid box = addEntity(EntityTypes::Box, glm::vec3(0.0f));
+    QUuid sphere = addEntity(EntityTypes::Sphere, glm::vec3(10.0f, 0.0f, 0.0f));
+    QVERIFY(!tree->getQuerySnapshot());
+    tree->update(false);
+    auto firstSnapshot = tree->getQuerySnapshot();
+    QVERIFY(firstSnapshot);
+    QCOMPARE((int)firstSnapshot->getNumEntities(), 2);
+    QCOMPARE(findInSphere(glm::vec3(0.0f), 1.0f), QVector<QUuid>({ box }));
+    QCOMPARE(findInSphere(glm::vec3(10.0f, 0.0f, 0.0f), 1.0f), QVector<QUuid>({ sphere }));
+    QCOMPARE(findInSphere(glm::vec3(5.0f, 0.0f, 0.0f), 1.0f), QVector<QUuid>());
+
+    // the sphere's narrow phase uses its shape rather than its bounding box
+    QCOMPARE(findInSphere(glm::vec3(10.6f, 0.6f, 0.6f), 0.2f), QVector<QUuid>());
+
+    // edits are picked up the same way
+    tree->withWriteLock([&] {
+        EntityItemProperties properties;
+        properties.setPosition(glm::vec3(10.0f, 0.0f, 1.0f));
+        tree->updateEntity(box, properties);
+    });
+    tree->update(false);
+    QCOMPARE(findInSphere(glm::vec3(0.0f), 1.0f), QVector<QUuid>());
+    QCOMPARE(findInSphere(glm::vec3(10.0f, 0.0f, 0.5f), 1.0f), sorted({ box, sphere }));
+
+    QVector<QUuid> found;
+    tree->getQuerySnapshot()->evalEntitiesInSphereWithType(glm::vec3(10.0f, 0.0f, 0.5f), 1.0f, EntityTypes::Sphere,
+                                                          searchFilter, found);
+    QCOMPARE(found, QVector<QUuid>({ sphere }));
+    found.clear();
+    tree->getQuerySnapshot()->evalEntitiesInBox(AABox(glm::vec3(9.0f, -1.0f, 0.6f), glm::vec3(2.0f)), searchFilter, found);
+    QCOMPARE(found, QVector<QUuid>({ box }));
+
+    // and so are deletes
+    tree->withWriteLock([&] {
+        tree->deleteEntity(sphere, true);
+    });
+    tree->update(false);
+    QCOMPARE((int)tree->getQuerySnapshot()->getNumEntities(), 1);
+    QCOMPARE(findInSphere(glm::vec3(10.0f, 0.0f, 0.5f), 1.0f), QVector<QUuid>({ box }));
+
+    // a published snapshot never changes under its reader
+    found.clear();
+    firstSnapshot->evalEntitiesInSphere(glm::vec3(0.0f), 1.0f, searchFilter, found);
+    QCOMPARE(found, QVector<QUuid>({ box }));
+    QCOMPARE((int)firstSnapshot->getNumEntities(), 2);
+
+    // enough entities to span several chunks, with deletes compacting them
+    QVector<QUuid> row;
+    for (int i = 0; i < 3 * EntityQuerySnapshot::CHUNK_SIZE; i++) {
+        row.push_back(addEntity(EntityTypes::Box, glm::vec3((float)i * 2.0f, 20.0f, 0.0f)));
+    }
+    tree->withWriteLock([&] {
+        for (int i = 0; i < row.size(); i += 2) {
+            tree->deleteEntity(row[i], true);
+        }
+    });
+    tree->update(false);
+    QCOMPARE((int)tree->getQuerySnapshot()->getNumEntities(), 1 + (int)row.size() / 2);
+    QCOMPARE(findInSphere(glm::vec3(2.0f, 20.0f, 0.0f), 0.5f), QVector<QUuid>({ row[1] }));
+    QCOMPARE(findInSphere(glm::vec3(0.0f, 20.0f, 0.0f), 0.5f), QVector<QUuid>());
+    // this one also reaches the first box
+    QCOMPARE(findInSphere(glm::vec3((float)row.size(), 20.0f, 0.0f), (float)row.size()).size(), 1 + (int)row.size() / 2);
+
+    // queries don't apply changes queued since the last update...
+    const glm::vec3 OVERLAY_POSITION(0.0f, -20.0f, 0.0f);
+    QUuid added = addEntity(EntityTypes::Box, OVERLAY_POSITION);
+    auto snapshot = tree->getQuerySnapshot();
+    found.clear();
+    snapshot->evalEntitiesInSphere(OVERLAY_POSITION, 1.0f, searchFilter, found);
+    QVERIFY(found.isEmpty());
+    QVERIFY(tree->getQueryOverlay(*snapshot).isEmpty());
+
+    // ...but the thread that made a change it noted finds it through its overlay
+    tree->noteQueryIndexChange(added);
+    tree->getQueryOverlay(*snapshot).evalEntitiesInSphere(OVERLAY_POSITION, 1.0f, searchFilter, found);
+    QCOMPARE(found, QVector<QUuid>({ added }));
+    found.clear();
+    tree->getQueryOverlay(*snapshot).evalEntitiesInBox(AABox(OVERLAY_POSITION, glm::vec3(0.1f)), searchFilter, found);
+    QCOMPARE(found, QVector<QUuid>({ added }));
+
+    // the overlay replaces what the snapshot found for an entity the thread has moved or deleted
+    tree->withWriteLock([&] {
+        EntityItemProperties properties;
+        properties.setPosition(OVERLAY_POSITION);
+        tree->updateEntity(row[1], properties);
+    });
+    tree->noteQueryIndexChange(row[1]);
+    found.clear();
+    snapshot->evalEntitiesInSphere(glm::vec3(2.0f, 20.0f, 0.0f), 0.5f, searchFilter, found);
+    tree->getQueryOverlay(*snapshot).evalEntitiesInSphere(glm::vec3(2.0f, 20.0f, 0.0f), 0.5f, searchFilter, found);
+    QVERIFY(found.isEmpty());
+    snapshot->evalEntitiesInSphere(OVERLAY_POSITION, 1.0f, searchFilter, found);
+    tree->getQueryOverlay(*snapshot).evalEntitiesInSphere(OVERLAY_POSITION, 1.0f, searchFilter, found);
+    QCOMPARE(sorted(found), sorted({ added, row[1] }));
+    tree->withWriteLock([&] {
+        tree->deleteEntity(added, true);
+    });
+    tree->noteQueryIndexChange(added);
+    found.clear();
+    tree->getQueryOverlay(*snapshot).evalEntitiesInSphere(OVERLAY_POSITION, 1.0f, searchFilter, found);
+    QCOMPARE(found, QVector<QUuid>({ row[1] }));
+
+    // other threads only see published changes
+    bool otherOverlayIsEmpty = false;
+    std::thread([&] {
+        otherOverlayIsEmpty = tree->getQueryOverlay(*snapshot).isEmpty();
+    }).join();
+    QVERIFY(otherOverlayIsEmpty);
+
+    // and once the changes are published the overlay is no longer needed
+    tree->update(false);
+    QVERIFY(tree->getQueryOverlay(*tree->getQuerySnapshot()).isEmpty());
+    QCOMPARE(findInSphere(OVERLAY_POSITION, 1.0f), QVector<QUuid>({ row[1] }));
+}
+
+void OctreeTests::cpuParticlesTests() {
+    const uint64_t NOW = 1000000;
+    const float DELTA_TIME = 1.0f / 60.0f;
+    const int NUM_PARTICLES = 11; // not a multiple of 4, so the scalar tail is covered too
+
+    particle::CpuParticles particles;
+    std::vector<particle::CpuParticles::Particle> reference;
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        particle::CpuParticles::Particle particle;
+        particle.seed = (float)i / NUM_PARTICLES;
+        particle.expiration = NOW + i * 1000;
+        particle.basePosition = glm::vec3(10.0f, 0.0f, 0.0f);
+        particle.relativePosition = glm::vec3((float)i, 0.0f, -1.0f);
+        particle.velocity = glm::vec3(1.0f, (float)i, 0.5f);
+        particle.acceleration = glm::vec3(0.0f, -9.8f, (float)i);
+        particles.push(particle);
+        reference.push_back(particle);
+    }
+    QCOMPARE(particles.size(), (size_t)NUM_PARTICLES);
+
+    // matches integrating one particle at a time
+    const int NUM_STEPS = 3;
+    for (int step = 0; step < NUM_STEPS; step++) {
+        particles.integrate(DELTA_TIME);
+        for (auto& particle : reference) {
+            glm::vec3 atSquared = (0.5f * DELTA_TIME * DELTA_TIME) * particle.acceleration;
+            particle.relativePosition += particle.velocity * DELTA_TIME + atSquared;
+            particle.velocity += particle.acceleration * DELTA_TIME;
+        }
+    }
+    const float TOLERANCE = 0.0001f;
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        QVERIFY(glm::length(particles.getRelativePosition(i) - reference[i].relativePosition) < TOLERANCE);
+        QVERIFY(glm::length(particles.getVelocity(i) - reference[i].velocity) < TOLERANCE);
+        QVERIFY(fabsf(particles.getLifetime(i) - NUM_STEPS * DELTA_TIME) < TOLERANCE);
+    }
+
+    particle::GpuParticles gpuParticles;
+    particles.writeGpuParticles(true, glm::vec3(0.0f), gpuParticles);
+    QCOMPARE(gpuParticles.size(), (size_t)NUM_PARTICLES);
+    QVERIFY(glm::length(gpuParticles[2].xyz - (reference[2].basePosition + reference[2].relativePosition)) < TOLERANCE);
+    QCOMPARE(gpuParticles[2].uv.y, reference[2].seed);
+    particles.writeGpuParticles(false, glm::vec3(0.0f, 5.0f, 0.0f), gpuParticles);
+    QVERIFY(glm::length(gpuParticles[2].xyz - (glm::vec3(0.0f, 5.0f, 0.0f) + reference[2].relativePosition)) < TOLERANCE);
+
+    // moving the base position can keep the world positions
+    glm::vec3 worldPosition = particles.getRelativePosition(0) + reference[0].basePosition;
+    particles.rebase(glm::vec3(-2.0f, 0.0f, 0.0f), true);
+    QVERIFY(glm::length(particles.getRelativePosition(0) + glm::vec3(-2.0f, 0.0f, 0.0f) - worldPosition) < TOLERANCE);
+
+    // expired particles come off the front, then the oldest beyond the maximum
+    particles.expire(NOW + 2500, NUM_PARTICLES);
+    QCOMPARE(particles.size(), (size_t)(NUM_PARTICLES - 3));
+    QCOMPARE(particles.getExpiration(0), NOW + 3000);
+    particles.expire(NOW, 4);
+    QCOMPARE(particles.size(), (size_t)4);
+    QCOMPARE(particles.getExpiration(0), NOW + (NUM_PARTICLES - 4) * 1000);
+    particles.clear();
+    QVERIFY(particles.empty());
+
+    // a steady stream of particles expiring a few at a time, enough to compact the arrays many times over
+    const int NUM_STREAMED = 1000;
+    const int NUM_LIVE = 100;
+    for (int i = 0; i < NUM_STREAMED; i++) {
+        particle::CpuParticles::Particle particle;
+        particle.seed = (float)i;
+        particle.expiration = NOW + i;
+        particle.relativePosition = glm::vec3((float)i, 0.0f, 0.0f);
+        particles.push(particle);
+        particles.integrate(0.0f);
+        if (i >= NUM_LIVE) {
+            particles.expire(NOW + i - NUM_LIVE, NUM_STREAMED);
+            QCOMPARE(particles.size(), (size_t)NUM_LIVE);
+            QCOMPARE(particles.getExpiration(0), NOW + i - NUM_LIVE + 1);
+            QCOMPARE(particles.getRelativePosition(0).x, (float)(i - NUM_LIVE + 1));
+            QCOMPARE(particles.getRelativePosition(NUM_LIVE - 1).x, (float)i);
+        }
+    }
+    particles.writeGpuParticles(false, glm::vec3(0.0f), gpuParticles);
+    QCOMPARE(gpuParticles.size(), (size_t)NUM_LIVE);
+    QCOMPARE(gpuParticles[0].uv.y, (float)(NUM_STREAMED - NUM_LIVE));
+    QCOMPARE(gpuParticles[NUM_LIVE - 1].xyz.x, (float)(NUM_STREAMED - 1));
+    particles.expire(NOW + NUM_STREAMED, NUM_STREAMED);
+    QVERIFY(particles.empty());
+}
+
+void OctreeTests::polyVoxChunksTests() {
+    const int CHUNK_SIZE = PolyVoxChunks::CHUNK_SIZE;
+
+    // a volume that isn't a multiple of the chunk size, so the last chunks are clamped
+    PolyVoxChunks chunks;
+    chunks.reset(glm::ivec3(2 * CHUNK_SIZE + 4, CHUNK_SIZE, 1));
+    QCOMPARE(chunks.getNumChunks(), 3);
+    QCOMPARE(chunks.getNumDirtyChunks(), 3);
+    QCOMPARE((int)chunks.takeDirtyChunks().size(), 3);
+    QCOMPARE(chunks.getNumDirtyChunks(), 0);
+    QVERIFY(chunks.takeDirtyChunks().empty());
+
+    PolyVoxChunks::Chunk first = chunks.getChunk(0);
+    QCOMPARE(first.low, glm::ivec3(0));
+    QCOMPARE(first.high, glm::ivec3(CHUNK_SIZE, CHUNK_SIZE - 1, 0));
+    QCOMPARE(first.ownedHigh, glm::ivec3(CHUNK_SIZE - 1, CHUNK_SIZE - 1, 0));
+    PolyVoxChunks::Chunk last = chunks.getChunk(2);
+    QCOMPARE(last.low, glm::ivec3(2 * CHUNK_SIZE, 0, 0));
+    QCOMPARE(last.high, glm::ivec3(2 * CHUNK_SIZE + 3, CHUNK_SIZE - 1, 0));
+    QCOMPARE(last.ownedHigh, glm::ivec3(2 * CHUNK_SIZE + 3, CHUNK_SIZE - 1, 0));
+
+    // a voxel inside a chunk only dirties that chunk
+    chunks.voxelChanged(glm::ivec3(CHUNK_SIZE / 2, 3, 0));
+    QCOMPARE(chunks.getNumDirtyChunks(), 1);
+    chunks.voxelChanged(glm::ivec3(CHUNK_SIZE / 2 + 1, 3, 0));
+    QCOMPARE(chunks.getNumDirtyChunks(), 1);
+    std::vector<PolyVoxChunks::Chunk> dirtyChunks = chunks.takeDirtyChunks();
+    QCOMPARE((int)dirtyChunks.size(), 1);
+    QCOMPARE(dirtyChunks[0].index, 0);
+
+    // voxels on either side of a chunk boundary dirty both chunks
+    chunks.voxelChanged(glm::ivec3(CHUNK_SIZE, 0, 0));
+    dirtyChunks = chunks.takeDirtyChunks();
+    QCOMPARE((int)dirtyChunks.size(), 2);
+    QCOMPARE(dirtyChunks[0].index, 0);
+    QCOMPARE(dirtyChunks[1].index, 1);
+    chunks.voxelChanged(glm::ivec3(2 * CHUNK_SIZE - 1, 0, 0));
+    dirtyChunks = chunks.takeDirtyChunks();
+    QCOMPARE((int)dirtyChunks.size(), 2);
+    QCOMPARE(dirtyChunks[0].index, 1);
+    QCOMPARE(dirtyChunks[1].index, 2);
+
+    // the normals at the shared layer are central differences, which reach one voxel into the next chunk
+    chunks.voxelChanged(glm::ivec3(CHUNK_SIZE + 1, 0, 0));
+    dirtyChunks = chunks.takeDirtyChunks();
+    QCOMPARE((int)dirtyChunks.size(), 2);
+    QCOMPARE(dirtyChunks[0].index, 0);
+    QCOMPARE(dirtyChunks[1].index, 1);
+    chunks.voxelChanged(glm::ivec3(CHUNK_SIZE + 2, 0, 0));
+    dirtyChunks = chunks.takeDirtyChunks();
+    QCOMPARE((int)dirtyChunks.size(), 1);
+    QCOMPARE(dirtyChunks[0].index, 1);
+    chunks.voxelChanged(glm::ivec3(CHUNK_SIZE - 2, 0, 0));
+    QCOMPARE(chunks.getNumDirtyChunks(), 1);
+    chunks.takeDirtyChunks();
+
+    // the corners of the volume stay inside the grid
+    chunks.voxelChanged(glm::ivec3(0));
+    chunks.voxelChanged(glm::ivec3(2 * CHUNK_SIZE + 3, CHUNK_SIZE - 1, 0));
+    QCOMPARE(chunks.getNumDirtyChunks(), 2);
+
+    chunks.markAllDirty();
+    QCOMPARE(chunks.getNumDirtyChunks(), 3);
+}
+
+void OctreeTests::kinematicSchedulingTests() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    SimpleEntitySimulationPointer simulation = std::make_shared<SimpleEntitySimulation>();
+    simulation->setEntityTree(tree);
+    tree->setSimulation(simulation);
+
+    auto addMovingEntity = [&](const glm::vec3& position) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(position);
+        properties.setDimensions(glm::vec3(0.5f));
+        properties.setVelocity(glm::vec3(1.0f, 0.0f, 0.0f));
+        properties.setDamping(0.0f);
+        EntityItemPointer entity;
+        tree->withWriteLock([&] {
+            entity = tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        });
+        // the velocity change is what makes the simulation move it kinematically
+        entity->markDirtyFlags(Simulation::DIRTY_VELOCITIES);
+        simulation->changeEntity(entity);
+        return entity;
+    };
+    const glm::vec3 NEAR_POSITION(10.0f, 1.0f, 0.0f);
+    const glm::vec3 FAR_POSITION(1000.0f, 1.0f, 0.0f);
+    EntityItemPointer nearEntity = addMovingEntity(NEAR_POSITION);
+    EntityItemPointer farEntity = addMovingEntity(FAR_POSITION);
+    simulation->processChangedEntities();
+
+    const uint64_t START = usecTimestampNow();
+    const uint64_t FRAME_PERIOD = USECS_PER_SECOND / 60;
+    nearEntity->setLastSimulated(START);
+    farEntity->setLastSimulated(START);
+    simulation->setViewerPositions({ glm::vec3(0.0f) });
+
+    // the near entity steps every frame while the far one waits
+    uint64_t now = START + FRAME_PERIOD;
+    simulation->moveSimpleKinematics(now);
+    QVERIFY(nearEntity->getLastSimulated() == now);
+    QVERIFY(farEntity->getLastSimulated() == START);
+    QCOMPARE(farEntity->getWorldPosition(), FAR_POSITION);
+
+    // and when the far one steps it catches up on the whole time since its last step
+    bool farEntityStepped = false;
+    for (int frame = 2; frame <= 60 && !farEntityStepped; frame++) {
+        now = START + frame * FRAME_PERIOD;
+        simulation->moveSimpleKinematics(now);
+        farEntityStepped = farEntity->getLastSimulated() == now;
+    }
+    QVERIFY(farEntityStepped);
+    const float TOLERANCE = 0.001f;
+    glm::vec3 nearDisplacement = nearEntity->getWorldPosition() - NEAR_POSITION;
+    glm::vec3 farDisplacement = farEntity->getWorldPosition() - FAR_POSITION;
+    QVERIFY(nearDisplacement.x > 0.0f);
+    QVERIFY(glm::distance(nearDisplacement, farDisplacement) < TOLERANCE);
+
+    // without viewers every kinematic entity steps every frame
+    simulation->setViewerPositions({});
+    now += FRAME_PERIOD;
+    simulation->moveSimpleKinematics(now);
+    QVERIFY(farEntity->getLastSimulated() == now);
+
+    // a far entity the viewer can see steps every frame too
+    auto makeViewFrustum = [](const glm::quat& orientation) {
+        ViewFrustum viewFrustum;
+        viewFrustum.setProjection(glm::perspective(PI / 2.0f, 1.0f, 0.1f, 2000.0f));
+        viewFrustum.setPosition(glm::vec3(0.0f));
+        viewFrustum.setOrientation(orientation);
+        viewFrustum.calculate();
+        return viewFrustum;
+    };
+    const glm::vec3 Y_AXIS(0.0f, 1.0f, 0.0f);
+    simulation->setViewerPositions({ glm::vec3(0.0f) });
+    simulation->setViewFrustums({ makeViewFrustum(glm::angleAxis(-PI / 2.0f, Y_AXIS)) });
+    for (int frame = 0; frame < 3; frame++) {
+        now += FRAME_PERIOD;
+        simulation->moveSimpleKinematics(now);
+        QVERIFY(farEntity->getLastSimulated() == now);
+    }
+
+    // but waits again once the viewer turns away from it
+    simulation->setViewFrustums({ makeViewFrustum(glm::angleAxis(PI / 2.0f, Y_AXIS)) });
+    uint64_t lastStep = now;
+    now += FRAME_PERIOD;
+    simulation->moveSimpleKinematics(now);
+    QVERIFY(farEntity->getLastSimulated() == lastStep);
+    QVERIFY(nearEntity->getLastSimulated() == now);
+}
+
+void OctreeTests::editFilterEnginePoolTests() {
+    const int NUM_ENGINES = 2;
+    const int NUM_THREADS = 8;
+    const int NUM_BORROWS = 500;
+    EntityEditFilters::FilterEnginePool pool;
+    for (int i = 0; i < NUM_ENGINES; i++) {
+        pool.add(std::unique_ptr<EntityEditFilters::FilterEngine>(new EntityEditFilters::FilterEngine()));
+    }
+
+    // every borrower gets an engine, and no more engines are out at once than the pool has
+    std::atomic<int> inUse { 0 };
+    std::atomic<int> maxInUse { 0 };
+    std::atomic<int> borrows { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < NUM_BORROWS; i++) {
+                auto engine = pool.borrow();
+                int count = ++inUse;
+                int previousMax = maxInUse.load();
+                while (count > previousMax && !maxInUse.compare_exchange_weak(previousMax, count)) {
+                }
+                borrows++;
+                --inUse;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    QCOMPARE(borrows.load(), NUM_THREADS * NUM_BORROWS);
+    QVERIFY(maxInUse.load() <= NUM_ENGINES);
+
+    // with every engine out, a borrower waits until one is returned
+    auto first = pool.borrow();
+    auto second = pool.borrow();
+    QVERIFY(first.get() != second.get());
+    std::atomic<bool> gotEngine { false };
+    std::thread waiter([&] {
+        auto engine = pool.borrow();
+        gotEngine = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    QVERIFY(!gotEngine);
+    first.reset();
+    waiter.join();
+    QVERIFY(gotEngine);
+}
+
+void OctreeTests::editFilterIgnoredPropertiesTests() {
+    DependencyManager::set<ScriptInitializers>();
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    // a filter that rejects everything it is asked about
+    const QString REJECTING_FILTER_SCRIPT = "function filter(properties, type) { return false; }\n";
+    auto filterEdit = [&](EntityEditFilters& filters, EntityItemProperties properties, EntityTree::FilterType filterType) {
+        glm::vec3 position = properties.getPosition();
+        bool wasChanged = false;
+        EntityItemID entityID;
+        EntityItemPointer existingEntity;
+        return filters.filter(position, properties, properties, wasChanged, filterType, entityID, existingEntity);
+    };
+
+    EntityItemProperties positionEdit;
+    positionEdit.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    EntityItemProperties physicsEdit = positionEdit;
+    physicsEdit.setVelocity(glm::vec3(1.0f, 0.0f, 0.0f));
+    EntityItemProperties namedEdit = positionEdit;
+    namedEdit.setName("named");
+
+    {
+        EntityEditFilters filters(tree);
+        QVERIFY(filters.addFilterScript(EntityItemID(), REJECTING_FILTER_SCRIPT + "filter.ignoredProperties = ['position', 'velocity'];\n",
+                                        "http://example.com/filter.js"));
+        // only ignored properties: the script isn't run, so the edit is accepted
+        QVERIFY(filterEdit(filters, positionEdit, EntityTree::FilterType::Edit));
+        QVERIFY(filterEdit(filters, physicsEdit, EntityTree::FilterType::Physics));
+        // anything else still goes through the script
+        QVERIFY(!filterEdit(filters, namedEdit, EntityTree::FilterType::Edit));
+        QVERIFY(!filterEdit(filters, positionEdit, EntityTree::FilterType::Add));
+    }
+    {
+        EntityEditFilters filters(tree);
+        QVERIFY(filters.addFilterScript(EntityItemID(), REJECTING_FILTER_SCRIPT + "filter.ignoredProperties = 'position';\n",
+                                        "http://example.com/filter.js"));
+        QVERIFY(filterEdit(filters, positionEdit, EntityTree::FilterType::Edit));
+        QVERIFY(!filterEdit(filters, physicsEdit, EntityTree::FilterType::Physics));
+    }
+    {
+        EntityEditFilters filters(tree);
+        QVERIFY(filters.addFilterScript(EntityItemID(), REJECTING_FILTER_SCRIPT, "http://example.com/filter.js"));
+        QVERIFY(!filterEdit(filters, positionEdit, EntityTree::FilterType::Edit));
+    }
+
+    DependencyManager::destroy<ScriptInitializers>();
+}
+
+void OctreeTests::editFilterPacketTests() {
+    // an edit packet filtered up front by beginEditPacket() leaves the tree as filtering each edit in turn does
+    const int NUM_ENTITIES = 8;
+    const QString FILTER_SCRIPT =
+        "function filter(properties, type) {\n"
+        "    if (properties.name && properties.name.indexOf('forbidden') >= 0) { return false; }\n"
+        "    if (properties.position && properties.position.y < 0) { properties.position.y = 0; }\n"
+        "    return properties;\n"
+        "}\n";
+
+    DependencyManager::set<ScriptInitializers>();
+    std::vector<EntityItemID> entityIDs;
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        entityIDs.push_back(EntityItemID(QUuid::createUuid()));
+    }
+    auto makeTree = [&] {
+        EntityTreePointer tree = std::make_shared<EntityTree>();
+        tree->createRootElement();
+        tree->setIsServer(true);
+        tree->withWriteLock([&] {
+            for (int i = 0; i < NUM_ENTITIES; i++) {
+                EntityItemProperties properties;
+                properties.setType(EntityTypes::Box);
+                properties.setName("original");
+                properties.setPosition(glm::vec3((float)i, 1.0f, 0.0f));
+                tree->addEntity(entityIDs[i], properties);
+            }
+        });
+        return tree;
+    };
+    EntityTreePointer prefilteredTree = makeTree();
+    EntityTreePointer serialTree = makeTree();
+    auto filters = DependencyManager::set<EntityEditFilters>(prefilteredTree);
+    QVERIFY(filters->addFilterScript(EntityItemID(), FILTER_SCRIPT, "http://example.com/filter.js"));
+
+    // one edit per entity, some rejected and some changed by the filter, then a second edit of the first entity
+    QByteArray packetData;
+    auto appendEdit = [&](const EntityItemID& entityID, const QString& name, const glm::vec3& position) {
+        EntityItemProperties properties;
+        properties.setName(name);
+        properties.setPosition(position);
+        properties.setLastEdited(usecTimestampNow());
+        QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+        EntityPropertyFlags didntFitProperties;
+        auto result = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, properties, buffer,
+                                                                   properties.getChangedProperties(), didntFitProperties);
+        QVERIFY(result == OctreeElement::COMPLETED);
+        packetData.append(buffer);
+    };
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        appendEdit(entityIDs[i], (i % 3 == 0) ? "forbidden" : "edited", glm::vec3((float)i, (i % 2 == 0) ? -1.0f : 2.0f, 0.0f));
+    }
+    appendEdit(entityIDs[1], "edited again", glm::vec3(1.0f, -5.0f, 0.0f));
+
+    SharedNodePointer senderNode(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr()));
+    auto processPacket = [&](EntityTreePointer tree, bool prefilter) {
+        ReceivedMessage message(packetData, PacketType::EntityEdit, versionForPacketType(PacketType::EntityEdit), HifiSockAddr());
+        tree->withWriteLock([&] {
+            if (prefilter) {
+                tree->beginEditPacket(message, senderNode);
+            }
+            while (message.getBytesLeftToRead() > 0) {
+                auto editData = reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition());
+                int bytesRead = tree->processEditPacketData(message, editData, message.getBytesLeftToRead(), senderNode);
+                QVERIFY(bytesRead > 0);
+                message.seek(message.getPosition() + bytesRead);
+            }
+            if (prefilter) {
+                tree->endEditPacket();
+            }
+        });
+    };
+    processPacket(prefilteredTree, true);
+    processPacket(serialTree, false);
+
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        EntityItemPointer prefiltered = prefilteredTree->findEntityByEntityItemID(entityIDs[i]);
+        EntityItemPointer serial = serialTree->findEntityByEntityItemID(entityIDs[i]);
+        QVERIFY(prefiltered && serial);
+        QCOMPARE(prefiltered->getName(), serial->getName());
+        QCOMPARE(prefiltered->getWorldPosition(), serial->getWorldPosition());
+    }
+    auto entity = [&](int i) { return prefilteredTree->findEntityByEntityItemID(entityIDs[i]); };
+    QCOMPARE(entity(0)->getName(), QString("original"));
+    QCOMPARE(entity(1)->getName(), QString("edited again"));
+    QCOMPARE(entity(1)->getWorldPosition(), glm::vec3(1.0f, 0.0f, 0.0f));
+    QCOMPARE(entity(2)->getName(), QString("edited"));
+    QCOMPARE(entity(2)->getWorldPosition(), glm::vec3(2.0f, 0.0f, 0.0f));
+    QCOMPARE(entity(5)->getWorldPosition(), glm::vec3(5.0f, 2.0f, 0.0f));
+
+    DependencyManager::destroy<EntityEditFilters>();
+    DependencyManager::destroy<ScriptInitializers>();
+}
+
+#ifdef MANUAL_TEST
+void OctreeTests::benchmarkEntityEdits() {
+    // a script moving many entities every frame with one Entities.editEntity() call per entity, which takes the tree
+    // write lock per edit, or with one Entities.editEntities() call, which takes it once.  Another thread keeps
+    // querying the tree the way scripts and the renderer do.
+    const int NUM_ENTITIES = 2000;
+    const int NUM_FRAMES = 100;
+    const QString EDIT_SCRIPT =
+        "function positionAt(i, frame) {\n"
+        "    return { x: i % 50, y: 1 + 0.01 * frame, z: Math.floor(i / 50) };\n"
+        "}\n"
+        "function editOneByOne(ids, frame) {\n"
+        "    for (var i = 0; i < ids.length; i++) {\n"
+        "        Entities.editEntity(ids[i], { position: positionAt(i, frame) });\n"
+        "    }\n"
+        "}\n"
+        "function editAll(ids, frame) {\n"
+        "    Entities.editEntities(ids, ids.map(function (id, i) {\n"
+        "        return { position: positionAt(i, frame) };\n"
+        "    }));\n"
+        "}\n";
+
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent);
+    auto entities = DependencyManager::set<EntityScriptingInterface>(false);
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    entities->init();
+    entities->setEntityTree(tree);
+
+    QVector<QUuid> entityIDs;
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3((float)(i % 50), 1.0f, (float)(i / 50)));
+        properties.setDimensions(glm::vec3(0.5f));
+        EntityItemID entityID(QUuid::createUuid());
+        tree->withWriteLock([&] {
+            tree->addEntity(entityID, properties);
+        });
+        entityIDs.push_back(entityID);
+    }
+
+    QScriptEngine engine;
+    registerMetaTypes(&engine);
+    qScriptRegisterMetaType(&engine, EntityItemPropertiesToScriptValue, EntityItemPropertiesFromScriptValueHonorReadOnly);
+    qScriptRegisterSequenceMetaType<QVector<QUuid>>(&engine);
+    QScriptValue entitiesObject = engine.newQObject(entities.data());
+    entitiesObject.setProperty("editEntities", engine.newFunction(EntityScriptingInterface::editEntities));
+    engine.globalObject().setProperty("Entities", entitiesObject);
+    engine.evaluate(EDIT_SCRIPT);
+    QVERIFY(!engine.hasUncaughtException());
+    QScriptValue scriptIDs = qScriptValueFromSequence(&engine, entityIDs);
+
+    std::atomic<bool> done { false };
+    std::atomic<int> queries { 0 };
+    std::thread reader([&] {
+        QVector<QUuid> found;
+        while (!done) {
+            found.clear();
+            tree->withReadLock([&] {
+                tree->evalEntitiesInSphere(glm::vec3(25.0f, 1.0f, 20.0f), 10.0f, PickFilter(PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES)), found);
+            });
+            queries++;
+        }
+    });
+
+    auto runEdits = [&](const QString& function) {
+        QScriptValue edit = engine.globalObject().property(function);
+        queries = 0;
+        auto start = usecTimestampNow();
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            edit.call(QScriptValue(), QScriptValueList() << scriptIDs << frame);
+        }
+        float seconds = (float)(usecTimestampNow() - start) / (float)USECS_PER_SECOND;
+        QVERIFY(!engine.hasUncaughtException());
+        std::cout << qPrintable(function) << ": " << (NUM_ENTITIES * NUM_FRAMES) / seconds
+            << " edits/sec, " << queries / seconds << " queries/sec" << std::endl;
+    };
+
+    runEdits("editOneByOne");
+    runEdits("editAll");
+
+    done = true;
+    reader.join();
+
+    QCOMPARE(tree->findEntityByID(entityIDs.back())->getWorldPosition().y, 1.0f + 0.01f * (NUM_FRAMES - 1));
+
+    DependencyManager::destroy<EntityScriptingInterface>();
+    DependencyManager::destroy<NodeList>();
+    DependencyManager::destroy<AddressManager>();
+    DependencyManager::destroy<AccountManager>();
+}
+
+void OctreeTests::benchmarkFilteredQuery() {
+    // what the entity server does for the entity script server's query on a large domain where few entities have
+    // server scripts: test every entity against the filter, or only the entities from the serverScripts index
+    const int NUM_ENTITIES = 100000;
+    const int SCRIPTED_ENTITY_INTERVAL = 100;
+    const int NUM_PASSES = 20;
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3((float)(i % 300), 1.0f, (float)(i / 300)));
+        if (i % SCRIPTED_ENTITY_INTERVAL == 0) {
+            properties.setServerScripts("http://example.com/server.js");
+        }
+        tree->withWriteLock([&] {
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        });
+    }
+
+    QJsonObject query;
+    query["serverScripts"] = EntityQueryFilterSymbol::NonDefault;
+    EntityQueryFilter filter(query);
+
+    int numMatches = 0;
+    auto start = usecTimestampNow();
+    for (int pass = 0; pass < NUM_PASSES; pass++) {
+        tree->withReadLock([&] {
+            tree->recurseTreeWithOperation([&](const OctreeElementPointer& element, void*) {
+                std::static_pointer_cast<EntityTreeElement>(element)->forEachEntity([&](EntityItemPointer entity) {
+                    numMatches += entity->matchesQueryFilter(filter) ? 1 : 0;
+                });
+                return true;
+            });
+        });
+    }
+    auto elapsed = usecTimestampNow() - start;
+    std::cout << "whole tree: " << (float)elapsed / NUM_PASSES << " usec per pass, " << numMatches / NUM_PASSES
+        << " matches" << std::endl;
+
+    numMatches = 0;
+    start = usecTimestampNow();
+    for (int pass = 0; pass < NUM_PASSES; pass++) {
+        tree->withReadLock([&] {
+            for (const auto& entity : tree->getIndexedEntities(filter)) {
+                numMatches += entity->matchesQueryFilter(filter) ? 1 : 0;
+            }
+        });
+    }
+    elapsed = usecTimestampNow() - start;
+    std::cout << "serverScripts index: " << (float)elapsed / NUM_PASSES << " usec per pass, " << numMatches / NUM_PASSES
+        << " matches" << std::endl;
+}
+
+void OctreeTests::benchmarkEntityQueries() {
+    // Entities.findEntities() from a script thread while another thread moves entities under the tree write lock
+    // and runs EntityTree::update() every frame, answered by walking the tree or from the query snapshot
+    const int NUM_ENTITIES = 20000;
+    const int NUM_MOVING_ENTITIES = 500;
+    const int NUM_QUERIES = 20000;
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    QVector<EntityItemID> entityIDs;
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3((float)(i % 150), 1.0f, (float)(i / 150)));
+        properties.setDimensions(glm::vec3(0.5f));
+        EntityItemID entityID(QUuid::createUuid());
+        tree->withWriteLock([&] {
+            tree->addEntity(entityID, properties);
+        });
+        entityIDs.push_back(entityID);
+    }
+    tree->update(false);
+    PickFilter searchFilter(PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES));
+
+    std::atomic<bool> done { false };
+    std::thread writer([&] {
+        int frame = 0;
+        while (!done) {
+            tree->withWriteLock([&] {
+                for (int i = 0; i < NUM_MOVING_ENTITIES; i++) {
+                    EntityItemProperties properties;
+                    properties.setPosition(glm::vec3((float)(i % 150), 1.0f + 0.01f * (frame % 100), (float)(i / 150)));
+                    tree->updateEntity(entityIDs[i], properties);
+                }
+            });
+            tree->update(false);
+            frame++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(11));
+        }
+    });
+
+    auto runQueries = [&](bool useSnapshot) {
+        size_t numFound = 0;
+        auto start = usecTimestampNow();
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            QVector<QUuid> found;
+            glm::vec3 center((float)(i % 150), 1.0f, (float)((i * 7) % 133));
+            auto snapshot = useSnapshot ? tree->getQuerySnapshot() : EntityQuerySnapshotPointer();
+            if (snapshot) {
+                snapshot->evalEntitiesInSphere(center, 5.0f, searchFilter, found);
+            } else {
+                tree->withReadLock([&] {
+                    tree->evalEntitiesInSphere(center, 5.0f, searchFilter, found);
+                });
+            }
+            numFound += found.size();
+        }
+        auto elapsed = usecTimestampNow() - start;
+        std::cout << (useSnapshot ? "snapshot" : "tree") << ": " << (float)elapsed / NUM_QUERIES << " usec per query, "
+            << numFound / NUM_QUERIES << " entities per query" << std::endl;
+    };
+
+    runQueries(false);
+    runQueries(true);
+
+    done = true;
+    writer.join();
+}
+
+void OctreeTests::benchmarkEditFilters() {
+    // runs position edits without a filter, then through a domain wide edit filter from one thread, from as many
+    // threads as the filter has engines, and with the filter declaring that it ignores position
+    const int NUM_EDITS = 20000;
+    const QString FILTER_SCRIPT =
+        "function filter(properties, type) {\n"
+        "    if (properties.name && properties.name.indexOf('forbidden') >= 0) { return false; }\n"
+        "    return properties;\n"
+        "}\n";
+    const QString IGNORING_FILTER_SCRIPT = FILTER_SCRIPT + "filter.ignoredProperties = ['position'];\n";
+
+    DependencyManager::set<ScriptInitializers>();
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    auto runEdits = [&](const QString& script, int numThreads, const char* label) {
+        EntityEditFilters filters(tree);
+        if (!script.isEmpty()) {
+            QVERIFY(filters.addFilterScript(EntityItemID(), script, "http://example.com/filter.js"));
+        }
+
+        std::atomic<int> accepted { 0 };
+        auto start = usecTimestampNow();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([&, t] {
+                for (int i = t; i < NUM_EDITS; i += numThreads) {
+                    EntityItemProperties properties;
+                    properties.setPosition(glm::vec3((float)i, 1.0f, 0.0f));
+                    glm::vec3 position = properties.getPosition();
+                    bool wasChanged = false;
+                    EntityItemID entityID;
+                    EntityItemPointer existingEntity;
+                    if (filters.filter(position, properties, properties, wasChanged, EntityTree::FilterType::Edit,
+                                       entityID, existingEntity)) {
+                        accepted++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        float seconds = (float)(usecTimestampNow() - start) / (float)USECS_PER_SECOND;
+        QCOMPARE(accepted.load(), NUM_EDITS);
+        std::cout << label << ": " << NUM_EDITS / seconds << " edits/sec" << std::endl;
+    };
+
+    int numThreads = std::max(2, QThread::idealThreadCount());
+    runEdits(QString(), 1, "no filter");
+    runEdits(FILTER_SCRIPT, 1, "one thread");
+    runEdits(FILTER_SCRIPT, numThreads, "concurrent");
+    runEdits(IGNORING_FILTER_SCRIPT, 1, "ignored properties");
+
+    DependencyManager::destroy<ScriptInitializers>();
+}
+
+void OctreeTests::benchmarkCpuParticles() {
+    // one simulation step of an emitter at its maximum particle count: expire, integrate and fill the vertex data
+    const int NUM_PARTICLES = 10000;
+    const int NUM_STEPS = 1000;
+    const float DELTA_TIME = 1.0f / 60.0f;
+
+    particle::CpuParticles particles;
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        particle::CpuParticles::Particle particle;
+        particle.seed = randFloatInRange(-1.0f, 1.0f);
+        particle.expiration = UINT64_MAX;
+        particle.velocity = glm::vec3(randFloatInRange(-1.0f, 1.0f), 1.0f, randFloatInRange(-1.0f, 1.0f));
+        particle.acceleration = glm::vec3(0.0f, -9.8f, 0.0f);
+        particles.push(particle);
+    }
+
+    particle::GpuParticles gpuParticles;
+    auto start = usecTimestampNow();
+    for (int step = 0; step < NUM_STEPS; step++) {
+        particles.expire(step, NUM_PARTICLES);
+        particles.integrate(DELTA_TIME);
+        particles.writeGpuParticles(false, glm::vec3(0.0f), gpuParticles);
+    }
+    float msecs = (float)(usecTimestampNow() - start) / (float)USECS_PER_MSEC;
+    std::cout << (float)NUM_PARTICLES * NUM_STEPS / msecs << " particles/msec" << std::endl;
+}
+
+void OctreeTests::benchmarkPolyVoxEdits() {
+    // the surface extraction that follows an edit to one voxel of a 128^3 marching cubes volume, done for the whole
+    // volume or for the chunks PolyVoxChunks marks dirty (serially here, RenderablePolyVoxEntityItem spreads them
+    // over a thread pool).  The time per edit is the CPU cost and, without queuing, the edit to visible latency.
+    const int VOLUME_SIZE = 128;
+    const int NUM_EDITS = 20;
+
+    // rolling terrain, so that every chunk column has some surface in it
+    PolyVox::SimpleVolume<uint8_t> volData(PolyVox::Region(PolyVox::Vector3DInt32(0, 0, 0),
+                                                           PolyVox::Vector3DInt32(VOLUME_SIZE + 1, VOLUME_SIZE + 1, VOLUME_SIZE + 1)));
+    for (int z = 0; z < VOLUME_SIZE; z++) {
+        for (int x = 0; x < VOLUME_SIZE; x++) {
+            int height = VOLUME_SIZE / 2 + (int)(20.0f * sinf((float)x * 0.1f) * cosf((float)z * 0.07f));
+            for (int y = 0; y < height; y++) {
+                volData.setVoxelAt(x, y, z, 255);
+            }
+        }
+    }
+
+    auto extract = [&](const glm::ivec3& low, const glm::ivec3& high) {
+        PolyVox::SurfaceMesh<PolyVox::PositionMaterialNormal> mesh;
+        PolyVox::Region region(PolyVox::Vector3DInt32(low.x, low.y, low.z), PolyVox::Vector3DInt32(high.x, high.y, high.z));
+        PolyVox::MarchingCubesSurfaceExtractor<PolyVox::SimpleVolume<uint8_t>> extractor(&volData, region, &mesh);
+        extractor.execute();
+        return mesh.getNoOfIndices();
+    };
+
+    PolyVoxChunks chunks;
+    chunks.reset(glm::ivec3(VOLUME_SIZE));
+    chunks.takeDirtyChunks();
+
+    quint64 wholeVolumeUsecs = 0;
+    quint64 dirtyChunksUsecs = 0;
+    int numDirtyChunks = 0;
+    for (int i = 0; i < NUM_EDITS; i++) {
+        glm::ivec3 voxel((i * 37) % VOLUME_SIZE, VOLUME_SIZE / 2, (i * 53) % VOLUME_SIZE);
+        volData.setVoxelAt(voxel.x, voxel.y, voxel.z, (i % 2) ? 255 : 0);
+        chunks.voxelChanged(voxel);
+
+        auto start = usecTimestampNow();
+        extract(glm::ivec3(0), glm::ivec3(VOLUME_SIZE - 1));
+        wholeVolumeUsecs += usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        for (const auto& chunk : chunks.takeDirtyChunks()) {
+            extract(chunk.low, chunk.high);
+            numDirtyChunks++;
+        }
+        dirtyChunksUsecs += usecTimestampNow() - start;
+    }
+
+    std::cout << "whole volume: " << (float)wholeVolumeUsecs / NUM_EDITS << " usec per edit" << std::endl;
+    std::cout << "dirty chunks: " << (float)dirtyChunksUsecs / NUM_EDITS << " usec per edit, "
+        << (float)numDirtyChunks / NUM_EDITS << " of " << chunks.getNumChunks() << " chunks" << std::endl;
+}
+
+void OctreeTests::benchmarkKinematicScheduling() {
+    // the per frame cost of moving kinematic entities spread over a large domain, stepping all of them every
+    // frame and stepping the ones far from the viewer at reduced rates
+    const float DOMAIN_SIZE = 2000.0f; // meters
+    const int NUM_FRAMES = 120;
+    const uint64_t FRAME_PERIOD = USECS_PER_SECOND / 60;
+
+    for (int numEntities : { 1000, 10000, 50000 }) {
+        EntityTreePointer tree = std::make_shared<EntityTree>();
+        tree->createRootElement();
+        SimpleEntitySimulationPointer simulation = std::make_shared<SimpleEntitySimulation>();
+        simulation->setEntityTree(tree);
+        tree->setSimulation(simulation);
+        for (int i = 0; i < numEntities; i++) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(glm::vec3(randFloatInRange(0.0f, DOMAIN_SIZE), 1.0f, randFloatInRange(0.0f, DOMAIN_SIZE)));
+            properties.setDimensions(glm::vec3(0.5f));
+            properties.setVelocity(glm::vec3(randFloatInRange(-1.0f, 1.0f), 0.0f, randFloatInRange(-1.0f, 1.0f)));
+            properties.setAngularVelocity(glm::vec3(0.0f, 1.0f, 0.0f));
+            EntityItemPointer entity;
+            tree->withWriteLock([&] {
+                entity = tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+            });
+            entity->markDirtyFlags(Simulation::DIRTY_VELOCITIES);
+            simulation->changeEntity(entity);
+        }
+        simulation->processChangedEntities();
+
+        uint64_t now = usecTimestampNow();
+        auto runFrames = [&](const char* label) {
+            auto start = usecTimestampNow();
+            for (int frame = 0; frame < NUM_FRAMES; frame++) {
+                now += FRAME_PERIOD;
+                tree->withWriteLock([&] {
+                    simulation->moveSimpleKinematics(now);
+                });
+            }
+            float usecsPerFrame = (float)(usecTimestampNow() - start) / NUM_FRAMES;
+            std::cout << numEntities << " entities, " << label << ": " << usecsPerFrame << " usec/frame" << std::endl;
+        };
+
+        simulation->setViewerPositions({});
+        runFrames("full rate");
+        simulation->setViewerPositions({ glm::vec3(0.5f * DOMAIN_SIZE, 1.0f, 0.5f * DOMAIN_SIZE) });
+        runFrames("scheduled");
+    }
+}
+
+void OctreeTests::benchmarkEntityGetters() {
+    // the per frame getters read by the render, physics and script threads, while another thread edits the entity
+    const int NUM_READERS = 4;
+    const int NUM_READS = 1000000;
+
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(glm::vec3(1.0f));
+    EntityItemPointer entity;
+    tree->withWriteLock([&] {
+        entity = tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+    });
+    QVERIFY(entity);
+
+    auto benchmarkReads = [&](const char* name, std::function<float()> read) {
+        std::atomic<bool> done { false };
+        std::thread writer([&] {
+            // a physics or network thread updating the entity at a high rate
+            float value = 0.0f;
+            while (!done) {
+                value += 1.0f;
+                entity->setGravity(glm::vec3(0.0f, -value, 0.0f));
+                entity->setUnscaledDimensions(glm::vec3(1.0f + value));
+                entity->setLocalPosition(glm::vec3(value));
+                entity->setLocalVelocity(glm::vec3(value, 0.0f, 0.0f));
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+
+        auto start = usecTimestampNow();
+        std::vector<std::thread> readers;
+        for (int i = 0; i < NUM_READERS; i++) {
+            readers.emplace_back([&] {
+                float sum = 0.0f;
+                for (int j = 0; j < NUM_READS; j++) {
+                    sum += read();
+                }
+                volatile float unused = sum;
+                Q_UNUSED(unused);
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        auto elapsed = usecTimestampNow() - start;
+        done = true;
+        writer.join();
+
+        std::cout << name << ": " << (float)(elapsed * 1000) / (NUM_READERS * NUM_READS) << " nsec per read of 4 properties with "
+            << NUM_READERS << " readers" << std::endl;
+    };
+
+    auto readProperties = [&] {
+        return entity->getGravity().y + entity->getUnscaledDimensions().x + entity->getLocalPosition().x +
+            entity->getLocalVelocity().x;
+    };
+    benchmarkReads("getters", readProperties);
+    // the same reads under the entity's read lock, as the getters did before they were SeqLocked
+    benchmarkReads("getters under read lock", [&] {
+        return entity->resultWithReadLock<float>(readProperties);
+    });
+}
+
+#endif
@@ -14,6 +14,8 @@
 
 #include <QtTest/QtTest>
 
+//#define MANUAL_TEST
+
 class OctreeTests : public QObject {
     Q_OBJECT
     
@@ -26,6 +28,25 @@ private slots:
     void modelItemTests();
 
     void elementAddChildTests();
+    void entityQueryFilterTests();
+    void entityQueryIndexTests();
+    void cpuParticlesTests();
+    void polyVoxChunksTests();
+    void kinematicSchedulingTests();
+    void editFilterEnginePoolTests();
+    void editFilterIgnoredPropertiesTests();
+    void editFilterPacketTests();
+
+#ifdef MANUAL_TEST
+    void benchmarkEntityEdits();
+    void benchmarkFilteredQuery();
+    void benchmarkEntityQueries();
+    void benchmarkEditFilters();
+    void benchmarkCpuParticles();
+    void benchmarkPolyVoxEdits();
+    void benchmarkKinematicScheduling();
+    void benchmarkEntityGetters();
+#endif
 
     // TODO: Break these into separate test functions
 };
@@ -27,13 +27,24 @@
 #include <Windows.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
 #include <recording/Clip.h>
 #include <recording/Frame.h>
 
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 
 #include "Constants.h"
 
+//#define MANUAL_TEST
+
 using namespace recording;
 FrameType TEST_FRAME_TYPE { Frame::TYPE_INVALID };
 
@@ -119,10 +130,193 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+// A few thousand frames, so that the indexed layout spans several blocks
+static const int MULTI_BLOCK_NUM_FRAMES = 4000;
+static const int MULTI_BLOCK_FRAME_SIZE = 100;
+static const Frame::Time MULTI_BLOCK_FRAME_INTERVAL = 11;
+
+static Clip::Pointer makeMultiBlockClip() {
+    auto clip = Clip::newClip();
+    QByteArray frameData(MULTI_BLOCK_FRAME_SIZE, 0);
+    for (int i = 0; i < MULTI_BLOCK_NUM_FRAMES; ++i) {
+        for (int j = 0; j < MULTI_BLOCK_FRAME_SIZE; ++j) {
+            frameData[j] = (char)((i + j * j) % 64);
+        }
+        clip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)(i * MULTI_BLOCK_FRAME_INTERVAL), frameData));
+    }
+    return clip;
+}
+
+static bool sameFrames(const FrameConstPointer& a, const FrameConstPointer& b) {
+    if (!a || !b) {
+        return !a && !b;
+    }
+    return a->type == b->type && a->timeOffset == b->timeOffset && a->data == b->data;
+}
+
+void testIndexedClipSeek() {
+    auto clip = makeMultiBlockClip();
+
+    QTemporaryFile legacyFile;
+    QVERIFY(legacyFile.open());
+    QVERIFY(clip->write(legacyFile));
+    legacyFile.close();
+
+    QTemporaryFile indexedFile;
+    QVERIFY(indexedFile.open());
+    indexedFile.close();
+    Clip::toFile(indexedFile.fileName(), clip);
+
+    auto legacyClip = Clip::fromFile(legacyFile.fileName());
+    auto indexedClip = Clip::fromFile(indexedFile.fileName());
+    QVERIFY(legacyClip && indexedClip);
+    QVERIFY(legacyClip->frameCount() == (size_t)MULTI_BLOCK_NUM_FRAMES);
+    QVERIFY(indexedClip->frameCount() == (size_t)MULTI_BLOCK_NUM_FRAMES);
+    QVERIFY(indexedClip->duration() == legacyClip->duration());
+
+    // every frame reads back the same across block boundaries
+    legacyClip->seek(0);
+    indexedClip->seek(0);
+    int count = 0;
+    for (auto legacyFrame = legacyClip->nextFrame(); legacyFrame; legacyFrame = legacyClip->nextFrame(), ++count) {
+        QVERIFY(sameFrames(legacyFrame, indexedClip->nextFrame()));
+    }
+    QVERIFY(count == MULTI_BLOCK_NUM_FRAMES);
+    QVERIFY(!indexedClip->nextFrame());
+
+    // seeks land on the same frame, on frames, between them and past the end, in both directions
+    const Frame::Time END_TIME = (MULTI_BLOCK_NUM_FRAMES + 1) * MULTI_BLOCK_FRAME_INTERVAL;
+    std::vector<Frame::Time> seekTimes;
+    for (Frame::Time time = 0; time <= END_TIME; time += MULTI_BLOCK_FRAME_INTERVAL * 7 + 3) {
+        seekTimes.push_back(time);
+        seekTimes.push_back(time - time % MULTI_BLOCK_FRAME_INTERVAL);
+    }
+    std::mt19937 generator;
+    std::shuffle(seekTimes.begin(), seekTimes.end(), generator);
+    for (auto time : seekTimes) {
+        legacyClip->seekFrameTime(time);
+        indexedClip->seekFrameTime(time);
+        QVERIFY(legacyClip->positionFrameTime() == indexedClip->positionFrameTime());
+        QVERIFY(sameFrames(legacyClip->peekFrame(), indexedClip->peekFrame()));
+        QVERIFY(sameFrames(legacyClip->nextFrame(), indexedClip->nextFrame()));
+        QVERIFY(sameFrames(legacyClip->nextFrame(), indexedClip->nextFrame()));
+    }
+}
+
+void testIndexedClipCorruptIndex() {
+    QTemporaryFile indexedFile;
+    QVERIFY(indexedFile.open());
+    indexedFile.close();
+    Clip::toFile(indexedFile.fileName(), makeMultiBlockClip());
+    QVERIFY(Clip::fromFile(indexedFile.fileName()));
+
+    // the footer ends the file, and starts with the offset of the index frames; the first index entry
+    // ends with its frame count
+    const int FRAME_HEADER_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
+    const int FOOTER_SIZE = sizeof(uint64_t) + 4 * sizeof(uint32_t);
+    const int ENTRY_NUM_FRAMES_OFFSET = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+    QFile file(indexedFile.fileName());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray data = file.readAll();
+    uint64_t indexOffset;
+    memcpy(&indexOffset, data.constData() + data.size() - FOOTER_SIZE, sizeof(indexOffset));
+    QVERIFY(indexOffset < (uint64_t)data.size());
+
+    // a frame count far beyond what the file holds must not be used to size anything
+    uint32_t numFrames = std::numeric_limits<uint32_t>::max() / 2;
+    memcpy(data.data() + indexOffset + FRAME_HEADER_SIZE + ENTRY_NUM_FRAMES_OFFSET, &numFrames, sizeof(numFrames));
+    QVERIFY(file.seek(0));
+    QVERIFY(file.write(data) == data.size());
+    file.close();
+    QVERIFY(!Clip::fromFile(indexedFile.fileName()));
+}
+
+#ifdef MANUAL_TEST
+static uint64_t residentMemoryBytes() {
+#if defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    auto fields = QString(statm.readAll()).split(' ');
+    return fields.size() > 1 ? fields[1].toULongLong() * sysconf(_SC_PAGESIZE) : 0;
+#else
+    MemoryInfo info;
+    return getMemoryInfo(info) ? info.processUsedMemoryBytes : 0;
+#endif
+}
+
+// An hour of frames at 90 fps, played by several players of the same file in both layouts
+static const int BENCHMARK_NUM_FRAMES = 90 * 60 * 60;
+static const int BENCHMARK_FRAME_SIZE = 100;
+static const Frame::Time BENCHMARK_FRAME_INTERVAL = 11;
+static const int BENCHMARK_NUM_PLAYERS = 16;
+static const int BENCHMARK_NUM_SEEKS = 1000;
+
+static std::vector<Frame::Time> benchmarkClipFile(const QString& layout, const QString& fileName) {
+    auto startMemory = residentMemoryBytes();
+
+    auto start = usecTimestampNow();
+    std::vector<Clip::Pointer> players;
+    for (int i = 0; i < BENCHMARK_NUM_PLAYERS; ++i) {
+        players.push_back(Clip::fromFile(fileName));
+    }
+    auto openUsecs = (usecTimestampNow() - start) / BENCHMARK_NUM_PLAYERS;
+
+    // seek like a player starting at a random time, and read the frame it would play
+    std::mt19937 generator;
+    std::uniform_int_distribution<Frame::Time> distribution(0, BENCHMARK_NUM_FRAMES * BENCHMARK_FRAME_INTERVAL);
+    std::vector<Frame::Time> frameTimes;
+    start = usecTimestampNow();
+    for (int i = 0; i < BENCHMARK_NUM_SEEKS; ++i) {
+        const auto& player = players[i % BENCHMARK_NUM_PLAYERS];
+        player->seekFrameTime(distribution(generator));
+        auto frame = player->nextFrame();
+        frameTimes.push_back(frame ? frame->timeOffset : Frame::INVALID_TIME);
+    }
+    auto seekUsecs = (float)(usecTimestampNow() - start) / BENCHMARK_NUM_SEEKS;
+
+    auto memoryBytes = residentMemoryBytes() - startMemory;
+    qDebug() << layout << "layout - open:" << openUsecs << "us, seek:" << seekUsecs << "us, memory of"
+             << BENCHMARK_NUM_PLAYERS << "players:" << memoryBytes / BYTES_PER_KILOBYTE << "KB";
+    return frameTimes;
+}
+
+void benchmarkClipLayouts() {
+    auto clip = Clip::newClip();
+    QByteArray frameData(BENCHMARK_FRAME_SIZE, 0);
+    for (int i = 0; i < BENCHMARK_NUM_FRAMES; ++i) {
+        for (int j = 0; j < BENCHMARK_FRAME_SIZE; ++j) {
+            frameData[j] = (char)((i + j * j) % 64);
+        }
+        clip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)(i * BENCHMARK_FRAME_INTERVAL), frameData));
+    }
+
+    QTemporaryFile legacyFile;
+    QVERIFY(legacyFile.open());
+    QVERIFY(clip->write(legacyFile));
+    legacyFile.close();
+
+    QTemporaryFile indexedFile;
+    QVERIFY(indexedFile.open());
+    indexedFile.close();
+    Clip::toFile(indexedFile.fileName(), clip);
+
+    auto legacyFrameTimes = benchmarkClipFile("Legacy", legacyFile.fileName());
+    auto indexedFrameTimes = benchmarkClipFile("Indexed", indexedFile.fileName());
+    QVERIFY(legacyFrameTimes == indexedFrameTimes);
+}
+#endif
+
 int main(int, const char**) {
     setupHifiApplication("Recording Test");
 
     testFrameTypeRegistration();
     testFilePersist();
     testClipOrdering();
+    testIndexedClipSeek();
+    testIndexedClipCorruptIndex();
+#ifdef MANUAL_TEST
+    benchmarkClipLayouts();
+#endif
 }
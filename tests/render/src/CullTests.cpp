@@ -0,0 +1,180 @@
+//
+//  CullTests.cpp
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullTests.h"
+
+#include <iostream>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <SharedUtil.h>
+#include <render/CullTask.h>
+#include <render/SortTask.h>
+
+QTEST_MAIN(CullTests)
+
+using namespace render;
+
+// Culls bounds smaller than 5cm, like the LOD functor does for distant items
+static bool bigEnough(const RenderArgs* args, const AABox& bound) {
+    return glm::dot(bound.getDimensions(), bound.getDimensions()) > 0.0025f;
+}
+
+static ViewFrustum makeFrustum() {
+    ViewFrustum frustum;
+    frustum.setProjection(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    frustum.setPosition(glm::vec3(10.0f, 2.0f, -5.0f));
+    frustum.setOrientation(glm::angleAxis(glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    frustum.calculate();
+    return frustum;
+}
+
+// A synthetic scene: bounds spread around the camera, so some are inside, some partially and some out of view
+static ItemBounds makeItemBounds(size_t numItems) {
+    ItemBounds items;
+    items.reserve(numItems);
+    for (size_t i = 0; i < numItems; i++) {
+        glm::vec3 corner(randFloatInRange(-400.0f, 400.0f), randFloatInRange(-50.0f, 50.0f), randFloatInRange(-400.0f, 400.0f));
+        glm::vec3 scale(randFloatInRange(0.01f, 10.0f), randFloatInRange(0.01f, 10.0f), randFloatInRange(0.01f, 10.0f));
+        if (i % 100 == 0) {
+            scale = glm::vec3(0.0f); // null bounds are always rendered
+        }
+        items.emplace_back(ItemBound((ItemID)i, AABox(corner, scale)));
+    }
+    return items;
+}
+
+static RenderContextPointer makeRenderContext(RenderArgs& args, const ViewFrustum& frustum) {
+    auto renderContext = std::make_shared<RenderContext>();
+    args.pushViewFrustum(frustum);
+    renderContext->args = &args;
+    return renderContext;
+}
+
+void CullTests::testCullItems() {
+    ViewFrustum frustum = makeFrustum();
+    RenderArgs args;
+    auto renderContext = makeRenderContext(args, frustum);
+
+    // large enough for the parallel path, and not a multiple of the block size
+    const size_t NUM_ITEMS = 20011;
+    ItemBounds inItems = makeItemBounds(NUM_ITEMS);
+
+    ItemBounds outItems;
+    RenderDetails::Item details;
+    cullItems(renderContext, bigEnough, details, inItems, outItems);
+
+    ItemBounds expectedItems;
+    int expectedOutOfView = 0;
+    int expectedTooSmall = 0;
+    for (auto& item : inItems) {
+        if (item.bound.isNull()) {
+            expectedItems.push_back(item);
+        } else if (!frustum.boxIntersectsFrustum(item.bound)) {
+            expectedOutOfView++;
+        } else if (!bigEnough(&args, item.bound)) {
+            expectedTooSmall++;
+        } else {
+            expectedItems.push_back(item);
+        }
+    }
+
+    QCOMPARE(details._considered, (int)NUM_ITEMS);
+    QCOMPARE(details._outOfView, expectedOutOfView);
+    QCOMPARE(details._tooSmall, expectedTooSmall);
+    QCOMPARE(details._rendered, (int)expectedItems.size());
+    QVERIFY(expectedOutOfView > 0);
+    QVERIFY(expectedTooSmall > 0);
+
+    // culling keeps the input order
+    QCOMPARE(outItems.size(), expectedItems.size());
+    for (size_t i = 0; i < outItems.size(); i++) {
+        QCOMPARE(outItems[i].id, expectedItems[i].id);
+    }
+}
+
+void CullTests::testDepthSortItems() {
+    ViewFrustum frustum = makeFrustum();
+    RenderArgs args;
+    auto renderContext = makeRenderContext(args, frustum);
+
+    const size_t NUM_ITEMS = 10007;
+    ItemBounds inItems = makeItemBounds(NUM_ITEMS);
+
+    for (bool frontToBack : { true, false }) {
+        ItemBounds outItems;
+        AABox bounds;
+        depthSortItems(renderContext, frontToBack, inItems, outItems, &bounds);
+        QCOMPARE(outItems.size(), inItems.size());
+
+        for (size_t i = 1; i < outItems.size(); i++) {
+            float previousDepth = frustum.distanceToCameraSquared(outItems[i - 1].bound.calcCenter());
+            float depth = frustum.distanceToCameraSquared(outItems[i].bound.calcCenter());
+            if (frontToBack) {
+                QVERIFY(previousDepth <= depth);
+            } else {
+                QVERIFY(previousDepth >= depth);
+            }
+        }
+
+        std::vector<bool> found(NUM_ITEMS, false);
+        for (auto& item : outItems) {
+            QVERIFY(!found[item.id]);
+            found[item.id] = true;
+            QVERIFY(bounds.contains(item.bound));
+        }
+    }
+}
+
+#ifdef MANUAL_TEST
+void CullTests::benchmarkCull() {
+    ViewFrustum frustum = makeFrustum();
+    RenderArgs args;
+    auto renderContext = makeRenderContext(args, frustum);
+
+    const int NUM_LOOPS = 100;
+    const size_t itemCounts[] = { 1000, 5000, 10000, 50000, 100000 };
+    std::cout << "numItems  serialCull(usec)  cullItems(usec)  depthSortItems(usec)" << std::endl;
+    for (size_t numItems : itemCounts) {
+        ItemBounds inItems = makeItemBounds(numItems);
+        ItemBounds outItems;
+        outItems.reserve(numItems);
+
+        // the per item loop cullItems used before
+        uint64_t start = usecTimestampNow();
+        for (int i = 0; i < NUM_LOOPS; i++) {
+            outItems.clear();
+            for (auto& item : inItems) {
+                if (item.bound.isNull() || (frustum.boxIntersectsFrustum(item.bound) && bigEnough(&args, item.bound))) {
+                    outItems.emplace_back(item);
+                }
+            }
+        }
+        uint64_t serialTime = (usecTimestampNow() - start) / NUM_LOOPS;
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_LOOPS; i++) {
+            outItems.clear();
+            RenderDetails::Item details;
+            cullItems(renderContext, bigEnough, details, inItems, outItems);
+        }
+        uint64_t cullTime = (usecTimestampNow() - start) / NUM_LOOPS;
+
+        ItemBounds sortedItems;
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_LOOPS; i++) {
+            depthSortItems(renderContext, true, outItems, sortedItems);
+        }
+        uint64_t sortTime = (usecTimestampNow() - start) / NUM_LOOPS;
+
+        std::cout << numItems << "  " << serialTime << "  " << cullTime << "  " << sortTime << std::endl;
+    }
+}
+#endif // MANUAL_TEST
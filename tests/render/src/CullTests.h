@@ -0,0 +1,29 @@
+//
+//  CullTests.h
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_CullTests_h
+#define hifi_render_CullTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class CullTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testCullItems();
+    void testDepthSortItems();
+#ifdef MANUAL_TEST
+    void benchmarkCull();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_render_CullTests_h
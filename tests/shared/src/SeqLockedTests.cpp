@@ -0,0 +1,105 @@
+//
+//  SeqLockedTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SeqLockedTests.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <shared/SeqLocked.h>
+
+QTEST_MAIN(SeqLockedTests)
+
+struct Triple {
+    uint64_t a;
+    uint64_t b;
+    uint64_t c;
+};
+
+void SeqLockedTests::testGetSet() {
+    SeqLocked<glm::vec3> value;
+    QCOMPARE(value.get(), glm::vec3(0.0f));
+
+    value.set(glm::vec3(1.0f, 2.0f, 3.0f));
+    QCOMPARE(value.get(), glm::vec3(1.0f, 2.0f, 3.0f));
+
+    SeqLocked<float> initialized { 0.5f };
+    QCOMPARE(initialized.get(), 0.5f);
+}
+
+void SeqLockedTests::testUpdate() {
+    SeqLocked<Triple> value { Triple { 1, 2, 3 } };
+    value.update([](Triple& triple) {
+        triple.a += 10;
+        triple.c = triple.a + triple.b;
+    });
+    Triple result = value.get();
+    QCOMPARE(result.a, (uint64_t)11);
+    QCOMPARE(result.b, (uint64_t)2);
+    QCOMPARE(result.c, (uint64_t)13);
+}
+
+void SeqLockedTests::testConcurrentReadsAreNotTorn() {
+    const int NUM_WRITERS = 2;
+    const int NUM_READERS = 4;
+    const uint64_t NUM_WRITES = 200000;
+
+    SeqLocked<Triple> value { Triple { 0, 0, 0 } };
+    std::atomic<bool> done { false };
+    std::atomic<int> numTornReads { 0 };
+    std::atomic<uint64_t> numReads { 0 };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < NUM_READERS; i++) {
+        readers.emplace_back([&] {
+            uint64_t reads = 0;
+            uint64_t lastA = 0;
+            while (!done) {
+                Triple triple = value.get();
+                // every write keeps the three fields equal, and values only grow
+                if (triple.a != triple.b || triple.b != triple.c || triple.a < lastA) {
+                    ++numTornReads;
+                }
+                lastA = triple.a;
+                ++reads;
+            }
+            numReads += reads;
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < NUM_WRITERS; i++) {
+        writers.emplace_back([&] {
+            for (uint64_t j = 0; j < NUM_WRITES; j++) {
+                value.update([](Triple& triple) {
+                    ++triple.a;
+                    ++triple.b;
+                    ++triple.c;
+                });
+            }
+        });
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    QCOMPARE(numTornReads.load(), 0);
+    QVERIFY(numReads.load() > 0);
+    // writers never lose each other's updates
+    QCOMPARE(value.get().a, NUM_WRITERS * NUM_WRITES);
+}
@@ -0,0 +1,25 @@
+//
+//  SeqLockedTests.h
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SeqLockedTests_h
+#define hifi_SeqLockedTests_h
+
+#include <QtTest/QtTest>
+
+class SeqLockedTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testGetSet();
+    void testUpdate();
+    void testConcurrentReadsAreNotTorn();
+};
+
+#endif // hifi_SeqLockedTests_h
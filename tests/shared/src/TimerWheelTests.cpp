@@ -0,0 +1,239 @@
+//
+//  TimerWheelTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheelTests.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+
+#include <SharedUtil.h>
+#include <TimerWheel.h>
+
+QTEST_MAIN(TimerWheelTests)
+
+void TimerWheelTests::testSingleShot() {
+    TimerWheel wheel(1000);
+    auto first = wheel.add(1000, 10, true);
+    auto second = wheel.add(1000, 10, true);
+    auto later = wheel.add(1000, 100000, true);
+    QCOMPARE(wheel.size(), (size_t)3);
+    QCOMPARE(wheel.msecsUntilNextExpiry(1000), (int64_t)10);
+
+    std::vector<TimerWheel::TimerID> expired;
+    wheel.advance(1009, expired);
+    QVERIFY(expired.empty());
+
+    wheel.advance(1010, expired);
+    QCOMPARE(expired.size(), (size_t)2);
+    QCOMPARE(expired[0], first); // same expiry fires in the order added
+    QCOMPARE(expired[1], second);
+    QVERIFY(!wheel.contains(first));
+
+    // far timers cascade down through the levels
+    expired.clear();
+    wheel.advance(100999, expired);
+    QVERIFY(expired.empty());
+    wheel.advance(101000, expired);
+    QCOMPARE(expired.size(), (size_t)1);
+    QCOMPARE(expired[0], later);
+    QVERIFY(wheel.isEmpty());
+    QCOMPARE(wheel.msecsUntilNextExpiry(101000), (int64_t)-1);
+
+    // zero timeouts fire on the next advance
+    auto immediate = wheel.add(101000, 0, true);
+    expired.clear();
+    wheel.advance(101001, expired);
+    QCOMPARE(expired.size(), (size_t)1);
+    QCOMPARE(expired[0], immediate);
+}
+
+void TimerWheelTests::testRepeating() {
+    TimerWheel wheel;
+    auto timer = wheel.add(0, 16, false);
+
+    std::vector<TimerWheel::TimerID> expired;
+    for (uint64_t now = 1; now <= 160; now++) {
+        wheel.advance(now, expired);
+    }
+    QCOMPARE(expired.size(), (size_t)10);
+    QVERIFY(wheel.contains(timer));
+
+    // a late repeating timer fires once, and keeps its interval from the late time
+    expired.clear();
+    wheel.advance(1000, expired);
+    QCOMPARE(expired.size(), (size_t)1);
+    QCOMPARE(wheel.msecsUntilNextExpiry(1000), (int64_t)16);
+}
+
+void TimerWheelTests::testRemove() {
+    TimerWheel wheel;
+    auto timer = wheel.add(0, 50, false);
+    auto other = wheel.add(0, 50, true);
+    QVERIFY(wheel.remove(timer));
+    QVERIFY(!wheel.remove(timer));
+    QVERIFY(!wheel.contains(timer));
+
+    // ids of removed timers stay invalid when their storage is reused
+    auto reused = wheel.add(0, 50, false);
+    QVERIFY(reused != timer);
+    QVERIFY(!wheel.remove(timer));
+
+    std::vector<TimerWheel::TimerID> expired;
+    wheel.advance(50, expired);
+    QCOMPARE(expired.size(), (size_t)2);
+    QCOMPARE(expired[0], other);
+    QCOMPARE(expired[1], reused);
+}
+
+void TimerWheelTests::testRemoveGroup() {
+    TimerWheel wheel;
+    QUuid entityA = QUuid::createUuid();
+    QUuid entityB = QUuid::createUuid();
+    std::vector<TimerWheel::TimerID> timersA;
+    for (int i = 0; i < 10; i++) {
+        timersA.push_back(wheel.add(0, 10 + i * 1000, i % 2 == 0, entityA));
+    }
+    auto timerB = wheel.add(0, 10, false, entityB);
+    auto ungrouped = wheel.add(0, 10, false);
+    QVERIFY(wheel.remove(timersA[3]));
+
+    std::vector<TimerWheel::TimerID> removed;
+    wheel.removeGroup(entityA, removed);
+    QCOMPARE(removed.size(), (size_t)9);
+    for (auto timer : timersA) {
+        QVERIFY(!wheel.contains(timer));
+    }
+    QCOMPARE(wheel.size(), (size_t)2);
+
+    removed.clear();
+    wheel.removeGroup(entityA, removed);
+    QVERIFY(removed.empty());
+
+    std::vector<TimerWheel::TimerID> expired;
+    wheel.advance(10, expired);
+    QCOMPARE(expired.size(), (size_t)2);
+    QCOMPARE(expired[0], timerB);
+    QCOMPARE(expired[1], ungrouped);
+}
+
+// Compares the wheel against a plain map of expiry times for random timers, removals and time steps
+void TimerWheelTests::testRandomTimers() {
+    struct Timer {
+        uint64_t expiry;
+        uint32_t interval;
+        bool singleShot;
+    };
+    std::mt19937 random(42);
+    std::map<TimerWheel::TimerID, Timer> timers;
+    uint64_t now = 1000;
+    TimerWheel wheel(now);
+
+    for (int step = 0; step < 20000; step++) {
+        int operation = random() % 10;
+        if (operation < 4) {
+            // delays spread over all the levels of the wheel, and beyond
+            const uint32_t MAX_DELAYS[] = { 70, 5000, 400000, 30000000 };
+            uint32_t interval = random() % MAX_DELAYS[random() % 4];
+            bool singleShot = random() % 2 == 0;
+            if (!singleShot) {
+                interval = std::max(interval, (uint32_t)1);
+            }
+            auto timer = wheel.add(now, interval, singleShot);
+            // timers never expire before the next advance
+            timers[timer] = { std::max(now + interval, now + 1), interval, singleShot };
+        } else if (operation == 4 && !timers.empty()) {
+            auto timerItr = timers.begin();
+            std::advance(timerItr, random() % timers.size());
+            QVERIFY(wheel.remove(timerItr->first));
+            timers.erase(timerItr);
+        } else {
+            int64_t msecsUntilNextExpiry = wheel.msecsUntilNextExpiry(now);
+            if (timers.empty()) {
+                QCOMPARE(msecsUntilNextExpiry, (int64_t)-1);
+            } else {
+                uint64_t nextExpiry = UINT64_MAX;
+                for (auto& timer : timers) {
+                    nextExpiry = std::min(nextExpiry, timer.second.expiry);
+                }
+                QVERIFY(now + msecsUntilNextExpiry <= nextExpiry);
+            }
+
+            now += (random() % 3 == 0) ? random() % 100000 : random() % 20;
+            std::vector<TimerWheel::TimerID> expired;
+            wheel.advance(now, expired);
+            std::sort(expired.begin(), expired.end());
+
+            std::vector<TimerWheel::TimerID> expected;
+            for (auto& timer : timers) {
+                if (timer.second.expiry <= now) {
+                    expected.push_back(timer.first);
+                }
+            }
+            QCOMPARE(expired.size(), expected.size());
+            QVERIFY(expired == expected);
+
+            for (auto timerID : expired) {
+                auto& timer = timers[timerID];
+                if (timer.singleShot) {
+                    timers.erase(timerID);
+                } else {
+                    timer.expiry += timer.interval;
+                    if (timer.expiry <= now) {
+                        timer.expiry = now + timer.interval;
+                    }
+                }
+            }
+        }
+        QCOMPARE(wheel.size(), timers.size());
+    }
+}
+
+#ifdef MANUAL_TEST
+void TimerWheelTests::benchmarkTimers() {
+    // 10k repeating timers from 2500 entity scripts, advanced once per 60Hz script frame
+    const int NUM_TIMERS = 10000;
+    const int TIMERS_PER_ENTITY = 4;
+    const uint64_t FRAME_MSECS = 16;
+    const int NUM_FRAMES = 6000;
+
+    std::mt19937 random(42);
+    TimerWheel wheel;
+    std::vector<QUuid> entities;
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        if (i % TIMERS_PER_ENTITY == 0) {
+            entities.push_back(QUuid::createUuid());
+        }
+        wheel.add(0, 16 + random() % 2000, false, entities.back());
+    }
+
+    std::vector<TimerWheel::TimerID> expired;
+    size_t numExpired = 0;
+    auto start = usecTimestampNow();
+    for (int frame = 1; frame <= NUM_FRAMES; frame++) {
+        expired.clear();
+        wheel.advance(frame * FRAME_MSECS, expired);
+        numExpired += expired.size();
+    }
+    auto elapsed = usecTimestampNow() - start;
+    std::cout << "advance: " << (float)elapsed / NUM_FRAMES << " usec per tick for " << NUM_TIMERS << " timers, "
+        << numExpired / NUM_FRAMES << " expired per tick" << std::endl;
+
+    std::vector<TimerWheel::TimerID> removed;
+    start = usecTimestampNow();
+    for (auto& entity : entities) {
+        wheel.removeGroup(entity, removed);
+    }
+    elapsed = usecTimestampNow() - start;
+    std::cout << "removeGroup: " << (float)elapsed / entities.size() << " usec per entity, "
+        << removed.size() << " timers removed" << std::endl;
+}
+#endif // MANUAL_TEST
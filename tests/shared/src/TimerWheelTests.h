@@ -0,0 +1,32 @@
+//
+//  TimerWheelTests.h
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheelTests_h
+#define hifi_TimerWheelTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class TimerWheelTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testSingleShot();
+    void testRepeating();
+    void testRemove();
+    void testRemoveGroup();
+    void testRandomTimers();
+#ifdef MANUAL_TEST
+    void benchmarkTimers();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_TimerWheelTests_h
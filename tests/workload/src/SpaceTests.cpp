@@ -12,6 +12,7 @@
 #include "SpaceTests.h"
 
 #include <iostream>
+#include <random>
 
 #include <workload/Space.h>
 #include <StreamUtils.h>
@@ -22,10 +23,27 @@ const float INV_SQRT_3 = 1.0f / sqrtf(3.0f);
 
 QTEST_MAIN(SpaceTests)
 
+namespace {
+    workload::View makeView(const glm::vec3& center, float near, float mid, float far) {
+        workload::View view;
+        view.origin = center;
+        view.regions[workload::Region::R1] = workload::Sphere(center, near);
+        view.regions[workload::Region::R2] = workload::Sphere(center, mid);
+        view.regions[workload::Region::R3] = workload::Sphere(center, far);
+        return view;
+    }
+
+    void applyTransaction(workload::Space& space, const workload::Transaction& transaction) {
+        space.enqueueTransaction(transaction);
+        space.enqueueFrame();
+        space.processTransactionQueue();
+    }
+}
+
 void SpaceTests::testOverlaps() {
     workload::Space space;
     using Changes = std::vector<workload::Space::Change>;
-    using Views = std::vector<workload::Space::View>;
+    using Views = std::vector<workload::View>;
 
     glm::vec3 viewCenter(0.0f, 0.0f, 0.0f);
     float near = 1.0f;
@@ -33,79 +51,184 @@ void SpaceTests::testOverlaps() {
     float far = 3.0f;
 
     Views views;
-    views.push_back(workload::Space::View(viewCenter, near, mid, far));
+    views.push_back(makeView(viewCenter, near, mid, far));
     space.setViews(views);
 
     int32_t proxyId = 0;
     const float DELTA = 0.001f;
     float proxyRadius = 0.5f;
     glm::vec3 proxyPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + proxyRadius + DELTA);
-    workload::Space::Sphere proxySphere(proxyPosition, proxyRadius);
+    workload::Sphere proxySphere(proxyPosition, proxyRadius);
 
     { // create very_far proxy
-        proxyId = space.createProxy(proxySphere);
+        proxyId = space.allocateID();
+        workload::Transaction transaction;
+        transaction.reset(proxyId, proxySphere, workload::Owner());
+        applyTransaction(space, transaction);
         QVERIFY(space.getNumObjects() == 1);
 
+        Changes changes;
+        space.categorizeAndGetChanges(changes);
+        QVERIFY(changes.size() == 1);
+        QVERIFY(changes[0].proxyId == proxyId);
+        QVERIFY(changes[0].region == workload::Region::R4);
+        QVERIFY(changes[0].prevRegion == workload::Region::UNKNOWN);
+    }
+
+    { // nothing moved
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 0);
+        QVERIFY(space.getRegion(proxyId) == workload::Region::R4);
     }
 
     { // move proxy far
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_FAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_UNKNOWN);
+        QVERIFY(changes[0].region == workload::Region::R3);
+        QVERIFY(changes[0].prevRegion == workload::Region::R4);
     }
 
     { // move proxy mid
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, mid + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_MIDDLE);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_FAR);
+        QVERIFY(changes[0].region == workload::Region::R2);
+        QVERIFY(changes[0].prevRegion == workload::Region::R3);
+    }
+
+    { // move view away, leaving the proxy far
+        Views movedViews;
+        movedViews.push_back(makeView(viewCenter - glm::vec3(0.0f, 0.0f, mid - near), near, mid, far));
+        space.setViews(movedViews);
+        Changes changes;
+        space.categorizeAndGetChanges(changes);
+        QVERIFY(changes.size() == 1);
+        QVERIFY(changes[0].region == workload::Region::R3);
+        QVERIFY(changes[0].prevRegion == workload::Region::R2);
+        space.setViews(views);
+        changes.clear();
+        space.categorizeAndGetChanges(changes);
+        QVERIFY(changes.size() == 1);
+        QVERIFY(changes[0].region == workload::Region::R2);
     }
 
     { // move proxy near
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, near + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_NEAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_MIDDLE);
+        QVERIFY(changes[0].region == workload::Region::R1);
+        QVERIFY(changes[0].prevRegion == workload::Region::R2);
+
+        workload::Proxy proxy;
+        QVERIFY(space.copyProxyValues(&proxy, 1) == 1);
+        QVERIFY(proxy.sphere == workload::Sphere(newPosition, newRadius));
+        QVERIFY(proxy.region == workload::Region::R1);
+        QVERIFY(proxy.prevRegion == workload::Region::R2);
+
+        std::vector<uint8_t> regions;
+        space.copyRegions(regions);
+        QVERIFY(proxyId < (int32_t)regions.size());
+        QVERIFY(regions[proxyId] == workload::Region::R1);
     }
 
     { // delete proxy
         // NOTE: atm deleting a proxy doesn't result in a "Change"
-        std::vector<int32_t> deadProxies;
-        deadProxies.push_back(proxyId);
-        space.deleteProxies(deadProxies);
+        workload::Transaction transaction;
+        transaction.remove(proxyId);
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 0);
         QVERIFY(space.getNumObjects() == 0);
+        QVERIFY(space.getRegion(proxyId) == workload::Region::INVALID);
+
+        std::vector<uint8_t> regions;
+        space.copyRegions(regions);
+        QVERIFY(proxyId >= (int32_t)regions.size() || regions[proxyId] == workload::Region::INVALID);
+    }
+}
+
+void SpaceTests::testParallelClassification() {
+    // enough proxies for the blocks to be classified on the TBB pool
+    const uint32_t NUM_PROXIES = 20000;
+    const float HALF_WIDTH = 50.0f;
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> coordinate(-HALF_WIDTH, HALF_WIDTH);
+    std::uniform_real_distribution<float> radius(0.1f, 2.0f);
+
+    workload::Space space;
+    std::vector<workload::Sphere> proxySpheres;
+    std::vector<int32_t> proxyIds;
+    workload::Transaction transaction;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        proxySpheres.emplace_back(coordinate(generator), coordinate(generator), coordinate(generator), radius(generator));
+        proxyIds.push_back(space.allocateID());
+        transaction.reset(proxyIds.back(), proxySpheres.back(), workload::Owner());
+    }
+    applyTransaction(space, transaction);
+
+    // every proxy must end up in the region a brute force test over all the region spheres gives
+    auto regionsAreExact = [&](const workload::Views& views) {
+        space.setViews(views);
+        std::vector<workload::Space::Change> changes;
+        space.categorizeAndGetChanges(changes);
+        for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+            const workload::Sphere& proxy = proxySpheres[i];
+            uint8_t expected = workload::Region::R4;
+            for (const auto& view : views) {
+                for (uint8_t k = 0; k < workload::Region::NUM_TRACKED_REGIONS; ++k) {
+                    float dx = proxy.x - view.regions[k].x;
+                    float dy = proxy.y - view.regions[k].y;
+                    float dz = proxy.z - view.regions[k].z;
+                    float touchDistance = proxy.w + view.regions[k].w;
+                    if (dx * dx + dy * dy + dz * dz < touchDistance * touchDistance) {
+                        expected = std::min(expected, k);
+                    }
+                }
+            }
+            if (space.getRegion(proxyIds[i]) != expected) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // two views, one of which walks across the proxies so that only the blocks near a boundary are reclassified
+    const glm::vec3 STILL_CENTER(20.0f, 0.0f, 0.0f);
+    glm::vec3 walkingCenter(-30.0f, 0.0f, -10.0f);
+    const glm::vec3 STEP(0.7f, 0.0f, 0.3f);
+    for (int frame = 0; frame < 40; ++frame) {
+        workload::Views views;
+        views.push_back(makeView(walkingCenter, 5.0f, 15.0f, 30.0f));
+        views.push_back(makeView(STILL_CENTER, 2.0f, 8.0f, 20.0f));
+        QVERIFY(regionsAreExact(views));
+        walkingCenter += STEP;
     }
+
+    // and a jump reclassifies everything
+    workload::Views views;
+    views.push_back(makeView(glm::vec3(0.0f), 10.0f, 25.0f, 40.0f));
+    QVERIFY(regionsAreExact(views));
 }
 
 #ifdef MANUAL_TEST
@@ -118,91 +241,70 @@ float randomFloat() {
     return 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
 }
 
-glm::vec3 randomVec3() {
-    glm::vec3 v(randomFloat(), randomFloat(), randomFloat());
-    return v;
-}
-
-void generateSpheres(uint32_t numProxies, std::vector<workload::Space::Sphere>& spheres) {
+void generateSpheres(uint32_t numProxies, std::vector<workload::Sphere>& spheres) {
     spheres.reserve(numProxies);
     for (uint32_t i = 0; i < numProxies; ++i) {
-        workload::Space::Sphere sphere(
+        workload::Sphere sphere(
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
-                (MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS)) * randomFloat());
+                MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * fabsf(randomFloat()));
         spheres.push_back(sphere);
     }
 }
 
-void generatePositions(uint32_t numProxies, std::vector<glm::vec3>& positions) {
-    positions.reserve(numProxies);
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        positions.push_back(WORLD_WIDTH * randomVec3());
-    }
+workload::Views generateViews(const glm::vec3& offset) {
+    float radius0 = 0.25f * WORLD_WIDTH;
+    float radius1 = 0.50f * WORLD_WIDTH;
+    float radius2 = 0.75f * WORLD_WIDTH;
+    workload::Views views;
+    views.push_back(makeView(offset, radius0, radius1, radius2));
+    views.push_back(makeView(offset + glm::vec3(0.0f, 0.0f, 0.1f * WORLD_WIDTH), radius0, radius1, radius2));
+    return views;
 }
 
-void generateRadiuses(uint32_t numRadiuses, std::vector<float>& radiuses) {
-    radiuses.reserve(numRadiuses);
-    for (uint32_t i = 0; i < numRadiuses; ++i) {
-        radiuses.push_back(MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * randomFloat());
+void printTimes(const char* name, const uint32_t* numProxies, const std::vector<uint64_t>& times) {
+    std::cout << "[numProxies, " << name << "] = [" << std::endl;
+    for (uint32_t i = 0; i < times.size(); ++i) {
+        std::cout << "    " << numProxies[i] << ", " << times[i] << std::endl;
     }
+    std::cout << "];" << std::endl;
 }
 
 void SpaceTests::benchmark() {
     uint32_t numProxies[] = { 100, 1000, 10000, 100000 };
     uint32_t numTests = 4;
+    const uint32_t NUM_FRAMES = 100;
     std::vector<uint64_t> timeToAddAll;
     std::vector<uint64_t> timeToMoveView;
+    std::vector<uint64_t> timeToWalkView;
+    std::vector<uint64_t> timeToHoldView;
     std::vector<uint64_t> timeToMoveProxies;
     std::vector<uint64_t> timeToRemoveAll;
     for (uint32_t i = 0; i < numTests; ++i) {
 
         workload::Space space;
-
-        { // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
+        space.setViews(generateViews(glm::vec3(0.0f)));
 
         // build the proxies
         uint32_t n = numProxies[i];
-        std::vector<workload::Space::Sphere> proxySpheres;
+        std::vector<workload::Sphere> proxySpheres;
         generateSpheres(n, proxySpheres);
         std::vector<int32_t> proxyKeys;
         proxyKeys.reserve(n);
 
         // measure time to put proxies in the space
         uint64_t startTime = usecTimestampNow();
+        workload::Transaction transaction;
         for (uint32_t j = 0; j < n; ++j) {
-            int32_t key = space.createProxy(proxySpheres[j]);
+            int32_t key = space.allocateID();
+            transaction.reset(key, proxySpheres[j], workload::Owner());
             proxyKeys.push_back(key);
         }
+        applyTransaction(space, transaction);
         uint64_t usec = usecTimestampNow() - startTime;
         timeToAddAll.push_back(usec);
 
-        {
-            // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f));
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f + 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
-
         // measure time to categorizeAndGetChanges everything
         std::vector<workload::Space::Change> changes;
         startTime = usecTimestampNow();
@@ -210,30 +312,37 @@ void SpaceTests::benchmark() {
         usec = usecTimestampNow() - startTime;
         timeToMoveView.push_back(usec);
 
+        // measure the average frame time while the views walk, the blocks far from every region boundary are skipped
+        const float viewSpeed = 0.01f;
+        startTime = usecTimestampNow();
+        for (uint32_t frame = 0; frame < NUM_FRAMES; ++frame) {
+            space.setViews(generateViews(glm::vec3(viewSpeed * (float)(frame + 1), 0.0f, 0.0f)));
+            changes.clear();
+            space.categorizeAndGetChanges(changes);
+        }
+        usec = (usecTimestampNow() - startTime) / NUM_FRAMES;
+        timeToWalkView.push_back(usec);
+
+        // measure the average frame time while nothing moves
+        startTime = usecTimestampNow();
+        for (uint32_t frame = 0; frame < NUM_FRAMES; ++frame) {
+            changes.clear();
+            space.categorizeAndGetChanges(changes);
+        }
+        usec = (usecTimestampNow() - startTime) / NUM_FRAMES;
+        timeToHoldView.push_back(usec);
+
         // move every 10th proxy around
         const float proxySpeed = 1.0f;
-        std::vector<workload::Space::Sphere> newSpheres;
-        uint32_t numMovingProxies = n / 10;
-        uint32_t jstep = n / numMovingProxies;
-        uint32_t maxJ = numMovingProxies * jstep - 1;
-        glm::vec3 direction;
-        for (uint32_t j = 0; j < maxJ - jstep; j += jstep) {
-            glm::vec3 position = (glm::vec3)proxySpheres[j];
-            glm::vec3 destination = (glm::vec3)proxySpheres[j + jstep];
-            direction = glm::normalize(destination - position);
-            glm::vec3 newPosition = position + proxySpeed * direction;
-            newSpheres.push_back(workload::Space::Sphere(newPosition, proxySpheres[j].w));
-        }
-        glm::vec3 position = (glm::vec3)proxySpheres[maxJ = jstep];
-        glm::vec3 destination = (glm::vec3)proxySpheres[0];
-        direction = glm::normalize(destination - position);
-        direction = position + proxySpeed * direction;
-        newSpheres.push_back(workload::Space::Sphere(direction, proxySpheres[0].w));
-        uint32_t k = 0;
         startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < maxJ; j += jstep) {
-            space.updateProxy(proxyKeys[j], newSpheres[k++]);
+        transaction.clear();
+        for (uint32_t j = 0; j < n; j += 10) {
+            glm::vec3 position = (glm::vec3)proxySpheres[j];
+            glm::vec3 destination = (glm::vec3)proxySpheres[(j + 10) % n];
+            glm::vec3 direction = glm::normalize(destination - position);
+            transaction.update(proxyKeys[j], workload::Sphere(position + proxySpeed * direction, proxySpheres[j].w));
         }
+        applyTransaction(space, transaction);
         changes.clear();
         space.categorizeAndGetChanges(changes);
         usec = usecTimestampNow() - startTime;
@@ -241,40 +350,21 @@ void SpaceTests::benchmark() {
 
         // measure time to remove proxies from space
         startTime = usecTimestampNow();
+        transaction.clear();
         for (uint32_t j = 0; j < n; ++j) {
-            space.deleteProxy(proxyKeys[j]);
+            transaction.remove(proxyKeys[j]);
         }
+        applyTransaction(space, transaction);
         usec = usecTimestampNow() - startTime;
         timeToRemoveAll.push_back(usec);
     }
 
-    std::cout << "[numProxies, timeToAddAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToAddAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToAddAll[i] << std::endl;
-    }
-    std::cout << "];" << std::endl;
-
-    std::cout << "[numProxies, timeToMoveView] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveView.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToMoveView[i] << std::endl;
-    }
-    std::cout << "];" << std::endl;
-
-    std::cout << "[numProxies, timeToMoveProxies] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveProxies.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << "/10, " << timeToMoveProxies[i] << std::endl;
-    }
-    std::cout << "];" << std::endl;
-
-    std::cout << "[numProxies, timeToRemoveAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToRemoveAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToRemoveAll[i] << std::endl;
-    }
-    std::cout << "];" << std::endl;
+    printTimes("timeToAddAll", numProxies, timeToAddAll);
+    printTimes("timeToMoveView", numProxies, timeToMoveView);
+    printTimes("timeToWalkView", numProxies, timeToWalkView);
+    printTimes("timeToHoldView", numProxies, timeToHoldView);
+    printTimes("timeToMoveProxies/10", numProxies, timeToMoveProxies);
+    printTimes("timeToRemoveAll", numProxies, timeToRemoveAll);
 }
 
 #endif // MANUAL_TEST
@@ -0,0 +1,573 @@
+//
+//  LoadBot.cpp
+//  tools/mixer-load-test/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadBot.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+
+#include <AudioConstants.h>
+#include <AudioHelpers.h>
+#include <AvatarHashMap.h>
+#include <LimitedNodeList.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <UUID.h>
+#include <shared/ConicalViewFrustum.h>
+#include <udt/PacketHeaders.h>
+
+using namespace std::chrono;
+
+// at most this many frames of recorded audio wait for their turn to be sent
+static const size_t MAX_PENDING_AUDIO_FRAMES = 10;
+// after a stall, skip the audio frames that could not be sent instead of bursting them
+static const quint64 MAX_AUDIO_FRAMES_CATCH_UP = 5;
+static const quint64 ENTITY_QUERY_INTERVAL_USECS = USECS_PER_SECOND;
+static const float ENTITY_QUERY_RADIUS = 50.0f;
+// bots start at different points of their recording so that they do not all move and talk in lockstep
+static const recording::Frame::Time BOT_START_OFFSET_MSECS = 7919;
+
+void LoadBotStats::merge(const LoadBotStats& other) {
+    packetsSent += other.packetsSent;
+    bytesSent += other.bytesSent;
+    packetsReceived += other.packetsReceived;
+    bytesReceived += other.bytesReceived;
+    audioFramesExpected += other.audioFramesExpected;
+    audioFramesLost += other.audioFramesLost;
+    for (const auto& entry : other.pingMsecs) {
+        auto& samples = pingMsecs[entry.first];
+        samples.insert(samples.end(), entry.second.begin(), entry.second.end());
+    }
+}
+
+LoadBot::LoadBot(int index, const Options& options, BotRecordingPointer recording, QObject* parent) :
+    QObject(parent),
+    _index(index),
+    _options(options),
+    _socket(this),
+    _machineFingerprint(QUuid::createUuid()),
+    _recording(recording)
+{
+    _socket.bind(_options.localAddress);
+    _localSockAddr = HifiSockAddr(_options.localAddress, _socket.localPort());
+
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+    _socket.setMessageHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handleMessagePart(std::move(packet));
+    });
+
+    _avatar.setDisplayName(QString("Load Bot %1").arg(index));
+    // where the bot stands until its recording says otherwise
+    _avatar.setWorldPosition(_options.positionOffset);
+}
+
+int LoadBot::getNumActiveServers() const {
+    return (int)std::count_if(_servers.begin(), _servers.end(), [](const std::unique_ptr<Server>& server) {
+        return !server->activeSocket.isNull();
+    });
+}
+
+LoadBotStats LoadBot::takeStats() {
+    const auto& mixedAudioStats = _mixedAudioSequenceStats.getStats();
+    auto intervalAudioStats = mixedAudioStats - _lastMixedAudioStats;
+    _lastMixedAudioStats = mixedAudioStats;
+    _stats.audioFramesExpected = intervalAudioStats._expectedReceived;
+    _stats.audioFramesLost = intervalAudioStats._lost;
+
+    LoadBotStats stats;
+    std::swap(stats, _stats);
+    return stats;
+}
+
+LoadBot::Server* LoadBot::findServer(NodeType_t type) {
+    auto it = std::find_if(_servers.begin(), _servers.end(), [&](const std::unique_ptr<Server>& server) {
+        return server->type == type;
+    });
+    return it != _servers.end() ? it->get() : nullptr;
+}
+
+LoadBot::Server* LoadBot::findServer(NLPacket::LocalID localID) {
+    auto it = std::find_if(_servers.begin(), _servers.end(), [&](const std::unique_ptr<Server>& server) {
+        return server->localID == localID;
+    });
+    return it != _servers.end() ? it->get() : nullptr;
+}
+
+void LoadBot::sendCheckIn(quint64 nowUsecs) {
+    bool isConnecting = !isConnected();
+    auto domainPacket = NLPacket::create(isConnecting ? PacketType::DomainConnectRequest : PacketType::DomainListRequest);
+    QDataStream packetStream(domainPacket.get());
+
+    if (isConnecting) {
+        // only assignment clients and ICE clients have a connect UUID
+        packetStream << QUuid();
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        // no hardware address, and a fingerprint per bot so that the domain sees them as different machines
+        packetStream << QString();
+        packetStream << _machineFingerprint;
+        // no system info
+        packetStream << QByteArray();
+        packetStream << (quint32)LimitedNodeList::Connect;
+        // no previous connection uptime
+        packetStream << (quint64)0;
+    }
+
+    packetStream << quint64(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
+
+    // a null public address has the domain-server use the address it sees us on
+    QList<NodeType_t> nodeTypesOfInterest { NodeType::AudioMixer, NodeType::AvatarMixer };
+    if (_options.queryEntities) {
+        nodeTypesOfInterest << NodeType::EntityServer;
+    }
+    packetStream << NodeType::Agent << HifiSockAddr(QHostAddress(), _localSockAddr.getPort()) << _localSockAddr
+                 << nodeTypesOfInterest;
+    // no place name
+    packetStream << QString();
+
+    if (isConnecting) {
+        // bots connect anonymously
+        packetStream << QString();
+    }
+
+    sendToDomain(*domainPacket);
+
+    // keep alive pings, they also activate the sockets of new servers and time the round trips
+    for (auto& server : _servers) {
+        auto sendPing = [&](PingType_t pingType, const HifiSockAddr& sockAddr) {
+            if (sockAddr.isNull()) {
+                return;
+            }
+            auto pingPacket = NLPacket::create(PacketType::Ping, sizeof(PingType_t) + sizeof(quint64) + sizeof(int64_t));
+            pingPacket->writePrimitive(pingType);
+            pingPacket->writePrimitive(nowUsecs);
+            // we never reconnect with the same session, so our connection ID stays at its initial value
+            pingPacket->writePrimitive((int64_t)0);
+            sendToServer(*pingPacket, *server, sockAddr);
+        };
+
+        if (server->activeSocket.isNull()) {
+            sendPing(PingType::Local, server->localSocket);
+            sendPing(PingType::Public, server->publicSocket);
+        } else {
+            sendPing(PingType::Agnostic, server->activeSocket);
+        }
+    }
+
+    // identities go out unreliably, so send them again once in a while
+    _identityNeedsSending = true;
+}
+
+void LoadBot::disconnectFromDomain() {
+    if (isConnected()) {
+        auto disconnectPacket = NLPacket::create(PacketType::DomainDisconnectRequest, 0);
+        sendToDomain(*disconnectPacket);
+    }
+}
+
+void LoadBot::sendToDomain(NLPacket& packet) {
+    if (!PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())) {
+        packet.writeSourceID(_sessionLocalID);
+    }
+
+    auto bytesSent = _socket.writePacket(packet, _options.domainSockAddr);
+    if (bytesSent > 0) {
+        _stats.packetsSent++;
+        _stats.bytesSent += bytesSent;
+    }
+}
+
+void LoadBot::sendToServer(NLPacket& packet, Server& server, const HifiSockAddr& sockAddr) {
+    auto type = packet.getType();
+    if (!PacketTypeEnum::getNonSourcedPackets().contains(type)) {
+        packet.writeSourceID(_sessionLocalID);
+
+        if (_authenticatePackets && server.authenticateHash &&
+            !PacketTypeEnum::getNonVerifiedPackets().contains(type)) {
+            packet.writeVerificationHash(*server.authenticateHash);
+        }
+    }
+
+    auto bytesSent = _socket.writePacket(packet, sockAddr);
+    if (bytesSent > 0) {
+        _stats.packetsSent++;
+        _stats.bytesSent += bytesSent;
+    }
+}
+
+void LoadBot::handleMessagePart(std::unique_ptr<udt::Packet> packet) {
+    // reliable messages (identities and traits of the other avatars...) only count towards the bandwidth
+    _stats.packetsReceived++;
+    _stats.bytesReceived += packet->getDataSize();
+}
+
+void LoadBot::handlePacket(std::unique_ptr<udt::Packet> packet) {
+    _stats.packetsReceived++;
+    _stats.bytesReceived += packet->getDataSize();
+
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    auto type = nlPacket->getType();
+    if (nlPacket->getVersion() != versionForPacketType(type)) {
+        return;
+    }
+
+    switch (type) {
+        case PacketType::DomainList:
+            processDomainList(*nlPacket);
+            break;
+        case PacketType::DomainServerAddedNode: {
+            QDataStream packetStream(nlPacket.get());
+            processServer(packetStream);
+            break;
+        }
+        case PacketType::DomainServerRemovedNode: {
+            auto uuid = QUuid::fromRfc4122(nlPacket->read(NUM_BYTES_RFC4122_UUID));
+            _servers.erase(std::remove_if(_servers.begin(), _servers.end(), [&](const std::unique_ptr<Server>& server) {
+                return server->uuid == uuid;
+            }), _servers.end());
+            break;
+        }
+        case PacketType::DomainConnectionDenied:
+            qWarning() << "Load bot" << _index << "was refused by the domain-server";
+            break;
+        case PacketType::Ping:
+        case PacketType::PingReply: {
+            auto server = findServer(nlPacket->getSourceID());
+            if (server) {
+                if (type == PacketType::Ping) {
+                    processPing(*nlPacket, *server);
+                } else {
+                    processPingReply(*nlPacket, *server);
+                }
+            }
+            break;
+        }
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+            processMixedAudio(*nlPacket);
+            break;
+        default:
+            // avatar data, entity data, audio stream stats... only count towards the bandwidth
+            break;
+    }
+}
+
+void LoadBot::processDomainList(NLPacket& packet) {
+    QDataStream packetStream(&packet);
+
+    QUuid domainUUID;
+    NLPacket::LocalID domainLocalID;
+    QUuid newUUID;
+    NLPacket::LocalID newLocalID;
+    NodePermissions newPermissions;
+    bool isAuthenticated;
+    quint64 connectRequestTimestamp;
+    quint64 domainServerPingSendTime;
+    quint64 domainServerCheckinProcessingTime;
+    bool newConnection;
+
+    packetStream >> domainUUID >> domainLocalID >> newUUID >> newLocalID >> newPermissions >> isAuthenticated
+                 >> connectRequestTimestamp >> domainServerPingSendTime >> domainServerCheckinProcessingTime
+                 >> newConnection;
+
+    if (isConnected() && (newLocalID != _sessionLocalID || domainUUID != _domainUUID)) {
+        // the domain-server gave us a new session, the servers will know us under the new one
+        _servers.clear();
+    }
+
+    _domainUUID = domainUUID;
+    _sessionUUID = newUUID;
+    _sessionLocalID = newLocalID;
+    _authenticatePackets = isAuthenticated;
+    _avatar.setSessionUUID(newUUID);
+
+    while (!packetStream.atEnd()) {
+        processServer(packetStream);
+    }
+}
+
+void LoadBot::processServer(QDataStream& packetStream) {
+    NodeType_t type;
+    QUuid uuid;
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+    NodePermissions permissions;
+    bool isReplicated;
+    NLPacket::LocalID localID;
+    QUuid connectionSecret;
+
+    packetStream >> type >> uuid >> publicSocket >> localSocket >> permissions >> isReplicated >> localID
+                 >> connectionSecret;
+
+    if (type != NodeType::AudioMixer && type != NodeType::AvatarMixer && type != NodeType::EntityServer) {
+        return;
+    }
+
+    // a null public address means the server is reachable on the address of the domain-server
+    if (publicSocket.getAddress().isNull()) {
+        publicSocket.setAddress(_options.domainSockAddr.getAddress());
+    }
+
+    auto server = findServer(type);
+    if (server && server->uuid != uuid) {
+        // the domain-server replaced this server
+        _servers.erase(std::find_if(_servers.begin(), _servers.end(), [&](const std::unique_ptr<Server>& other) {
+            return other.get() == server;
+        }));
+        server = nullptr;
+    }
+    if (!server) {
+        _servers.emplace_back(new Server());
+        server = _servers.back().get();
+        server->type = type;
+        server->uuid = uuid;
+        if (type == NodeType::AvatarMixer) {
+            _identityNeedsSending = true;
+        }
+    }
+
+    server->localID = localID;
+    server->publicSocket = publicSocket;
+    server->localSocket = localSocket;
+    if (!server->authenticateHash) {
+        server->authenticateHash.reset(new HMACAuth());
+    }
+    server->authenticateHash->setKey(connectionSecret);
+}
+
+void LoadBot::processPing(NLPacket& packet, Server& server) {
+    PingType_t pingType;
+    quint64 timeFromOriginalPing;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&timeFromOriginalPing);
+
+    auto replyPacket = NLPacket::create(PacketType::PingReply, sizeof(PingType_t) + sizeof(quint64) + sizeof(quint64));
+    replyPacket->writePrimitive(pingType);
+    replyPacket->writePrimitive(timeFromOriginalPing);
+    replyPacket->writePrimitive(usecTimestampNow());
+    sendToServer(*replyPacket, server, packet.getSenderSockAddr());
+}
+
+void LoadBot::processPingReply(NLPacket& packet, Server& server) {
+    PingType_t pingType;
+    quint64 timeFromOriginalPing;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&timeFromOriginalPing);
+
+    if (server.activeSocket.isNull()) {
+        server.activeSocket = packet.getSenderSockAddr();
+    }
+
+    auto nowUsecs = usecTimestampNow();
+    if (nowUsecs >= timeFromOriginalPing) {
+        _stats.pingMsecs[server.type].push_back((float)(nowUsecs - timeFromOriginalPing) / USECS_PER_MSEC);
+    }
+}
+
+void LoadBot::processMixedAudio(NLPacket& packet) {
+    quint16 sequenceNumber;
+    packet.readPrimitive(&sequenceNumber);
+    _mixedAudioSequenceStats.sequenceNumberReceived(sequenceNumber);
+}
+
+void LoadBot::tick(quint64 nowUsecs) {
+    if (!isConnected()) {
+        return;
+    }
+
+    playRecording(nowUsecs);
+
+    auto avatarMixer = findServer(NodeType::AvatarMixer);
+    if (avatarMixer && !avatarMixer->activeSocket.isNull() &&
+        nowUsecs - _lastAvatarSendUsecs >= MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS) {
+        if (_pendingAvatarFrame) {
+            // only the latest frame matters, the ones played since the last send were never seen by the mixer
+            AvatarData::fromFrame(*_pendingAvatarFrame, _avatar);
+            _avatar.setWorldPosition(_avatar.getWorldPosition() + _options.positionOffset);
+            _pendingAvatarFrame = nullptr;
+        }
+        if (_identityNeedsSending) {
+            sendAvatarIdentity();
+        }
+        sendAvatarData();
+        _lastAvatarSendUsecs = nowUsecs;
+    }
+
+    auto audioMixer = findServer(NodeType::AudioMixer);
+    if (audioMixer && !audioMixer->activeSocket.isNull()) {
+        if (_audioStartUsecs == 0) {
+            _audioStartUsecs = nowUsecs;
+        }
+        quint64 numFramesDue = (nowUsecs - _audioStartUsecs) / AudioConstants::NETWORK_FRAME_USECS + 1;
+        if (numFramesDue - _numAudioFramesSent > MAX_AUDIO_FRAMES_CATCH_UP) {
+            _numAudioFramesSent = numFramesDue - MAX_AUDIO_FRAMES_CATCH_UP;
+        }
+        for (; _numAudioFramesSent < numFramesDue; ++_numAudioFramesSent) {
+            QByteArray samples;
+            if (!_pendingAudioFrames.empty()) {
+                samples = _pendingAudioFrames.front();
+                _pendingAudioFrames.pop_front();
+            }
+            sendAudioFrame(samples);
+        }
+    }
+
+    auto entityServer = findServer(NodeType::EntityServer);
+    if (_options.queryEntities && entityServer && !entityServer->activeSocket.isNull() &&
+        nowUsecs - _lastEntityQueryUsecs >= ENTITY_QUERY_INTERVAL_USECS) {
+        sendEntityQuery();
+        _lastEntityQueryUsecs = nowUsecs;
+    }
+}
+
+void LoadBot::playRecording(quint64 nowUsecs) {
+    if (!_recording || _recording->frames.empty()) {
+        return;
+    }
+
+    static const recording::FrameType AVATAR_FRAME_TYPE = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+    static const recording::FrameType AUDIO_FRAME_TYPE =
+        recording::Frame::registerFrameType(AudioConstants::getAudioFrameName());
+
+    const auto& frames = _recording->frames;
+    if (_playbackStartUsecs == 0) {
+        auto startOffset = _recording->duration > 0 ? (_index * BOT_START_OFFSET_MSECS) % _recording->duration : 0;
+        _playbackStartUsecs = nowUsecs - (quint64)startOffset * USECS_PER_MSEC;
+        _nextFrame = std::lower_bound(frames.begin(), frames.end(), startOffset,
+            [](const BotRecording::Frame& frame, recording::Frame::Time time) {
+                return frame.timeOffset < time;
+            }) - frames.begin();
+    }
+
+    auto position = (recording::Frame::Time)((nowUsecs - _playbackStartUsecs) / USECS_PER_MSEC);
+    while (_nextFrame < frames.size() && frames[_nextFrame].timeOffset <= position) {
+        const auto& frame = frames[_nextFrame++];
+        if (frame.type == AVATAR_FRAME_TYPE) {
+            _pendingAvatarFrame = &frame.data;
+        } else if (frame.type == AUDIO_FRAME_TYPE) {
+            _pendingAudioFrames.push_back(frame.data);
+            if (_pendingAudioFrames.size() > MAX_PENDING_AUDIO_FRAMES) {
+                _pendingAudioFrames.pop_front();
+            }
+        }
+    }
+
+    // loop the recording
+    if (_nextFrame >= frames.size()) {
+        _nextFrame = 0;
+        _playbackStartUsecs = nowUsecs;
+    }
+}
+
+void LoadBot::sendAvatarData() {
+    auto avatarMixer = findServer(NodeType::AvatarMixer);
+
+    // like AvatarData::sendAvatarDataPacket, send everything once in a while in case a packet was lost
+    bool sendAllData = randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO;
+    auto dataDetail = sendAllData ? AvatarData::SendAllData : AvatarData::CullSmallData;
+    QByteArray avatarByteArray = _avatar.toByteArrayStateful(dataDetail);
+
+    int maximumByteArraySize = NLPacket::maxPayloadSize(PacketType::AvatarData) - sizeof(AvatarDataSequenceNumber);
+    if (avatarByteArray.size() > maximumByteArraySize) {
+        avatarByteArray = _avatar.toByteArrayStateful(dataDetail, true);
+        if (avatarByteArray.size() > maximumByteArraySize) {
+            avatarByteArray = _avatar.toByteArrayStateful(AvatarData::MinimumData, true);
+        }
+    }
+    _avatar.doneEncoding(sendAllData);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(AvatarDataSequenceNumber));
+    avatarPacket->writePrimitive(_avatarSequenceNumber++);
+    avatarPacket->write(avatarByteArray);
+    sendToServer(*avatarPacket, *avatarMixer);
+}
+
+void LoadBot::sendAvatarIdentity() {
+    auto avatarMixer = findServer(NodeType::AvatarMixer);
+
+    // sent unreliably so that bots never need a send queue (and its thread) per connection
+    QByteArray identityData = _avatar.identityByteArray();
+    auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, identityData.size());
+    identityPacket->write(identityData);
+    sendToServer(*identityPacket, *avatarMixer);
+
+    _identityNeedsSending = false;
+}
+
+void LoadBot::sendAudioFrame(const QByteArray& samples) {
+    auto audioMixer = findServer(NodeType::AudioMixer);
+    auto position = _avatar.getWorldPosition();
+    auto orientation = _avatar.getWorldOrientation();
+
+    // the bots do not negotiate a codec, so the empty codec name stands for raw samples
+    static const QString NO_CODEC;
+
+    // with injected audio, the microphone stream stays silent so the mixer keeps mixing for this bot
+    bool isSilent = samples.isEmpty() || _options.injectAudio;
+    auto audioPacket = NLPacket::create(isSilent ? PacketType::SilentAudioFrame : PacketType::MicrophoneAudioNoEcho);
+    audioPacket->writePrimitive(audioMixer->audioSequenceNumber++);
+    audioPacket->writeString(NO_CODEC);
+    if (isSilent) {
+        audioPacket->writePrimitive((int16_t)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        // mono
+        audioPacket->writePrimitive((quint8)0);
+    }
+    audioPacket->writePrimitive(position);
+    audioPacket->writePrimitive(orientation);
+    audioPacket->writePrimitive(position);
+    audioPacket->writePrimitive(glm::vec3(0.0f));
+    if (!isSilent) {
+        audioPacket->write(samples);
+    }
+    sendToServer(*audioPacket, *audioMixer);
+
+    if (_options.injectAudio && !samples.isEmpty()) {
+        // same layout as AudioInjector::injectNextFrame
+        auto injectPacket = NLPacket::create(PacketType::InjectAudio);
+        QDataStream packetStream(injectPacket.get());
+        packetStream << audioMixer->injectorSequenceNumber++;
+        packetStream << (quint32)0; // empty codec name
+        packetStream << _injectorStreamID;
+        packetStream << false; // mono
+        packetStream << (uchar)0; // no loopback
+        packetStream.writeRawData(reinterpret_cast<const char*>(&position), sizeof(position));
+        packetStream.writeRawData(reinterpret_cast<const char*>(&orientation), sizeof(orientation));
+        packetStream.writeRawData(reinterpret_cast<const char*>(&position), sizeof(position));
+        glm::vec3 boxCorner(0.0f);
+        packetStream.writeRawData(reinterpret_cast<const char*>(&boxCorner), sizeof(boxCorner));
+        packetStream << 0.0f; // point source
+        packetStream << (quint8)packFloatGainToByte(1.0f);
+        packetStream << false; // don't ignore penumbra
+        packetStream.writeRawData(samples.constData(), samples.size());
+        sendToServer(*injectPacket, *audioMixer);
+    }
+}
+
+void LoadBot::sendEntityQuery() {
+    auto entityServer = findServer(NodeType::EntityServer);
+
+    ConicalViewFrustum view;
+    view.setPositionAndSimpleRadius(_avatar.getWorldPosition(), ENTITY_QUERY_RADIUS);
+    _octreeQuery.setConicalViews({ view });
+
+    auto queryPacket = NLPacket::create(PacketType::EntityQuery);
+    int querySize = _octreeQuery.getBroadcastData(reinterpret_cast<unsigned char*>(queryPacket->getPayload()));
+    queryPacket->setPayloadSize(querySize);
+    sendToServer(*queryPacket, *entityServer);
+}
@@ -0,0 +1,173 @@
+//
+//  LoadBot.h
+//  tools/mixer-load-test/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LoadBot_h
+#define hifi_LoadBot_h
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+
+#include <AvatarData.h>
+#include <HMACAuth.h>
+#include <HifiSockAddr.h>
+#include <NLPacket.h>
+#include <NodeType.h>
+#include <OctreeQuery.h>
+#include <SequenceNumberStats.h>
+#include <recording/Frame.h>
+#include <udt/Socket.h>
+
+// A recording read once and played by many bots, each keeping its own position in it
+struct BotRecording {
+    struct Frame {
+        recording::FrameType type;
+        recording::Frame::Time timeOffset;
+        QByteArray data;
+    };
+
+    QString name;
+    std::vector<Frame> frames;
+    recording::Frame::Time duration { 0 };
+};
+using BotRecordingPointer = std::shared_ptr<const BotRecording>;
+
+// The avatar of a bot, set from the avatar frames of its recording
+class BotAvatar : public AvatarData {
+public:
+    QByteArray toByteArrayStateful(AvatarDataDetail dataDetail, bool dropFaceTracking = false) override {
+        _globalPosition = getWorldPosition();
+        return AvatarData::toByteArrayStateful(dataDetail, dropFaceTracking);
+    }
+};
+
+// What the bots saw since the stats were last taken
+struct LoadBotStats {
+    quint64 packetsSent { 0 };
+    quint64 bytesSent { 0 };
+    quint64 packetsReceived { 0 };
+    quint64 bytesReceived { 0 };
+
+    // sequence numbers of the mixed audio sent back by the audio mixer
+    quint32 audioFramesExpected { 0 };
+    quint32 audioFramesLost { 0 };
+
+    // round trip times of keep alive pings, per server type
+    std::map<NodeType_t, std::vector<float>> pingMsecs;
+
+    void merge(const LoadBotStats& other);
+};
+
+// One simulated client. It connects to the domain on its own socket (mixers tell clients apart by their socket) and
+// plays a recording: avatar frames go to the avatar mixer, audio frames to the audio mixer as the microphone stream or
+// as an injected stream, and it keeps an entity query open with the entity server.
+// Bots are not thread safe: the harness drives all of them from one thread.
+class LoadBot : public QObject {
+    Q_OBJECT
+public:
+    struct Options {
+        HifiSockAddr domainSockAddr;
+        QHostAddress localAddress { QHostAddress::LocalHost };
+        bool injectAudio { false };
+        bool queryEntities { true };
+        glm::vec3 positionOffset { 0.0f };
+    };
+
+    LoadBot(int index, const Options& options, BotRecordingPointer recording, QObject* parent = nullptr);
+
+    // Sends what is due at nowUsecs: avatar data, audio frames, entity queries
+    void tick(quint64 nowUsecs);
+    // Connects to or checks in with the domain, and pings the servers
+    void sendCheckIn(quint64 nowUsecs);
+    void disconnectFromDomain();
+
+    bool isConnected() const { return _sessionLocalID != 0; }
+    int getNumActiveServers() const;
+
+    LoadBotStats takeStats();
+
+private:
+    struct Server {
+        NodeType_t type;
+        QUuid uuid;
+        NLPacket::LocalID localID { 0 };
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket;
+        std::unique_ptr<HMACAuth> authenticateHash;
+        quint16 audioSequenceNumber { 0 };
+        quint16 injectorSequenceNumber { 0 };
+    };
+
+    void handlePacket(std::unique_ptr<udt::Packet> packet);
+    void handleMessagePart(std::unique_ptr<udt::Packet> packet);
+
+    void processDomainList(NLPacket& packet);
+    void processServer(QDataStream& packetStream);
+    void processPing(NLPacket& packet, Server& server);
+    void processPingReply(NLPacket& packet, Server& server);
+    void processMixedAudio(NLPacket& packet);
+
+    Server* findServer(NodeType_t type);
+    Server* findServer(NLPacket::LocalID localID);
+
+    void sendToDomain(NLPacket& packet);
+    void sendToServer(NLPacket& packet, Server& server, const HifiSockAddr& sockAddr);
+    void sendToServer(NLPacket& packet, Server& server) { sendToServer(packet, server, server.activeSocket); }
+
+    void playRecording(quint64 nowUsecs);
+    void sendAvatarData();
+    void sendAvatarIdentity();
+    void sendAudioFrame(const QByteArray& samples);
+    void sendEntityQuery();
+
+    int _index;
+    Options _options;
+    udt::Socket _socket;
+    HifiSockAddr _localSockAddr;
+
+    QUuid _machineFingerprint;
+    QUuid _domainUUID;
+    QUuid _sessionUUID;
+    NLPacket::LocalID _sessionLocalID { 0 };
+    bool _authenticatePackets { false };
+    std::vector<std::unique_ptr<Server>> _servers;
+
+    BotRecordingPointer _recording;
+    size_t _nextFrame { 0 };
+    quint64 _playbackStartUsecs { 0 };
+    const QByteArray* _pendingAvatarFrame { nullptr };
+    std::deque<QByteArray> _pendingAudioFrames;
+
+    BotAvatar _avatar;
+    AvatarDataSequenceNumber _avatarSequenceNumber { 0 };
+    bool _identityNeedsSending { true };
+    OctreeQuery _octreeQuery;
+    QUuid _injectorStreamID { QUuid::createUuid() };
+
+    quint64 _lastAvatarSendUsecs { 0 };
+    quint64 _audioStartUsecs { 0 };
+    quint64 _numAudioFramesSent { 0 };
+    quint64 _lastEntityQueryUsecs { 0 };
+
+    SequenceNumberStats _mixedAudioSequenceStats;
+    PacketStreamStats _lastMixedAudioStats;
+    LoadBotStats _stats;
+};
+
+#endif // hifi_LoadBot_h
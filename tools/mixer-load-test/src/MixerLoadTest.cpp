@@ -0,0 +1,274 @@
+//
+//  MixerLoadTest.cpp
+//  tools/mixer-load-test/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MixerLoadTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDebug>
+
+#include <AudioConstants.h>
+#include <DomainHandler.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+
+const QCommandLineOption DOMAIN_OPTION {
+    "d", "domain-server to connect the bots to (default is 127.0.0.1:" + QString::number(DEFAULT_DOMAIN_SERVER_PORT) + ")",
+    "IP:PORT or HOSTNAME:PORT"
+};
+const QCommandLineOption BOTS_OPTION { "bots", "number of bots (default is 10)", "count", "10" };
+const QCommandLineOption RECORDING_OPTION {
+    "recording", "recording played by the bots, can be repeated to spread several recordings over the bots", "file"
+};
+const QCommandLineOption RAMP_OPTION { "ramp", "time between two bots joining (default is 100ms)", "milliseconds", "100" };
+const QCommandLineOption DURATION_OPTION {
+    "duration", "time to run once all the bots have joined (default is until interrupted)", "seconds"
+};
+const QCommandLineOption STATS_INTERVAL_OPTION { "stats-interval", "stats output interval (default is 5s)", "seconds", "5" };
+const QCommandLineOption INJECT_OPTION {
+    "inject", "send the recorded audio as injected streams (default is the microphone stream)"
+};
+const QCommandLineOption NO_ENTITIES_OPTION { "no-entities", "don't query the entity server" };
+const QCommandLineOption SPACING_OPTION {
+    "spacing", "distance between two bots, spread on a grid (default is 1m)", "meters", "1"
+};
+const QCommandLineOption LOCAL_ADDRESS_OPTION {
+    "local-address", "address the bot sockets are bound to (default is 127.0.0.1)", "IP"
+};
+
+// bots tick faster than the audio frames so that frames go out close to when they are due
+static const int TICK_INTERVAL_MSECS = 5;
+
+MixerLoadTest::MixerLoadTest(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    if (!parseArguments()) {
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+
+    qDebug() << "Starting" << _numBots << "bots against" << _botOptions.domainSockAddr;
+
+    _tickTimer.setTimerType(Qt::PreciseTimer);
+    _tickTimer.setInterval(TICK_INTERVAL_MSECS);
+    connect(&_tickTimer, &QTimer::timeout, this, &MixerLoadTest::tick);
+
+    _checkInTimer.setInterval((int)DOMAIN_SERVER_CHECK_IN_MSECS);
+    connect(&_checkInTimer, &QTimer::timeout, this, &MixerLoadTest::checkIn);
+
+    _rampTimer.setInterval(_argumentParser.value(RAMP_OPTION).toInt());
+    connect(&_rampTimer, &QTimer::timeout, this, &MixerLoadTest::addBot);
+
+    _statsTimer.setInterval((int)(_argumentParser.value(STATS_INTERVAL_OPTION).toFloat() * MSECS_PER_SECOND));
+    connect(&_statsTimer, &QTimer::timeout, this, &MixerLoadTest::sampleStats);
+
+    connect(this, &QCoreApplication::aboutToQuit, this, &MixerLoadTest::finish);
+
+    _startUsecs = _lastStatsUsecs = usecTimestampNow();
+    _tickTimer.start();
+    _checkInTimer.start();
+    _rampTimer.start();
+    _statsTimer.start();
+    addBot();
+}
+
+bool MixerLoadTest::parseArguments() {
+    _argumentParser.addOptions({
+        DOMAIN_OPTION, BOTS_OPTION, RECORDING_OPTION, RAMP_OPTION, DURATION_OPTION, STATS_INTERVAL_OPTION,
+        INJECT_OPTION, NO_ENTITIES_OPTION, SPACING_OPTION, LOCAL_ADDRESS_OPTION
+    });
+    const QCommandLineOption helpOption = _argumentParser.addHelpOption();
+
+    if (!_argumentParser.parse(arguments())) {
+        qCritical() << _argumentParser.errorText();
+        _argumentParser.showHelp();
+        return false;
+    }
+
+    if (_argumentParser.isSet(helpOption)) {
+        _argumentParser.showHelp();
+        return false;
+    }
+
+    QString hostnamePortString = _argumentParser.isSet(DOMAIN_OPTION) ? _argumentParser.value(DOMAIN_OPTION) : "127.0.0.1";
+    int portIndex = hostnamePortString.indexOf(':');
+    quint16 port = portIndex >= 0 ? (quint16)hostnamePortString.mid(portIndex + 1).toUInt() : DEFAULT_DOMAIN_SERVER_PORT;
+    _botOptions.domainSockAddr = HifiSockAddr(hostnamePortString.left(portIndex), port, true);
+    if (_botOptions.domainSockAddr.getAddress().isNull() || port == 0) {
+        qCritical() << "Could not parse a domain-server address from" << hostnamePortString;
+        return false;
+    }
+
+    if (_argumentParser.isSet(LOCAL_ADDRESS_OPTION)) {
+        _botOptions.localAddress = QHostAddress(_argumentParser.value(LOCAL_ADDRESS_OPTION));
+        if (_botOptions.localAddress.isNull()) {
+            qCritical() << "Could not parse a local address from" << _argumentParser.value(LOCAL_ADDRESS_OPTION);
+            return false;
+        }
+    }
+
+    _botOptions.injectAudio = _argumentParser.isSet(INJECT_OPTION);
+    _botOptions.queryEntities = !_argumentParser.isSet(NO_ENTITIES_OPTION);
+    _numBots = std::max(_argumentParser.value(BOTS_OPTION).toInt(), 0);
+    _botSpacing = _argumentParser.value(SPACING_OPTION).toFloat();
+
+    return loadRecordings(_argumentParser.values(RECORDING_OPTION));
+}
+
+bool MixerLoadTest::loadRecordings(const QStringList& filePaths) {
+    // the clips only keep the frames of the types known when they are read
+    const auto avatarFrameType = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+    const auto audioFrameType = recording::Frame::registerFrameType(AudioConstants::getAudioFrameName());
+
+    for (const auto& filePath : filePaths) {
+        auto clip = recording::Clip::fromFile(filePath);
+        if (!clip) {
+            qCritical() << "Could not load recording" << filePath;
+            return false;
+        }
+
+        // read once and shared by all the bots playing it
+        auto recording = std::make_shared<BotRecording>();
+        recording->name = clip->getName();
+        recording->frames.reserve(clip->frameCount());
+        clip->seekFrameTime(0);
+        for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+            if (frame->type == avatarFrameType || frame->type == audioFrameType) {
+                recording->frames.push_back({ frame->type, frame->timeOffset, frame->data });
+                recording->duration = std::max(recording->duration, frame->timeOffset);
+            }
+        }
+
+        qDebug() << "Loaded recording" << filePath << "-" << recording->frames.size() << "frames,"
+                 << recording->duration << "ms";
+        _recordings.push_back(recording);
+    }
+
+    if (_recordings.empty()) {
+        qDebug() << "No recording given, the bots will stand still and stay silent";
+    }
+    return true;
+}
+
+void MixerLoadTest::addBot() {
+    int index = (int)_bots.size();
+    if (index >= _numBots) {
+        _rampTimer.stop();
+        if (_argumentParser.isSet(DURATION_OPTION)) {
+            int durationMsecs = (int)(_argumentParser.value(DURATION_OPTION).toFloat() * MSECS_PER_SECOND);
+            QTimer::singleShot(durationMsecs, this, &QCoreApplication::quit);
+        }
+        return;
+    }
+
+    // spread the bots on a square grid around the origin of their recordings
+    int gridSize = (int)std::ceil(std::sqrt((float)_numBots));
+    LoadBot::Options options = _botOptions;
+    options.positionOffset = glm::vec3((float)(index % gridSize - gridSize / 2), 0.0f,
+                                       (float)(index / gridSize - gridSize / 2)) * _botSpacing;
+
+    BotRecordingPointer recording;
+    if (!_recordings.empty()) {
+        recording = _recordings[index % _recordings.size()];
+    }
+
+    auto bot = new LoadBot(index, options, recording, this);
+    _bots.push_back(bot);
+    bot->sendCheckIn(usecTimestampNow());
+}
+
+void MixerLoadTest::tick() {
+    // all the bots send from this one thread, a tick sends the packets of every bot that are due
+    auto nowUsecs = usecTimestampNow();
+    for (auto bot : _bots) {
+        bot->tick(nowUsecs);
+    }
+}
+
+void MixerLoadTest::checkIn() {
+    auto nowUsecs = usecTimestampNow();
+    for (auto bot : _bots) {
+        bot->sendCheckIn(nowUsecs);
+    }
+}
+
+static void printPingStats(const LoadBotStats& stats) {
+    for (const auto& entry : stats.pingMsecs) {
+        auto samples = entry.second;
+        if (samples.empty()) {
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        float total = 0.0f;
+        for (auto sample : samples) {
+            total += sample;
+        }
+        size_t p95Index = std::min(samples.size() - 1, (size_t)(samples.size() * 0.95f));
+        qDebug().nospace() << "    RTT " << NodeType::getNodeTypeName(entry.first) << ": avg " << total / samples.size()
+                           << " ms, p95 " << samples[p95Index] << " ms, max " << samples.back() << " ms";
+    }
+}
+
+static void printTrafficStats(const LoadBotStats& stats, quint64 intervalUsecs) {
+    float intervalSecs = (float)intervalUsecs / USECS_PER_SECOND;
+    float upMbps = (float)stats.bytesSent * BITS_IN_BYTE / intervalSecs / BYTES_PER_KILOBYTE / BYTES_PER_KILOBYTE;
+    float downMbps = (float)stats.bytesReceived * BITS_IN_BYTE / intervalSecs / BYTES_PER_KILOBYTE / BYTES_PER_KILOBYTE;
+    float audioLoss = stats.audioFramesExpected > 0 ? 100.0f * stats.audioFramesLost / stats.audioFramesExpected : 0.0f;
+
+    qDebug().nospace() << "    Up " << upMbps << " Mb/s (" << stats.packetsSent << " packets), down " << downMbps
+                       << " Mb/s (" << stats.packetsReceived << " packets), mixed audio loss " << audioLoss << "% ("
+                       << stats.audioFramesLost << "/" << stats.audioFramesExpected << ")";
+    printPingStats(stats);
+}
+
+void MixerLoadTest::sampleStats() {
+    auto nowUsecs = usecTimestampNow();
+
+    LoadBotStats intervalStats;
+    int numConnected = 0;
+    int numFullyConnected = 0;
+    int numServers = _botOptions.queryEntities ? 3 : 2;
+    for (auto bot : _bots) {
+        intervalStats.merge(bot->takeStats());
+        if (bot->isConnected()) {
+            numConnected++;
+            if (bot->getNumActiveServers() == numServers) {
+                numFullyConnected++;
+            }
+        }
+    }
+    _totalStats.merge(intervalStats);
+
+    qDebug().nospace() << (nowUsecs - _startUsecs) / USECS_PER_SECOND << "s - " << _bots.size() << "/" << _numBots
+                       << " bots, " << numConnected << " connected to the domain, " << numFullyConnected
+                       << " connected to every server";
+    printTrafficStats(intervalStats, nowUsecs - _lastStatsUsecs);
+
+    _lastStatsUsecs = nowUsecs;
+}
+
+void MixerLoadTest::finish() {
+    if (_startUsecs == 0) {
+        return;
+    }
+
+    sampleStats();
+
+    qDebug() << "Total over" << (usecTimestampNow() - _startUsecs) / USECS_PER_SECOND << "s";
+    printTrafficStats(_totalStats, usecTimestampNow() - _startUsecs);
+
+    for (auto bot : _bots) {
+        bot->disconnectFromDomain();
+    }
+}
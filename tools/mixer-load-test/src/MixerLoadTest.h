@@ -0,0 +1,60 @@
+//
+//  MixerLoadTest.h
+//  tools/mixer-load-test/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_MixerLoadTest_h
+#define hifi_MixerLoadTest_h
+
+#include <vector>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+
+#include "LoadBot.h"
+
+// Connects a growing number of recorded avatar bots to a domain and reports what they see: bandwidth, the loss of
+// the mixed audio and the round trip times to every mixer.
+class MixerLoadTest : public QCoreApplication {
+    Q_OBJECT
+public:
+    MixerLoadTest(int& argc, char** argv);
+
+private slots:
+    void tick();
+    void checkIn();
+    void addBot();
+    void sampleStats();
+    void finish();
+
+private:
+    bool parseArguments();
+    bool loadRecordings(const QStringList& filePaths);
+
+    QCommandLineParser _argumentParser;
+
+    LoadBot::Options _botOptions;
+    int _numBots { 0 };
+    float _botSpacing { 0.0f };
+    std::vector<BotRecordingPointer> _recordings;
+    std::vector<LoadBot*> _bots;
+
+    QTimer _tickTimer;
+    QTimer _checkInTimer;
+    QTimer _rampTimer;
+    QTimer _statsTimer;
+
+    quint64 _startUsecs { 0 };
+    quint64 _lastStatsUsecs { 0 };
+    LoadBotStats _totalStats;
+};
+
+#endif // hifi_MixerLoadTest_h